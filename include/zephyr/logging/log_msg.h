@@ -393,7 +393,37 @@ do { \
  *
  * @param ...  Optional string with arguments (fmt, ...). It may be empty.
  */
-#if defined(CONFIG_LOG_ALWAYS_RUNTIME) || \
+#if defined(CONFIG_LOG_FMT_DESC)
+/* Format string and argument types are known at compile time so they are put
+ * into a descriptor which is passed in place of the format string. Runtime
+ * packaging does not need to parse the format string then.
+ */
+#define Z_LOG_MSG2_FMT_DESC_CREATE(_cstr_cnt, _domain_id, _source, _level, \
+				   _data, _dlen, ...) \
+do { \
+	CBPRINTF_FMT_DESC_DEFINE(_log_fmt_desc, __VA_ARGS__); \
+	z_log_msg_runtime_create(_domain_id, (void *)_source, \
+				  _level, (uint8_t *)_data, _dlen, \
+				  Z_LOG_MSG2_CBPRINTF_FLAGS(_cstr_cnt) | \
+				  CBPRINTF_PACKAGE_FMT_DESC, \
+				  (const char *)&_log_fmt_desc \
+				  COND_CODE_0(NUM_VA_ARGS_LESS_1(__VA_ARGS__), (), \
+					      (, GET_ARGS_LESS_N(1, __VA_ARGS__)))); \
+} while (false)
+
+#define Z_LOG_MSG2_CREATE2(_try_0cpy, _mode,  _cstr_cnt, _domain_id, _source,\
+			  _level, _data, _dlen, ...) \
+do {\
+	COND_CODE_0(NUM_VA_ARGS_LESS_1(_, ##__VA_ARGS__), \
+		(z_log_msg_runtime_create(_domain_id, (void *)_source, \
+					   _level, (uint8_t *)_data, _dlen, \
+					   Z_LOG_MSG2_CBPRINTF_FLAGS(_cstr_cnt), \
+					   NULL)), \
+		(Z_LOG_MSG2_FMT_DESC_CREATE(_cstr_cnt, _domain_id, _source, \
+					    _level, _data, _dlen, __VA_ARGS__))); \
+	_mode = Z_LOG_MSG2_MODE_RUNTIME; \
+} while (false)
+#elif defined(CONFIG_LOG_ALWAYS_RUNTIME) || \
 	(!defined(CONFIG_LOG) && \
 		(!TOOLCHAIN_HAS_PRAGMA_DIAG || !TOOLCHAIN_HAS_C_AUTO_TYPE))
 #define Z_LOG_MSG2_CREATE2(_try_0cpy, _mode,  _cstr_cnt, _domain_id, _source,\
@@ -983,6 +983,9 @@ struct net_buf_pool {
 	/* Size of user data allocated to this pool */
 	uint8_t user_data_size;
 
+	/** Data up to this size is stored in the buffer itself */
+	uint16_t inline_size;
+
 #if defined(CONFIG_NET_BUF_POOL_USAGE)
 	/** Amount of available buffers in the pool. */
 	atomic_t avail_count;
@@ -1006,13 +1009,15 @@ struct net_buf_pool {
 
 /** @cond INTERNAL_HIDDEN */
 #if defined(CONFIG_NET_BUF_POOL_USAGE)
-#define NET_BUF_POOL_INITIALIZER(_pool, _alloc, _bufs, _count, _ud_size, _destroy) \
+#define NET_BUF_POOL_INLINE_INITIALIZER(_pool, _alloc, _bufs, _count, _ud_size,    \
+					_inline_size, _destroy)                    \
 	{                                                                          \
 		.free = Z_LIFO_INITIALIZER(_pool.free),                            \
 		.lock = { },                                                       \
 		.buf_count = _count,                                               \
 		.uninit_count = _count,                                            \
 		.user_data_size = _ud_size,                                        \
+		.inline_size = _inline_size,                                       \
 		.avail_count = ATOMIC_INIT(_count),                                \
 		.name = STRINGIFY(_pool),                                          \
 		.destroy = _destroy,                                               \
@@ -1020,32 +1025,44 @@ struct net_buf_pool {
 		.__bufs = (struct net_buf *)_bufs,                                 \
 	}
 #else
-#define NET_BUF_POOL_INITIALIZER(_pool, _alloc, _bufs, _count, _ud_size, _destroy) \
+#define NET_BUF_POOL_INLINE_INITIALIZER(_pool, _alloc, _bufs, _count, _ud_size,    \
+					_inline_size, _destroy)                    \
 	{                                                                          \
 		.free = Z_LIFO_INITIALIZER(_pool.free),                            \
 		.lock = { },                                                       \
 		.buf_count = _count,                                               \
 		.uninit_count = _count,                                            \
 		.user_data_size = _ud_size,                                        \
+		.inline_size = _inline_size,                                       \
 		.destroy = _destroy,                                               \
 		.alloc = _alloc,                                                   \
 		.__bufs = (struct net_buf *)_bufs,                                 \
 	}
 #endif /* CONFIG_NET_BUF_POOL_USAGE */
 
-#define _NET_BUF_ARRAY_DEFINE(_name, _count, _ud_size)					       \
-	struct _net_buf_##_name { uint8_t b[sizeof(struct net_buf)];			       \
-				  uint8_t ud[_ud_size]; } __net_buf_align;		       \
-	BUILD_ASSERT(_ud_size <= UINT8_MAX);						       \
-	BUILD_ASSERT(offsetof(struct net_buf, user_data) ==				       \
-		     offsetof(struct _net_buf_##_name, ud), "Invalid offset");		       \
-	BUILD_ASSERT(__alignof__(struct net_buf) ==					       \
-		     __alignof__(struct _net_buf_##_name), "Invalid alignment");	       \
-	BUILD_ASSERT(sizeof(struct _net_buf_##_name) ==					       \
-		     ROUND_UP(sizeof(struct net_buf) + _ud_size, __alignof__(struct net_buf)), \
-		     "Size cannot be determined");					       \
+#define NET_BUF_POOL_INITIALIZER(_pool, _alloc, _bufs, _count, _ud_size, _destroy) \
+	NET_BUF_POOL_INLINE_INITIALIZER(_pool, _alloc, _bufs, _count, _ud_size, \
+					0, _destroy)
+
+#define _NET_BUF_ARRAY_INLINE_DEFINE(_name, _count, _ud_size, _inline_size)             \
+	struct _net_buf_##_name { uint8_t b[sizeof(struct net_buf)];                    \
+				  uint8_t ud[_ud_size];                                 \
+				  uint8_t data[_inline_size]; } __net_buf_align;        \
+	BUILD_ASSERT(_ud_size <= UINT8_MAX);                                            \
+	BUILD_ASSERT(_inline_size <= UINT16_MAX);                                       \
+	BUILD_ASSERT(offsetof(struct net_buf, user_data) ==                             \
+		     offsetof(struct _net_buf_##_name, ud), "Invalid offset");          \
+	BUILD_ASSERT(__alignof__(struct net_buf) ==                                     \
+		     __alignof__(struct _net_buf_##_name), "Invalid alignment");        \
+	BUILD_ASSERT(sizeof(struct _net_buf_##_name) ==                                 \
+		     ROUND_UP(sizeof(struct net_buf) + _ud_size + _inline_size,         \
+			      __alignof__(struct net_buf)),                             \
+		     "Size cannot be determined");                                      \
 	static struct _net_buf_##_name _net_buf_##_name[_count] __noinit
 
+#define _NET_BUF_ARRAY_DEFINE(_name, _count, _ud_size)                                  \
+	_NET_BUF_ARRAY_INLINE_DEFINE(_name, _count, _ud_size, 0)
+
 extern const struct net_buf_data_alloc net_buf_heap_alloc;
 /** @endcond */
 
@@ -1083,9 +1100,37 @@ extern const struct net_buf_data_alloc net_buf_heap_alloc;
 					 _net_buf_##_name, _count, _ud_size, \
 					 _destroy)
 
+/**
+ *
+ * @brief Define a new pool for buffers storing small payloads inline.
+ *
+ * Same as NET_BUF_POOL_HEAP_DEFINE(), but each buffer also reserves
+ * @p _inline_size bytes right after its user data. Allocations of up to
+ * that many bytes use this space instead of the heap, so the data shares
+ * the cache lines of the buffer header and no heap allocation is made.
+ * Larger allocations fall back to the heap. This is transparent to the
+ * net_buf API users.
+ *
+ * @param _name        Name of the pool variable.
+ * @param _count       Number of buffers in the pool.
+ * @param _inline_size Maximum data payload stored inline per buffer.
+ * @param _ud_size     User data space to reserve per buffer.
+ * @param _destroy     Optional destroy callback when buffer is freed.
+ */
+#define NET_BUF_POOL_HEAP_INLINE_DEFINE(_name, _count, _inline_size, _ud_size, \
+					_destroy)                              \
+	_NET_BUF_ARRAY_INLINE_DEFINE(_name, _count, _ud_size, _inline_size);   \
+	static STRUCT_SECTION_ITERABLE(net_buf_pool, _name) =                  \
+		NET_BUF_POOL_INLINE_INITIALIZER(_name, &net_buf_heap_alloc,    \
+						_net_buf_##_name, _count,      \
+						_ud_size, _inline_size,        \
+						_destroy)
+
 struct net_buf_pool_fixed {
 	size_t data_size;
 	uint8_t *data_pool;
+	/* Number of buffers referencing each data chunk */
+	atomic_t *data_refs;
 };
 
 /** @cond INTERNAL_HIDDEN */
@@ -1110,6 +1155,9 @@ extern const struct net_buf_data_cb net_buf_fixed_cb;
  * that allocation failures, i.e. NULL returns, must always be handled
  * cleanly.
  *
+ * The data chunks are reference counted, so net_buf_shared_clone() can
+ * share the data of a buffer instead of copying it.
+ *
  * If provided with a custom destroy callback, this callback is
  * responsible for eventually calling net_buf_destroy() to complete the
  * process of returning the buffer to the pool.
@@ -1123,9 +1171,11 @@ extern const struct net_buf_data_cb net_buf_fixed_cb;
 #define NET_BUF_POOL_FIXED_DEFINE(_name, _count, _data_size, _ud_size, _destroy) \
 	_NET_BUF_ARRAY_DEFINE(_name, _count, _ud_size);                        \
 	static uint8_t __noinit net_buf_data_##_name[_count][_data_size] __net_buf_align; \
+	static atomic_t net_buf_data_refs_##_name[_count];                     \
 	static const struct net_buf_pool_fixed net_buf_fixed_##_name = {       \
 		.data_size = _data_size,                                       \
 		.data_pool = (uint8_t *)net_buf_data_##_name,                  \
+		.data_refs = net_buf_data_refs_##_name,                        \
 	};                                                                     \
 	static const struct net_buf_data_alloc net_buf_fixed_alloc_##_name = { \
 		.cb = &net_buf_fixed_cb,                                       \
@@ -1176,6 +1226,41 @@ extern const struct net_buf_data_cb net_buf_var_cb;
 					 _net_buf_##_name, _count, _ud_size,   \
 					 _destroy)
 
+/**
+ *
+ * @brief Define a new pool for variable size payloads, storing small
+ *        payloads inline.
+ *
+ * Same as NET_BUF_POOL_VAR_DEFINE(), but each buffer also reserves
+ * @p _inline_size bytes right after its user data. Allocations of up to
+ * that many bytes use this space instead of the memory pool, so small
+ * payloads such as TCP ACKs share the cache lines of the buffer header.
+ * Larger allocations fall back to the memory pool. This is transparent
+ * to the net_buf API users.
+ *
+ * @param _name        Name of the pool variable.
+ * @param _count       Number of buffers in the pool.
+ * @param _data_size   Total amount of memory available for data payloads
+ *                     not stored inline.
+ * @param _inline_size Maximum data payload stored inline per buffer.
+ * @param _ud_size     User data space to reserve per buffer.
+ * @param _destroy     Optional destroy callback when buffer is freed.
+ */
+#define NET_BUF_POOL_VAR_INLINE_DEFINE(_name, _count, _data_size, _inline_size, \
+				       _ud_size, _destroy)                      \
+	_NET_BUF_ARRAY_INLINE_DEFINE(_name, _count, _ud_size, _inline_size);    \
+	K_HEAP_DEFINE(net_buf_mem_pool_##_name, _data_size);                    \
+	static const struct net_buf_data_alloc net_buf_data_alloc_##_name = {   \
+		.cb = &net_buf_var_cb,                                          \
+		.alloc_data = &net_buf_mem_pool_##_name,                        \
+	};                                                                      \
+	static STRUCT_SECTION_ITERABLE(net_buf_pool, _name) =                   \
+		NET_BUF_POOL_INLINE_INITIALIZER(_name,                          \
+						&net_buf_data_alloc_##_name,    \
+						_net_buf_##_name, _count,       \
+						_ud_size, _inline_size,         \
+						_destroy)
+
 /**
  *
  * @brief Define a new pool for buffers
@@ -1453,6 +1538,31 @@ struct net_buf * __must_check net_buf_ref(struct net_buf *buf);
 struct net_buf * __must_check net_buf_clone(struct net_buf *buf,
 					    k_timeout_t timeout);
 
+/**
+ * @brief Clone buffer sharing its data
+ *
+ * Allocate a new buffer header from the pool of @p buf that references the
+ * data of @p buf instead of copying it, whatever the data allocator of the
+ * pool. The clone has its own data pointer, length and fragment chain, so
+ * it can be pulled, trimmed or chained independently of @p buf. The shared
+ * bytes, including the headroom and tailroom, must not be modified by
+ * either buffer. The data is freed when the last buffer referencing it is
+ * unreferenced.
+ *
+ * Data that cannot be shared, i.e. data stored inline or set with
+ * net_buf_alloc_with_data(), is copied as net_buf_clone() does.
+ *
+ * @param buf A valid pointer on a buffer
+ * @param timeout Affects the action taken should the pool be empty.
+ *        If K_NO_WAIT, then return immediately. If K_FOREVER, then
+ *        wait as long as necessary. Otherwise, wait until the specified
+ *        timeout.
+ *
+ * @return Cloned buffer or NULL if out of buffers.
+ */
+struct net_buf * __must_check net_buf_shared_clone(struct net_buf *buf,
+						   k_timeout_t timeout);
+
 /**
  * @brief Get a pointer to the user data of a buffer.
  *
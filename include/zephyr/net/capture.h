@@ -103,6 +103,8 @@ static inline int net_capture_cleanup(const struct device *dev)
  * @details This creates tunnel network interface where all the
  * captured packets are pushed. The captured network packets are
  * placed in UDP packets that are sent to tunnel peer.
+ * If CONFIG_NET_PKT_FILTER is enabled, only the packets accepted by
+ * the npf_capture_rules rule list are captured.
  *
  * @param dev Network capture device
  * @param iface Network interface we are starting to capture packets.
@@ -201,8 +203,17 @@ static inline int net_capture_send(const struct device *dev, struct net_if *ifac
  * @param iface Network interface the packet is being sent
  * @param pkt The network packet that is sent
  */
+#if defined(CONFIG_NET_CAPTURE_PCAPNG)
+void net_capture_pcapng_pkt(struct net_if *iface, struct net_pkt *pkt);
+#endif
+
 #if defined(CONFIG_NET_CAPTURE)
 void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt);
+#elif defined(CONFIG_NET_CAPTURE_PCAPNG)
+static inline void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt)
+{
+	net_capture_pcapng_pkt(iface, pkt);
+}
 #else
 static inline void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt)
 {
@@ -250,6 +261,120 @@ static inline void net_capture_foreach(net_capture_cb_t cb, void *user_data)
 
 /** @endcond */
 
+/**
+ * @brief Local pcap-ng capture statistics of a network interface
+ */
+struct net_capture_pcapng_stats {
+	/** Packets written to the capture ring */
+	uint32_t captured;
+	/** Packets not captured as the ring was full */
+	uint32_t dropped;
+};
+
+/**
+ * @brief Start capturing the packets of a network interface locally.
+ *
+ * @details The packets sent and received by the interface are written
+ * as pcap-ng records into the capture ring, which is read with
+ * net_capture_pcapng_get_claim() or net_capture_pcapng_read(). The ring
+ * starts with a section header, and every enabled interface gets an
+ * interface description record, so the data read from the ring is a
+ * valid pcap-ng stream.
+ *
+ * @param iface Network interface to capture.
+ *
+ * @return 0 if ok, -EALREADY if already captured, -ENOMEM if no more
+ *         interfaces can be captured or the ring is full.
+ */
+int net_capture_pcapng_enable(struct net_if *iface);
+
+/**
+ * @brief Stop capturing the packets of a network interface locally.
+ *
+ * @details An interface statistics record with the number of captured
+ * and dropped packets is written to the ring if there is room for it.
+ *
+ * @param iface Captured network interface.
+ *
+ * @return 0 if ok, -ENOENT if the interface is not captured.
+ */
+int net_capture_pcapng_disable(struct net_if *iface);
+
+/**
+ * @brief Set the number of bytes captured per packet.
+ *
+ * @details Applies to interfaces enabled after this call, as the value is
+ * recorded in their interface description.
+ *
+ * @param snaplen Maximum number of bytes captured from each packet.
+ */
+void net_capture_pcapng_set_snaplen(uint32_t snaplen);
+
+/**
+ * @brief Get the capture statistics of a network interface.
+ *
+ * @param iface Captured network interface.
+ * @param stats Statistics are returned here.
+ *
+ * @return 0 if ok, -ENOENT if the interface is not captured.
+ */
+int net_capture_pcapng_get_stats(struct net_if *iface,
+				 struct net_capture_pcapng_stats *stats);
+
+/**
+ * @brief Get direct access to the captured data in the ring.
+ *
+ * @details Only one reader may drain the ring at a time. The data stays
+ * valid until released with net_capture_pcapng_get_finish().
+ *
+ * @param data Pointer to the captured data is returned here.
+ * @param size Maximum number of bytes to claim.
+ *
+ * @return Number of contiguous bytes available at @p data.
+ */
+uint32_t net_capture_pcapng_get_claim(uint8_t **data, uint32_t size);
+
+/**
+ * @brief Release captured data claimed from the ring.
+ *
+ * @param size Number of bytes consumed.
+ *
+ * @return 0 if ok, -EINVAL if more than the claimed size is released.
+ */
+int net_capture_pcapng_get_finish(uint32_t size);
+
+/**
+ * @brief Copy captured data out of the ring.
+ *
+ * @param data Buffer receiving the data.
+ * @param len Size of @p data.
+ *
+ * @return Number of bytes copied.
+ */
+size_t net_capture_pcapng_read(uint8_t *data, size_t len);
+
+/**
+ * @brief Discard the captured data and start a new pcap-ng section.
+ *
+ * @details The ring is restarted with a section header and the interface
+ * descriptions of the enabled interfaces.
+ */
+void net_capture_pcapng_reset(void);
+
+#if defined(CONFIG_FILE_SYSTEM) || defined(__DOXYGEN__)
+/**
+ * @brief Append the captured data to a file.
+ *
+ * @details Drains the ring into the given file, which is created if it
+ * does not exist.
+ *
+ * @param path Path of the file.
+ *
+ * @return Number of bytes written, <0 on file system error.
+ */
+int net_capture_pcapng_write_file(const char *path);
+#endif
+
 /**
  * @}
  */
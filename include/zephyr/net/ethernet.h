@@ -119,7 +119,10 @@ enum ethernet_hw_caps {
 	/** TX Checksum offloading supported for all of IPv4, UDP, TCP */
 	ETHERNET_HW_TX_CHKSUM_OFFLOAD	= BIT(0),
 
-	/** RX Checksum offloading supported for all of IPv4, UDP, TCP */
+	/** RX Checksum offloading supported for all of IPv4, UDP, TCP.
+	 *  Devices validating only some packets mark those with
+	 *  net_pkt_set_l4_chksum_ok() instead.
+	 */
 	ETHERNET_HW_RX_CHKSUM_OFFLOAD	= BIT(1),
 
 	/** VLAN supported */
@@ -173,6 +176,12 @@ enum ethernet_hw_caps {
 
 	/** TXTIME supported */
 	ETHERNET_TXTIME			= BIT(19),
+
+	/** TCP segmentation offload (TSO) supported */
+	ETHERNET_HW_TSO			= BIT(20),
+
+	/** TCP large receive offload (LRO) supported */
+	ETHERNET_HW_LRO			= BIT(21),
 };
 
 /** @cond INTERNAL_HIDDEN */
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ * @brief HTTP/1.1 server API
+ *
+ * Serves the resources of the services defined with HTTP_SERVICE_DEFINE()
+ * and HTTP_RESOURCE_DEFINE().
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_
+#define ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_
+
+/**
+ * @brief HTTP server API
+ * @defgroup http_server HTTP server API
+ * @ingroup networking
+ * @{
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <zephyr/sys/util.h>
+#include <zephyr/net/http/method.h>
+#include <zephyr/net/http/service.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Bit of @p _method in a mask of supported HTTP methods */
+#define HTTP_METHOD_BIT(_method) BIT(_method)
+
+/** Type of an HTTP resource */
+enum http_resource_type {
+	/** Constant data, typically compiled into flash */
+	HTTP_RESOURCE_TYPE_STATIC,
+	/** Data generated by the application when requested */
+	HTTP_RESOURCE_TYPE_DYNAMIC,
+	/** File read with the file system API */
+	HTTP_RESOURCE_TYPE_FS,
+};
+
+/**
+ * @brief Common part of all HTTP resource details.
+ *
+ * The detail given to HTTP_RESOURCE_DEFINE() must point to one of the
+ * http_resource_detail_* structures, all of which start with this one.
+ */
+struct http_resource_detail {
+	/** Mask of HTTP_METHOD_BIT() of the supported methods. HEAD is
+	 *  implied by GET.
+	 */
+	uint32_t bitmask_of_supported_http_methods;
+
+	/** Type of the resource */
+	enum http_resource_type type;
+
+	/** Value of the Content-Type header, or NULL to omit it */
+	const char *content_type;
+
+	/** Value of the Content-Encoding header, e.g. "gzip" for
+	 *  pre-compressed data, or NULL to omit it
+	 */
+	const char *content_encoding;
+};
+
+/** Detail of a static resource */
+struct http_resource_detail_static {
+	/** Common resource detail */
+	struct http_resource_detail common;
+
+	/** Data of the resource, sent without being copied first */
+	const void *static_data;
+
+	/** Length of the data */
+	size_t static_data_len;
+};
+
+/** Request handed to the callback of a dynamic resource */
+struct http_server_request {
+	/** Request method */
+	enum http_method method;
+
+	/** Request target, including the query string if any */
+	const char *url;
+
+	/** Request body, if any */
+	const uint8_t *body;
+
+	/** Length of the request body */
+	size_t body_len;
+};
+
+/**
+ * @typedef http_resource_dynamic_cb_t
+ * @brief Callback producing the response body of a dynamic resource.
+ *
+ * The callback is called repeatedly until it returns 0, and each call is
+ * sent as one chunk of a chunked response. It runs in an HTTP server
+ * worker thread.
+ *
+ * @param req Request being served.
+ * @param offset Number of body bytes produced by the previous calls.
+ * @param buf Buffer to write the next part of the body to.
+ * @param len Size of @p buf.
+ * @param user_data User data given in the resource detail.
+ *
+ * @return Number of bytes written to @p buf, 0 at the end of the body,
+ *         or a negative error code. An error in the first call sends a
+ *         500 response, a later one aborts the connection.
+ */
+typedef int (*http_resource_dynamic_cb_t)(const struct http_server_request *req,
+					  size_t offset, uint8_t *buf, size_t len,
+					  void *user_data);
+
+/** Detail of a dynamic resource */
+struct http_resource_detail_dynamic {
+	/** Common resource detail */
+	struct http_resource_detail common;
+
+	/** Callback producing the response body */
+	http_resource_dynamic_cb_t cb;
+
+	/** User data passed to @ref cb */
+	void *user_data;
+};
+
+/** Detail of a file system resource */
+struct http_resource_detail_fs {
+	/** Common resource detail */
+	struct http_resource_detail common;
+
+	/** Absolute path of the file, e.g. "/lfs/index.html" */
+	const char *path;
+};
+
+/**
+ * @brief Start serving all the defined HTTP services.
+ *
+ * Creates a listening socket for each service and starts the worker
+ * threads. A service whose host is not an IP address listens on all
+ * addresses, and one with port 0 gets an ephemeral port, written back
+ * to its port variable.
+ *
+ * @return 0 on success, -EALREADY if already started, or another
+ *         negative error code.
+ */
+int http_server_start(void);
+
+/**
+ * @brief Stop serving HTTP services.
+ *
+ * Closes every client connection and listening socket, and waits for the
+ * worker threads to exit.
+ *
+ * @return 0 on success, -EALREADY if not started.
+ */
+int http_server_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_ */
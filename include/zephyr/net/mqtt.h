@@ -601,6 +601,28 @@ int mqtt_connect(struct mqtt_client *client);
 int mqtt_publish(struct mqtt_client *client,
 		 const struct mqtt_publish_param *param);
 
+/**
+ * @brief API to publish several messages with a single transport write.
+ *
+ * The headers of the messages are encoded one after the other into the
+ * client's TX buffer, and written together with the payloads, which are
+ * not copied. If the headers do not fit in the TX buffer, or there are
+ * more than @kconfig{CONFIG_MQTT_PUBLISH_BATCH_SIZE} messages, they are
+ * written in several batches.
+ *
+ * @param[in] client Client instance for which the procedure is requested.
+ *                   Shall not be NULL.
+ * @param[in] params Parameters of the messages to publish, in order.
+ *                   Shall not be NULL.
+ * @param[in] count Number of messages in @p params.
+ *
+ * @return 0 or a negative error code (errno.h) indicating reason of failure.
+ *         On failure, the messages before the failing one may have been
+ *         sent.
+ */
+int mqtt_publish_batch(struct mqtt_client *client,
+		       const struct mqtt_publish_param *params, size_t count);
+
 /**
  * @brief API used by client to send acknowledgment on receiving QoS1 publish
  *        message. Should be called on reception of @ref MQTT_EVT_PUBLISH with
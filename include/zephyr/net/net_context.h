@@ -188,6 +188,19 @@ typedef struct k_mem_slab *(*net_pkt_get_slab_func_t)(void);
  */
 typedef struct net_buf_pool *(*net_pkt_get_pool_func_t)(void);
 
+/**
+ * @typedef net_context_zerocopy_cb_t
+ *
+ * @brief Callback telling that the stack has released caller-owned data
+ * that was sent without copying.
+ *
+ * @param data Start of the released data.
+ * @param len Length of the released data.
+ * @param user_data The user data given to the context.
+ */
+typedef void (*net_context_zerocopy_cb_t)(const void *data, size_t len,
+					  void *user_data);
+
 struct net_tcp;
 
 struct net_conn_handle;
@@ -282,6 +295,14 @@ __net_socket struct net_context {
 		/** Mutex used by condition variable */
 		struct k_mutex *lock;
 	} cond;
+
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+	/** Called when data sent with ZSOCK_MSG_ZEROCOPY is released */
+	net_context_zerocopy_cb_t zerocopy_cb;
+
+	/** User data for zerocopy_cb */
+	void *zerocopy_user_data;
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY */
 #endif /* CONFIG_NET_SOCKETS */
 
 #if defined(CONFIG_NET_OFFLOAD)
@@ -847,7 +868,10 @@ int net_context_bind(struct net_context *context,
  * @details This is similar as BSD listen() function.
  *
  * @param context The context to use.
- * @param backlog The size of the pending connections backlog.
+ * @param backlog The size of the pending connections backlog. For TCP, a
+ *        connection is pending from its SYN until it is taken by the
+ *        application with net_context_set_accepting(ctx, false).
+ *        0 means no limit.
  *
  * @return 0 if ok, < 0 if error
  */
@@ -500,6 +500,27 @@ struct net_if_dev {
 	enum net_if_oper_state oper_state;
 };
 
+#if defined(CONFIG_NET_PKT_CACHE)
+/** @cond INTERNAL_HIDDEN */
+struct net_pkt;
+
+enum net_pkt_cache_class {
+	NET_PKT_CACHE_SMALL,
+	NET_PKT_CACHE_MTU,
+	NET_PKT_CACHE_CLASSES,
+};
+
+/* TX packets with their buffers already attached, see net_pkt.c */
+struct net_pkt_cache {
+	struct k_spinlock lock;
+	struct net_pkt *pkts[NET_PKT_CACHE_CLASSES][CONFIG_NET_PKT_CACHE_DEPTH];
+	/* Buffer length of the cached packets of each class */
+	uint16_t len[NET_PKT_CACHE_CLASSES];
+	uint8_t count[NET_PKT_CACHE_CLASSES];
+};
+/** @endcond */
+#endif /* CONFIG_NET_PKT_CACHE */
+
 /**
  * @brief Network Interface structure
  *
@@ -526,6 +547,11 @@ struct net_if {
 	 */
 	int tx_pending;
 #endif
+
+#if defined(CONFIG_NET_PKT_CACHE)
+	/** Pre-allocated TX packets, see CONFIG_NET_PKT_CACHE */
+	struct net_pkt_cache pkt_cache;
+#endif
 };
 
 /**
@@ -2110,6 +2136,27 @@ bool net_if_need_calc_rx_checksum(struct net_if *iface);
  */
 bool net_if_need_calc_tx_checksum(struct net_if *iface);
 
+/**
+ * @brief Check if large outgoing TCP packets need to be split into MSS sized
+ * segments by the IP stack, or if the network device can do the segmentation
+ * itself (TSO).
+ *
+ * @param iface Network interface
+ *
+ * @return True if segmentation needs to be done in software, false otherwise.
+ */
+bool net_if_need_tcp_segmentation(struct net_if *iface);
+
+/**
+ * @brief Check if consecutive received TCP segments should be coalesced by the
+ * IP stack, or if the network device does it already (LRO).
+ *
+ * @param iface Network interface
+ *
+ * @return True if coalescing needs to be done in software, false otherwise.
+ */
+bool net_if_need_tcp_coalescing(struct net_if *iface);
+
 /**
  * @brief Get interface according to index
  *
@@ -190,6 +190,11 @@ struct net_pkt {
 	uint8_t l2_processed : 1; /* Set to 1 if this packet has already been
 				   * processed by the L2
 				   */
+	uint8_t l4_chksum_ok : 1; /* Set to 1 if the L4 (TCP, UDP or ICMP)
+				   * checksum of this received packet has
+				   * already been verified, either by the
+				   * network device or earlier in the stack
+				   */
 
 	/* bitfield byte alignment boundary */
 
@@ -263,6 +268,21 @@ struct net_pkt {
 	uint16_t vlan_tci;
 #endif /* CONFIG_NET_VLAN */
 
+#if defined(CONFIG_NET_GSO)
+	/* Size of the TCP segments this packet is split into before it is
+	 * sent, or 0 if the packet is sent as is.
+	 */
+	uint16_t gso_size;
+#endif /* CONFIG_NET_GSO */
+
+#if defined(CONFIG_NET_TC_FLOW_STEERING)
+	/* Hash of the flow the packet belongs to, selecting the queue of
+	 * its traffic class. Drivers doing the hashing in hardware may set
+	 * it, 0 means that it is not computed yet.
+	 */
+	uint32_t flow_hash;
+#endif /* CONFIG_NET_TC_FLOW_STEERING */
+
 #if defined(NET_PKT_HAS_CONTROL_BLOCK)
 	/* TODO: Evolve this into a union of orthogonal
 	 *       control block declarations if further L2
@@ -392,6 +412,73 @@ static inline void net_pkt_set_l2_processed(struct net_pkt *pkt,
 	pkt->l2_processed = is_l2_processed;
 }
 
+static inline bool net_pkt_is_l4_chksum_ok(struct net_pkt *pkt)
+{
+	return !!(pkt->l4_chksum_ok);
+}
+
+/**
+ * @brief Mark the L4 checksum of a received packet as verified
+ *
+ * Network drivers whose hardware validates the checksum of only some of
+ * the received packets, and so cannot announce
+ * ETHERNET_HW_RX_CHKSUM_OFFLOAD, set this for each packet the hardware
+ * found valid before passing it to net_recv_data(). The stack then skips
+ * the software verification of the TCP, UDP and ICMP checksum of that
+ * packet. Packets with a bad checksum must be dropped by the driver or
+ * passed up without this flag.
+ *
+ * @param pkt Received network packet
+ * @param is_l4_chksum_ok True if the L4 checksum is known to be valid
+ */
+static inline void net_pkt_set_l4_chksum_ok(struct net_pkt *pkt,
+					    bool is_l4_chksum_ok)
+{
+	pkt->l4_chksum_ok = is_l4_chksum_ok;
+}
+
+static inline uint16_t net_pkt_gso_size(struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_GSO)
+	return pkt->gso_size;
+#else
+	ARG_UNUSED(pkt);
+
+	return 0;
+#endif
+}
+
+static inline void net_pkt_set_gso_size(struct net_pkt *pkt, uint16_t size)
+{
+#if defined(CONFIG_NET_GSO)
+	pkt->gso_size = size;
+#else
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(size);
+#endif
+}
+
+static inline uint32_t net_pkt_flow_hash(struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_TC_FLOW_STEERING)
+	return pkt->flow_hash;
+#else
+	ARG_UNUSED(pkt);
+
+	return 0;
+#endif
+}
+
+static inline void net_pkt_set_flow_hash(struct net_pkt *pkt, uint32_t hash)
+{
+#if defined(CONFIG_NET_TC_FLOW_STEERING)
+	pkt->flow_hash = hash;
+#else
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(hash);
+#endif
+}
+
 static inline uint8_t net_pkt_ip_hdr_len(struct net_pkt *pkt)
 {
 #if defined(CONFIG_NET_IP)
@@ -1251,6 +1338,7 @@ static inline bool net_pkt_is_being_overwritten(struct net_pkt *pkt)
 
 bool net_pkt_filter_send_ok(struct net_pkt *pkt);
 bool net_pkt_filter_recv_ok(struct net_pkt *pkt);
+bool net_pkt_filter_capture_ok(struct net_pkt *pkt);
 
 #else
 
@@ -1268,6 +1356,13 @@ static inline bool net_pkt_filter_recv_ok(struct net_pkt *pkt)
 	return true;
 }
 
+static inline bool net_pkt_filter_capture_ok(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return true;
+}
+
 #endif /* CONFIG_NET_PKT_FILTER */
 
 /* @endcond */
@@ -1960,6 +2055,10 @@ struct net_pkt *net_pkt_rx_clone(struct net_pkt *pkt, k_timeout_t timeout);
 /**
  * @brief Clone pkt and increase the refcount of its buffer.
  *
+ * The clone uses the very same net_buf fragments as the original, so any
+ * change to the fragments, including pulling or trimming data, is seen by
+ * both packets. Only the packet metadata is independent.
+ *
  * @param pkt Original pkt to be shallow cloned
  * @param timeout Timeout to wait for free packet
  *
@@ -1968,6 +2067,28 @@ struct net_pkt *net_pkt_rx_clone(struct net_pkt *pkt, k_timeout_t timeout);
 struct net_pkt *net_pkt_shallow_clone(struct net_pkt *pkt,
 				      k_timeout_t timeout);
 
+/**
+ * @brief Clone pkt sharing the data of its buffer.
+ *
+ * The clone gets its own net_buf fragments, allocated with
+ * net_buf_shared_clone(), which reference the data of the original
+ * fragments without copying it. Fragments can thus be added, removed or
+ * have their data start and length adjusted on either packet without
+ * affecting the other, but the shared data bytes must not be modified in
+ * place. Note that net_pkt_pull() moves data inside a fragment, so it
+ * modifies the shared data. Sending a packet to N interfaces this way
+ * costs N packets and fragment headers instead of N copies of the
+ * payload. Use net_pkt_clone() if the data needs to be modified. The
+ * clone is allocated from the same slab as @p pkt.
+ *
+ * @param pkt Original pkt to be cloned
+ * @param timeout Timeout to wait for free packet and fragments
+ *
+ * @return NULL if error, cloned packet otherwise.
+ */
+struct net_pkt *net_pkt_shared_clone(struct net_pkt *pkt,
+				     k_timeout_t timeout);
+
 /**
  * @brief Read some data from a net_pkt
  *
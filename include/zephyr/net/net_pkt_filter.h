@@ -16,6 +16,7 @@
 
 #include <limits.h>
 #include <stdbool.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/sys/slist.h>
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/ethernet.h>
@@ -57,16 +58,56 @@ extern struct npf_rule npf_default_ok;
 /** @brief Default rule list termination for rejecting a packet */
 extern struct npf_rule npf_default_drop;
 
-/** @brief rule set for a given test location */
+/** @cond INTERNAL_HIDDEN */
+
+/* Compiled form of a rule list, see base.c for the instruction set */
+struct npf_insn {
+	uint16_t jt;			/* forward jump if true */
+	uint16_t jf;			/* forward jump if false */
+	uint8_t op;
+	uint32_t k;
+	struct npf_test *test;
+};
+
+struct npf_prog {
+	atomic_t users;
+	uint16_t len;
+	struct npf_insn insns[CONFIG_NET_PKT_FILTER_PROG_LEN];
+};
+
+/** @endcond */
+
+/**
+ * @brief rule set for a given test location
+ *
+ * Every change to the rule list compiles it into a flat program which
+ * packets are then evaluated against without taking any lock. The
+ * program replaces the previous one atomically. Rule lists too long to
+ * fit in CONFIG_NET_PKT_FILTER_PROG_LEN instructions are evaluated rule
+ * by rule under the list lock instead.
+ *
+ * Interface, size and Ethernet type conditions are read when the list
+ * is compiled, so they must not be modified while their rule is in a
+ * list. Ethernet address sets are read at evaluation time.
+ */
 struct npf_rule_list {
 	sys_slist_t rule_head;
 	struct k_spinlock lock;
+	/** @cond INTERNAL_HIDDEN */
+	struct k_mutex prog_lock;
+	atomic_ptr_t prog;
+	struct npf_prog progs[2];
+	/** @endcond */
 };
 
 /** @brief  rule list applied to outgoing packets */
 extern struct npf_rule_list npf_send_rules;
 /** @brief rule list applied to incoming packets */
 extern struct npf_rule_list npf_recv_rules;
+#if defined(CONFIG_NET_CAPTURE) || defined(__DOXYGEN__)
+/** @brief rule list selecting the packets tunneled by network capture */
+extern struct npf_rule_list npf_capture_rules;
+#endif
 
 /**
  * @brief Insert a rule at the front of given rule list
@@ -110,6 +151,10 @@ bool npf_remove_all_rules(struct npf_rule_list *rules);
 #define npf_remove_recv_rule(rule) npf_remove_rule(&npf_recv_rules, rule)
 #define npf_remove_all_send_rules() npf_remove_all_rules(&npf_send_rules)
 #define npf_remove_all_recv_rules() npf_remove_all_rules(&npf_recv_rules)
+#define npf_insert_capture_rule(rule) npf_insert_rule(&npf_capture_rules, rule)
+#define npf_append_capture_rule(rule) npf_append_rule(&npf_capture_rules, rule)
+#define npf_remove_capture_rule(rule) npf_remove_rule(&npf_capture_rules, rule)
+#define npf_remove_all_capture_rules() npf_remove_all_rules(&npf_capture_rules)
 
 /**
  * @brief Statically define one packet filter rule
@@ -63,6 +63,10 @@ struct zsock_pollfd {
 #define ZSOCK_MSG_DONTWAIT 0x40
 /** zsock_recv: block until the full amount of data can be returned */
 #define ZSOCK_MSG_WAITALL 0x100
+/** zsock_send: Send caller-owned data without copying it, see
+ *  @ref zsock_set_zerocopy_cb
+ */
+#define ZSOCK_MSG_ZEROCOPY 0x4000000
 
 /* Well-known values, e.g. from Linux man 2 shutdown:
  * "The constants SHUT_RD, SHUT_WR, SHUT_RDWR have the value 0, 1, 2,
@@ -419,6 +423,52 @@ __syscall ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len,
 				 int flags, struct sockaddr *src_addr,
 				 socklen_t *addrlen);
 
+/**
+ * @brief Send multiple messages
+ *
+ * @details
+ * Sends the messages in @p msgvec as with @ref zsock_sendmsg, storing the
+ * number of bytes sent for each in its @c msg_len field. Sending stops at
+ * the first failing message.
+ * This function is also exposed as ``sendmmsg()``
+ * if :kconfig:option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ *
+ * @param sock Socket descriptor.
+ * @param msgvec Messages to send.
+ * @param vlen Number of messages in @p msgvec.
+ * @param flags Send flags, applied to every message.
+ *
+ * @return Number of messages sent, or -1 with errno set if none could be
+ *         sent.
+ */
+__syscall int zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+/**
+ * @brief Receive multiple datagrams
+ *
+ * @details
+ * Waits for a datagram like @ref zsock_recvfrom, and then receives it and
+ * any further already queued datagrams, up to @p vlen, into the scatter
+ * arrays of @p msgvec. The length of each datagram is stored in the
+ * @c msg_len field of its message, and ZSOCK_MSG_TRUNC is set in
+ * @c msg_flags if it did not fit. Unlike Linux recvmmsg(), there is no
+ * timeout argument; the socket receive timeout applies to the first
+ * datagram only. Ancillary data is not supported.
+ * This function is also exposed as ``recvmmsg()``
+ * if :kconfig:option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ *
+ * @param sock Socket descriptor.
+ * @param msgvec Messages to receive into.
+ * @param vlen Number of messages in @p msgvec.
+ * @param flags Receive flags. ZSOCK_MSG_PEEK is not supported.
+ *
+ * @return Number of datagrams received, or -1 with errno set if none
+ *         could be received.
+ */
+__syscall int zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
 /**
  * @brief Receive data from a connected peer
  *
@@ -437,6 +487,81 @@ static inline ssize_t zsock_recv(int sock, void *buf, size_t max_len,
 	return zsock_recvfrom(sock, buf, max_len, flags, NULL, NULL);
 }
 
+struct net_buf;
+
+/**
+ * @typedef zsock_zerocopy_cb_t
+ * @brief Called when the stack no longer references data sent with
+ *        @ref ZSOCK_MSG_ZEROCOPY.
+ *
+ * The callback runs in the context of whichever thread drops the last
+ * reference to the data (e.g. the TX thread or the TCP work queue), so it
+ * must not block.
+ *
+ * @param data Start of the released piece of caller data.
+ * @param len Length of the released piece of caller data.
+ * @param user_data User data given to @ref zsock_set_zerocopy_cb.
+ */
+typedef void (*zsock_zerocopy_cb_t)(const void *data, size_t len,
+				    void *user_data);
+
+/**
+ * @brief Enable zero-copy sends on a socket
+ *
+ * @details
+ * Data sent with the @ref ZSOCK_MSG_ZEROCOPY flag is not copied into
+ * network buffers. The caller must keep the data intact until @p cb reports
+ * it released, which happens once the data has been transmitted, or for
+ * TCP, acknowledged by the peer. Data larger than 64 KiB is reported in
+ * several pieces. If the send call fails, no callback is made and the data
+ * belongs to the caller again. The send fails with ENOBUFS when
+ * @kconfig{CONFIG_NET_SOCKETS_ZEROCOPY_TX_BUFS} pieces are already in flight.
+ *
+ * Only native TCP and UDP sockets support zero-copy. The function is not
+ * available to user mode threads.
+ *
+ * @param sock Socket descriptor.
+ * @param cb Release callback, NULL to disable zero-copy sends.
+ * @param user_data User data passed to @p cb.
+ *
+ * @return 0 on success, -1 with errno set otherwise.
+ */
+int zsock_set_zerocopy_cb(int sock, zsock_zerocopy_cb_t cb, void *user_data);
+
+/**
+ * @brief Receive data without copying it
+ *
+ * @details
+ * Waits for data like @ref zsock_recvfrom and hands the network buffers
+ * holding the next received packet (or, for stream sockets, the next
+ * received segment) over to the caller, who must give them back with
+ * @ref zsock_release_buf. For stream sockets the advertised receive window
+ * is reopened only when the buffers are released.
+ *
+ * Only @ref ZSOCK_MSG_DONTWAIT is supported in @p flags. Only native TCP
+ * and UDP sockets support zero-copy, and the function is not available to
+ * user mode threads.
+ *
+ * @param sock Socket descriptor.
+ * @param buf Set to the received fragment chain.
+ * @param flags Receive flags.
+ * @param src_addr Optional source address of a datagram.
+ * @param addrlen Length of @p src_addr, updated on return.
+ *
+ * @return Number of bytes in @p buf, 0 at end of stream, or -1 with errno
+ *         set otherwise.
+ */
+ssize_t zsock_recv_buf(int sock, struct net_buf **buf, int flags,
+		       struct sockaddr *src_addr, socklen_t *addrlen);
+
+/**
+ * @brief Release buffers received with @ref zsock_recv_buf
+ *
+ * @param sock Socket descriptor the buffers were received from.
+ * @param buf Fragment chain returned by @ref zsock_recv_buf.
+ */
+void zsock_release_buf(int sock, struct net_buf *buf);
+
 /**
  * @brief Control blocking/non-blocking mode of a socket
  *
@@ -778,6 +903,20 @@ static inline ssize_t sendmsg(int sock, const struct msghdr *message,
 	return zsock_sendmsg(sock, message, flags);
 }
 
+/** POSIX wrapper for @ref zsock_sendmmsg */
+static inline int sendmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+
+/** POSIX wrapper for @ref zsock_recvmmsg */
+static inline int recvmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_recvmmsg(sock, msgvec, vlen, flags);
+}
+
 /** POSIX wrapper for @ref zsock_recvfrom */
 static inline ssize_t recvfrom(int sock, void *buf, size_t max_len, int flags,
 			       struct sockaddr *src_addr, socklen_t *addrlen)
@@ -888,6 +1027,8 @@ static inline char *inet_ntop(sa_family_t family, const void *src, char *dst,
 #define MSG_DONTWAIT ZSOCK_MSG_DONTWAIT
 /** POSIX wrapper for @ref ZSOCK_MSG_WAITALL */
 #define MSG_WAITALL ZSOCK_MSG_WAITALL
+/** POSIX wrapper for @ref ZSOCK_MSG_ZEROCOPY */
+#define MSG_ZEROCOPY ZSOCK_MSG_ZEROCOPY
 
 /** POSIX wrapper for @ref ZSOCK_SHUT_RD */
 #define SHUT_RD ZSOCK_SHUT_RD
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_POSIX_SYS_EPOLL_H_
+#define ZEPHYR_INCLUDE_POSIX_SYS_EPOLL_H_
+
+#include <stdint.h>
+#include <zephyr/net/socket.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EPOLLIN      ZSOCK_POLLIN
+#define EPOLLOUT     ZSOCK_POLLOUT
+#define EPOLLERR     ZSOCK_POLLERR
+#define EPOLLHUP     ZSOCK_POLLHUP
+#define EPOLLONESHOT BIT(30)
+#define EPOLLET      BIT(31)
+
+#define EPOLL_CTL_ADD 1
+#define EPOLL_CTL_DEL 2
+#define EPOLL_CTL_MOD 3
+
+typedef union epoll_data {
+	void *ptr;
+	int fd;
+	uint32_t u32;
+	uint64_t u64;
+} epoll_data_t;
+
+struct epoll_event {
+	uint32_t events;
+	epoll_data_t data;
+};
+
+/**
+ * @brief Create an epoll instance
+ *
+ * An epoll instance watches the readiness of the file descriptors added to
+ * it with epoll_ctl(). Readiness is pushed to the instance by the objects
+ * behind the descriptors (sockets, socketpairs and eventfds), so
+ * epoll_wait() only looks at the descriptors that became ready rather than
+ * at all of them.
+ *
+ * @param size Ignored, must be positive.
+ *
+ * @return New epoll file descriptor on success, -1 on error
+ */
+int epoll_create(int size);
+
+/**
+ * @brief Create an epoll instance
+ *
+ * @param flags Must be 0.
+ *
+ * @return New epoll file descriptor on success, -1 on error
+ */
+int epoll_create1(int flags);
+
+/**
+ * @brief Add, modify or remove a descriptor watched by an epoll instance
+ *
+ * Descriptors are watched level-triggered unless EPOLLET is given. An
+ * edge-triggered descriptor is not checked again by epoll_wait() until a
+ * new readiness notification arrives for it. As the readiness of Zephyr
+ * objects is level based, re-arming a descriptor that is still ready also
+ * produces a notification, so applications should read until EAGAIN as
+ * usual with EPOLLET. EPOLLONESHOT disables the descriptor after one
+ * report until it is re-enabled with EPOLL_CTL_MOD.
+ *
+ * A descriptor must be removed from all epoll instances before it is
+ * closed.
+ *
+ * @note Must not be called from the system work queue.
+ *
+ * @param epfd epoll file descriptor
+ * @param op EPOLL_CTL_ADD, EPOLL_CTL_MOD or EPOLL_CTL_DEL
+ * @param fd Descriptor to watch
+ * @param event Events to watch for and the data to report them with
+ *
+ * @return 0 on success, -1 on error
+ */
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event);
+
+/**
+ * @brief Wait for events on an epoll instance
+ *
+ * @param epfd epoll file descriptor
+ * @param events Array receiving the ready descriptors
+ * @param maxevents Size of @p events
+ * @param timeout Timeout in milliseconds, -1 to wait forever
+ *
+ * @return Number of ready descriptors, 0 on timeout, -1 on error
+ */
+int epoll_wait(int epfd, struct epoll_event *events, int maxevents,
+	       int timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_POSIX_SYS_EPOLL_H_ */
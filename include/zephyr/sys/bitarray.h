@@ -26,12 +26,43 @@ struct sys_bitarray {
 	/* Bundle of bits */
 	uint32_t *bundles;
 
+	/* Summary of bundles, one bit per bundle, so that fully allocated
+	 * and fully free bundles can be skipped 32 at a time. The first half
+	 * marks bundles with all bits set, the second half marks bundles with
+	 * any bit set. Can be NULL.
+	 */
+	uint32_t *summary;
+
 	/* Spinlock guarding access to this bit array */
 	struct k_spinlock lock;
 };
 
 typedef struct sys_bitarray sys_bitarray_t;
 
+/**
+ * @brief Region of bits in a bitarray.
+ */
+struct sys_bitarray_region {
+	/** Offset to the start of the region */
+	size_t offset;
+
+	/** Number of bits in the region */
+	size_t num_bits;
+};
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+#define _SYS_BITARRAY_NUM_BUNDLES(total_bits)				\
+	((((total_bits + 8 - 1) / 8) + sizeof(uint32_t) - 1)		\
+	 / sizeof(uint32_t))
+
+#define _SYS_BITARRAY_NUM_SUMMARY(total_bits)				\
+	((_SYS_BITARRAY_NUM_BUNDLES(total_bits) + 32 - 1) / 32)
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
 /**
  * @brief Create a bitarray object.
  *
@@ -41,14 +72,14 @@ typedef struct sys_bitarray sys_bitarray_t;
  */
 #define _SYS_BITARRAY_DEFINE(name, total_bits, sba_mod)			\
 	sba_mod uint32_t _sys_bitarray_bundles_##name			\
-		[(((total_bits + 8 - 1) / 8) + sizeof(uint32_t) - 1)	\
-		 / sizeof(uint32_t)] = {0};				\
+		[_SYS_BITARRAY_NUM_BUNDLES(total_bits)] = {0};		\
+	sba_mod uint32_t _sys_bitarray_summary_##name			\
+		[2 * _SYS_BITARRAY_NUM_SUMMARY(total_bits)] = {0};	\
 	sba_mod sys_bitarray_t name = {					\
 		.num_bits = total_bits,					\
-		.num_bundles = (((total_bits + 8 - 1) / 8)		\
-				+ sizeof(uint32_t) - 1)			\
-			       / sizeof(uint32_t),			\
+		.num_bundles = _SYS_BITARRAY_NUM_BUNDLES(total_bits),	\
 		.bundles = _sys_bitarray_bundles_##name,		\
+		.summary = _sys_bitarray_summary_##name,		\
 	}
 
 /**
@@ -154,6 +185,30 @@ int sys_bitarray_test_and_clear_bit(sys_bitarray_t *bitarray, size_t bit, int *p
 int sys_bitarray_alloc(sys_bitarray_t *bitarray, size_t num_bits,
 		       size_t *offset);
 
+/**
+ * Allocate bits in a bit array, not necessarily contiguous
+ *
+ * This finds a number of bits (@p num_bits) in at most @p max_regions
+ * previously unallocated regions. A single contiguous region is preferred,
+ * otherwise free regions are taken from the start of the bit array. If
+ * enough bits are found, they are all marked as allocated in a single
+ * atomic operation and the regions are returned via @p regions.
+ *
+ * @param[in]  bitarray    Bitarray struct
+ * @param[in]  num_bits    Number of bits to allocate
+ * @param[in]  max_regions Number of elements in @p regions
+ * @param[out] regions     Array of allocated regions if successful
+ *
+ * @retval positive Number of regions used
+ * @retval -EINVAL  Invalid argument (e.g. allocating more bits than
+ *                  the bitarray has, trying to allocate 0 bits, etc.)
+ * @retval -ENOSPC  Not enough unallocated bits in at most @p max_regions
+ *                  regions
+ */
+int sys_bitarray_alloc_scatter(sys_bitarray_t *bitarray, size_t num_bits,
+			       size_t max_regions,
+			       struct sys_bitarray_region *regions);
+
 /**
  * Free bits in a bit array
  *
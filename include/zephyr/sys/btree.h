@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Cache-aware B+tree data structure
+ *
+ * This implements an ordered map from integer keys to pointer values
+ * with the same O(log(N)) guarantees as the red/black tree in
+ * @ref rbtree_apis, but laid out for targets with data caches.  Each
+ * node keeps its keys and its occupancy in one d-cache line
+ * (@kconfig{CONFIG_SYS_BTREE_CACHE_LINE_SIZE}), so a lookup touches one
+ * key line per tree level and the tree is a small fraction of the
+ * height of a binary tree holding the same elements.  All values
+ * live in the leaves, which are chained for in-order iteration.
+ *
+ * Unlike struct rbtree the tree is not intrusive: nodes come from a
+ * fixed pool of struct sys_btree_node provided at definition time,
+ * and there is no memory allocation at runtime.  Keys are unique.
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_BTREE_H_
+#define ZEPHYR_INCLUDE_SYS_BTREE_H_
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <zephyr/toolchain.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup btree_apis Cache-aware B+tree
+ * @ingroup datastructure_apis
+ * @{
+ */
+
+/** @brief B+tree key type */
+typedef uint64_t sys_btree_key_t;
+
+/**
+ * @brief Number of keys per node
+ *
+ * One d-cache line worth of keys, less one slot taken by the node header.
+ */
+#define SYS_BTREE_ORDER (CONFIG_SYS_BTREE_CACHE_LINE_SIZE / sizeof(sys_btree_key_t) - 1)
+
+/** @brief Maximum height of a tree, bounded by the minimum node fan-out */
+#define SYS_BTREE_MAX_DEPTH 32
+
+/**
+ * @brief B+tree node
+ *
+ * Treat as opaque. The header and the keys are placed first so that
+ * they share exactly one cache line: a lookup reads the node occupancy
+ * and scans the keys without touching a second line.
+ */
+struct sys_btree_node {
+	uint8_t count;
+	bool leaf;
+	sys_btree_key_t keys[SYS_BTREE_ORDER];
+	union {
+		/* Internal node: children[i] holds keys below keys[i] */
+		struct sys_btree_node *children[SYS_BTREE_ORDER + 1];
+		/* Leaf node */
+		struct {
+			void *values[SYS_BTREE_ORDER];
+			struct sys_btree_node *next;
+		};
+	};
+} __aligned(CONFIG_SYS_BTREE_CACHE_LINE_SIZE);
+
+/** @brief B+tree */
+struct sys_btree {
+	struct sys_btree_node *root;
+	/* Leftmost leaf, start of in-order iteration */
+	struct sys_btree_node *first;
+	struct sys_btree_node *pool;
+	struct sys_btree_node *free_list;
+	uint32_t pool_size;
+	uint32_t pool_used;
+	uint32_t size;
+	uint8_t height;
+};
+
+/**
+ * @brief In-order iterator
+ */
+struct sys_btree_iter {
+	struct sys_btree_node *node;
+	uint8_t idx;
+};
+
+/**
+ * @brief Worst case number of nodes needed to hold a number of elements
+ *
+ * Every node but the root is at least half full, which bounds the
+ * number of leaves and of internal nodes above them.
+ *
+ * @param n Number of elements
+ */
+#define SYS_BTREE_POOL_SIZE(n)							\
+	((n) / (SYS_BTREE_ORDER / 2) +						\
+	 (n) / ((SYS_BTREE_ORDER / 2) * ((SYS_BTREE_ORDER - 1) / 2)) +		\
+	 SYS_BTREE_MAX_DEPTH + 1)
+
+/**
+ * @brief Statically define and initialize a B+tree
+ *
+ * Use @ref SYS_BTREE_POOL_SIZE to size the node pool.
+ *
+ * @param name Name of the struct sys_btree
+ * @param num_nodes Number of nodes in the node pool
+ */
+#define SYS_BTREE_DEFINE(name, num_nodes)					\
+	static struct sys_btree_node _btree_pool_##name[num_nodes];		\
+	struct sys_btree name = {						\
+		.pool = _btree_pool_##name,					\
+		.pool_size = (num_nodes),					\
+	}
+
+/**
+ * @brief Initialize a B+tree
+ *
+ * @param tree Tree to initialize
+ * @param pool Node pool, must stay valid as long as the tree is used
+ * @param num_nodes Number of nodes in @p pool
+ */
+void sys_btree_init(struct sys_btree *tree, struct sys_btree_node *pool,
+		    size_t num_nodes);
+
+/**
+ * @brief Insert an element into the tree
+ *
+ * @param tree Tree
+ * @param key Key of the element
+ * @param value Value associated with @p key
+ *
+ * @retval 0 on success
+ * @retval -EEXIST if @p key is already in the tree
+ * @retval -ENOMEM if the node pool is exhausted
+ */
+int sys_btree_insert(struct sys_btree *tree, sys_btree_key_t key, void *value);
+
+/**
+ * @brief Remove an element from the tree
+ *
+ * @param tree Tree
+ * @param key Key of the element
+ * @param value Location to store the removed value, may be NULL
+ *
+ * @retval 0 on success
+ * @retval -ENOENT if @p key is not in the tree
+ */
+int sys_btree_remove(struct sys_btree *tree, sys_btree_key_t key, void **value);
+
+/**
+ * @brief Look up an element
+ *
+ * @param tree Tree
+ * @param key Key of the element
+ * @param value Location to store the value, may be NULL
+ *
+ * @retval 0 on success
+ * @retval -ENOENT if @p key is not in the tree
+ */
+int sys_btree_get(const struct sys_btree *tree, sys_btree_key_t key, void **value);
+
+/**
+ * @brief Returns true if the given key is part of the tree
+ */
+static inline bool sys_btree_contains(const struct sys_btree *tree, sys_btree_key_t key)
+{
+	return sys_btree_get(tree, key, NULL) == 0;
+}
+
+/**
+ * @brief Returns the lowest-sorted element of the tree
+ *
+ * @param tree Tree
+ * @param key Location to store the key, may be NULL
+ * @param value Location to store the value, may be NULL
+ *
+ * @retval 0 on success
+ * @retval -ENOENT if the tree is empty
+ */
+int sys_btree_get_min(const struct sys_btree *tree, sys_btree_key_t *key, void **value);
+
+/**
+ * @brief Returns the highest-sorted element of the tree
+ *
+ * @param tree Tree
+ * @param key Location to store the key, may be NULL
+ * @param value Location to store the value, may be NULL
+ *
+ * @retval 0 on success
+ * @retval -ENOENT if the tree is empty
+ */
+int sys_btree_get_max(const struct sys_btree *tree, sys_btree_key_t *key, void **value);
+
+/**
+ * @brief Returns the number of elements in the tree
+ */
+static inline size_t sys_btree_size(const struct sys_btree *tree)
+{
+	return tree->size;
+}
+
+/**
+ * @brief Returns true if the tree is empty
+ */
+static inline bool sys_btree_is_empty(const struct sys_btree *tree)
+{
+	return tree->size == 0;
+}
+
+/** @cond INTERNAL_HIDDEN */
+static inline void z_btree_iter_begin(const struct sys_btree *tree,
+				      struct sys_btree_iter *iter)
+{
+	iter->node = tree->first;
+	iter->idx = 0;
+}
+
+static inline void z_btree_iter_next(struct sys_btree_iter *iter)
+{
+	if (++iter->idx >= iter->node->count) {
+		iter->node = iter->node->next;
+		iter->idx = 0;
+	}
+}
+/** @endcond */
+
+/**
+ * @brief Key of the element an iterator points at
+ */
+static inline sys_btree_key_t sys_btree_iter_key(const struct sys_btree_iter *iter)
+{
+	return iter->node->keys[iter->idx];
+}
+
+/**
+ * @brief Value of the element an iterator points at
+ */
+static inline void *sys_btree_iter_value(const struct sys_btree_iter *iter)
+{
+	return iter->node->values[iter->idx];
+}
+
+/**
+ * @brief Walk a tree in-order
+ *
+ * Iteration follows the chain of leaves, so it neither recurses nor
+ * needs a stack.  As with RB_FOR_EACH(), the loop is not safe against
+ * modifications to the tree.
+ *
+ * @param tree A pointer to a struct sys_btree to walk
+ * @param iter The symbol name of a local struct sys_btree_iter variable
+ */
+#define SYS_BTREE_FOR_EACH(tree, iter)						\
+	for (z_btree_iter_begin(tree, &(iter)); (iter).node != NULL;		\
+	     z_btree_iter_next(&(iter)))
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_BTREE_H_ */
@@ -200,6 +200,15 @@ BUILD_ASSERT(Z_IS_POW2(CBPRINTF_PACKAGE_ALIGNMENT));
  */
 #define CBPRINTF_PACKAGE_ARGS_ARE_TAGGED BIT(6)
 
+/** @brief Indicate the package was created from a format descriptor.
+ *
+ * When set, the format string location in the package holds a pointer to a
+ * @ref cbprintf_fmt_desc instead of a pointer to the format string. The flag
+ * is set by @ref cbvprintf_package_fmt_desc and it is not meant to be passed
+ * by the user.
+ */
+#define CBPRINTF_PACKAGE_FMT_DESC BIT(7)
+
 /**@} */
 
 /**@defgroup CBPRINTF_PACKAGE_CONVERT_FLAGS Package flags.
@@ -257,6 +266,17 @@ BUILD_ASSERT(Z_IS_POW2(CBPRINTF_PACKAGE_ALIGNMENT));
  */
 #define CBPRINTF_PACKAGE_CONVERT_PTR_CHECK BIT(3)
 
+/** @brief Replace format descriptor with the format string.
+ *
+ * If package was created from a format descriptor (see
+ * @ref CBPRINTF_FMT_DESC_PACKAGE), the output package gets the pointer to the
+ * format string in place of the pointer to the descriptor, so that it is
+ * indistinguishable from a package created by @ref cbprintf_package. It is
+ * implied by @ref CBPRINTF_PACKAGE_CONVERT_RO_STR since format string is then
+ * appended to the package.
+ */
+#define CBPRINTF_PACKAGE_CONVERT_EXPAND_FMT_DESC BIT(4)
+
 /**@} */
 
 /**@defgroup Z_CBVPRINTF_PROCESS_FLAGS cbvprintf processing flags.
@@ -382,6 +402,64 @@ typedef int (*cbvprintf_external_formatter_func)(cbprintf_cb out, void *ctx,
 	Z_CBPRINTF_STATIC_PACKAGE(packaged, inlen, outlen, \
 				  align_offset, flags, __VA_ARGS__)
 
+/** @brief Format string with argument types resolved at compile time.
+ *
+ * Descriptor is created by @ref CBPRINTF_FMT_DESC_DEFINE and it is used by
+ * @ref cbvprintf_package_fmt_desc so that format string is not parsed when
+ * package is created.
+ */
+struct cbprintf_fmt_desc {
+	/** Format string. */
+	const char *fmt;
+
+	/** Types of arguments (see @ref cbprintf_package_arg_type), terminated
+	 * with @ref CBPRINTF_PACKAGE_ARG_TYPE_END.
+	 */
+	const uint8_t *types;
+};
+
+#if defined(CONFIG_CBPRINTF_PACKAGE_FMT_DESC) || defined(__DOXYGEN__)
+/** @brief Define a format descriptor.
+ *
+ * Types of arguments are determined at compile time by the type of provided
+ * arguments, the same way as for @ref CBPRINTF_STATIC_PACKAGE, thus the same
+ * limitation regarding (unsigned) char pointers used for %p applies.
+ * Arguments are not evaluated.
+ *
+ * @note Requires @kconfig{CONFIG_CBPRINTF_PACKAGE_FMT_DESC}.
+ *
+ * @param _name Name of the descriptor.
+ * @param ... Format string followed by arguments (or expressions of the same
+ * type as arguments).
+ */
+#define CBPRINTF_FMT_DESC_DEFINE(_name, ... /* fmt, ... */) \
+	Z_CBPRINTF_FMT_DESC_DEFINE(_name, __VA_ARGS__)
+
+/** @brief Package string using a format descriptor created at compile time.
+ *
+ * Descriptor of the format string is defined in place and the package is
+ * created by @ref cbprintf_package_fmt_desc. Format string is never parsed
+ * in the process. Format string must be constant.
+ *
+ * @note Requires @kconfig{CONFIG_CBPRINTF_PACKAGE_FMT_DESC}.
+ *
+ * @param packaged pointer to where the packaged data can be stored. Pass a null
+ * pointer to skip packaging but still calculate the total space required.
+ *
+ * @param len number of bytes available at @p packaged or alignment offset if
+ * @p packaged is null. See @ref cbprintf_package.
+ *
+ * @param outlen variable updated to the value returned by
+ * @ref cbprintf_package_fmt_desc.
+ *
+ * @param flags option flags. See @ref CBPRINTF_PACKAGE_FLAGS.
+ *
+ * @param ... formatted string with arguments.
+ */
+#define CBPRINTF_FMT_DESC_PACKAGE(packaged, len, outlen, flags, ... /* fmt, ... */) \
+	Z_CBPRINTF_FMT_DESC_PACKAGE(packaged, len, outlen, flags, __VA_ARGS__)
+#endif /* CONFIG_CBPRINTF_PACKAGE_FMT_DESC */
+
 /** @brief Capture state required to output formatted data later.
  *
  * Like cbprintf() but instead of processing the arguments and emitting the
@@ -469,6 +547,60 @@ int cbvprintf_package(void *packaged,
 		      const char *format,
 		      va_list ap);
 
+/** @brief Capture state using a format descriptor.
+ *
+ * Like cbvprintf_package() but types of arguments are taken from the
+ * descriptor instead of being determined by parsing the format string. The
+ * package contains pointer to the descriptor in place of the format string
+ * pointer. It can be formatted with cbpprintf() or converted to a regular
+ * package with @ref CBPRINTF_PACKAGE_CONVERT_EXPAND_FMT_DESC.
+ *
+ * @note Requires @kconfig{CONFIG_CBPRINTF_PACKAGE_FMT_DESC}.
+ *
+ * @param packaged pointer to where the packaged data can be stored. See
+ * @ref cbvprintf_package.
+ *
+ * @param len number of bytes available at @p packaged or alignment offset if
+ * @p packaged is null. See @ref cbprintf_package.
+ *
+ * @param flags option flags. See @ref CBPRINTF_PACKAGE_FLAGS.
+ *
+ * @param desc format descriptor.
+ *
+ * @param ap captured stack arguments of types given by @p desc.
+ *
+ * @retval nonegative the number of bytes successfully stored at @p packaged.
+ * This will not exceed @p len.
+ * @retval -EINVAL if @p desc contains an unknown type
+ * @retval -ENOSPC if @p packaged was not null and the space required to store
+ * exceed @p len.
+ */
+int cbvprintf_package_fmt_desc(void *packaged,
+			       size_t len,
+			       uint32_t flags,
+			       const struct cbprintf_fmt_desc *desc,
+			       va_list ap);
+
+/** @brief Capture state using a format descriptor.
+ *
+ * See @ref cbvprintf_package_fmt_desc.
+ *
+ * @note Requires @kconfig{CONFIG_CBPRINTF_PACKAGE_FMT_DESC}.
+ *
+ * @param packaged pointer to where the packaged data can be stored.
+ * @param len number of bytes available at @p packaged or alignment offset.
+ * @param flags option flags. See @ref CBPRINTF_PACKAGE_FLAGS.
+ * @param desc format descriptor.
+ * @param ... arguments of types given by @p desc.
+ *
+ * @return See @ref cbvprintf_package_fmt_desc.
+ */
+int cbprintf_package_fmt_desc(void *packaged,
+			      size_t len,
+			      uint32_t flags,
+			      const struct cbprintf_fmt_desc *desc,
+			      ...);
+
 /** @brief Convert a package.
  *
  * Converting may include appending strings used in the package to the package body.
@@ -665,6 +665,31 @@ do { \
 		    (CBPRINTF_PACKAGE_ARG_TYPE_END), \
 		    (Z_CBPRINTF_TAGGED_ARGS_2(__VA_ARGS__)))
 
+#ifdef CONFIG_CBPRINTF_PACKAGE_FMT_DESC
+/* Array of argument types terminated with CBPRINTF_PACKAGE_ARG_TYPE_END. */
+#define Z_CBPRINTF_FMT_DESC_TYPES(_num_args, ...) \
+	COND_CODE_0(_num_args, \
+		    (CBPRINTF_PACKAGE_ARG_TYPE_END), \
+		    (FOR_EACH(Z_CBPRINTF_ARG_TYPE, (,), __VA_ARGS__), \
+		     CBPRINTF_PACKAGE_ARG_TYPE_END))
+
+#define Z_CBPRINTF_FMT_DESC_DEFINE(_name, ...) \
+	static const uint8_t _name##_types[] = { \
+		Z_CBPRINTF_FMT_DESC_TYPES(NUM_VA_ARGS_LESS_1(__VA_ARGS__), \
+					  GET_ARGS_LESS_N(1, __VA_ARGS__)) \
+	}; \
+	static const struct cbprintf_fmt_desc _name = { \
+		GET_ARG_N(1, __VA_ARGS__), _name##_types \
+	}
+
+#define Z_CBPRINTF_FMT_DESC_PACKAGE(packaged, len, outlen, flags, ...) do { \
+	Z_CBPRINTF_FMT_DESC_DEFINE(_cbprintf_fmt_desc, __VA_ARGS__); \
+	outlen = cbprintf_package_fmt_desc(packaged, len, flags, &_cbprintf_fmt_desc \
+		COND_CODE_0(NUM_VA_ARGS_LESS_1(__VA_ARGS__), (), \
+			    (, GET_ARGS_LESS_N(1, __VA_ARGS__)))); \
+} while (false)
+#endif /* CONFIG_CBPRINTF_PACKAGE_FMT_DESC */
+
 #endif /* CONFIG_CBPRINTF_PACKAGE_SUPPORT_TAGGED_ARGUMENTS */
 
 #endif /* ZEPHYR_INCLUDE_SYS_CBPRINTF_INTERNAL_H_ */
@@ -194,14 +194,24 @@ struct sys_hashmap_api {
  * when moving from size 0 to size 1 such that the maximum @a load_factor
  * property is preserved.
  *
+ * The @a rehash_step selects how entries are moved when the Hashmap is
+ * resized. When zero, the insert or remove that triggers the resize moves
+ * every entry at once. Otherwise, the previous table is kept alongside the
+ * resized one, and each subsequent insert or remove moves the entries of at
+ * most @a rehash_step of its buckets. This bounds the worst-case latency of
+ * those operations at the cost of holding both tables in memory, and of
+ * lookups consulting both tables, until the migration completes.
+ *
  * @param max_size Maximum number of entries
  * @param load_factor Maximum load factor of expressed in hundredths
  * @param initial_n_buckets Initial number of buckets to allocate
+ * @param rehash_step Number of buckets migrated per operation, or 0
  */
 struct sys_hashmap_config {
 	size_t max_size;
 	uint8_t load_factor;
 	uint8_t initial_n_buckets;
+	uint16_t rehash_step;
 };
 
 /**
@@ -211,11 +221,15 @@ struct sys_hashmap_config {
  *
  * @param _max_size Maximum number of entries
  * @param _load_factor Maximum load factor of expressed in hundredths
+ * @param ... Optional number of buckets migrated per operation when resizing
+ *            incrementally (see @ref sys_hashmap_config). Defaults to 0, i.e.
+ *            all entries are migrated at once.
  */
-#define SYS_HASHMAP_CONFIG(_max_size, _load_factor)                                                \
+#define SYS_HASHMAP_CONFIG(_max_size, _load_factor, ...)                                           \
 	{                                                                                          \
 		.max_size = (size_t)_max_size, .load_factor = (uint8_t)_load_factor,               \
 		.initial_n_buckets = NHPOT(ceiling_fraction(100, _load_factor)),                   \
+		.rehash_step = COND_CODE_1(IS_EMPTY(__VA_ARGS__), (0), (__VA_ARGS__)),             \
 	}
 
 /**
@@ -28,6 +28,10 @@ struct sys_hashmap_oa_lp_data {
 	size_t n_buckets;
 	size_t size;
 	size_t n_tombstones;
+	/* table being drained while an incremental rehash is in progress */
+	void *old_buckets;
+	size_t old_n_buckets;
+	size_t rehash_pos;
 };
 
 /**
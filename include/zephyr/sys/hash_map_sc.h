@@ -26,6 +26,16 @@
 extern "C" {
 #endif
 
+struct sys_hashmap_sc_data {
+	void *buckets;
+	size_t n_buckets;
+	size_t size;
+	/* buckets being drained while an incremental rehash is in progress */
+	void *old_buckets;
+	size_t old_n_buckets;
+	size_t rehash_pos;
+};
+
 /**
  * @brief Declare a Separate Chaining Hashmap (advanced)
  *
@@ -41,7 +51,7 @@ extern "C" {
  */
 #define SYS_HASHMAP_SC_DEFINE_ADVANCED(_name, _hash_func, _alloc_func, ...)                        \
 	SYS_HASHMAP_DEFINE_ADVANCED(_name, &sys_hashmap_sc_api, sys_hashmap_config,                \
-				    sys_hashmap_data, _hash_func, _alloc_func, __VA_ARGS__)
+				    sys_hashmap_sc_data, _hash_func, _alloc_func, __VA_ARGS__)
 
 /**
  * @brief Declare a Separate Chaining Hashmap (advanced)
@@ -58,7 +68,7 @@ extern "C" {
  */
 #define SYS_HASHMAP_SC_DEFINE_STATIC_ADVANCED(_name, _hash_func, _alloc_func, ...)                 \
 	SYS_HASHMAP_DEFINE_STATIC_ADVANCED(_name, &sys_hashmap_sc_api, sys_hashmap_config,         \
-					   sys_hashmap_data, _hash_func, _alloc_func, __VA_ARGS__)
+					   sys_hashmap_sc_data, _hash_func, _alloc_func, __VA_ARGS__)
 
 /**
  * @brief Declare a Separate Chaining Hashmap statically
@@ -78,6 +78,17 @@ typedef struct sys_multi_mem_blocks sys_multi_mem_blocks_t;
 typedef sys_mem_blocks_t *(*sys_multi_mem_blocks_choice_fn_t)
 	(struct sys_multi_mem_blocks *group, void *cfg);
 
+/**
+ * @brief Region of contiguous memory blocks
+ */
+struct sys_mem_blocks_region {
+	/** Address of the first memory block in the region */
+	void *block;
+
+	/** Number of memory blocks in the region */
+	size_t count;
+};
+
 /**
  * @cond INTERNAL_HIDDEN
  */
@@ -295,6 +306,46 @@ int sys_mem_blocks_free(sys_mem_blocks_t *mem_block, size_t count,
  */
 int sys_mem_blocks_free_contiguous(sys_mem_blocks_t *mem_block, void *block, size_t count);
 
+/**
+ * @brief Allocate multiple memory blocks as a scatter list
+ *
+ * Allocate @p count memory blocks as at most @p max_regions regions of
+ * contiguous memory blocks. A single region is used if possible. All
+ * blocks are searched for and allocated in a single pass, so this is
+ * much faster than sys_mem_blocks_alloc() when many blocks are needed.
+ *
+ * @param[in]  mem_block   Pointer to memory block object.
+ * @param[in]  count       Number of blocks to allocate.
+ * @param[in]  max_regions Number of elements in @p out_regions.
+ * @param[out] out_regions Output array to be populated by the allocated
+ *                         regions.
+ *
+ * @retval positive Number of regions populated in @p out_regions.
+ * @retval 0        Nothing to allocate (@p count is 0).
+ * @retval -EINVAL  Invalid argument supplied.
+ * @retval -ENOMEM  Not enough blocks in at most @p max_regions regions.
+ */
+int sys_mem_blocks_alloc_scatter(sys_mem_blocks_t *mem_block, size_t count,
+				 size_t max_regions,
+				 struct sys_mem_blocks_region *out_regions);
+
+/**
+ * @brief Free memory blocks allocated as a scatter list
+ *
+ * Free regions of contiguous memory blocks, as returned by
+ * sys_mem_blocks_alloc_scatter(). Nothing is freed if any region lies
+ * outside of the memory blocks buffer.
+ *
+ * @param[in] mem_block   Pointer to memory block object.
+ * @param[in] num_regions Number of regions to free.
+ * @param[in] in_regions  Input array of regions.
+ *
+ * @retval 0       Successful
+ * @retval -EFAULT Invalid region supplied.
+ */
+int sys_mem_blocks_free_scatter(sys_mem_blocks_t *mem_block, size_t num_regions,
+				struct sys_mem_blocks_region *in_regions);
+
 #ifdef CONFIG_SYS_MEM_BLOCKS_RUNTIME_STATS
 /**
  * @brief Get the runtime statistics of a memory block
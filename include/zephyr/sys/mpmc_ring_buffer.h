@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/** @file */
+
+#ifndef ZEPHYR_INCLUDE_SYS_MPMC_RING_BUFFER_H_
+#define ZEPHYR_INCLUDE_SYS_MPMC_RING_BUFFER_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+#include <errno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Slot descriptor of a multi-producer, multi-consumer ring buffer.
+ *
+ * The sequence number is stored relative to the slot index so that a zero
+ * initialized slot array is a valid empty ring buffer.
+ */
+struct mpmc_ring_buf_slot {
+	atomic_t seq;
+	uint32_t len;
+	uint16_t type;
+	uint8_t value;
+};
+
+/**
+ * @brief A structure to represent a multi-producer, multi-consumer ring buffer
+ */
+struct mpmc_ring_buf {
+	uint8_t *buffer;
+	struct mpmc_ring_buf_slot *slots;
+	atomic_t put_pos;
+	atomic_t get_pos;
+	uint32_t slot_size;
+	uint32_t slot_mask;
+};
+
+/**
+ * @defgroup mpmc_ring_buffer_apis Multi-producer, multi-consumer Ring Buffer APIs
+ * @ingroup datastructure_apis
+ * @{
+ */
+
+/**
+ * @brief Define and initialize a multi-producer, multi-consumer ring buffer.
+ *
+ * The ring buffer is made of @p count slots of @p size8 bytes each.
+ * Every put operation stores exactly one record in one slot.
+ *
+ * The ring buffer can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct mpmc_ring_buf <name>; @endcode
+ *
+ * @param name  Name of the ring buffer.
+ * @param size8 Size of a slot (in bytes), must be a multiple of 4.
+ * @param count Number of slots, must be a power of 2.
+ */
+#define MPMC_RING_BUF_DECLARE(name, size8, count) \
+	BUILD_ASSERT(IS_POWER_OF_TWO(count), \
+		     "Slot count must be a power of 2"); \
+	BUILD_ASSERT(((size8) > 0) && (((size8) % 4) == 0), \
+		     "Slot size must be a non-zero multiple of 4"); \
+	static uint8_t __noinit __aligned(4) \
+		_mpmc_ring_buf_data_##name[(size8) * (count)]; \
+	static struct mpmc_ring_buf_slot _mpmc_ring_buf_slots_##name[count]; \
+	struct mpmc_ring_buf name = { \
+		.buffer = _mpmc_ring_buf_data_##name, \
+		.slots = _mpmc_ring_buf_slots_##name, \
+		.slot_size = (size8), \
+		.slot_mask = (count) - 1 \
+	}
+
+/**
+ * @brief Function to force mpmc_ring_buf internal states to given value
+ *
+ * Any value other than 0 makes sense only in validation testing context.
+ * Must not be called while the ring buffer is in use.
+ */
+static inline void mpmc_ring_buf_internal_reset(struct mpmc_ring_buf *buf,
+						atomic_val_t value)
+{
+	for (uint32_t idx = 0; idx <= buf->slot_mask; idx++) {
+		/* Position which will be put to this slot next. */
+		unsigned long pos = (unsigned long)value +
+			((idx - (unsigned long)value) & buf->slot_mask);
+
+		atomic_set(&buf->slots[idx].seq, (atomic_val_t)(pos - idx));
+	}
+
+	atomic_set(&buf->put_pos, value);
+	atomic_set(&buf->get_pos, value);
+}
+
+/**
+ * @brief Initialize a multi-producer, multi-consumer ring buffer.
+ *
+ * This routine initializes a ring buffer, prior to its first use. It is only
+ * used for ring buffers not defined using MPMC_RING_BUF_DECLARE.
+ *
+ * @param buf        Address of ring buffer.
+ * @param slot_size  Size of a slot (in bytes), must be a multiple of 4.
+ * @param slot_count Number of slots, must be a power of 2.
+ * @param data       Ring buffer data area (uint32_t data[slot_size * slot_count / 4]).
+ * @param slots      Slot descriptors (struct mpmc_ring_buf_slot slots[slot_count]).
+ */
+static inline void mpmc_ring_buf_init(struct mpmc_ring_buf *buf,
+				      uint32_t slot_size,
+				      uint32_t slot_count,
+				      uint32_t *data,
+				      struct mpmc_ring_buf_slot *slots)
+{
+	__ASSERT(is_power_of_two(slot_count), "Slot count must be a power of 2");
+	__ASSERT((slot_size > 0) && ((slot_size % 4) == 0),
+		 "Slot size must be a non-zero multiple of 4");
+
+	buf->buffer = (uint8_t *)data;
+	buf->slots = slots;
+	buf->slot_size = slot_size;
+	buf->slot_mask = slot_count - 1;
+	mpmc_ring_buf_internal_reset(buf, 0);
+}
+
+/**
+ * @brief Return the number of slots of a ring buffer.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return Ring buffer capacity (in records).
+ */
+static inline uint32_t mpmc_ring_buf_capacity_get(struct mpmc_ring_buf *buf)
+{
+	return buf->slot_mask + 1;
+}
+
+/**
+ * @brief Return the maximum size of a single record.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return Slot size (in bytes).
+ */
+static inline uint32_t mpmc_ring_buf_slot_size_get(struct mpmc_ring_buf *buf)
+{
+	return buf->slot_size;
+}
+
+/**
+ * @brief Determine number of records in a ring buffer.
+ *
+ * The value includes records which are claimed but not yet finished by a
+ * producer or a consumer. When the ring buffer is used concurrently the
+ * result is only a snapshot.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return Number of used slots.
+ */
+static inline uint32_t mpmc_ring_buf_size_get(struct mpmc_ring_buf *buf)
+{
+	unsigned long put_pos = (unsigned long)atomic_get(&buf->put_pos);
+	unsigned long get_pos = (unsigned long)atomic_get(&buf->get_pos);
+	unsigned long used = put_pos - get_pos;
+
+	/* Positions are read non-atomically with respect to each other. */
+	return (uint32_t)MIN(used, (unsigned long)buf->slot_mask + 1);
+}
+
+/**
+ * @brief Determine if a ring buffer is empty.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return true if the ring buffer is empty, or false if not.
+ */
+static inline bool mpmc_ring_buf_is_empty(struct mpmc_ring_buf *buf)
+{
+	return mpmc_ring_buf_size_get(buf) == 0;
+}
+
+/**
+ * @brief Allocate a slot for writing a record to a ring buffer.
+ *
+ * Unlike @ref ring_buf_put_claim, any number of producers can claim slots
+ * concurrently (including from interrupt context and from other CPUs)
+ * without additional locking. Each claim reserves one whole slot which must
+ * be committed using @ref mpmc_ring_buf_put_finish. Records are delivered to
+ * consumers in claim order, so a producer which does not finish its claim
+ * blocks consumption of later records.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Pointer to the address. It is set to the beginning of the
+ *		    claimed slot.
+ * @param[in]  size Requested allocation size (in bytes).
+ *
+ * @return Size of allocated buffer which is limited to the slot size or 0 if
+ *	   there is no free slot.
+ */
+uint32_t mpmc_ring_buf_put_claim(struct mpmc_ring_buf *buf,
+				 uint8_t **data,
+				 uint32_t size);
+
+/**
+ * @brief Commit a slot allocated by @ref mpmc_ring_buf_put_claim.
+ *
+ * The record becomes visible to consumers. If @a size is 0 the slot is
+ * released and consumers skip it.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Address returned by @ref mpmc_ring_buf_put_claim.
+ * @param size Number of valid bytes in the slot.
+ *
+ * @retval 0 Successful operation.
+ * @retval -EINVAL Provided @a size exceeds claimed size.
+ */
+int mpmc_ring_buf_put_finish(struct mpmc_ring_buf *buf, uint8_t *data,
+			     uint32_t size);
+
+/**
+ * @brief Write (copy) a record to a ring buffer.
+ *
+ * @param buf Address of ring buffer.
+ * @param data Address of data.
+ * @param size Data size (in bytes).
+ *
+ * @retval Number of bytes written. It is limited to the slot size and it is 0
+ *	   if the ring buffer is full.
+ */
+uint32_t mpmc_ring_buf_put(struct mpmc_ring_buf *buf, const uint8_t *data,
+			   uint32_t size);
+
+/**
+ * @brief Get address of the oldest record in a ring buffer.
+ *
+ * Any number of consumers can claim records concurrently. Each claim takes
+ * ownership of one whole record which must be released using
+ * @ref mpmc_ring_buf_get_finish.
+ *
+ * @param[in]  buf  Address of ring buffer.
+ * @param[out] data Pointer to the address. It is set to the beginning of the
+ *		    record.
+ * @param[in]  size Requested size (in bytes).
+ *
+ * @return Number of valid bytes in the record limited to @a size or 0 if the
+ *	   ring buffer is empty.
+ */
+uint32_t mpmc_ring_buf_get_claim(struct mpmc_ring_buf *buf,
+				 uint8_t **data,
+				 uint32_t size);
+
+/**
+ * @brief Release a record claimed by @ref mpmc_ring_buf_get_claim.
+ *
+ * The slot is always released as a whole. Bytes of the record which were
+ * not processed are dropped.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Address returned by @ref mpmc_ring_buf_get_claim.
+ * @param size Number of processed bytes.
+ *
+ * @retval 0 Successful operation.
+ * @retval -EINVAL Provided @a size exceeds record length.
+ */
+int mpmc_ring_buf_get_finish(struct mpmc_ring_buf *buf, uint8_t *data,
+			     uint32_t size);
+
+/**
+ * @brief Read a record from a ring buffer.
+ *
+ * @param buf  Address of ring buffer.
+ * @param data Address of the output buffer. Can be NULL to discard data.
+ * @param size Output buffer size (in bytes). Part of the record which does
+ *	       not fit is dropped.
+ *
+ * @retval Number of bytes written to the output buffer.
+ */
+uint32_t mpmc_ring_buf_get(struct mpmc_ring_buf *buf, uint8_t *data,
+			   uint32_t size);
+
+/**
+ * @brief Write a data item to a ring buffer.
+ *
+ * The data item is an array of 32-bit words (up to the slot size), coupled
+ * with a 16-bit type identifier and an 8-bit integer value.
+ *
+ * @param buf Address of ring buffer.
+ * @param type Data item's type identifier (application specific).
+ * @param value Data item's integer value (application specific).
+ * @param data Address of data item.
+ * @param size32 Data item size (number of 32-bit words).
+ *
+ * @retval 0 Data item was written.
+ * @retval -EMSGSIZE Ring buffer is full or item does not fit in a slot.
+ */
+int mpmc_ring_buf_item_put(struct mpmc_ring_buf *buf, uint16_t type,
+			   uint8_t value, uint32_t *data, uint8_t size32);
+
+/**
+ * @brief Read a data item from a ring buffer.
+ *
+ * @param buf Address of ring buffer.
+ * @param type Area to store the data item's type identifier.
+ * @param value Area to store the data item's integer value.
+ * @param data Area to store the data item. Can be NULL to discard data.
+ * @param size32 Size of the data item storage area (number of 32-bit chunks).
+ *
+ * @retval 0 Data item was fetched; @a size32 now contains the number of
+ *         32-bit words read into data area @a data.
+ * @retval -EAGAIN Ring buffer is empty.
+ * @retval -EMSGSIZE Data area @a data is too small; @a size32 now contains
+ *         the number of 32-bit words needed. The item is left in the ring
+ *         buffer.
+ */
+int mpmc_ring_buf_item_get(struct mpmc_ring_buf *buf, uint16_t *type,
+			   uint8_t *value, uint32_t *data, uint8_t *size32);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_MPMC_RING_BUFFER_H_ */
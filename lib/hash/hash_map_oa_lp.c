@@ -34,13 +34,13 @@ BUILD_ASSERT(offsetof(struct sys_hashmap_oa_lp_data, n_buckets) ==
 BUILD_ASSERT(offsetof(struct sys_hashmap_oa_lp_data, size) ==
 	     offsetof(struct sys_hashmap_data, size));
 
-static struct oalp_entry *sys_hashmap_oa_lp_find(const struct sys_hashmap *map, uint64_t key,
-						 bool used_ok, bool unused_ok, bool tombstone_ok)
+static struct oalp_entry *sys_hashmap_oa_lp_find_in(const struct sys_hashmap *map,
+						    struct oalp_entry *const buckets,
+						    const size_t n_buckets, uint64_t key, bool used_ok,
+						    bool unused_ok, bool tombstone_ok)
 {
 	struct oalp_entry *entry = NULL;
-	const size_t n_buckets = map->data->n_buckets;
 	uint32_t hash = map->hash_func(&key, sizeof(key));
-	struct oalp_entry *const buckets = map->data->buckets;
 
 	for (size_t i = 0, j = hash; i < n_buckets; ++i, ++j) {
 		j &= (n_buckets - 1);
@@ -73,46 +73,93 @@ static struct oalp_entry *sys_hashmap_oa_lp_find(const struct sys_hashmap *map,
 	return NULL;
 }
 
-static int sys_hashmap_oa_lp_insert_no_rehash(struct sys_hashmap *map, uint64_t key, uint64_t value,
-					      uint64_t *old_value)
+static struct oalp_entry *sys_hashmap_oa_lp_find(const struct sys_hashmap *map, uint64_t key,
+						 bool used_ok, bool unused_ok, bool tombstone_ok)
+{
+	return sys_hashmap_oa_lp_find_in(map, map->data->buckets, map->data->n_buckets, key,
+					 used_ok, unused_ok, tombstone_ok);
+}
+
+/*
+ * Find the entry holding @p key in the current table or, failing that, in the
+ * table being drained by an incremental rehash.
+ */
+static struct oalp_entry *sys_hashmap_oa_lp_lookup(const struct sys_hashmap *map, uint64_t key)
+{
+	struct oalp_entry *entry;
+	struct sys_hashmap_oa_lp_data *data = (struct sys_hashmap_oa_lp_data *)map->data;
+
+	entry = sys_hashmap_oa_lp_find(map, key, true, true, false);
+	if (entry != NULL && entry->state == USED) {
+		return entry;
+	}
+
+	if (data->old_buckets == NULL) {
+		return NULL;
+	}
+
+	entry = sys_hashmap_oa_lp_find_in(map, data->old_buckets, data->old_n_buckets, key, true,
+					  true, false);
+	if (entry != NULL && entry->state == USED) {
+		return entry;
+	}
+
+	return NULL;
+}
+
+/* Place an entry whose key is not in the Hashmap into the current table */
+static void sys_hashmap_oa_lp_place(struct sys_hashmap *map, uint64_t key, uint64_t value)
 {
-	int ret;
 	struct oalp_entry *entry = NULL;
 	struct sys_hashmap_oa_lp_data *data = (struct sys_hashmap_oa_lp_data *)map->data;
 
-	entry = sys_hashmap_oa_lp_find(map, key, true, true, true);
+	entry = sys_hashmap_oa_lp_find(map, key, false, true, true);
 	__ASSERT_NO_MSG(entry != NULL);
 
-	switch (entry->state) {
-	case UNUSED:
-		++data->size;
-		ret = 1;
-		break;
-	case TOMBSTONE:
+	if (entry->state == TOMBSTONE) {
 		--data->n_tombstones;
-		++data->size;
-		ret = 0;
-		break;
-	case USED:
-	default:
-		ret = 0;
-		break;
-	}
-
-	if (old_value != NULL) {
-		*old_value = entry->value;
 	}
 
 	entry->state = USED;
 	entry->key = key;
 	entry->value = value;
+}
+
+/*
+ * Move the entries of up to @p n_steps buckets from the table being drained
+ * to the current one, and release the former once it is empty.
+ */
+static void sys_hashmap_oa_lp_rehash_step(struct sys_hashmap *map, size_t n_steps)
+{
+	struct oalp_entry *entry;
+	struct sys_hashmap_oa_lp_data *data = (struct sys_hashmap_oa_lp_data *)map->data;
+	struct oalp_entry *const old_buckets = data->old_buckets;
+
+	if (old_buckets == NULL) {
+		return;
+	}
+
+	for (; n_steps > 0 && data->rehash_pos < data->old_n_buckets;
+	     --n_steps, ++data->rehash_pos) {
+		entry = &old_buckets[data->rehash_pos];
+
+		if (entry->state == USED) {
+			sys_hashmap_oa_lp_place(map, entry->key, entry->value);
+			/* keep probe sequences through the old table intact */
+			entry->state = TOMBSTONE;
+		}
+	}
 
-	return ret;
+	if (data->rehash_pos == data->old_n_buckets) {
+		map->alloc_func(old_buckets, 0);
+		data->old_buckets = NULL;
+		data->old_n_buckets = 0;
+		data->rehash_pos = 0;
+	}
 }
 
 static int sys_hashmap_oa_lp_rehash(struct sys_hashmap *map, bool grow)
 {
-	size_t old_size;
 	size_t old_n_buckets;
 	size_t new_n_buckets = 0;
 	struct oalp_entry *entry;
@@ -128,62 +175,101 @@ static int sys_hashmap_oa_lp_rehash(struct sys_hashmap *map, bool grow)
 		return -ENOSPC;
 	}
 
+	if (data->old_buckets != NULL) {
+		if (!grow && data->size != 0) {
+			/* shrinking can wait until the current migration completes */
+			return 0;
+		}
+
+		/* only one table is ever drained at a time */
+		sys_hashmap_oa_lp_rehash_step(map, SIZE_MAX);
+	}
+
 	/* extract all entries from the hashmap */
-	old_size = data->size;
 	old_n_buckets = data->n_buckets;
 	old_buckets = (struct oalp_entry *)data->buckets;
 
-	new_buckets = (struct oalp_entry *)map->alloc_func(NULL, new_n_buckets * sizeof(*entry));
-	if (new_buckets == NULL && new_n_buckets != 0) {
-		return -ENOMEM;
-	}
+	new_buckets = NULL;
+	if (new_n_buckets != 0) {
+		new_buckets = (struct oalp_entry *)map->alloc_func(NULL,
+								   new_n_buckets * sizeof(*entry));
+		if (new_buckets == NULL) {
+			return -ENOMEM;
+		}
 
-	if (new_buckets != NULL) {
 		/* ensure all buckets are empty / initialized */
 		memset(new_buckets, 0, new_n_buckets * sizeof(*new_buckets));
 	}
 
-	data->size = 0;
+	data->n_tombstones = 0;
 	data->buckets = new_buckets;
 	data->n_buckets = new_n_buckets;
 
+	if (map->config->rehash_step != 0 && old_buckets != NULL && new_buckets != NULL) {
+		/* entries are moved over by subsequent inserts and removals */
+		data->old_buckets = old_buckets;
+		data->old_n_buckets = old_n_buckets;
+		data->rehash_pos = 0;
+
+		return 0;
+	}
+
 	/* re-insert all entries into the hashmap */
-	for (size_t i = 0, j = 0; i < old_n_buckets && j < old_size; ++i) {
+	for (size_t i = 0, j = 0; i < old_n_buckets && j < data->size; ++i) {
 		entry = &old_buckets[i];
 
 		if (entry->state == USED) {
-			sys_hashmap_oa_lp_insert_no_rehash(map, entry->key, entry->value, NULL);
+			sys_hashmap_oa_lp_place(map, entry->key, entry->value);
 			++j;
 		}
 	}
 
 	/* free the old Hashmap */
-	map->alloc_func(old_buckets, 0);
+	if (old_buckets != NULL) {
+		map->alloc_func(old_buckets, 0);
+	}
 
 	return 0;
 }
 
+/*
+ * Buckets of the table being drained, if any, are indexed before those of
+ * the current table.
+ */
+static struct oalp_entry *sys_hashmap_oa_lp_bucket(const struct sys_hashmap *map, size_t i)
+{
+	struct sys_hashmap_oa_lp_data *data = (struct sys_hashmap_oa_lp_data *)map->data;
+
+	if (i < data->old_n_buckets) {
+		return &((struct oalp_entry *)data->old_buckets)[i];
+	}
+
+	return &((struct oalp_entry *)data->buckets)[i - data->old_n_buckets];
+}
+
 static void sys_hashmap_oa_lp_iter_next(struct sys_hashmap_iterator *it)
 {
 	size_t i;
 	struct oalp_entry *entry;
 	const struct sys_hashmap *map = (const struct sys_hashmap *)it->map;
-	struct oalp_entry *buckets = map->data->buckets;
+	struct sys_hashmap_oa_lp_data *data = (struct sys_hashmap_oa_lp_data *)map->data;
+	const size_t n_buckets = data->old_n_buckets + data->n_buckets;
 
 	__ASSERT(it->size == map->data->size, "Concurrent modification!");
 	__ASSERT(sys_hashmap_iterator_has_next(it), "Attempt to access beyond current bound!");
 
 	if (it->pos == 0) {
-		it->state = buckets;
+		it->state = (void *)0;
 	}
 
-	i = (struct oalp_entry *)it->state - buckets;
-	__ASSERT(i < map->data->n_buckets, "Invalid iterator state %p", it->state);
+	/* the state holds the index of the next bucket to visit */
+	i = (uintptr_t)it->state;
+	__ASSERT(i < n_buckets, "Invalid iterator state %p", it->state);
 
-	for (; i < map->data->n_buckets; ++i) {
-		entry = &buckets[i];
+	for (; i < n_buckets; ++i) {
+		entry = sys_hashmap_oa_lp_bucket(map, i);
 		if (entry->state == USED) {
-			it->state = &buckets[i + 1];
+			it->state = (void *)(uintptr_t)(i + 1);
 			it->key = entry->key;
 			it->value = entry->value;
 			++it->pos;
@@ -211,21 +297,28 @@ static void sys_hashmap_oa_lp_clear(struct sys_hashmap *map, sys_hashmap_callbac
 {
 	struct oalp_entry *entry;
 	struct sys_hashmap_oa_lp_data *data = (struct sys_hashmap_oa_lp_data *)map->data;
-	struct oalp_entry *buckets = data->buckets;
+	const size_t n_buckets = data->old_n_buckets + data->n_buckets;
 
-	for (size_t i = 0, j = 0; cb != NULL && i < data->n_buckets && j < data->size; ++i) {
-		entry = &buckets[i];
+	for (size_t i = 0, j = 0; cb != NULL && i < n_buckets && j < data->size; ++i) {
+		entry = sys_hashmap_oa_lp_bucket(map, i);
 		if (entry->state == USED) {
 			cb(entry->key, entry->value, cookie);
 			++j;
 		}
 	}
 
+	if (data->old_buckets != NULL) {
+		map->alloc_func(data->old_buckets, 0);
+		data->old_buckets = NULL;
+	}
+
 	if (data->buckets != NULL) {
 		map->alloc_func(data->buckets, 0);
 		data->buckets = NULL;
 	}
 
+	data->old_n_buckets = 0;
+	data->rehash_pos = 0;
 	data->n_buckets = 0;
 	data->size = 0;
 	data->n_tombstones = 0;
@@ -235,22 +328,42 @@ static inline int sys_hashmap_oa_lp_insert(struct sys_hashmap *map, uint64_t key
 					   uint64_t *old_value)
 {
 	int ret;
+	struct oalp_entry *entry;
+
+	sys_hashmap_oa_lp_rehash_step(map, map->config->rehash_step);
+
+	entry = sys_hashmap_oa_lp_lookup(map, key);
+	if (entry != NULL) {
+		if (old_value != NULL) {
+			*old_value = entry->value;
+		}
+
+		entry->value = value;
+
+		return 0;
+	}
 
 	ret = sys_hashmap_oa_lp_rehash(map, true);
 	if (ret < 0) {
 		return ret;
 	}
 
-	return sys_hashmap_oa_lp_insert_no_rehash(map, key, value, old_value);
+	sys_hashmap_oa_lp_place(map, key, value);
+	++map->data->size;
+
+	return 1;
 }
 
 static bool sys_hashmap_oa_lp_remove(struct sys_hashmap *map, uint64_t key, uint64_t *value)
 {
 	struct oalp_entry *entry;
 	struct sys_hashmap_oa_lp_data *data = (struct sys_hashmap_oa_lp_data *)map->data;
+	struct oalp_entry *const buckets = data->buckets;
 
-	entry = sys_hashmap_oa_lp_find(map, key, true, true, false);
-	if (entry == NULL || entry->state == UNUSED) {
+	sys_hashmap_oa_lp_rehash_step(map, map->config->rehash_step);
+
+	entry = sys_hashmap_oa_lp_lookup(map, key);
+	if (entry == NULL) {
 		return false;
 	}
 
@@ -260,7 +373,10 @@ static bool sys_hashmap_oa_lp_remove(struct sys_hashmap *map, uint64_t key, uint
 
 	entry->state = TOMBSTONE;
 	--data->size;
-	++data->n_tombstones;
+	/* tombstones left in the table being drained go away with it */
+	if (entry >= buckets && entry < &buckets[data->n_buckets]) {
+		++data->n_tombstones;
+	}
 
 	/* ignore a possible -ENOMEM since the table will remain intact */
 	(void)sys_hashmap_oa_lp_rehash(map, false);
@@ -272,8 +388,8 @@ static bool sys_hashmap_oa_lp_get(const struct sys_hashmap *map, uint64_t key, u
 {
 	struct oalp_entry *entry;
 
-	entry = sys_hashmap_oa_lp_find(map, key, true, true, false);
-	if (entry == NULL || entry->state == UNUSED) {
+	entry = sys_hashmap_oa_lp_lookup(map, key);
+	if (entry == NULL) {
 		return false;
 	}
 
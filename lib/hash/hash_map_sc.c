@@ -22,6 +22,13 @@ struct sys_hashmap_sc_entry {
 	sys_dnode_t node;
 };
 
+BUILD_ASSERT(offsetof(struct sys_hashmap_sc_data, buckets) ==
+	     offsetof(struct sys_hashmap_data, buckets));
+BUILD_ASSERT(offsetof(struct sys_hashmap_sc_data, n_buckets) ==
+	     offsetof(struct sys_hashmap_data, n_buckets));
+BUILD_ASSERT(offsetof(struct sys_hashmap_sc_data, size) ==
+	     offsetof(struct sys_hashmap_data, size));
+
 static void sys_hashmap_sc_entry_init(struct sys_hashmap_sc_entry *entry, uint64_t key,
 				      uint64_t value)
 {
@@ -30,15 +37,35 @@ static void sys_hashmap_sc_entry_init(struct sys_hashmap_sc_entry *entry, uint64
 	sys_dnode_init(&entry->node);
 }
 
-static void sys_hashmap_sc_insert_entry(struct sys_hashmap *map, struct sys_hashmap_sc_entry *entry)
+static void sys_hashmap_sc_place_entry(struct sys_hashmap *map, struct sys_hashmap_sc_entry *entry)
 {
 	sys_dlist_t *buckets = map->data->buckets;
 	uint32_t hash = map->hash_func(&entry->key, sizeof(entry->key));
 
 	sys_dlist_append(&buckets[hash % map->data->n_buckets], &entry->node);
+}
+
+static void sys_hashmap_sc_insert_entry(struct sys_hashmap *map, struct sys_hashmap_sc_entry *entry)
+{
+	sys_hashmap_sc_place_entry(map, entry);
 	++map->data->size;
 }
 
+/*
+ * Buckets of the table being drained, if any, are indexed before those of
+ * the current table.
+ */
+static sys_dlist_t *sys_hashmap_sc_bucket(const struct sys_hashmap *map, size_t i)
+{
+	struct sys_hashmap_sc_data *data = (struct sys_hashmap_sc_data *)map->data;
+
+	if (i < data->old_n_buckets) {
+		return &((sys_dlist_t *)data->old_buckets)[i];
+	}
+
+	return &((sys_dlist_t *)data->buckets)[i - data->old_n_buckets];
+}
+
 static void sys_hashmap_sc_insert_all(struct sys_hashmap *map, sys_dlist_t *list)
 {
 	__unused int ret;
@@ -54,12 +81,12 @@ static void sys_hashmap_sc_to_list(struct sys_hashmap *map, sys_dlist_t *list)
 {
 	sys_dlist_t *bucket;
 	struct sys_hashmap_sc_entry *entry;
-	sys_dlist_t *buckets = map->data->buckets;
+	struct sys_hashmap_sc_data *data = (struct sys_hashmap_sc_data *)map->data;
 
 	sys_dlist_init(list);
 
-	for (size_t i = 0; i < map->data->n_buckets; ++i) {
-		bucket = &buckets[i];
+	for (size_t i = 0; i < data->old_n_buckets + data->n_buckets; ++i) {
+		bucket = sys_hashmap_sc_bucket(map, i);
 		while (!sys_dlist_is_empty(bucket)) {
 			entry = CONTAINER_OF(sys_dlist_get(bucket), struct sys_hashmap_sc_entry,
 					     node);
@@ -68,17 +95,88 @@ static void sys_hashmap_sc_to_list(struct sys_hashmap *map, sys_dlist_t *list)
 	}
 }
 
+/*
+ * Move the entries of up to @p n_steps buckets from the table being drained
+ * to the current one, and release the former once it is empty.
+ */
+static void sys_hashmap_sc_rehash_step(struct sys_hashmap *map, size_t n_steps)
+{
+	sys_dlist_t *bucket;
+	struct sys_hashmap_sc_entry *entry;
+	struct sys_hashmap_sc_data *data = (struct sys_hashmap_sc_data *)map->data;
+
+	if (data->old_buckets == NULL) {
+		return;
+	}
+
+	for (; n_steps > 0 && data->rehash_pos < data->old_n_buckets;
+	     --n_steps, ++data->rehash_pos) {
+		bucket = &((sys_dlist_t *)data->old_buckets)[data->rehash_pos];
+		while (!sys_dlist_is_empty(bucket)) {
+			entry = CONTAINER_OF(sys_dlist_get(bucket), struct sys_hashmap_sc_entry,
+					     node);
+			sys_hashmap_sc_place_entry(map, entry);
+		}
+	}
+
+	if (data->rehash_pos == data->old_n_buckets) {
+		map->alloc_func(data->old_buckets, 0);
+		data->old_buckets = NULL;
+		data->old_n_buckets = 0;
+		data->rehash_pos = 0;
+	}
+}
+
+static int sys_hashmap_sc_rehash_incremental(struct sys_hashmap *map, size_t new_n_buckets)
+{
+	sys_dlist_t *new_buckets;
+	struct sys_hashmap_sc_data *data = (struct sys_hashmap_sc_data *)map->data;
+
+	new_buckets = (sys_dlist_t *)map->alloc_func(NULL, new_n_buckets * sizeof(*new_buckets));
+	if (new_buckets == NULL) {
+		return -ENOMEM;
+	}
+
+	for (size_t i = 0; i < new_n_buckets; ++i) {
+		sys_dlist_init(&new_buckets[i]);
+	}
+
+	/* entries are moved over by subsequent inserts and removals */
+	data->old_buckets = data->buckets;
+	data->old_n_buckets = data->n_buckets;
+	data->rehash_pos = 0;
+	data->buckets = new_buckets;
+	data->n_buckets = new_n_buckets;
+
+	return 0;
+}
+
 static int sys_hashmap_sc_rehash(struct sys_hashmap *map, bool grow)
 {
 	sys_dlist_t list;
 	sys_dlist_t *bucket;
 	size_t new_n_buckets;
 	sys_dlist_t *new_buckets;
+	struct sys_hashmap_sc_data *data = (struct sys_hashmap_sc_data *)map->data;
 
 	if (!sys_hashmap_should_rehash(map, grow, 0, &new_n_buckets)) {
 		return 0;
 	}
 
+	if (data->old_buckets != NULL) {
+		if (!grow && data->size != 0) {
+			/* shrinking can wait until the current migration completes */
+			return 0;
+		}
+
+		/* only one table is ever drained at a time */
+		sys_hashmap_sc_rehash_step(map, SIZE_MAX);
+	}
+
+	if (map->config->rehash_step != 0 && data->n_buckets != 0 && new_n_buckets != 0) {
+		return sys_hashmap_sc_rehash_incremental(map, new_n_buckets);
+	}
+
 	/* extract all entries from the hashmap */
 	sys_hashmap_sc_to_list(map, &list);
 
@@ -112,16 +210,31 @@ static struct sys_hashmap_sc_entry *sys_hashmap_sc_find(const struct sys_hashmap
 	sys_dlist_t *bucket;
 	sys_dlist_t *buckets;
 	struct sys_hashmap_sc_entry *entry;
+	struct sys_hashmap_sc_data *data = (struct sys_hashmap_sc_data *)map->data;
 
-	if (map->data->n_buckets == 0) {
+	if (data->n_buckets == 0) {
 		return NULL;
 	}
 
-	__ASSERT_NO_MSG(map->data->size > 0);
+	__ASSERT_NO_MSG(data->size > 0);
 
 	hash = map->hash_func(&key, sizeof(key));
-	buckets = (sys_dlist_t *)map->data->buckets;
-	bucket = &buckets[hash % map->data->n_buckets];
+	buckets = (sys_dlist_t *)data->buckets;
+	bucket = &buckets[hash % data->n_buckets];
+
+	SYS_DLIST_FOR_EACH_CONTAINER(bucket, entry, node) {
+		if (entry->key == key) {
+			return entry;
+		}
+	}
+
+	if (data->old_buckets == NULL) {
+		return NULL;
+	}
+
+	/* the key may not have been migrated yet */
+	buckets = (sys_dlist_t *)data->old_buckets;
+	bucket = &buckets[hash % data->old_n_buckets];
 
 	SYS_DLIST_FOR_EACH_CONTAINER(bucket, entry, node) {
 		if (entry->key == key) {
@@ -134,22 +247,24 @@ static struct sys_hashmap_sc_entry *sys_hashmap_sc_find(const struct sys_hashmap
 
 static void sys_hashmap_sc_iter_next(struct sys_hashmap_iterator *it)
 {
+	size_t i;
 	sys_dlist_t *bucket;
 	bool found_previous_key = false;
 	struct sys_hashmap_sc_entry *entry;
 	const struct sys_hashmap *map = it->map;
-	sys_dlist_t *buckets = map->data->buckets;
+	struct sys_hashmap_sc_data *data = (struct sys_hashmap_sc_data *)map->data;
 
 	__ASSERT(it->size == map->data->size, "Concurrent modification!");
 	__ASSERT(sys_hashmap_iterator_has_next(it), "Attempt to access beyond current bound!");
 
 	if (it->pos == 0) {
-		/* at position 0, state equals the beginning of the bucket array */
-		it->state = buckets;
+		/* at position 0, state equals the index of the first bucket */
+		it->state = (void *)0;
 		found_previous_key = true;
 	}
 
-	for (bucket = it->state; bucket < &buckets[map->data->n_buckets]; ++bucket) {
+	for (i = (uintptr_t)it->state; i < data->old_n_buckets + data->n_buckets; ++i) {
+		bucket = sys_hashmap_sc_bucket(map, i);
 		SYS_DLIST_FOR_EACH_CONTAINER(bucket, entry, node) {
 			if (!found_previous_key) {
 				if (entry->key == it->key) {
@@ -159,9 +274,10 @@ static void sys_hashmap_sc_iter_next(struct sys_hashmap_iterator *it)
 				continue;
 			}
 
-			/* save the bucket to state so we can restart scanning from a saved position
+			/* save the bucket index to state so we can restart scanning from a saved
+			 * position
 			 */
-			it->state = bucket;
+			it->state = (void *)(uintptr_t)i;
 			it->key = entry->key;
 			it->value = entry->value;
 			++it->pos;
@@ -181,7 +297,7 @@ static void sys_hashmap_sc_iter(const struct sys_hashmap *map, struct sys_hashma
 {
 	it->map = map;
 	it->next = sys_hashmap_sc_iter_next;
-	it->state = map->data->buckets;
+	it->state = (void *)0;
 	it->key = 0;
 	it->value = 0;
 	it->pos = 0;
@@ -192,17 +308,25 @@ static void sys_hashmap_sc_clear(struct sys_hashmap *map, sys_hashmap_callback_t
 {
 	sys_dlist_t list;
 	struct sys_hashmap_sc_entry *entry;
+	struct sys_hashmap_sc_data *data = (struct sys_hashmap_sc_data *)map->data;
 
 	sys_hashmap_sc_to_list(map, &list);
 
 	/* free the buckets */
-	if (map->data->buckets != NULL) {
-		map->alloc_func(map->data->buckets, 0);
-		map->data->buckets = NULL;
+	if (data->old_buckets != NULL) {
+		map->alloc_func(data->old_buckets, 0);
+		data->old_buckets = NULL;
 	}
 
-	map->data->n_buckets = 0;
-	map->data->size = 0;
+	if (data->buckets != NULL) {
+		map->alloc_func(data->buckets, 0);
+		data->buckets = NULL;
+	}
+
+	data->old_n_buckets = 0;
+	data->rehash_pos = 0;
+	data->n_buckets = 0;
+	data->size = 0;
 
 	while (!sys_dlist_is_empty(&list)) {
 		entry = CONTAINER_OF(sys_dlist_get(&list), struct sys_hashmap_sc_entry, node);
@@ -223,6 +347,8 @@ static int sys_hashmap_sc_insert(struct sys_hashmap *map, uint64_t key, uint64_t
 	int ret;
 	struct sys_hashmap_sc_entry *entry;
 
+	sys_hashmap_sc_rehash_step(map, map->config->rehash_step);
+
 	entry = sys_hashmap_sc_find(map, key);
 	if (entry != NULL) {
 		if (old_value != NULL) {
@@ -255,6 +381,8 @@ static bool sys_hashmap_sc_remove(struct sys_hashmap *map, uint64_t key, uint64_
 	__unused int ret;
 	struct sys_hashmap_sc_entry *entry;
 
+	sys_hashmap_sc_rehash_step(map, map->config->rehash_step);
+
 	entry = sys_hashmap_sc_find(map, key);
 	if (entry == NULL) {
 		return false;
@@ -268,8 +396,11 @@ static bool sys_hashmap_sc_remove(struct sys_hashmap *map, uint64_t key, uint64_
 	--map->data->size;
 
 	ret = sys_hashmap_sc_rehash(map, false);
-	/* Realloc to a smaller size of memory should *always* work */
-	__ASSERT_NO_MSG(ret >= 0);
+	/*
+	 * Realloc to a smaller size of memory should *always* work. An incremental rehash
+	 * allocates a second table and may fail, which leaves the table intact.
+	 */
+	__ASSERT_NO_MSG(ret >= 0 || map->config->rehash_step != 0);
 
 	/* free the entry */
 	map->alloc_func(entry, 0);
@@ -0,0 +1,548 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <zephyr/sys/__assert.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/hash_map.h>
+#include <zephyr/sys/hash_map_swiss.h>
+#include <zephyr/sys/util.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* Number of control bytes scanned at once */
+#define GROUP_WIDTH 16
+
+/*
+ * Control byte values. A full bucket holds the low 7 bits of the hash
+ * of its key, so the top bit distinguishes full from non-full buckets.
+ */
+#define CTRL_EMPTY 0x80
+/* Only ever found in the table drained by an incremental rehash */
+#define CTRL_MOVED 0xfe
+
+/*
+ * Number of buckets drained from the old table by each insert / remove, unless
+ * the Hashmap configuration asks for a specific number. This table is always
+ * resized incrementally.
+ */
+#define REHASH_STEP (2 * GROUP_WIDTH)
+
+struct swiss_entry {
+	uint64_t key;
+	uint64_t value;
+};
+
+/*
+ * The allocation for a table of n buckets holds n entries followed by
+ * n + GROUP_WIDTH control bytes. The trailing control bytes mirror the
+ * first GROUP_WIDTH ones so that a group can be loaded at any bucket
+ * without wrapping around.
+ */
+struct swiss_table {
+	struct swiss_entry *entries;
+	uint8_t *ctrl;
+	size_t mask;
+};
+
+BUILD_ASSERT(offsetof(struct sys_hashmap_swiss_data, buckets) ==
+	     offsetof(struct sys_hashmap_data, buckets));
+BUILD_ASSERT(offsetof(struct sys_hashmap_swiss_data, n_buckets) ==
+	     offsetof(struct sys_hashmap_data, n_buckets));
+BUILD_ASSERT(offsetof(struct sys_hashmap_swiss_data, size) ==
+	     offsetof(struct sys_hashmap_data, size));
+
+/*
+ * Group matching. Both variants return a mask with bit i set if control
+ * byte i of the group matches.
+ */
+#ifdef __SSE2__
+
+static inline uint32_t group_match(const uint8_t *ctrl, uint8_t h2)
+{
+	__m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)h2)));
+}
+
+static inline uint32_t group_match_empty(const uint8_t *ctrl)
+{
+	return group_match(ctrl, CTRL_EMPTY);
+}
+
+#else /* __SSE2__ */
+
+#define SWAR_LSBS 0x0101010101010101ULL
+#define SWAR_MSBS 0x8080808080808080ULL
+
+/* Gather the top bit of each byte into the low 8 bits */
+static inline uint32_t swar_bitmask(uint64_t msbs)
+{
+	return (uint32_t)(((msbs >> 7) * 0x0102040810204080ULL) >> 56);
+}
+
+/*
+ * Classic "has zero byte" test. A byte just above a real match may be
+ * reported as a false positive, which is harmless since the key of each
+ * candidate is compared anyway.
+ */
+static inline uint32_t swar_match(uint64_t word, uint8_t h2)
+{
+	uint64_t x = word ^ (SWAR_LSBS * h2);
+
+	return swar_bitmask((x - SWAR_LSBS) & ~x & SWAR_MSBS);
+}
+
+static inline uint32_t swar_match_empty(uint64_t word)
+{
+	/* top bit set and bit 1 clear only holds for CTRL_EMPTY */
+	return swar_bitmask(word & ~(word << 6) & SWAR_MSBS);
+}
+
+static inline uint32_t group_match(const uint8_t *ctrl, uint8_t h2)
+{
+	return swar_match(sys_get_le64(ctrl), h2) |
+	       (swar_match(sys_get_le64(ctrl + 8), h2) << 8);
+}
+
+static inline uint32_t group_match_empty(const uint8_t *ctrl)
+{
+	return swar_match_empty(sys_get_le64(ctrl)) |
+	       (swar_match_empty(sys_get_le64(ctrl + 8)) << 8);
+}
+
+#endif /* __SSE2__ */
+
+static inline size_t h1(uint32_t hash)
+{
+	return hash >> 7;
+}
+
+static inline uint8_t h2(uint32_t hash)
+{
+	return hash & 0x7f;
+}
+
+static inline size_t table_alloc_size(size_t n_buckets)
+{
+	return n_buckets * sizeof(struct swiss_entry) + n_buckets + GROUP_WIDTH;
+}
+
+static inline struct swiss_table table_get(void *buckets, size_t n_buckets)
+{
+	return (struct swiss_table){
+		.entries = buckets,
+		.ctrl = (uint8_t *)((struct swiss_entry *)buckets + n_buckets),
+		.mask = n_buckets - 1,
+	};
+}
+
+static inline void table_set_ctrl(struct swiss_table *t, size_t i, uint8_t ctrl)
+{
+	t->ctrl[i] = ctrl;
+	if (i < GROUP_WIDTH) {
+		t->ctrl[t->mask + 1 + i] = ctrl;
+	}
+}
+
+static inline uint32_t sys_hashmap_swiss_hash(const struct sys_hashmap *map, uint64_t key)
+{
+	return map->hash_func(&key, sizeof(key));
+}
+
+static inline size_t sys_hashmap_swiss_rehash_step_size(const struct sys_hashmap *map)
+{
+	return map->config->rehash_step != 0 ? map->config->rehash_step : REHASH_STEP;
+}
+
+static struct swiss_entry *table_find(const struct swiss_table *t, uint64_t key, uint32_t hash)
+{
+	uint32_t match;
+	uint32_t empty;
+	size_t pos = h1(hash) & t->mask;
+
+	for (size_t probed = 0; probed <= t->mask; probed += GROUP_WIDTH) {
+		match = group_match(&t->ctrl[pos], h2(hash));
+		empty = group_match_empty(&t->ctrl[pos]);
+
+		if (empty != 0) {
+			/* probing is linear, so the key cannot be past an empty bucket */
+			match &= (empty & -empty) - 1;
+		}
+
+		for (; match != 0; match &= match - 1) {
+			size_t i = (pos + __builtin_ctz(match)) & t->mask;
+
+			if (t->entries[i].key == key) {
+				return &t->entries[i];
+			}
+		}
+
+		if (empty != 0) {
+			break;
+		}
+
+		pos = (pos + GROUP_WIDTH) & t->mask;
+	}
+
+	return NULL;
+}
+
+/* The key must not be in the table yet and the table must not be full */
+static void table_insert(struct swiss_table *t, uint64_t key, uint64_t value, uint32_t hash)
+{
+	size_t i;
+	uint32_t empty;
+	size_t pos = h1(hash) & t->mask;
+
+	for (;;) {
+		empty = group_match_empty(&t->ctrl[pos]);
+		if (empty != 0) {
+			break;
+		}
+
+		pos = (pos + GROUP_WIDTH) & t->mask;
+	}
+
+	i = (pos + __builtin_ctz(empty)) & t->mask;
+	t->entries[i].key = key;
+	t->entries[i].value = value;
+	table_set_ctrl(t, i, h2(hash));
+}
+
+/*
+ * Backward-shift deletion: entries following the hole are moved into it
+ * unless that would place them before their home bucket. This keeps every
+ * probe sequence free of holes without resorting to tombstones.
+ */
+static void table_erase(const struct sys_hashmap *map, struct swiss_table *t, size_t i)
+{
+	size_t home;
+
+	for (size_t j = (i + 1) & t->mask; t->ctrl[j] != CTRL_EMPTY; j = (j + 1) & t->mask) {
+		home = h1(sys_hashmap_swiss_hash(map, t->entries[j].key)) & t->mask;
+
+		if (((j - home) & t->mask) >= ((j - i) & t->mask)) {
+			t->entries[i] = t->entries[j];
+			table_set_ctrl(t, i, t->ctrl[j]);
+			i = j;
+		}
+	}
+
+	table_set_ctrl(t, i, CTRL_EMPTY);
+}
+
+/*
+ * Move up to @p n_steps buckets worth of entries from the old table to the
+ * current one, and release the old table once it is empty.
+ */
+static void sys_hashmap_swiss_rehash_step(struct sys_hashmap *map, size_t n_steps)
+{
+	uint32_t hash;
+	struct swiss_entry *entry;
+	struct swiss_table old_table;
+	struct swiss_table new_table;
+	struct sys_hashmap_swiss_data *data = (struct sys_hashmap_swiss_data *)map->data;
+
+	if (data->old_buckets == NULL) {
+		return;
+	}
+
+	old_table = table_get(data->old_buckets, data->old_n_buckets);
+	new_table = table_get(data->buckets, data->n_buckets);
+
+	for (; n_steps > 0 && data->old_size > 0; --n_steps, ++data->rehash_pos) {
+		__ASSERT_NO_MSG(data->rehash_pos < data->old_n_buckets);
+
+		if ((old_table.ctrl[data->rehash_pos] & CTRL_EMPTY) != 0) {
+			continue;
+		}
+
+		entry = &old_table.entries[data->rehash_pos];
+		hash = sys_hashmap_swiss_hash(map, entry->key);
+		table_insert(&new_table, entry->key, entry->value, hash);
+		/* lookups that still probe the old table must skip past it */
+		table_set_ctrl(&old_table, data->rehash_pos, CTRL_MOVED);
+		--data->old_size;
+	}
+
+	if (data->old_size == 0) {
+		map->alloc_func(data->old_buckets, 0);
+		data->old_buckets = NULL;
+		data->old_n_buckets = 0;
+		data->rehash_pos = 0;
+	}
+}
+
+static int sys_hashmap_swiss_resize(struct sys_hashmap *map, size_t new_n_buckets)
+{
+	void *new_buckets;
+	struct swiss_table table;
+	struct sys_hashmap_swiss_data *data = (struct sys_hashmap_swiss_data *)map->data;
+
+	/* there is only ever one table being drained */
+	sys_hashmap_swiss_rehash_step(map, SIZE_MAX);
+
+	new_buckets = map->alloc_func(NULL, table_alloc_size(new_n_buckets));
+	if (new_buckets == NULL) {
+		return -ENOMEM;
+	}
+
+	table = table_get(new_buckets, new_n_buckets);
+	memset(table.ctrl, CTRL_EMPTY, new_n_buckets + GROUP_WIDTH);
+
+	/* an empty Hashmap has no table yet */
+	if (data->size != 0) {
+		data->old_buckets = data->buckets;
+		data->old_n_buckets = data->n_buckets;
+		data->old_size = data->size;
+		data->rehash_pos = 0;
+	}
+
+	data->buckets = new_buckets;
+	data->n_buckets = new_n_buckets;
+
+	return 0;
+}
+
+static struct swiss_entry *sys_hashmap_swiss_find(const struct sys_hashmap *map, uint64_t key,
+						  uint32_t hash, struct swiss_table *table)
+{
+	struct swiss_entry *entry;
+	struct sys_hashmap_swiss_data *data = (struct sys_hashmap_swiss_data *)map->data;
+
+	if (data->n_buckets == 0) {
+		return NULL;
+	}
+
+	*table = table_get(data->buckets, data->n_buckets);
+	entry = table_find(table, key, hash);
+	if (entry != NULL || data->old_buckets == NULL) {
+		return entry;
+	}
+
+	*table = table_get(data->old_buckets, data->old_n_buckets);
+
+	return table_find(table, key, hash);
+}
+
+static void sys_hashmap_swiss_iter_next(struct sys_hashmap_iterator *it)
+{
+	size_t i;
+	struct swiss_table table;
+	const struct sys_hashmap *map = (const struct sys_hashmap *)it->map;
+	struct sys_hashmap_swiss_data *data = (struct sys_hashmap_swiss_data *)map->data;
+
+	__ASSERT(it->size == map->data->size, "Concurrent modification!");
+	__ASSERT(sys_hashmap_iterator_has_next(it), "Attempt to access beyond current bound!");
+
+	if (it->pos == 0) {
+		it->state = (void *)0;
+	}
+
+	/* the state indexes the old table, if any, followed by the current one */
+	for (i = (uintptr_t)it->state; i < data->old_n_buckets + data->n_buckets; ++i) {
+		if (i < data->old_n_buckets) {
+			table = table_get(data->old_buckets, data->old_n_buckets);
+			if ((table.ctrl[i] & CTRL_EMPTY) != 0) {
+				continue;
+			}
+
+			it->key = table.entries[i].key;
+			it->value = table.entries[i].value;
+		} else {
+			table = table_get(data->buckets, data->n_buckets);
+			if ((table.ctrl[i - data->old_n_buckets] & CTRL_EMPTY) != 0) {
+				continue;
+			}
+
+			it->key = table.entries[i - data->old_n_buckets].key;
+			it->value = table.entries[i - data->old_n_buckets].value;
+		}
+
+		it->state = (void *)(uintptr_t)(i + 1);
+		++it->pos;
+		return;
+	}
+
+	__ASSERT(false, "Entire Hashmap traversed and no entry was found");
+}
+
+/*
+ * Swiss Table Hashmap API
+ */
+
+static void sys_hashmap_swiss_iter(const struct sys_hashmap *map, struct sys_hashmap_iterator *it)
+{
+	it->map = map;
+	it->next = sys_hashmap_swiss_iter_next;
+	it->pos = 0;
+	*((size_t *)&it->size) = map->data->size;
+}
+
+static void sys_hashmap_swiss_clear(struct sys_hashmap *map, sys_hashmap_callback_t cb,
+				    void *cookie)
+{
+	struct swiss_table table;
+	struct sys_hashmap_swiss_data *data = (struct sys_hashmap_swiss_data *)map->data;
+
+	if (data->old_buckets != NULL) {
+		table = table_get(data->old_buckets, data->old_n_buckets);
+		for (size_t i = 0; cb != NULL && i < data->old_n_buckets; ++i) {
+			if ((table.ctrl[i] & CTRL_EMPTY) == 0) {
+				cb(table.entries[i].key, table.entries[i].value, cookie);
+			}
+		}
+
+		map->alloc_func(data->old_buckets, 0);
+	}
+
+	if (data->buckets != NULL) {
+		table = table_get(data->buckets, data->n_buckets);
+		for (size_t i = 0; cb != NULL && i < data->n_buckets; ++i) {
+			if ((table.ctrl[i] & CTRL_EMPTY) == 0) {
+				cb(table.entries[i].key, table.entries[i].value, cookie);
+			}
+		}
+
+		map->alloc_func(data->buckets, 0);
+	}
+
+	*data = (struct sys_hashmap_swiss_data){0};
+}
+
+static int sys_hashmap_swiss_insert(struct sys_hashmap *map, uint64_t key, uint64_t value,
+				    uint64_t *old_value)
+{
+	int ret;
+	size_t n_buckets;
+	struct swiss_table table;
+	struct swiss_entry *entry;
+	uint32_t hash = sys_hashmap_swiss_hash(map, key);
+	struct sys_hashmap_swiss_data *data = (struct sys_hashmap_swiss_data *)map->data;
+	const size_t load_factor = map->config->load_factor;
+
+	__ASSERT_NO_MSG(load_factor > 0);
+
+	sys_hashmap_swiss_rehash_step(map, sys_hashmap_swiss_rehash_step_size(map));
+
+	entry = sys_hashmap_swiss_find(map, key, hash, &table);
+	if (entry != NULL) {
+		if (old_value != NULL) {
+			*old_value = entry->value;
+		}
+
+		entry->value = value;
+
+		return 0;
+	}
+
+	if (data->size == map->config->max_size) {
+		return -ENOSPC;
+	}
+
+	/* always leave at least one empty bucket to terminate probing */
+	n_buckets = data->n_buckets;
+	if (n_buckets == 0) {
+		n_buckets = MAX(GROUP_WIDTH, map->config->initial_n_buckets);
+	}
+
+	while ((data->size + 1) * 100 > load_factor * n_buckets || data->size + 1 >= n_buckets) {
+		n_buckets <<= 1;
+	}
+
+	if (n_buckets != data->n_buckets) {
+		ret = sys_hashmap_swiss_resize(map, n_buckets);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	table = table_get(data->buckets, data->n_buckets);
+	table_insert(&table, key, value, hash);
+	++data->size;
+
+	return 1;
+}
+
+static bool sys_hashmap_swiss_remove(struct sys_hashmap *map, uint64_t key, uint64_t *value)
+{
+	struct swiss_table table;
+	struct swiss_entry *entry;
+	uint32_t hash = sys_hashmap_swiss_hash(map, key);
+	struct sys_hashmap_swiss_data *data = (struct sys_hashmap_swiss_data *)map->data;
+
+	sys_hashmap_swiss_rehash_step(map, sys_hashmap_swiss_rehash_step_size(map));
+
+	entry = sys_hashmap_swiss_find(map, key, hash, &table);
+	if (entry == NULL) {
+		return false;
+	}
+
+	if (value != NULL) {
+		*value = entry->value;
+	}
+
+	if (table.entries == data->buckets) {
+		table_erase(map, &table, entry - table.entries);
+	} else {
+		table_set_ctrl(&table, entry - table.entries, CTRL_MOVED);
+		--data->old_size;
+		sys_hashmap_swiss_rehash_step(map, 0);
+	}
+
+	if (--data->size == 0) {
+		sys_hashmap_swiss_clear(map, NULL, NULL);
+		return true;
+	}
+
+	/*
+	 * Shrink with hysteresis, so that alternating insert / remove does not thrash. Both grow
+	 * conditions of insert are mirrored: the halved table must be at most half way to the
+	 * load factor, and at most half full, since a load factor above 100 does not bound the
+	 * number of empty buckets.
+	 */
+	if (data->old_buckets == NULL && data->n_buckets > GROUP_WIDTH &&
+	    data->size * 100 * 4 <= map->config->load_factor * data->n_buckets &&
+	    (data->size + 1) * 4 <= data->n_buckets) {
+		/* ignore a possible -ENOMEM since the table will remain intact */
+		(void)sys_hashmap_swiss_resize(map, data->n_buckets >> 1);
+	}
+
+	return true;
+}
+
+static bool sys_hashmap_swiss_get(const struct sys_hashmap *map, uint64_t key, uint64_t *value)
+{
+	struct swiss_table table;
+	struct swiss_entry *entry;
+
+	entry = sys_hashmap_swiss_find(map, key, sys_hashmap_swiss_hash(map, key), &table);
+	if (entry == NULL) {
+		return false;
+	}
+
+	if (value != NULL) {
+		*value = entry->value;
+	}
+
+	return true;
+}
+
+const struct sys_hashmap_api sys_hashmap_swiss_api = {
+	.iter = sys_hashmap_swiss_iter,
+	.clear = sys_hashmap_swiss_clear,
+	.insert = sys_hashmap_swiss_insert,
+	.remove = sys_hashmap_swiss_remove,
+	.get = sys_hashmap_swiss_get,
+};
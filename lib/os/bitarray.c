@@ -5,6 +5,7 @@
  */
 
 #include <errno.h>
+#include <limits.h>
 #include <stddef.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -15,6 +16,133 @@
 /* Number of bits represented by one bundle */
 #define bundle_bitness(ba)	(sizeof(ba->bundles[0]) * 8)
 
+/* Number of bundles represented by one summary word */
+#define summary_bitness(ba)	(sizeof((ba)->summary[0]) * 8)
+
+/* Number of words in each level of the summary */
+#define summary_words(ba)	ceiling_fraction((ba)->num_bundles, summary_bitness(ba))
+
+/* Summary of bundles with all bits set */
+#define summary_full(ba)	(&(ba)->summary[0])
+
+/* Summary of bundles with any bit set */
+#define summary_used(ba)	(&(ba)->summary[summary_words(ba)])
+
+/* Update the summary bits of a bundle after the bundle has changed. */
+static void update_summary(sys_bitarray_t *bitarray, size_t idx)
+{
+	size_t sidx = idx / summary_bitness(bitarray);
+	uint32_t mask = BIT(idx % summary_bitness(bitarray));
+	uint32_t bundle = bitarray->bundles[idx];
+
+	if (bitarray->summary == NULL) {
+		return;
+	}
+
+	if (~bundle == 0U) {
+		summary_full(bitarray)[sidx] |= mask;
+	} else {
+		summary_full(bitarray)[sidx] &= ~mask;
+	}
+
+	if (bundle != 0U) {
+		summary_used(bitarray)[sidx] |= mask;
+	} else {
+		summary_used(bitarray)[sidx] &= ~mask;
+	}
+}
+
+/*
+ * Find the first bundle in [idx, end) whose bit in the summary @p level is
+ * set (or cleared if @p invert), looking at one summary word at a time.
+ *
+ * @return Index of the bundle, or @p end if there is none.
+ */
+static size_t scan_summary(sys_bitarray_t *bitarray, const uint32_t *level,
+			   bool invert, size_t idx, size_t end)
+{
+	while (idx < end) {
+		size_t sidx = idx / summary_bitness(bitarray);
+		uint32_t word = invert ? ~level[sidx] : level[sidx];
+
+		/* Ignore bundles before idx */
+		word &= ~(BIT(idx % summary_bitness(bitarray)) - 1);
+		if (word != 0U) {
+			idx = sidx * summary_bitness(bitarray) + find_lsb_set(word) - 1;
+			return MIN(idx, end);
+		}
+
+		idx = (sidx + 1) * summary_bitness(bitarray);
+	}
+
+	return end;
+}
+
+/* Find the first bundle in [idx, end) which has at least one bit cleared. */
+static size_t next_bundle_not_full(sys_bitarray_t *bitarray, size_t idx, size_t end)
+{
+	if (bitarray->summary != NULL) {
+		return scan_summary(bitarray, summary_full(bitarray), true, idx, end);
+	}
+
+	while ((idx < end) && (~bitarray->bundles[idx] == 0U)) {
+		idx++;
+	}
+
+	return idx;
+}
+
+/* Find the first bundle in [idx, end) which has at least one bit set. */
+static size_t next_bundle_used(sys_bitarray_t *bitarray, size_t idx, size_t end)
+{
+	if (bitarray->summary != NULL) {
+		return scan_summary(bitarray, summary_used(bitarray), false, idx, end);
+	}
+
+	while ((idx < end) && (bitarray->bundles[idx] == 0U)) {
+		idx++;
+	}
+
+	return idx;
+}
+
+/*
+ * Find the first bit at or after @p bit which is cleared (or set if
+ * @p find_set).
+ *
+ * @return Offset of the bit, or number of bits in bitarray if there is none.
+ */
+static size_t next_bit(sys_bitarray_t *bitarray, size_t bit, bool find_set)
+{
+	size_t idx = bit / bundle_bitness(bitarray);
+	uint32_t bundle;
+
+	if (bit >= bitarray->num_bits) {
+		return bitarray->num_bits;
+	}
+
+	bundle = find_set ? bitarray->bundles[idx] : ~bitarray->bundles[idx];
+	bundle &= ~(BIT(bit % bundle_bitness(bitarray)) - 1);
+
+	if (bundle == 0U) {
+		if (find_set) {
+			idx = next_bundle_used(bitarray, idx + 1, bitarray->num_bundles);
+		} else {
+			idx = next_bundle_not_full(bitarray, idx + 1, bitarray->num_bundles);
+		}
+
+		if (idx >= bitarray->num_bundles) {
+			return bitarray->num_bits;
+		}
+
+		bundle = find_set ? bitarray->bundles[idx] : ~bitarray->bundles[idx];
+	}
+
+	bit = idx * bundle_bitness(bitarray) + find_lsb_set(bundle) - 1;
+
+	return MIN(bit, bitarray->num_bits);
+}
+
 struct bundle_data {
 	 /* Start and end index of bundles */
 	size_t sidx, eidx;
@@ -120,22 +248,19 @@ static bool match_region(sys_bitarray_t *bitarray, size_t offset,
 		goto mismatch;
 	}
 
-	/* In-between bundles */
-	for (idx = bd->sidx + 1; idx < bd->eidx; idx++) {
-		/* Note that this is opposite from above so that
-		 * we are simply checking if bundle == 0.
-		 */
-		bundle = bitarray->bundles[idx];
-		if (match_set) {
-			bundle = ~bundle;
-		}
+	/* In-between bundles, skipped using the summary where possible */
+	if (match_set) {
+		idx = next_bundle_not_full(bitarray, bd->sidx + 1, bd->eidx);
+	} else {
+		idx = next_bundle_used(bitarray, bd->sidx + 1, bd->eidx);
+	}
 
-		if (bundle != 0U) {
-			/* Bits in "between bundles" do not match */
-			mismatch_bundle = ~bundle;
-			mismatch_bundle_idx = idx;
-			goto mismatch;
-		}
+	if (idx < bd->eidx) {
+		/* Bits in "between bundles" do not match */
+		bundle = bitarray->bundles[idx];
+		mismatch_bundle = match_set ? ~bundle : bundle;
+		mismatch_bundle_idx = idx;
+		goto mismatch;
 	}
 
 out:
@@ -188,6 +313,7 @@ static void set_region(sys_bitarray_t *bitarray, size_t offset,
 		} else {
 			bitarray->bundles[bd->sidx] &= ~bd->smask;
 		}
+		update_summary(bitarray, bd->sidx);
 	} else {
 		/* Start/end at different bundle.
 		 * So set/clear the bits in start and end bundles
@@ -207,7 +333,49 @@ static void set_region(sys_bitarray_t *bitarray, size_t offset,
 				bitarray->bundles[idx] = 0U;
 			}
 		}
+
+		for (idx = bd->sidx; idx <= bd->eidx; idx++) {
+			update_summary(bitarray, idx);
+		}
+	}
+}
+
+/*
+ * Find a contiguous region of cleared bits.
+ *
+ * @param[in]  bitarray Bitarray struct
+ * @param[in]  num_bits Number of bits in the region
+ * @param[out] offset   Offset to the start of the region
+ * @param[out] bd       Bundle data of the region, can be passed
+ *                      to set_region().
+ *
+ * @retval     true     Region found
+ * @retval     false    No region big enough
+ */
+static bool find_region(sys_bitarray_t *bitarray, size_t num_bits,
+			size_t *offset, struct bundle_data *bd)
+{
+	size_t off_end = bitarray->num_bits - num_bits;
+	size_t bit_idx;
+	size_t mismatch;
+
+	/* Skip fully allocated bundles using the summary */
+	bit_idx = next_bit(bitarray, 0, false);
+
+	while (bit_idx <= off_end) {
+		if (match_region(bitarray, bit_idx, num_bits, false,
+				 bd, &mismatch)) {
+			*offset = bit_idx;
+			return true;
+		}
+
+		/* Fast-forward to the first free bit after
+		 * the mismatched bit.
+		 */
+		bit_idx = next_bit(bitarray, mismatch + 1, false);
 	}
+
+	return false;
 }
 
 int sys_bitarray_set_bit(sys_bitarray_t *bitarray, size_t bit)
@@ -230,6 +398,7 @@ int sys_bitarray_set_bit(sys_bitarray_t *bitarray, size_t bit)
 	off = bit % bundle_bitness(bitarray);
 
 	bitarray->bundles[idx] |= BIT(off);
+	update_summary(bitarray, idx);
 
 	ret = 0;
 
@@ -258,6 +427,7 @@ int sys_bitarray_clear_bit(sys_bitarray_t *bitarray, size_t bit)
 	off = bit % bundle_bitness(bitarray);
 
 	bitarray->bundles[idx] &= ~BIT(off);
+	update_summary(bitarray, idx);
 
 	ret = 0;
 
@@ -334,6 +504,7 @@ int sys_bitarray_test_and_set_bit(sys_bitarray_t *bitarray, size_t bit, int *pre
 	}
 
 	bitarray->bundles[idx] |= BIT(off);
+	update_summary(bitarray, idx);
 
 	ret = 0;
 
@@ -373,6 +544,7 @@ int sys_bitarray_test_and_clear_bit(sys_bitarray_t *bitarray, size_t bit, int *p
 	}
 
 	bitarray->bundles[idx] &= ~BIT(off);
+	update_summary(bitarray, idx);
 
 	ret = 0;
 
@@ -385,11 +557,9 @@ int sys_bitarray_alloc(sys_bitarray_t *bitarray, size_t num_bits,
 		       size_t *offset)
 {
 	k_spinlock_key_t key;
-	uint32_t bit_idx;
+	size_t bit_idx;
 	int ret;
 	struct bundle_data bd;
-	size_t off_start, off_end;
-	size_t mismatch;
 
 	__ASSERT_NO_MSG(bitarray != NULL);
 	__ASSERT_NO_MSG(bitarray->num_bits > 0);
@@ -406,49 +576,83 @@ int sys_bitarray_alloc(sys_bitarray_t *bitarray, size_t num_bits,
 		goto out;
 	}
 
-	bit_idx = 0;
+	if (find_region(bitarray, num_bits, &bit_idx, &bd)) {
+		set_region(bitarray, bit_idx, num_bits, true, &bd);
 
-	/* Find the first non-allocated bit by looking at bundles
-	 * instead of individual bits.
-	 *
-	 * On RISC-V 64-bit, it complains about undefined reference to `ffs`.
-	 * So don't use this on RISCV64.
-	 */
-	for (size_t idx = 0; idx < bitarray->num_bundles; idx++) {
-		if (~bitarray->bundles[idx] == 0U) {
-			/* bundle is all 1s => all allocated, skip */
-			bit_idx += bundle_bitness(bitarray);
-			continue;
-		}
+		*offset = bit_idx;
+		ret = 0;
+	} else {
+		ret = -ENOSPC;
+	}
 
-		if (bitarray->bundles[idx] != 0U) {
-			/* Find the first free bit in bundle if not all free */
-			off_start = find_lsb_set(~bitarray->bundles[idx]) - 1;
-			bit_idx += off_start;
-		}
+out:
+	k_spin_unlock(&bitarray->lock, key);
+	return ret;
+}
+
+int sys_bitarray_alloc_scatter(sys_bitarray_t *bitarray, size_t num_bits,
+			       size_t max_regions,
+			       struct sys_bitarray_region *regions)
+{
+	k_spinlock_key_t key;
+	struct bundle_data bd;
+	size_t remaining = num_bits;
+	size_t bit_idx, run_end;
+	size_t cnt = 0;
+	int ret;
+
+	__ASSERT_NO_MSG(bitarray != NULL);
+	__ASSERT_NO_MSG(bitarray->num_bits > 0);
 
-		ret = idx < INT_MAX ? (int)idx : INT_MAX;
-		break;
+	key = k_spin_lock(&bitarray->lock);
+
+	CHECKIF(regions == NULL) {
+		ret = -EINVAL;
+		goto out;
 	}
 
-	off_end = bitarray->num_bits - num_bits;
-	ret = -ENOSPC;
-	while (bit_idx <= off_end) {
-		if (match_region(bitarray, bit_idx, num_bits, false,
-				 &bd, &mismatch)) {
-			set_region(bitarray, bit_idx, num_bits, true, &bd);
+	if ((num_bits == 0) || (num_bits > bitarray->num_bits) ||
+	    (max_regions == 0)) {
+		ret = -EINVAL;
+		goto out;
+	}
 
-			*offset = bit_idx;
-			ret = 0;
-			break;
-		}
+	/* Single region is preferred */
+	if (find_region(bitarray, num_bits, &regions[0].offset, &bd)) {
+		set_region(bitarray, regions[0].offset, num_bits, true, &bd);
+		regions[0].num_bits = num_bits;
+		ret = 1;
+		goto out;
+	}
 
-		/* Fast-forward to the bit just after
-		 * the mismatched bit.
-		 */
-		bit_idx = mismatch + 1;
+	/* Otherwise collect free regions from the start. Nothing is
+	 * marked as allocated until there are enough of them.
+	 */
+	bit_idx = next_bit(bitarray, 0, false);
+	while ((remaining > 0) && (cnt < max_regions) &&
+	       (bit_idx < bitarray->num_bits)) {
+		run_end = next_bit(bitarray, bit_idx, true);
+
+		regions[cnt].offset = bit_idx;
+		regions[cnt].num_bits = MIN(run_end - bit_idx, remaining);
+		remaining -= regions[cnt].num_bits;
+		cnt++;
+
+		bit_idx = next_bit(bitarray, run_end, false);
+	}
+
+	if (remaining > 0) {
+		ret = -ENOSPC;
+		goto out;
+	}
+
+	for (size_t i = 0; i < cnt; i++) {
+		set_region(bitarray, regions[i].offset, regions[i].num_bits,
+			   true, NULL);
 	}
 
+	ret = cnt < INT_MAX ? (int)cnt : INT_MAX;
+
 out:
 	k_spin_unlock(&bitarray->lock, key);
 	return ret;
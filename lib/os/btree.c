@@ -0,0 +1,444 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* B+tree with one cache line of keys per node.
+ *
+ * Insertion splits full nodes on the way down, so a parent always has
+ * room for the separator of a split child.  Removal records the path
+ * to the leaf and restores minimum occupancy bottom-up by borrowing
+ * from, or merging with, a sibling.  Separators in internal nodes may
+ * go stale after a removal; they remain valid bounds, which is all a
+ * lookup needs.
+ */
+
+#include <zephyr/sys/btree.h>
+#include <zephyr/sys/__assert.h>
+#include <string.h>
+
+#define ORDER SYS_BTREE_ORDER
+#define LEAF_MIN (ORDER / 2)
+#define INNER_MIN ((ORDER - 1) / 2)
+
+BUILD_ASSERT(ORDER >= 3, "B+tree cache line too small");
+BUILD_ASSERT(ORDER < UINT8_MAX, "B+tree cache line too big");
+BUILD_ASSERT(offsetof(struct sys_btree_node, keys) + ORDER * sizeof(sys_btree_key_t) <=
+	     CONFIG_SYS_BTREE_CACHE_LINE_SIZE,
+	     "B+tree node header and keys must share one cache line");
+#if defined(CONFIG_DCACHE_LINE_SIZE) && (CONFIG_DCACHE_LINE_SIZE > 0)
+BUILD_ASSERT(CONFIG_SYS_BTREE_CACHE_LINE_SIZE <= CONFIG_DCACHE_LINE_SIZE,
+	     "B+tree key line does not fit in a d-cache line");
+#endif
+
+static struct sys_btree_node *node_alloc(struct sys_btree *tree, bool leaf)
+{
+	struct sys_btree_node *node = tree->free_list;
+
+	if (node != NULL) {
+		tree->free_list = node->children[0];
+	} else if (tree->pool_used < tree->pool_size) {
+		node = &tree->pool[tree->pool_used++];
+	} else {
+		return NULL;
+	}
+
+	node->count = 0;
+	node->leaf = leaf;
+	if (leaf) {
+		node->next = NULL;
+	}
+
+	return node;
+}
+
+static void node_free(struct sys_btree *tree, struct sys_btree_node *node)
+{
+	node->children[0] = tree->free_list;
+	tree->free_list = node;
+}
+
+/* Index of the first key which is not less than key */
+static inline uint8_t lower_bound(const struct sys_btree_node *node, sys_btree_key_t key)
+{
+	uint8_t i = 0;
+
+	while ((i < node->count) && (node->keys[i] < key)) {
+		i++;
+	}
+
+	return i;
+}
+
+/* Index of the child whose subtree may hold key */
+static inline uint8_t child_index(const struct sys_btree_node *node, sys_btree_key_t key)
+{
+	uint8_t i = 0;
+
+	while ((i < node->count) && (key >= node->keys[i])) {
+		i++;
+	}
+
+	return i;
+}
+
+static const struct sys_btree_node *find_leaf(const struct sys_btree *tree,
+					      sys_btree_key_t key)
+{
+	const struct sys_btree_node *node = tree->root;
+
+	while ((node != NULL) && !node->leaf) {
+		node = node->children[child_index(node, key)];
+	}
+
+	return node;
+}
+
+/* Split the full child at idx into two, parent must not be full */
+static int split_child(struct sys_btree *tree, struct sys_btree_node *parent,
+		       uint8_t idx)
+{
+	struct sys_btree_node *child = parent->children[idx];
+	struct sys_btree_node *sibling = node_alloc(tree, child->leaf);
+	uint8_t mid = ORDER / 2;
+	sys_btree_key_t sep;
+
+	if (sibling == NULL) {
+		return -ENOMEM;
+	}
+
+	if (child->leaf) {
+		sibling->count = ORDER - mid;
+		memcpy(sibling->keys, &child->keys[mid],
+		       sibling->count * sizeof(sys_btree_key_t));
+		memcpy(sibling->values, &child->values[mid],
+		       sibling->count * sizeof(void *));
+		sibling->next = child->next;
+		child->next = sibling;
+		sep = sibling->keys[0];
+	} else {
+		/* keys[mid] moves up to the parent */
+		sibling->count = ORDER - mid - 1;
+		memcpy(sibling->keys, &child->keys[mid + 1],
+		       sibling->count * sizeof(sys_btree_key_t));
+		memcpy(sibling->children, &child->children[mid + 1],
+		       (sibling->count + 1) * sizeof(struct sys_btree_node *));
+		sep = child->keys[mid];
+	}
+	child->count = mid;
+
+	memmove(&parent->keys[idx + 1], &parent->keys[idx],
+		(parent->count - idx) * sizeof(sys_btree_key_t));
+	memmove(&parent->children[idx + 2], &parent->children[idx + 1],
+		(parent->count - idx) * sizeof(struct sys_btree_node *));
+	parent->keys[idx] = sep;
+	parent->children[idx + 1] = sibling;
+	parent->count++;
+
+	return 0;
+}
+
+void sys_btree_init(struct sys_btree *tree, struct sys_btree_node *pool,
+		    size_t num_nodes)
+{
+	__ASSERT_NO_MSG(num_nodes <= UINT32_MAX);
+
+	*tree = (struct sys_btree) {
+		.pool = pool,
+		.pool_size = (uint32_t)num_nodes,
+	};
+}
+
+int sys_btree_insert(struct sys_btree *tree, sys_btree_key_t key, void *value)
+{
+	struct sys_btree_node *node = tree->root;
+	uint8_t idx;
+
+	if (node == NULL) {
+		node = node_alloc(tree, true);
+		if (node == NULL) {
+			return -ENOMEM;
+		}
+
+		tree->root = node;
+		tree->first = node;
+		tree->height = 1;
+	} else if (node->count == ORDER) {
+		struct sys_btree_node *root = node_alloc(tree, false);
+
+		if (root == NULL) {
+			return -ENOMEM;
+		}
+
+		root->children[0] = node;
+		if (split_child(tree, root, 0) != 0) {
+			node_free(tree, root);
+			return -ENOMEM;
+		}
+
+		__ASSERT_NO_MSG(tree->height < SYS_BTREE_MAX_DEPTH);
+		tree->root = root;
+		tree->height++;
+		node = root;
+	}
+
+	while (!node->leaf) {
+		idx = child_index(node, key);
+		if (node->children[idx]->count == ORDER) {
+			if (split_child(tree, node, idx) != 0) {
+				return -ENOMEM;
+			}
+
+			if (key >= node->keys[idx]) {
+				idx++;
+			}
+		}
+
+		node = node->children[idx];
+	}
+
+	idx = lower_bound(node, key);
+	if ((idx < node->count) && (node->keys[idx] == key)) {
+		return -EEXIST;
+	}
+
+	memmove(&node->keys[idx + 1], &node->keys[idx],
+		(node->count - idx) * sizeof(sys_btree_key_t));
+	memmove(&node->values[idx + 1], &node->values[idx],
+		(node->count - idx) * sizeof(void *));
+	node->keys[idx] = key;
+	node->values[idx] = value;
+	node->count++;
+	tree->size++;
+
+	return 0;
+}
+
+/* Move the last element of the left sibling to the front of node */
+static void borrow_left(struct sys_btree_node *parent, uint8_t idx,
+			struct sys_btree_node *node, struct sys_btree_node *left)
+{
+	memmove(&node->keys[1], &node->keys[0],
+		node->count * sizeof(sys_btree_key_t));
+
+	if (node->leaf) {
+		memmove(&node->values[1], &node->values[0],
+			node->count * sizeof(void *));
+		node->keys[0] = left->keys[left->count - 1];
+		node->values[0] = left->values[left->count - 1];
+		parent->keys[idx - 1] = node->keys[0];
+	} else {
+		memmove(&node->children[1], &node->children[0],
+			(node->count + 1) * sizeof(struct sys_btree_node *));
+		node->keys[0] = parent->keys[idx - 1];
+		node->children[0] = left->children[left->count];
+		parent->keys[idx - 1] = left->keys[left->count - 1];
+	}
+
+	left->count--;
+	node->count++;
+}
+
+/* Move the first element of the right sibling to the back of node */
+static void borrow_right(struct sys_btree_node *parent, uint8_t idx,
+			 struct sys_btree_node *node, struct sys_btree_node *right)
+{
+	if (node->leaf) {
+		node->keys[node->count] = right->keys[0];
+		node->values[node->count] = right->values[0];
+		memmove(&right->values[0], &right->values[1],
+			(right->count - 1) * sizeof(void *));
+		memmove(&right->keys[0], &right->keys[1],
+			(right->count - 1) * sizeof(sys_btree_key_t));
+		parent->keys[idx] = right->keys[0];
+	} else {
+		node->keys[node->count] = parent->keys[idx];
+		node->children[node->count + 1] = right->children[0];
+		parent->keys[idx] = right->keys[0];
+		memmove(&right->keys[0], &right->keys[1],
+			(right->count - 1) * sizeof(sys_btree_key_t));
+		memmove(&right->children[0], &right->children[1],
+			right->count * sizeof(struct sys_btree_node *));
+	}
+
+	right->count--;
+	node->count++;
+}
+
+/* Merge children sep and sep + 1 of parent into the left one */
+static void merge(struct sys_btree *tree, struct sys_btree_node *parent, uint8_t sep)
+{
+	struct sys_btree_node *left = parent->children[sep];
+	struct sys_btree_node *right = parent->children[sep + 1];
+
+	if (left->leaf) {
+		memcpy(&left->keys[left->count], right->keys,
+		       right->count * sizeof(sys_btree_key_t));
+		memcpy(&left->values[left->count], right->values,
+		       right->count * sizeof(void *));
+		left->count += right->count;
+		left->next = right->next;
+	} else {
+		left->keys[left->count] = parent->keys[sep];
+		memcpy(&left->keys[left->count + 1], right->keys,
+		       right->count * sizeof(sys_btree_key_t));
+		memcpy(&left->children[left->count + 1], right->children,
+		       (right->count + 1) * sizeof(struct sys_btree_node *));
+		left->count += right->count + 1;
+	}
+
+	__ASSERT_NO_MSG(left->count <= ORDER);
+
+	memmove(&parent->keys[sep], &parent->keys[sep + 1],
+		(parent->count - sep - 1) * sizeof(sys_btree_key_t));
+	memmove(&parent->children[sep + 1], &parent->children[sep + 2],
+		(parent->count - sep - 1) * sizeof(struct sys_btree_node *));
+	parent->count--;
+
+	node_free(tree, right);
+}
+
+int sys_btree_remove(struct sys_btree *tree, sys_btree_key_t key, void **value)
+{
+	struct sys_btree_node *path[SYS_BTREE_MAX_DEPTH];
+	uint8_t path_idx[SYS_BTREE_MAX_DEPTH];
+	struct sys_btree_node *node = tree->root;
+	int depth = 0;
+	uint8_t idx;
+
+	if (node == NULL) {
+		return -ENOENT;
+	}
+
+	while (!node->leaf) {
+		idx = child_index(node, key);
+		path[depth] = node;
+		path_idx[depth] = idx;
+		depth++;
+		node = node->children[idx];
+	}
+
+	idx = lower_bound(node, key);
+	if ((idx == node->count) || (node->keys[idx] != key)) {
+		return -ENOENT;
+	}
+
+	if (value != NULL) {
+		*value = node->values[idx];
+	}
+
+	memmove(&node->keys[idx], &node->keys[idx + 1],
+		(node->count - idx - 1) * sizeof(sys_btree_key_t));
+	memmove(&node->values[idx], &node->values[idx + 1],
+		(node->count - idx - 1) * sizeof(void *));
+	node->count--;
+	tree->size--;
+
+	while (depth > 0) {
+		struct sys_btree_node *parent = path[depth - 1];
+		struct sys_btree_node *left, *right;
+		uint8_t min = node->leaf ? LEAF_MIN : INNER_MIN;
+
+		if (node->count >= min) {
+			return 0;
+		}
+
+		idx = path_idx[depth - 1];
+		left = (idx > 0) ? parent->children[idx - 1] : NULL;
+		right = (idx < parent->count) ? parent->children[idx + 1] : NULL;
+
+		if ((left != NULL) && (left->count > min)) {
+			borrow_left(parent, idx, node, left);
+			return 0;
+		}
+
+		if ((right != NULL) && (right->count > min)) {
+			borrow_right(parent, idx, node, right);
+			return 0;
+		}
+
+		merge(tree, parent, (left != NULL) ? (idx - 1) : idx);
+
+		node = parent;
+		depth--;
+	}
+
+	/* Shrink the tree from the top */
+	if (node->count == 0) {
+		if (node->leaf) {
+			tree->root = NULL;
+			tree->first = NULL;
+		} else {
+			tree->root = node->children[0];
+		}
+
+		tree->height--;
+		node_free(tree, node);
+	}
+
+	return 0;
+}
+
+int sys_btree_get(const struct sys_btree *tree, sys_btree_key_t key, void **value)
+{
+	const struct sys_btree_node *node = find_leaf(tree, key);
+	uint8_t idx;
+
+	if (node == NULL) {
+		return -ENOENT;
+	}
+
+	idx = lower_bound(node, key);
+	if ((idx == node->count) || (node->keys[idx] != key)) {
+		return -ENOENT;
+	}
+
+	if (value != NULL) {
+		*value = node->values[idx];
+	}
+
+	return 0;
+}
+
+int sys_btree_get_min(const struct sys_btree *tree, sys_btree_key_t *key, void **value)
+{
+	const struct sys_btree_node *node = tree->first;
+
+	if (node == NULL) {
+		return -ENOENT;
+	}
+
+	if (key != NULL) {
+		*key = node->keys[0];
+	}
+
+	if (value != NULL) {
+		*value = node->values[0];
+	}
+
+	return 0;
+}
+
+int sys_btree_get_max(const struct sys_btree *tree, sys_btree_key_t *key, void **value)
+{
+	const struct sys_btree_node *node = tree->root;
+
+	if (node == NULL) {
+		return -ENOENT;
+	}
+
+	while (!node->leaf) {
+		node = node->children[node->count];
+	}
+
+	if (key != NULL) {
+		*key = node->keys[node->count - 1];
+	}
+
+	if (value != NULL) {
+		*value = node->values[node->count - 1];
+	}
+
+	return 0;
+}
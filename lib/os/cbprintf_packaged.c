@@ -230,8 +230,26 @@ static int append_string(cbprintf_convert_cb cb, void *ctx, const char *str, uin
 	return cb(str, strl, ctx);
 }
 
-int cbvprintf_package(void *packaged, size_t len, uint32_t flags,
-		      const char *fmt, va_list ap)
+/* Get format string of the package, resolving format descriptor if used. */
+static const char *package_fmt(void *packaged)
+{
+	struct cbprintf_package_hdr_ext *hdr = packaged;
+
+#ifdef CONFIG_CBPRINTF_PACKAGE_FMT_DESC
+	if (hdr->hdr.desc.pkg_flags & CBPRINTF_PACKAGE_FMT_DESC) {
+		return ((const struct cbprintf_fmt_desc *)hdr->fmt)->fmt;
+	}
+#endif
+
+	return hdr->fmt;
+}
+
+/*
+ * Create a package. If @p types is not null, it holds types of arguments and
+ * @p fmt is not parsed.
+ */
+static int package(void *packaged, size_t len, uint32_t flags,
+		   const char *fmt, const uint8_t *types, va_list ap)
 {
 /*
  * Internally, a byte is used to store location of a string argument within a
@@ -343,35 +361,48 @@ int cbvprintf_package(void *packaged, size_t len, uint32_t flags,
 	while (true) {
 
 #if defined(CONFIG_CBPRINTF_PACKAGE_SUPPORT_TAGGED_ARGUMENTS)
-		if ((flags & CBPRINTF_PACKAGE_ARGS_ARE_TAGGED)
+		if (types != NULL ||
+		    (flags & CBPRINTF_PACKAGE_ARGS_ARE_TAGGED)
 		    == CBPRINTF_PACKAGE_ARGS_ARE_TAGGED) {
-			int arg_tag = va_arg(ap, int);
+			int arg_tag;
 
-			/*
-			 * Here we copy the tag over to the package.
-			 */
-			align = VA_STACK_ALIGN(int);
-			size = sizeof(int);
+			if (types != NULL) {
+				/*
+				 * Types are known from the format descriptor,
+				 * only values are copied to the package.
+				 */
+				arg_tag = *types++;
+			} else {
+				arg_tag = va_arg(ap, int);
 
-			/* align destination buffer location */
-			buf = (void *)ROUND_UP(buf, align);
+				/*
+				 * Here we copy the tag over to the package.
+				 */
+				align = VA_STACK_ALIGN(int);
+				size = sizeof(int);
 
-			/* make sure the data fits */
-			if (buf0 != NULL && BUF_OFFSET + size > len) {
-				return -ENOSPC;
-			}
+				/* align destination buffer location */
+				buf = (void *)ROUND_UP(buf, align);
 
-			if (buf0 != NULL) {
-				*(int *)buf = arg_tag;
-			}
+				/* make sure the data fits */
+				if (buf0 != NULL && BUF_OFFSET + size > len) {
+					return -ENOSPC;
+				}
 
-			buf += sizeof(int);
+				if (buf0 != NULL) {
+					*(int *)buf = arg_tag;
+				}
+
+				buf += sizeof(int);
+			}
 
 			if (arg_tag == CBPRINTF_PACKAGE_ARG_TYPE_END) {
 				/* End of arguments */
 				break;
 			}
 
+			arg_idx++;
+
 			/*
 			 * There are lots of __fallthrough here since
 			 * quite a few of the data types have the same
@@ -437,14 +468,14 @@ int cbvprintf_package(void *packaged, size_t len, uint32_t flags,
 					}
 					if (Z_CBPRINTF_VA_STACK_LL_DBL_MEMCPY) {
 						memcpy(buf, &v, size);
-					} else if (fmt[-1] == 'L') {
+					} else if (arg_tag ==
+						   CBPRINTF_PACKAGE_ARG_TYPE_LONG_DOUBLE) {
 						*(long double *)buf = v.ld;
 					} else {
 						*(double *)buf = v.d;
 					}
 				}
 				buf += size;
-				parsing = false;
 				continue;
 			}
 
@@ -812,6 +843,12 @@ process_string:
 #undef STR_POS_MASK
 }
 
+int cbvprintf_package(void *packaged, size_t len, uint32_t flags,
+		      const char *fmt, va_list ap)
+{
+	return package(packaged, len, flags, fmt, NULL, ap);
+}
+
 int cbprintf_package(void *packaged, size_t len, uint32_t flags,
 		     const char *format, ...)
 {
@@ -824,6 +861,34 @@ int cbprintf_package(void *packaged, size_t len, uint32_t flags,
 	return ret;
 }
 
+#ifdef CONFIG_CBPRINTF_PACKAGE_FMT_DESC
+int cbvprintf_package_fmt_desc(void *packaged, size_t len, uint32_t flags,
+			       const struct cbprintf_fmt_desc *desc, va_list ap)
+{
+	__ASSERT_NO_MSG(desc != NULL);
+
+	/* Descriptor takes the place of the format string, it is always
+	 * in read-only memory.
+	 */
+	flags &= ~CBPRINTF_PACKAGE_ARGS_ARE_TAGGED;
+	flags |= CBPRINTF_PACKAGE_FMT_DESC;
+
+	return package(packaged, len, flags, (const char *)desc, desc->types, ap);
+}
+
+int cbprintf_package_fmt_desc(void *packaged, size_t len, uint32_t flags,
+			      const struct cbprintf_fmt_desc *desc, ...)
+{
+	va_list ap;
+	int ret;
+
+	va_start(ap, desc);
+	ret = cbvprintf_package_fmt_desc(packaged, len, flags, desc, ap);
+	va_end(ap);
+	return ret;
+}
+#endif /* CONFIG_CBPRINTF_PACKAGE_FMT_DESC */
+
 int cbpprintf_external(cbprintf_cb out,
 		       cbvprintf_external_formatter_func formatter,
 		       void *ctx, void *packaged)
@@ -863,7 +928,7 @@ int cbpprintf_external(cbprintf_cb out,
 	buf += sizeof(*hdr);
 
 	/* Turn this into a va_list and  print it */
-	return cbprintf_via_va_list(out, formatter, ctx, hdr->fmt, buf);
+	return cbprintf_via_va_list(out, formatter, ctx, package_fmt(packaged), buf);
 }
 
 /* Function checks if character might be format specifier. Check is relaxed since
@@ -905,15 +970,14 @@ bool is_ptr(const char *fmt, int n)
 	return false;
 }
 
-int cbprintf_package_convert(void *in_packaged,
-			     size_t in_len,
-			     cbprintf_convert_cb cb,
-			     void *ctx,
-			     uint32_t flags,
-			     uint16_t *strl,
-			     size_t strl_len)
+static int package_convert(void *in_packaged,
+			   size_t in_len,
+			   cbprintf_convert_cb cb,
+			   void *ctx,
+			   uint32_t flags,
+			   uint16_t *strl,
+			   size_t strl_len)
 {
-	__ASSERT_NO_MSG(in_packaged != NULL);
 
 	uint8_t *buf = in_packaged;
 	uint32_t *buf32 = in_packaged;
@@ -962,7 +1026,7 @@ int cbprintf_package_convert(void *in_packaged,
 	/* Pointer to array with string locations. Array starts with read-only
 	 * string locations.
 	 */
-	const char *fmt = *(const char **)(buf + sizeof(void *));
+	const char *fmt = package_fmt(in_packaged);
 	uint8_t *str_pos = &buf[args_size];
 	size_t strl_cnt = 0;
 
@@ -1109,6 +1173,9 @@ calculate_string_length:
 	out_desc.rw_str_cnt = (flags & CBPRINTF_PACKAGE_CONVERT_RW_STR) ? 0 : (keep_cnt / 2);
 	out_desc.ro_str_cnt = (flags & CBPRINTF_PACKAGE_CONVERT_RO_STR) ? 0 :
 			((flags & CBPRINTF_PACKAGE_CONVERT_KEEP_RO_STR) ? keep_cnt : 0);
+#ifdef CONFIG_CBPRINTF_PACKAGE_HEADER_STORE_CREATION_FLAGS
+	out_desc.pkg_flags = in_desc->pkg_flags;
+#endif
 
 	/* Temporary overwrite input descriptor to allow bulk transfer */
 	struct cbprintf_package_desc in_desc_backup = *in_desc;
@@ -1163,3 +1230,40 @@ calculate_string_length:
 
 	return out_len;
 }
+
+int cbprintf_package_convert(void *in_packaged,
+			     size_t in_len,
+			     cbprintf_convert_cb cb,
+			     void *ctx,
+			     uint32_t flags,
+			     uint16_t *strl,
+			     size_t strl_len)
+{
+	__ASSERT_NO_MSG(in_packaged != NULL);
+
+#ifdef CONFIG_CBPRINTF_PACKAGE_FMT_DESC
+	struct cbprintf_package_hdr_ext *hdr = in_packaged;
+
+	if ((hdr->hdr.desc.pkg_flags & CBPRINTF_PACKAGE_FMT_DESC) &&
+	    (flags & (CBPRINTF_PACKAGE_CONVERT_EXPAND_FMT_DESC |
+		      CBPRINTF_PACKAGE_CONVERT_RO_STR))) {
+		char *desc = hdr->fmt;
+		int rv;
+
+		/* Temporary put format string in place of the descriptor so
+		 * that it is copied (or appended) as in any other package.
+		 */
+		hdr->fmt = (char *)((const struct cbprintf_fmt_desc *)desc)->fmt;
+		hdr->hdr.desc.pkg_flags &= ~CBPRINTF_PACKAGE_FMT_DESC;
+
+		rv = package_convert(in_packaged, in_len, cb, ctx, flags, strl, strl_len);
+
+		hdr->fmt = desc;
+		hdr->hdr.desc.pkg_flags |= CBPRINTF_PACKAGE_FMT_DESC;
+
+		return rv;
+	}
+#endif
+
+	return package_convert(in_packaged, in_len, cb, ctx, flags, strl, strl_len);
+}
@@ -316,6 +316,132 @@ out:
 	return ret;
 }
 
+/* Bitarray regions are converted to memory block regions in place. */
+BUILD_ASSERT(sizeof(struct sys_mem_blocks_region) == sizeof(struct sys_bitarray_region));
+BUILD_ASSERT(offsetof(struct sys_mem_blocks_region, block) ==
+	     offsetof(struct sys_bitarray_region, offset));
+BUILD_ASSERT(offsetof(struct sys_mem_blocks_region, count) ==
+	     offsetof(struct sys_bitarray_region, num_bits));
+
+int sys_mem_blocks_alloc_scatter(sys_mem_blocks_t *mem_block, size_t count,
+				 size_t max_regions,
+				 struct sys_mem_blocks_region *out_regions)
+{
+	struct sys_bitarray_region *ba_regions =
+		(struct sys_bitarray_region *)out_regions;
+	int ret = 0;
+
+	__ASSERT_NO_MSG(mem_block != NULL);
+	__ASSERT_NO_MSG(out_regions != NULL);
+	__ASSERT_NO_MSG(mem_block->bitmap != NULL);
+	__ASSERT_NO_MSG(mem_block->buffer != NULL);
+
+	if (count == 0) {
+		/* Nothing to allocate */
+		goto out;
+	}
+
+	if (max_regions == 0) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	if (count > mem_block->num_blocks) {
+		/* Definitely not enough blocks to be allocated */
+		ret = -ENOMEM;
+		goto out;
+	}
+
+#ifdef CONFIG_SYS_MEM_BLOCKS_RUNTIME_STATS
+	k_spinlock_key_t  key = k_spin_lock(&mem_block->lock);
+#endif
+
+	ret = sys_bitarray_alloc_scatter(mem_block->bitmap, count,
+					 max_regions, ba_regions);
+
+#ifdef CONFIG_SYS_MEM_BLOCKS_RUNTIME_STATS
+	if (ret > 0) {
+		mem_block->used_blocks += (uint32_t)count;
+
+		if (mem_block->max_used_blocks < mem_block->used_blocks) {
+			mem_block->max_used_blocks = mem_block->used_blocks;
+		}
+	}
+
+	k_spin_unlock(&mem_block->lock, key);
+#endif
+
+	if (ret < 0) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	for (int i = 0; i < ret; i++) {
+		size_t offset = ba_regions[i].offset;
+		size_t num_blocks = ba_regions[i].num_bits;
+
+		out_regions[i].block = mem_block->buffer + (offset << mem_block->blk_sz_shift);
+		out_regions[i].count = num_blocks;
+
+#ifdef CONFIG_SYS_MEM_BLOCKS_LISTENER
+		heap_listener_notify_alloc(HEAP_ID_FROM_POINTER(mem_block),
+					   out_regions[i].block,
+					   num_blocks << mem_block->blk_sz_shift);
+#endif
+	}
+
+out:
+	return ret;
+}
+
+int sys_mem_blocks_free_scatter(sys_mem_blocks_t *mem_block, size_t num_regions,
+				struct sys_mem_blocks_region *in_regions)
+{
+	int ret = 0;
+
+	__ASSERT_NO_MSG(mem_block != NULL);
+	__ASSERT_NO_MSG(in_regions != NULL);
+	__ASSERT_NO_MSG(mem_block->bitmap != NULL);
+	__ASSERT_NO_MSG(mem_block->buffer != NULL);
+
+	/* Check bounds of all regions first, so that nothing is freed on error. */
+	for (size_t i = 0; i < num_regions; i++) {
+		uint8_t *blk = in_regions[i].block;
+		size_t offset;
+
+		if ((in_regions[i].count == 0) ||
+		    (in_regions[i].count > mem_block->num_blocks) ||
+		    (blk < mem_block->buffer)) {
+			ret = -EFAULT;
+			goto out;
+		}
+
+		offset = (blk - mem_block->buffer) >> mem_block->blk_sz_shift;
+		if (offset + in_regions[i].count > mem_block->num_blocks) {
+			ret = -EFAULT;
+			goto out;
+		}
+	}
+
+	for (size_t i = 0; i < num_regions; i++) {
+		int r = free_blocks(mem_block, in_regions[i].block, in_regions[i].count);
+
+		if (r != 0) {
+			ret = r;
+			continue;
+		}
+
+#ifdef CONFIG_SYS_MEM_BLOCKS_LISTENER
+		heap_listener_notify_free(HEAP_ID_FROM_POINTER(mem_block),
+					  in_regions[i].block,
+					  in_regions[i].count << mem_block->blk_sz_shift);
+#endif
+	}
+
+out:
+	return ret;
+}
+
 void sys_multi_mem_blocks_init(sys_multi_mem_blocks_t *group,
 			       sys_multi_mem_blocks_choice_fn_t choice_fn)
 {
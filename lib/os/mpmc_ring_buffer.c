@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Bounded multi-producer, multi-consumer queue based on per-slot sequence
+ * numbers. A slot at index i is free for the producer of position p when its
+ * sequence number equals p, and it holds a record for the consumer of
+ * position p when its sequence number equals p + 1. Positions are claimed
+ * with a compare-and-swap, after which the slot is owned exclusively until
+ * the sequence number is advanced by the matching finish call.
+ *
+ * Sequence numbers are stored as (seq - i) so that a zero initialized slot
+ * array is valid. Committing a put then is a single increment and releasing
+ * a get is an addition of (slot count - 1).
+ */
+
+#include <zephyr/sys/mpmc_ring_buffer.h>
+#include <string.h>
+
+/* Length marker of a slot abandoned by its producer. */
+#define SLOT_DISCARDED UINT32_MAX
+
+static inline unsigned long slot_seq(struct mpmc_ring_buf *buf, uint32_t idx)
+{
+	return (unsigned long)atomic_get(&buf->slots[idx].seq) + idx;
+}
+
+static inline uint8_t *slot_data(struct mpmc_ring_buf *buf, uint32_t idx)
+{
+	return &buf->buffer[idx * buf->slot_size];
+}
+
+static inline uint32_t slot_idx(struct mpmc_ring_buf *buf, uint8_t *data)
+{
+	uint32_t offset = data - buf->buffer;
+
+	__ASSERT((data >= buf->buffer) && ((offset % buf->slot_size) == 0) &&
+		 ((offset / buf->slot_size) <= buf->slot_mask),
+		 "Invalid slot address %p", data);
+
+	return offset / buf->slot_size;
+}
+
+/* Claim a free slot. Returns slot index or -ENOMEM if all slots are used. */
+static int put_acquire(struct mpmc_ring_buf *buf)
+{
+	unsigned long pos = (unsigned long)atomic_get(&buf->put_pos);
+
+	for (;;) {
+		uint32_t idx = pos & buf->slot_mask;
+		long diff = (long)(slot_seq(buf, idx) - pos);
+
+		if (diff == 0) {
+			if (atomic_cas(&buf->put_pos, (atomic_val_t)pos,
+				       (atomic_val_t)(pos + 1))) {
+				return idx;
+			}
+		} else if (diff < 0) {
+			/* Slot still holds a record from the previous lap. */
+			return -ENOMEM;
+		}
+
+		/* Another producer got ahead of us. */
+		pos = (unsigned long)atomic_get(&buf->put_pos);
+	}
+}
+
+static void put_release(struct mpmc_ring_buf *buf, uint32_t idx)
+{
+	/* seq: pos -> pos + 1. Publishes len and data stored before. */
+	(void)atomic_inc(&buf->slots[idx].seq);
+}
+
+/* Claim the oldest record. Records longer than max_len are not claimed and
+ * their length is reported in @p len instead.
+ *
+ * Returns slot index, -EAGAIN if the ring buffer is empty or -EMSGSIZE.
+ */
+static int get_acquire(struct mpmc_ring_buf *buf, uint32_t max_len,
+		       uint32_t *len)
+{
+	unsigned long pos = (unsigned long)atomic_get(&buf->get_pos);
+
+	for (;;) {
+		uint32_t idx = pos & buf->slot_mask;
+		long diff = (long)(slot_seq(buf, idx) - (pos + 1));
+
+		if (diff == 0) {
+			/* Slot content is stable for as long as get_pos
+			 * equals pos, so it is safe to inspect it before
+			 * the claim.
+			 */
+			uint32_t rec_len = buf->slots[idx].len;
+
+			if ((rec_len != SLOT_DISCARDED) && (rec_len > max_len)) {
+				*len = rec_len;
+				return -EMSGSIZE;
+			}
+
+			if (atomic_cas(&buf->get_pos, (atomic_val_t)pos,
+				       (atomic_val_t)(pos + 1))) {
+				if (rec_len != SLOT_DISCARDED) {
+					*len = rec_len;
+					return idx;
+				}
+
+				/* Skip abandoned slot. */
+				(void)atomic_add(&buf->slots[idx].seq,
+						 (atomic_val_t)buf->slot_mask);
+			}
+		} else if (diff < 0) {
+			return -EAGAIN;
+		}
+
+		pos = (unsigned long)atomic_get(&buf->get_pos);
+	}
+}
+
+static void get_release(struct mpmc_ring_buf *buf, uint32_t idx)
+{
+	/* seq: pos + 1 -> pos + slot count, slot is free for the next lap. */
+	(void)atomic_add(&buf->slots[idx].seq, (atomic_val_t)buf->slot_mask);
+}
+
+uint32_t mpmc_ring_buf_put_claim(struct mpmc_ring_buf *buf, uint8_t **data,
+				 uint32_t size)
+{
+	int idx;
+
+	if (size == 0) {
+		return 0;
+	}
+
+	idx = put_acquire(buf);
+	if (idx < 0) {
+		return 0;
+	}
+
+	size = MIN(size, buf->slot_size);
+	buf->slots[idx].len = size;
+	*data = slot_data(buf, idx);
+
+	return size;
+}
+
+int mpmc_ring_buf_put_finish(struct mpmc_ring_buf *buf, uint8_t *data,
+			     uint32_t size)
+{
+	uint32_t idx = slot_idx(buf, data);
+	struct mpmc_ring_buf_slot *slot = &buf->slots[idx];
+
+	if (unlikely(size > slot->len)) {
+		return -EINVAL;
+	}
+
+	slot->len = (size == 0) ? SLOT_DISCARDED : size;
+	put_release(buf, idx);
+
+	return 0;
+}
+
+uint32_t mpmc_ring_buf_put(struct mpmc_ring_buf *buf, const uint8_t *data,
+			   uint32_t size)
+{
+	uint8_t *dst;
+	int err;
+
+	size = mpmc_ring_buf_put_claim(buf, &dst, size);
+	if (size == 0) {
+		return 0;
+	}
+
+	memcpy(dst, data, size);
+
+	err = mpmc_ring_buf_put_finish(buf, dst, size);
+	__ASSERT_NO_MSG(err == 0);
+	ARG_UNUSED(err);
+
+	return size;
+}
+
+uint32_t mpmc_ring_buf_get_claim(struct mpmc_ring_buf *buf, uint8_t **data,
+				 uint32_t size)
+{
+	uint32_t len;
+	int idx;
+
+	if (size == 0) {
+		return 0;
+	}
+
+	idx = get_acquire(buf, UINT32_MAX - 1, &len);
+	if (idx < 0) {
+		return 0;
+	}
+
+	*data = slot_data(buf, idx);
+
+	return MIN(size, len);
+}
+
+int mpmc_ring_buf_get_finish(struct mpmc_ring_buf *buf, uint8_t *data,
+			     uint32_t size)
+{
+	uint32_t idx = slot_idx(buf, data);
+
+	if (unlikely(size > buf->slots[idx].len)) {
+		return -EINVAL;
+	}
+
+	get_release(buf, idx);
+
+	return 0;
+}
+
+uint32_t mpmc_ring_buf_get(struct mpmc_ring_buf *buf, uint8_t *data,
+			   uint32_t size)
+{
+	uint8_t *src;
+	int err;
+
+	size = mpmc_ring_buf_get_claim(buf, &src, size);
+	if (size == 0) {
+		return 0;
+	}
+
+	if (data) {
+		memcpy(data, src, size);
+	}
+
+	err = mpmc_ring_buf_get_finish(buf, src, size);
+	__ASSERT_NO_MSG(err == 0);
+	ARG_UNUSED(err);
+
+	return size;
+}
+
+int mpmc_ring_buf_item_put(struct mpmc_ring_buf *buf, uint16_t type,
+			   uint8_t value, uint32_t *data, uint8_t size32)
+{
+	uint32_t size = size32 * sizeof(uint32_t);
+	struct mpmc_ring_buf_slot *slot;
+	int idx;
+
+	if (size > buf->slot_size) {
+		return -EMSGSIZE;
+	}
+
+	idx = put_acquire(buf);
+	if (idx < 0) {
+		return -EMSGSIZE;
+	}
+
+	slot = &buf->slots[idx];
+	slot->len = size;
+	slot->type = type;
+	slot->value = value;
+	memcpy(slot_data(buf, idx), data, size);
+
+	put_release(buf, idx);
+
+	return 0;
+}
+
+int mpmc_ring_buf_item_get(struct mpmc_ring_buf *buf, uint16_t *type,
+			   uint8_t *value, uint32_t *data, uint8_t *size32)
+{
+	struct mpmc_ring_buf_slot *slot;
+	uint32_t max_len = data ? *size32 * sizeof(uint32_t) : UINT32_MAX - 1;
+	uint32_t len;
+	int idx;
+
+	idx = get_acquire(buf, max_len, &len);
+	if (idx == -EMSGSIZE) {
+		*size32 = len / sizeof(uint32_t);
+		return -EMSGSIZE;
+	} else if (idx < 0) {
+		return -EAGAIN;
+	}
+
+	slot = &buf->slots[idx];
+	*size32 = len / sizeof(uint32_t);
+	*type = slot->type;
+	*value = slot->value;
+	if (data) {
+		memcpy(data, slot_data(buf, idx), len);
+	}
+
+	get_release(buf, idx);
+
+	return 0;
+}
@@ -0,0 +1,510 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* The objects behind the watched descriptors already signal their
+ * readiness through kernel poll objects (the socket receive queues and
+ * send semaphores, socketpair and eventfd signals). Each watched descriptor
+ * has a triggered work item registered on these objects, which moves the
+ * descriptor to the ready list of its epoll instance when one of them is
+ * signaled. epoll_wait() then only has to look at the ready list.
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/dlist.h>
+#include <zephyr/sys/fdtable.h>
+#include <zephyr/posix/sys/epoll.h>
+#include <zephyr/net/socket.h>
+
+/* At most one poll event for input and one for output per descriptor */
+#define EPOLL_POLL_EVENTS 2
+
+struct epoll_instance;
+
+struct epoll_item {
+	sys_dnode_t ready_node;
+	struct k_work_poll work;
+	struct k_poll_event poll_events[EPOLL_POLL_EVENTS];
+	struct epoll_instance *ep;
+	const struct fd_op_vtable *vtable;
+	void *obj;
+	struct k_mutex *lock;
+	epoll_data_t data;
+	uint32_t events;
+	int fd;
+};
+
+struct epoll_instance {
+	struct epoll_item items[CONFIG_EPOLL_MAX_FDS];
+	/* Items to look at in epoll_wait(), protected by lock */
+	sys_dlist_t ready;
+	struct k_spinlock lock;
+	/* Serializes epoll_ctl() and the collecting of events */
+	struct k_mutex mutex;
+	struct k_sem ready_sem;
+	bool in_use;
+};
+
+K_MUTEX_DEFINE(epoll_mtx);
+static struct epoll_instance instances[CONFIG_EPOLL_MAX];
+
+static const struct fd_op_vtable epoll_fd_vtable;
+
+static void epoll_mark_ready(struct epoll_item *item)
+{
+	struct epoll_instance *ep = item->ep;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&ep->lock);
+
+	if (!sys_dnode_is_linked(&item->ready_node)) {
+		sys_dlist_append(&ep->ready, &item->ready_node);
+	}
+
+	k_spin_unlock(&ep->lock, key);
+
+	k_sem_give(&ep->ready_sem);
+}
+
+static void epoll_work_handler(struct k_work *work)
+{
+	struct k_work_poll *pwork = CONTAINER_OF(work, struct k_work_poll, work);
+	struct epoll_item *item = CONTAINER_OF(pwork, struct epoll_item, work);
+
+	epoll_mark_ready(item);
+}
+
+static int epoll_poll_prepare(struct epoll_item *item, struct zsock_pollfd *pfd,
+			      struct k_poll_event **pev,
+			      struct k_poll_event *pev_end)
+{
+	pfd->fd = item->fd;
+	pfd->events = item->events & (EPOLLIN | EPOLLOUT);
+	pfd->revents = 0;
+
+	return z_fdtable_call_ioctl(item->vtable, item->obj,
+				    ZFD_IOCTL_POLL_PREPARE, pfd, pev, pev_end);
+}
+
+/* Get notified once the descriptor becomes ready */
+static int epoll_arm(struct epoll_item *item)
+{
+	struct k_poll_event *pev = item->poll_events;
+	struct zsock_pollfd pfd;
+	int ret;
+
+	if (!(item->events & (EPOLLIN | EPOLLOUT))) {
+		/* Disabled after a one-shot report */
+		return 0;
+	}
+
+	k_mutex_lock(item->lock, K_FOREVER);
+	ret = epoll_poll_prepare(item, &pfd, &pev,
+				 item->poll_events + EPOLL_POLL_EVENTS);
+	k_mutex_unlock(item->lock);
+
+	if (ret == -EALREADY) {
+		epoll_mark_ready(item);
+		return 0;
+	}
+
+	if (ret < 0) {
+		return -EPERM;
+	}
+
+	if (pev == item->poll_events) {
+		return 0;
+	}
+
+	return k_work_poll_submit(&item->work, item->poll_events,
+				  pev - item->poll_events, K_FOREVER);
+}
+
+static void epoll_disarm(struct epoll_item *item)
+{
+	struct epoll_instance *ep = item->ep;
+	struct k_work_sync sync;
+	k_spinlock_key_t key;
+
+	if (k_work_poll_cancel(&item->work) != 0) {
+		/* Already triggered, let the handler complete */
+		(void)k_work_flush(&item->work.work, &sync);
+	}
+
+	key = k_spin_lock(&ep->lock);
+
+	if (sys_dnode_is_linked(&item->ready_node)) {
+		sys_dlist_remove(&item->ready_node);
+	}
+
+	k_spin_unlock(&ep->lock, key);
+}
+
+/* Return the events the descriptor is currently ready for */
+static uint32_t epoll_check(struct epoll_item *item)
+{
+	struct k_poll_event poll_events[EPOLL_POLL_EVENTS];
+	struct k_poll_event *pev = poll_events;
+	struct zsock_pollfd pfd;
+	int ret;
+
+	k_mutex_lock(item->lock, K_FOREVER);
+
+	ret = epoll_poll_prepare(item, &pfd, &pev,
+				 poll_events + EPOLL_POLL_EVENTS);
+	if (ret == 0 || ret == -EALREADY) {
+		if (pev != poll_events) {
+			(void)k_poll(poll_events, pev - poll_events, K_NO_WAIT);
+		}
+
+		pev = poll_events;
+		ret = z_fdtable_call_ioctl(item->vtable, item->obj,
+					   ZFD_IOCTL_POLL_UPDATE, &pfd, &pev);
+	}
+
+	k_mutex_unlock(item->lock);
+
+	if (ret != 0) {
+		return 0;
+	}
+
+	return pfd.revents & (item->events | EPOLLERR | EPOLLHUP);
+}
+
+static int epoll_collect(struct epoll_instance *ep, struct epoll_event *events,
+			 int maxevents)
+{
+	sys_dlist_t pending, reported;
+	k_spinlock_key_t key;
+	sys_dnode_t *node;
+	int count = 0;
+
+	sys_dlist_init(&pending);
+	sys_dlist_init(&reported);
+
+	key = k_spin_lock(&ep->lock);
+
+	while ((node = sys_dlist_get(&ep->ready)) != NULL) {
+		sys_dlist_append(&pending, node);
+	}
+
+	k_spin_unlock(&ep->lock, key);
+
+	while (count < maxevents &&
+	       (node = sys_dlist_get(&pending)) != NULL) {
+		struct epoll_item *item =
+			CONTAINER_OF(node, struct epoll_item, ready_node);
+		uint32_t revents;
+
+		revents = epoll_check(item);
+		if (revents == 0) {
+			(void)epoll_arm(item);
+			continue;
+		}
+
+		events[count].events = revents;
+		events[count].data = item->data;
+		count++;
+
+		if (item->events & EPOLLONESHOT) {
+			item->events &= EPOLLONESHOT | EPOLLET;
+		} else if (item->events & EPOLLET) {
+			(void)epoll_arm(item);
+		} else {
+			/* Level-triggered, check again on the next call */
+			sys_dlist_append(&reported, node);
+		}
+	}
+
+	key = k_spin_lock(&ep->lock);
+
+	/* Items not looked at go first, reported ones last */
+	while ((node = sys_dlist_peek_tail(&pending)) != NULL) {
+		sys_dlist_remove(node);
+		sys_dlist_prepend(&ep->ready, node);
+	}
+
+	while ((node = sys_dlist_get(&reported)) != NULL) {
+		sys_dlist_append(&ep->ready, node);
+	}
+
+	k_spin_unlock(&ep->lock, key);
+
+	return count;
+}
+
+static struct epoll_item *epoll_find(struct epoll_instance *ep, int fd)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(ep->items); i++) {
+		if (ep->items[i].fd == fd) {
+			return &ep->items[i];
+		}
+	}
+
+	return NULL;
+}
+
+static int epoll_add(struct epoll_instance *ep, int fd,
+		     const struct epoll_event *event)
+{
+	const struct fd_op_vtable *vtable;
+	struct epoll_item *item;
+	struct k_mutex *lock;
+	void *obj;
+	int ret;
+
+	obj = z_get_fd_obj_and_vtable(fd, &vtable, &lock);
+	if (obj == NULL) {
+		return -EBADF;
+	}
+
+	if (vtable == &epoll_fd_vtable) {
+		return -EINVAL;
+	}
+
+	item = epoll_find(ep, -1);
+	if (item == NULL) {
+		return -ENOSPC;
+	}
+
+	item->ep = ep;
+	item->vtable = vtable;
+	item->obj = obj;
+	item->lock = lock;
+	item->data = event->data;
+	item->events = event->events;
+	item->fd = fd;
+
+	sys_dnode_init(&item->ready_node);
+	k_work_poll_init(&item->work, epoll_work_handler);
+
+	ret = epoll_arm(item);
+	if (ret < 0) {
+		epoll_disarm(item);
+		item->fd = -1;
+	}
+
+	return ret;
+}
+
+static int epoll_close_op(void *obj)
+{
+	struct epoll_instance *ep = obj;
+
+	k_mutex_lock(&ep->mutex, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(ep->items); i++) {
+		if (ep->items[i].fd >= 0) {
+			epoll_disarm(&ep->items[i]);
+			ep->items[i].fd = -1;
+		}
+	}
+
+	k_mutex_unlock(&ep->mutex);
+
+	k_mutex_lock(&epoll_mtx, K_FOREVER);
+	ep->in_use = false;
+	k_mutex_unlock(&epoll_mtx);
+
+	return 0;
+}
+
+static ssize_t epoll_read_op(void *obj, void *buf, size_t sz)
+{
+	errno = EINVAL;
+	return -1;
+}
+
+static ssize_t epoll_write_op(void *obj, const void *buf, size_t sz)
+{
+	errno = EINVAL;
+	return -1;
+}
+
+static int epoll_ioctl_op(void *obj, unsigned int request, va_list args)
+{
+	errno = EOPNOTSUPP;
+	return -1;
+}
+
+static const struct fd_op_vtable epoll_fd_vtable = {
+	.read = epoll_read_op,
+	.write = epoll_write_op,
+	.close = epoll_close_op,
+	.ioctl = epoll_ioctl_op,
+};
+
+int epoll_create1(int flags)
+{
+	struct epoll_instance *ep = NULL;
+	int fd = -1;
+	int i;
+
+	if (flags != 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	k_mutex_lock(&epoll_mtx, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(instances); ++i) {
+		if (!instances[i].in_use) {
+			ep = &instances[i];
+			break;
+		}
+	}
+
+	if (ep == NULL) {
+		errno = ENOMEM;
+		goto exit_mtx;
+	}
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		goto exit_mtx;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(ep->items); ++i) {
+		ep->items[i].fd = -1;
+	}
+
+	sys_dlist_init(&ep->ready);
+	k_mutex_init(&ep->mutex);
+	k_sem_init(&ep->ready_sem, 0, 1);
+	ep->in_use = true;
+
+	z_finalize_fd(fd, ep, &epoll_fd_vtable);
+
+exit_mtx:
+	k_mutex_unlock(&epoll_mtx);
+	return fd;
+}
+
+int epoll_create(int size)
+{
+	if (size <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	return epoll_create1(0);
+}
+
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event)
+{
+	struct epoll_instance *ep;
+	struct epoll_item *item;
+	int ret = 0;
+
+	ep = z_get_fd_obj(epfd, &epoll_fd_vtable, EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	if (fd < 0 || fd == epfd) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (op != EPOLL_CTL_DEL && event == NULL) {
+		errno = EFAULT;
+		return -1;
+	}
+
+	k_mutex_lock(&ep->mutex, K_FOREVER);
+
+	item = epoll_find(ep, fd);
+
+	switch (op) {
+	case EPOLL_CTL_ADD:
+		ret = item != NULL ? -EEXIST : epoll_add(ep, fd, event);
+		break;
+
+	case EPOLL_CTL_MOD:
+		if (item == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		epoll_disarm(item);
+		item->data = event->data;
+		item->events = event->events;
+		ret = epoll_arm(item);
+		break;
+
+	case EPOLL_CTL_DEL:
+		if (item == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		epoll_disarm(item);
+		item->fd = -1;
+		break;
+
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	k_mutex_unlock(&ep->mutex);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return 0;
+}
+
+int epoll_wait(int epfd, struct epoll_event *events, int maxevents,
+	       int timeout)
+{
+	struct epoll_instance *ep;
+	k_timeout_t ktimeout;
+	uint64_t end;
+	int count;
+
+	ep = z_get_fd_obj(epfd, &epoll_fd_vtable, EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	if (events == NULL || maxevents <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	ktimeout = timeout < 0 ? K_FOREVER : K_MSEC(timeout);
+	end = sys_clock_timeout_end_calc(ktimeout);
+
+	while (true) {
+		k_mutex_lock(&ep->mutex, K_FOREVER);
+		count = epoll_collect(ep, events, maxevents);
+		k_mutex_unlock(&ep->mutex);
+
+		if (count > 0 || K_TIMEOUT_EQ(ktimeout, K_NO_WAIT)) {
+			break;
+		}
+
+		if (!K_TIMEOUT_EQ(ktimeout, K_FOREVER)) {
+			int64_t remaining = end - sys_clock_tick_get();
+
+			if (remaining <= 0) {
+				break;
+			}
+
+			ktimeout = Z_TIMEOUT_TICKS(remaining);
+		}
+
+		if (k_sem_take(&ep->ready_sem, ktimeout) != 0) {
+			/* Last look before reporting the timeout */
+			ktimeout = K_NO_WAIT;
+		}
+	}
+
+	return count;
+}
@@ -89,6 +89,20 @@ static inline void z_vrfy_z_log_msg_static_create(const void *source,
 #include <syscalls/z_log_msg_static_create_mrsh.c>
 #endif
 
+static int log_package(void *pkg, size_t len, uint32_t package_flags,
+		       const char *fmt, va_list ap)
+{
+#ifdef CONFIG_LOG_FMT_DESC
+	if (package_flags & CBPRINTF_PACKAGE_FMT_DESC) {
+		return cbvprintf_package_fmt_desc(pkg, len, package_flags,
+						  (const struct cbprintf_fmt_desc *)fmt,
+						  ap);
+	}
+#endif
+
+	return cbvprintf_package(pkg, len, package_flags, fmt, ap);
+}
+
 void z_impl_z_log_msg_runtime_vcreate(uint8_t domain_id, const void *source,
 				uint8_t level, const void *data, size_t dlen,
 				uint32_t package_flags, const char *fmt, va_list ap)
@@ -99,8 +113,8 @@ void z_impl_z_log_msg_runtime_vcreate(uint8_t domain_id, const void *source,
 		va_list ap2;
 
 		va_copy(ap2, ap);
-		plen = cbvprintf_package(NULL, Z_LOG_MSG2_ALIGN_OFFSET,
-					 package_flags, fmt, ap2);
+		plen = log_package(NULL, Z_LOG_MSG2_ALIGN_OFFSET,
+				   package_flags, fmt, ap2);
 		__ASSERT_NO_MSG(plen >= 0);
 		va_end(ap2);
 	} else {
@@ -126,7 +140,7 @@ void z_impl_z_log_msg_runtime_vcreate(uint8_t domain_id, const void *source,
 	}
 
 	if (pkg && fmt) {
-		plen = cbvprintf_package(pkg, (size_t)plen, package_flags, fmt, ap);
+		plen = log_package(pkg, (size_t)plen, package_flags, fmt, ap);
 		__ASSERT_NO_MSG(plen >= 0);
 	}
 
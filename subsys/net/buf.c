@@ -55,11 +55,29 @@ static int pool_id(struct net_buf_pool *pool)
 	return pool - _net_buf_pool_list;
 }
 
+static size_t pool_struct_size(struct net_buf_pool *pool)
+{
+	return ROUND_UP(sizeof(struct net_buf) + pool->user_data_size +
+			pool->inline_size, __alignof__(struct net_buf));
+}
+
+/* Inline data is placed right after the user data of the buffer */
+static uint8_t *inline_data(struct net_buf *buf)
+{
+	return buf->user_data + buf->user_data_size;
+}
+
+static bool is_inline_data(struct net_buf *buf, uint8_t *data)
+{
+	struct net_buf_pool *pool = net_buf_pool_get(buf->pool_id);
+
+	return pool->inline_size > 0 && data == inline_data(buf);
+}
+
 int net_buf_id(struct net_buf *buf)
 {
 	struct net_buf_pool *pool = net_buf_pool_get(buf->pool_id);
-	size_t struct_size = ROUND_UP(sizeof(struct net_buf) + pool->user_data_size,
-				__alignof__(struct net_buf));
+	size_t struct_size = pool_struct_size(pool);
 	ptrdiff_t offset = (uint8_t *)buf - (uint8_t *)pool->__bufs;
 
 	return offset / struct_size;
@@ -68,8 +86,7 @@ int net_buf_id(struct net_buf *buf)
 static inline struct net_buf *pool_get_uninit(struct net_buf_pool *pool,
 					      uint16_t uninit_count)
 {
-	size_t struct_size = ROUND_UP(sizeof(struct net_buf) + pool->user_data_size,
-				__alignof__(struct net_buf));
+	size_t struct_size = pool_struct_size(pool);
 	size_t byte_offset = (pool->buf_count - uninit_count) * struct_size;
 	struct net_buf *buf;
 
@@ -146,17 +163,72 @@ static uint8_t *fixed_data_alloc(struct net_buf *buf, size_t *size,
 {
 	struct net_buf_pool *pool = net_buf_pool_get(buf->pool_id);
 	const struct net_buf_pool_fixed *fixed = pool->alloc->alloc_data;
+	int id = net_buf_id(buf);
 
 	*size = MIN(fixed->data_size, *size);
 
-	return fixed->data_pool + fixed->data_size * net_buf_id(buf);
+	if (!fixed->data_size) {
+		return fixed->data_pool;
+	}
+
+	/* The chunk of the buffer is free unless clones of its previous
+	 * user still reference it. There are as many chunks as buffers and
+	 * a buffer references at most one chunk, so another one is free.
+	 */
+	if (!atomic_cas(&fixed->data_refs[id], 0, 1)) {
+		for (id = 0; id < pool->buf_count; id++) {
+			if (atomic_cas(&fixed->data_refs[id], 0, 1)) {
+				break;
+			}
+		}
+
+		if (id == pool->buf_count) {
+			return NULL;
+		}
+	}
+
+	return fixed->data_pool + fixed->data_size * id;
+}
+
+static atomic_t *fixed_data_refs(struct net_buf *buf, uint8_t *data)
+{
+	struct net_buf_pool *pool = net_buf_pool_get(buf->pool_id);
+	const struct net_buf_pool_fixed *fixed = pool->alloc->alloc_data;
+	size_t offset = data - fixed->data_pool;
+
+	/* Some users point the buffer to data of their own */
+	if (!fixed->data_size || data < fixed->data_pool ||
+	    offset >= fixed->data_size * pool->buf_count) {
+		return NULL;
+	}
+
+	return &fixed->data_refs[offset / fixed->data_size];
+}
+
+static uint8_t *fixed_data_ref(struct net_buf *buf, uint8_t *data)
+{
+	atomic_t *refs = fixed_data_refs(buf, data);
+
+	if (refs) {
+		atomic_inc(refs);
+	}
+
+	return data;
 }
 
 static void fixed_data_unref(struct net_buf *buf, uint8_t *data)
 {
-	/* Nothing needed for fixed-size data pools */
+	atomic_t *refs = fixed_data_refs(buf, data);
+
+	if (refs) {
+		atomic_dec(refs);
+	}
 }
 
+/* No ref callback: net_buf_clone() keeps copying the data of fixed pools,
+ * as users may push into the headroom of the clone. Sharing is only done
+ * on request, with net_buf_shared_clone().
+ */
 const struct net_buf_data_cb net_buf_fixed_cb = {
 	.alloc = fixed_data_alloc,
 	.unref = fixed_data_unref,
@@ -207,6 +279,10 @@ static uint8_t *data_alloc(struct net_buf *buf, size_t *size, k_timeout_t timeou
 {
 	struct net_buf_pool *pool = net_buf_pool_get(buf->pool_id);
 
+	if (*size <= pool->inline_size) {
+		return inline_data(buf);
+	}
+
 	return pool->alloc->cb->alloc(buf, size, timeout);
 }
 
@@ -221,7 +297,7 @@ static void data_unref(struct net_buf *buf, uint8_t *data)
 {
 	struct net_buf_pool *pool = net_buf_pool_get(buf->pool_id);
 
-	if (buf->flags & NET_BUF_EXTERNAL_DATA) {
+	if ((buf->flags & NET_BUF_EXTERNAL_DATA) || is_inline_data(buf, data)) {
 		return;
 	}
 
@@ -559,9 +635,11 @@ struct net_buf *net_buf_clone(struct net_buf *buf, k_timeout_t timeout)
 	}
 
 	/* If the pool supports data referencing use that. Otherwise
-	 * we need to allocate new data and make a copy.
+	 * we need to allocate new data and make a copy. Inline data
+	 * belongs to the original buffer, so it is always copied.
 	 */
-	if (pool->alloc->cb->ref && !(buf->flags & NET_BUF_EXTERNAL_DATA)) {
+	if (pool->alloc->cb->ref && !(buf->flags & NET_BUF_EXTERNAL_DATA) &&
+	    !is_inline_data(buf, buf->__buf)) {
 		clone->__buf = data_ref(buf, buf->__buf);
 		clone->data = buf->data;
 		clone->len = buf->len;
@@ -594,6 +672,40 @@ struct net_buf *net_buf_clone(struct net_buf *buf, k_timeout_t timeout)
 	return clone;
 }
 
+struct net_buf *net_buf_shared_clone(struct net_buf *buf, k_timeout_t timeout)
+{
+	struct net_buf_pool *pool;
+	struct net_buf *clone;
+	uint8_t *(*ref)(struct net_buf *buf, uint8_t *data);
+
+	__ASSERT_NO_MSG(buf);
+
+	pool = net_buf_pool_get(buf->pool_id);
+
+	if (pool->alloc->cb == &net_buf_fixed_cb) {
+		ref = fixed_data_ref;
+	} else {
+		ref = pool->alloc->cb->ref;
+	}
+
+	if (!ref || !buf->__buf || (buf->flags & NET_BUF_EXTERNAL_DATA) ||
+	    is_inline_data(buf, buf->__buf)) {
+		return net_buf_clone(buf, timeout);
+	}
+
+	clone = net_buf_alloc_len(pool, 0, timeout);
+	if (!clone) {
+		return NULL;
+	}
+
+	clone->__buf = ref(buf, buf->__buf);
+	clone->data = buf->data;
+	clone->len = buf->len;
+	clone->size = buf->size;
+
+	return clone;
+}
+
 struct net_buf *net_buf_frag_last(struct net_buf *buf)
 {
 	__ASSERT_NO_MSG(buf);
@@ -59,11 +59,27 @@ LOG_MODULE_REGISTER(net_conn, CONFIG_NET_CONN_LOG_LEVEL);
 
 #define NET_CONN_RANK(_flags)		(_flags & 0x78)
 
+/** Local and remote address and port all specified */
+#define NET_CONN_FULLY_SPEC		(NET_CONN_REMOTE_PORT_SPEC | \
+					 NET_CONN_LOCAL_PORT_SPEC | \
+					 NET_CONN_REMOTE_ADDR_SPEC | \
+					 NET_CONN_LOCAL_ADDR_SPEC)
+
+BUILD_ASSERT(IS_POWER_OF_TWO(CONFIG_NET_CONN_HASH_BUCKETS),
+	     "CONFIG_NET_CONN_HASH_BUCKETS must be a power of two");
+
 static struct net_conn conns[CONFIG_NET_MAX_CONN];
 
 static sys_slist_t conn_unused;
 static sys_slist_t conn_used;
 
+/* Fully specified connections are not in conn_used but hashed by their
+ * remote address and both ports, so that a received packet only needs to
+ * be compared against the few of them sharing its hash bucket.
+ */
+static sys_slist_t conn_hash[CONFIG_NET_CONN_HASH_BUCKETS];
+static size_t conn_hashed;
+
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
 void conn_register_debug(struct net_conn *conn,
@@ -116,6 +132,45 @@ void conn_register_debug(struct net_conn *conn,
 
 static K_MUTEX_DEFINE(conn_lock);
 
+/* Ports are in network byte order */
+static sys_slist_t *conn_hash_bucket(const uint8_t *remote_addr, size_t len,
+				     uint16_t remote_port, uint16_t local_port)
+{
+	uint32_t hash = ((uint32_t)remote_port << 16) | local_port;
+
+	for (size_t i = 0; i < len; i += sizeof(uint32_t)) {
+		hash = (hash ^ UNALIGNED_GET((const uint32_t *)&remote_addr[i])) *
+		       0x9e3779b1U;
+	}
+
+	hash ^= hash >> 16;
+
+	return &conn_hash[hash & (CONFIG_NET_CONN_HASH_BUCKETS - 1)];
+}
+
+/* Return the list the connection belongs to, decided by its flags */
+static sys_slist_t *conn_get_list(struct net_conn *conn)
+{
+	if ((conn->flags & NET_CONN_FULLY_SPEC) != NET_CONN_FULLY_SPEC) {
+		return &conn_used;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) &&
+	    conn->remote_addr.sa_family == AF_INET6) {
+		return conn_hash_bucket(
+			net_sin6(&conn->remote_addr)->sin6_addr.s6_addr,
+			sizeof(struct in6_addr),
+			net_sin6(&conn->remote_addr)->sin6_port,
+			net_sin6(&conn->local_addr)->sin6_port);
+	}
+
+	return conn_hash_bucket(
+		(const uint8_t *)&net_sin(&conn->remote_addr)->sin_addr,
+		sizeof(struct in_addr),
+		net_sin(&conn->remote_addr)->sin_port,
+		net_sin(&conn->local_addr)->sin_port);
+}
+
 static struct net_conn *conn_get_unused(void)
 {
 	sys_snode_t *node;
@@ -137,10 +192,19 @@ static struct net_conn *conn_get_unused(void)
 
 static void conn_set_used(struct net_conn *conn)
 {
+	sys_slist_t *list;
+
 	conn->flags |= NET_CONN_IN_USE;
 
 	k_mutex_lock(&conn_lock, K_FOREVER);
-	sys_slist_prepend(&conn_used, &conn->node);
+
+	list = conn_get_list(conn);
+	if (list != &conn_used) {
+		conn_hashed++;
+	}
+
+	sys_slist_prepend(list, &conn->node);
+
 	k_mutex_unlock(&conn_lock);
 }
 
@@ -153,8 +217,8 @@ static void conn_set_unused(struct net_conn *conn)
 	k_mutex_unlock(&conn_lock);
 }
 
-/* Check if we already have identical connection handler installed. */
-static struct net_conn *conn_find_handler(uint16_t proto, uint8_t family,
+static struct net_conn *conn_find_in_list(sys_slist_t *list,
+					  uint16_t proto, uint8_t family,
 					  const struct sockaddr *remote_addr,
 					  const struct sockaddr *local_addr,
 					  uint16_t remote_port,
@@ -163,9 +227,7 @@ static struct net_conn *conn_find_handler(uint16_t proto, uint8_t family,
 	struct net_conn *conn;
 	struct net_conn *tmp;
 
-	k_mutex_lock(&conn_lock, K_FOREVER);
-
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&conn_used, conn, tmp, node) {
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(list, conn, tmp, node) {
 		if (conn->proto != proto) {
 			continue;
 		}
@@ -248,14 +310,37 @@ static struct net_conn *conn_find_handler(uint16_t proto, uint8_t family,
 			continue;
 		}
 
-		k_mutex_unlock(&conn_lock);
 		return conn;
 	}
 
-	k_mutex_unlock(&conn_lock);
 	return NULL;
 }
 
+/* Check if we already have identical connection handler installed. */
+static struct net_conn *conn_find_handler(uint16_t proto, uint8_t family,
+					  const struct sockaddr *remote_addr,
+					  const struct sockaddr *local_addr,
+					  uint16_t remote_port,
+					  uint16_t local_port)
+{
+	struct net_conn *conn;
+
+	k_mutex_lock(&conn_lock, K_FOREVER);
+
+	conn = conn_find_in_list(&conn_used, proto, family, remote_addr,
+				 local_addr, remote_port, local_port);
+
+	for (int i = 0; conn == NULL && i < ARRAY_SIZE(conn_hash); i++) {
+		conn = conn_find_in_list(&conn_hash[i], proto, family,
+					 remote_addr, local_addr, remote_port,
+					 local_port);
+	}
+
+	k_mutex_unlock(&conn_lock);
+
+	return conn;
+}
+
 int net_conn_register(uint16_t proto, uint8_t family,
 		      const struct sockaddr *remote_addr,
 		      const struct sockaddr *local_addr,
@@ -384,6 +469,7 @@ error:
 int net_conn_unregister(struct net_conn_handle *handle)
 {
 	struct net_conn *conn = (struct net_conn *)handle;
+	sys_slist_t *list;
 
 	if (conn < &conns[0] || conn > &conns[CONFIG_NET_MAX_CONN]) {
 		return -EINVAL;
@@ -396,7 +482,14 @@ int net_conn_unregister(struct net_conn_handle *handle)
 	NET_DBG("Connection handler %p removed", conn);
 
 	k_mutex_lock(&conn_lock, K_FOREVER);
-	sys_slist_find_and_remove(&conn_used, &conn->node);
+
+	list = conn_get_list(conn);
+	if (list != &conn_used) {
+		conn_hashed--;
+	}
+
+	sys_slist_find_and_remove(list, &conn->node);
+
 	k_mutex_unlock(&conn_lock);
 
 	conn_set_unused(conn);
@@ -521,6 +614,29 @@ static bool conn_are_endpoints_valid(struct net_pkt *pkt, uint8_t family,
 	return !are_invalid_endpoints;
 }
 
+/* Go through the hash bucket of the packet first and then through the
+ * connections that are not fully specified. The latter are skipped if a
+ * fully specified connection already matched, as it cannot be overridden.
+ */
+static struct net_conn *conn_input_next(struct net_conn *conn,
+					sys_slist_t **list, bool matched)
+{
+	sys_snode_t *node;
+
+	if (conn == NULL) {
+		node = sys_slist_peek_head(*list);
+	} else {
+		node = sys_slist_peek_next(&conn->node);
+	}
+
+	if (node == NULL && *list != &conn_used && !matched) {
+		*list = &conn_used;
+		node = sys_slist_peek_head(*list);
+	}
+
+	return node == NULL ? NULL : CONTAINER_OF(node, struct net_conn, node);
+}
+
 static enum net_verdict conn_raw_socket(struct net_pkt *pkt,
 					struct net_conn *conn, uint8_t proto)
 {
@@ -616,6 +732,7 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	bool is_bcast_pkt = false;
 	bool raw_pkt_delivered = false;
 	bool raw_pkt_continue = false;
+	sys_slist_t *list = &conn_used;
 	struct net_conn *conn;
 
 	if (IS_ENABLED(CONFIG_NET_IP)) {
@@ -632,9 +749,20 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		} else if (IS_ENABLED(CONFIG_NET_IPV6) && pkt_family == AF_INET6) {
 			is_mcast_pkt = net_ipv6_is_addr_mcast((struct in6_addr *)ip_hdr->ipv6->dst);
 		}
+
+		if (IS_ENABLED(CONFIG_NET_IPV4) && pkt_family == AF_INET) {
+			list = conn_hash_bucket(ip_hdr->ipv4->src,
+						sizeof(struct in_addr),
+						src_port, dst_port);
+		} else if (IS_ENABLED(CONFIG_NET_IPV6) && pkt_family == AF_INET6) {
+			list = conn_hash_bucket(ip_hdr->ipv6->src,
+						sizeof(struct in6_addr),
+						src_port, dst_port);
+		}
 	}
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
+	for (conn = conn_input_next(NULL, &list, false); conn != NULL;
+	     conn = conn_input_next(conn, &list, best_match != NULL)) {
 		/* Is the candidate connection matching the packet's interface? */
 		if (conn->context != NULL &&
 		    net_context_is_bound_to_iface(conn->context) &&
@@ -780,7 +908,10 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	} /* loop end */
 
 	if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) && pkt_family == AF_PACKET) {
-		if (raw_pkt_continue) {
+		/* The hashed connections are not walked above, and they
+		 * are all TCP or UDP ones.
+		 */
+		if (raw_pkt_continue || conn_hashed > 0) {
 			/* When there is open connection different than
 			 * AF_PACKET this packet shall be also handled in
 			 * the upper net stack layers.
@@ -847,6 +978,12 @@ void net_conn_foreach(net_conn_foreach_cb_t cb, void *user_data)
 		cb(conn, user_data);
 	}
 
+	for (int i = 0; i < ARRAY_SIZE(conn_hash); i++) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&conn_hash[i], conn, node) {
+			cb(conn, user_data);
+		}
+	}
+
 	k_mutex_unlock(&conn_lock);
 }
 
@@ -857,6 +994,10 @@ void net_conn_init(void)
 	sys_slist_init(&conn_unused);
 	sys_slist_init(&conn_used);
 
+	for (i = 0; i < ARRAY_SIZE(conn_hash); i++) {
+		sys_slist_init(&conn_hash[i]);
+	}
+
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		sys_slist_prepend(&conn_unused, &conns[i].node);
 	}
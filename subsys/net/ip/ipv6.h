@@ -117,6 +117,11 @@ struct net_ipv6_nbr_data {
 	 */
 	uint32_t stale_counter;
 #endif
+
+#if defined(CONFIG_NET_IPV6_NBR_CACHE)
+	/** Node in the neighbor address hash bucket. */
+	sys_snode_t hash_node;
+#endif
 };
 
 static inline struct net_ipv6_nbr_data *net_ipv6_nbr_data(struct net_nbr *nbr)
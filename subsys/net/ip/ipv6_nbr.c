@@ -255,14 +255,37 @@ void nbr_print(void)
 #define nbr_print(...)
 #endif
 
+BUILD_ASSERT(IS_POWER_OF_TWO(CONFIG_NET_IPV6_NBR_HASH_BUCKETS),
+	     "CONFIG_NET_IPV6_NBR_HASH_BUCKETS must be a power of two");
+
+/* Neighbors hashed by their IPv6 address so that lookups in the data
+ * path do not need to scan the whole table.
+ */
+static sys_slist_t nbr_hash[CONFIG_NET_IPV6_NBR_HASH_BUCKETS];
+
+static inline sys_slist_t *nbr_hash_bucket(const struct in6_addr *addr)
+{
+	uint32_t hash = 0U;
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		hash = (hash ^ UNALIGNED_GET(&addr->s6_addr32[i])) * 0x9e3779b1U;
+	}
+
+	return &nbr_hash[(hash >> 16) & (CONFIG_NET_IPV6_NBR_HASH_BUCKETS - 1)];
+}
+
 static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 				  struct net_if *iface,
 				  const struct in6_addr *addr)
 {
-	int i;
+	struct net_ipv6_nbr_data *data;
 
-	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
-		struct net_nbr *nbr = get_nbr(i);
+	ARG_UNUSED(table);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(nbr_hash_bucket(addr), data, hash_node) {
+		struct net_nbr *nbr = CONTAINER_OF((uint8_t *)data,
+						   struct net_nbr, __nbr);
 
 		if (!nbr->ref) {
 			continue;
@@ -272,7 +295,7 @@ static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 			continue;
 		}
 
-		if (net_ipv6_addr_cmp(&net_ipv6_nbr_data(nbr)->addr, addr)) {
+		if (net_ipv6_addr_cmp(&data->addr, addr)) {
 			return nbr;
 		}
 	}
@@ -407,6 +430,8 @@ static void nbr_init(struct net_nbr *nbr, struct net_if *iface,
 	nbr->iface = iface;
 
 	net_ipaddr_copy(&net_ipv6_nbr_data(nbr)->addr, addr);
+	sys_slist_prepend(nbr_hash_bucket(addr),
+			  &net_ipv6_nbr_data(nbr)->hash_node);
 	ipv6_nbr_set_state(nbr, state);
 	net_ipv6_nbr_data(nbr)->is_router = is_router;
 	net_ipv6_nbr_data(nbr)->pending = NULL;
@@ -650,7 +675,9 @@ void net_neighbor_data_remove(struct net_nbr *nbr)
 {
 	NET_DBG("Neighbor %p removed", nbr);
 
-	return;
+	(void)sys_slist_find_and_remove(
+		nbr_hash_bucket(&net_ipv6_nbr_data(nbr)->addr),
+		&net_ipv6_nbr_data(nbr)->hash_node);
 }
 
 void net_neighbor_table_clear(struct net_nbr_table *table)
@@ -784,9 +811,11 @@ enum net_verdict net_ipv6_prepare_for_send(struct net_pkt *pkt)
 
 #if defined(CONFIG_NET_IPV6_FRAGMENT)
 	/* If we have already fragmented the packet, the fragment id will
-	 * contain a proper value and we can skip other checks.
+	 * contain a proper value and we can skip other checks. Packets left
+	 * for the driver to segment are not fragmented either.
 	 */
-	if (net_pkt_ipv6_fragment_id(pkt) == 0U) {
+	if (net_pkt_ipv6_fragment_id(pkt) == 0U &&
+	    net_pkt_gso_size(pkt) == 0U) {
 		uint16_t mtu = net_if_get_mtu(net_pkt_iface(pkt));
 		size_t pkt_len = net_pkt_get_len(pkt);
 
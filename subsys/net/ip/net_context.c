@@ -841,8 +841,6 @@ static inline struct net_context *find_context(void *conn_handler)
 
 int net_context_listen(struct net_context *context, int backlog)
 {
-	ARG_UNUSED(backlog);
-
 	NET_ASSERT(PART_OF_ARRAY(contexts, context));
 
 	if (!net_context_is_used(context)) {
@@ -857,7 +855,7 @@ int net_context_listen(struct net_context *context, int backlog)
 
 	k_mutex_lock(&context->lock, K_FOREVER);
 
-	if (net_tcp_listen(context) >= 0) {
+	if (net_tcp_listen(context, backlog) >= 0) {
 		k_mutex_unlock(&context->lock);
 		return 0;
 	}
@@ -1287,14 +1285,141 @@ static int get_context_dscp_ecn(struct net_context *context,
 #endif
 }
 
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+/* Kept in the buffer user data, as the data pointer is cleared before
+ * the destroy callback runs.
+ */
+struct zerocopy_buf_info {
+	net_context_zerocopy_cb_t cb;
+	void *user_data;
+	const void *data;
+};
+
+static void zerocopy_buf_destroy(struct net_buf *buf);
+
+NET_BUF_POOL_FIXED_DEFINE(zerocopy_pool, CONFIG_NET_SOCKETS_ZEROCOPY_TX_BUFS,
+			  0, sizeof(struct zerocopy_buf_info),
+			  zerocopy_buf_destroy);
+
+static void zerocopy_buf_destroy(struct net_buf *buf)
+{
+	struct zerocopy_buf_info info =
+		*(struct zerocopy_buf_info *)net_buf_user_data(buf);
+	size_t len = buf->size;
+
+	net_buf_destroy(buf);
+
+	if (info.cb) {
+		info.cb(info.data, len, info.user_data);
+	}
+}
+
+/* Reference the iovec data from external buffers instead of copying it */
+static int context_attach_zerocopy(struct net_pkt *pkt, int buf_len,
+				   const struct msghdr *msghdr)
+{
+	struct net_context *context = net_pkt_context(pkt);
+
+	/* Drop the unused room allocated for the payload */
+	net_pkt_trim_buffer(pkt);
+
+	for (size_t i = 0; i < msghdr->msg_iovlen && buf_len > 0; i++) {
+		uint8_t *data = msghdr->msg_iov[i].iov_base;
+		size_t len = MIN(msghdr->msg_iov[i].iov_len, (size_t)buf_len);
+
+		buf_len -= len;
+
+		while (len > 0) {
+			size_t chunk = MIN(len, UINT16_MAX);
+			struct zerocopy_buf_info *info;
+			struct net_buf *frag;
+
+			/* Descriptors are released by TX or by TCP acks, the
+			 * socket layer retries blocking sends on -ENOBUFS.
+			 */
+			frag = net_buf_alloc_with_data(&zerocopy_pool, data,
+						       chunk, K_NO_WAIT);
+			if (!frag) {
+				return -ENOBUFS;
+			}
+
+			info = net_buf_user_data(frag);
+			info->cb = context->zerocopy_cb;
+			info->user_data = context->zerocopy_user_data;
+			info->data = data;
+
+			net_pkt_append_buffer(pkt, frag);
+
+			data += chunk;
+			len -= chunk;
+		}
+	}
+
+	return 0;
+}
+
+/* The payload room of the packet is not allocated for zero-copy data, so
+ * apply the MTU based limit of net_pkt_alloc_with_buffer() to datagrams here.
+ */
+static size_t context_zerocopy_max_len(struct net_context *context,
+				       struct net_pkt *pkt, size_t len)
+{
+	size_t hdr_len = net_pkt_available_buffer(pkt) -
+		net_pkt_available_payload_buffer(pkt,
+						 net_context_get_proto(context));
+	size_t max_len = net_if_get_mtu(net_pkt_iface(pkt));
+
+	if (net_context_get_type(context) != SOCK_DGRAM) {
+		return len;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && net_pkt_family(pkt) == AF_INET6) {
+		if (IS_ENABLED(CONFIG_NET_IPV6_FRAGMENT)) {
+			return len;
+		}
+
+		max_len = MAX(max_len, NET_IPV6_MTU);
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		   net_pkt_family(pkt) == AF_INET) {
+		if (IS_ENABLED(CONFIG_NET_IPV4_FRAGMENT)) {
+			return len;
+		}
+
+		max_len = MAX(max_len, NET_IPV4_MTU);
+	}
+
+	return max_len > hdr_len ? max_len - hdr_len : 0;
+}
+
+/* The caller keeps ownership of the data if sending fails */
+static void context_cancel_zerocopy(struct net_pkt *pkt)
+{
+	for (struct net_buf *frag = pkt->buffer; frag; frag = frag->frags) {
+		if (net_buf_pool_get(frag->pool_id) == &zerocopy_pool) {
+			struct zerocopy_buf_info *info =
+				net_buf_user_data(frag);
+
+			info->cb = NULL;
+		}
+	}
+}
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY */
+
 /* If buf is not NULL, then use it. Otherwise read the data to be written
  * to net_pkt from msghdr.
  */
 static int context_write_data(struct net_pkt *pkt, const void *buf,
-			      int buf_len, const struct msghdr *msghdr)
+			      int buf_len, const struct msghdr *msghdr,
+			      int flags)
 {
 	int ret = 0;
 
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+	if (msghdr && (flags & ZSOCK_MSG_ZEROCOPY)) {
+		return context_attach_zerocopy(pkt, buf_len, msghdr);
+	}
+#endif
+
 	if (msghdr) {
 		int i;
 
@@ -1324,6 +1449,7 @@ static int context_setup_udp_packet(struct net_context *context,
 				    const void *buf,
 				    size_t len,
 				    const struct msghdr *msg,
+				    int flags,
 				    const struct sockaddr *dst_addr,
 				    socklen_t addrlen)
 {
@@ -1365,7 +1491,7 @@ static int context_setup_udp_packet(struct net_context *context,
 		return ret;
 	}
 
-	ret = context_write_data(pkt, buf, len, msg);
+	ret = context_write_data(pkt, buf, len, msg, flags);
 	if (ret) {
 		return ret;
 	}
@@ -1453,7 +1579,8 @@ static int context_sendto(struct net_context *context,
 			  net_context_send_cb_t cb,
 			  k_timeout_t timeout,
 			  void *user_data,
-			  bool sendto)
+			  bool sendto,
+			  int flags)
 {
 	const struct msghdr *msghdr = NULL;
 	struct net_if *iface;
@@ -1666,7 +1793,20 @@ static int context_sendto(struct net_context *context,
 		return -ENETDOWN;
 	}
 
-	pkt = context_alloc_pkt(context, len, PKT_WAIT_TIME);
+	/* Without a release callback the data is copied as usual */
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+	if (!msghdr || !context->zerocopy_cb) {
+		flags &= ~ZSOCK_MSG_ZEROCOPY;
+	}
+#else
+	flags &= ~ZSOCK_MSG_ZEROCOPY;
+#endif
+
+	/* Zero-copy data is attached to the packet, only the headers need
+	 * room in the packet buffer.
+	 */
+	pkt = context_alloc_pkt(context, (flags & ZSOCK_MSG_ZEROCOPY) ? 0 : len,
+				PKT_WAIT_TIME);
 	if (!pkt) {
 		NET_ERR("Failed to allocate net_pkt");
 		return -ENOBUFS;
@@ -1674,6 +1814,11 @@ static int context_sendto(struct net_context *context,
 
 	tmp_len = net_pkt_available_payload_buffer(
 				pkt, net_context_get_proto(context));
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+	if (flags & ZSOCK_MSG_ZEROCOPY) {
+		tmp_len = context_zerocopy_max_len(context, pkt, len);
+	}
+#endif
 	if (tmp_len < len) {
 		if (net_context_get_type(context) == SOCK_DGRAM) {
 			NET_ERR("Available payload buffer (%zu) is not enough for requested DGRAM (%zu)",
@@ -1710,7 +1855,7 @@ static int context_sendto(struct net_context *context,
 
 	if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
 	    net_if_is_ip_offloaded(net_context_get_iface(context))) {
-		ret = context_write_data(pkt, buf, len, msghdr);
+		ret = context_write_data(pkt, buf, len, msghdr, flags);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1728,7 +1873,7 @@ static int context_sendto(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_UDP) &&
 	    net_context_get_proto(context) == IPPROTO_UDP) {
 		ret = context_setup_udp_packet(context, pkt, buf, len, msghdr,
-					       dst_addr, addrlen);
+					       flags, dst_addr, addrlen);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1739,7 +1884,7 @@ static int context_sendto(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_TCP) &&
 		   net_context_get_proto(context) == IPPROTO_TCP) {
 
-		ret = context_write_data(pkt, buf, len, msghdr);
+		ret = context_write_data(pkt, buf, len, msghdr, flags);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1753,7 +1898,7 @@ static int context_sendto(struct net_context *context,
 		ret = net_tcp_send_data(context, cb, user_data);
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_PACKET) &&
 		   net_context_get_family(context) == AF_PACKET) {
-		ret = context_write_data(pkt, buf, len, msghdr);
+		ret = context_write_data(pkt, buf, len, msghdr, flags);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1784,7 +1929,7 @@ static int context_sendto(struct net_context *context,
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_CAN) &&
 		   net_context_get_family(context) == AF_CAN &&
 		   net_context_get_proto(context) == CAN_RAW) {
-		ret = context_write_data(pkt, buf, len, msghdr);
+		ret = context_write_data(pkt, buf, len, msghdr, flags);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -1804,6 +1949,12 @@ static int context_sendto(struct net_context *context,
 
 	return len;
 fail:
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+	if (flags & ZSOCK_MSG_ZEROCOPY) {
+		context_cancel_zerocopy(pkt);
+	}
+#endif
+
 	net_pkt_unref(pkt);
 
 	return ret;
@@ -1845,7 +1996,7 @@ int net_context_send(struct net_context *context,
 	}
 
 	ret = context_sendto(context, buf, len, &context->remote,
-			     addrlen, cb, timeout, user_data, false);
+			     addrlen, cb, timeout, user_data, false, 0);
 unlock:
 	k_mutex_unlock(&context->lock);
 
@@ -1864,7 +2015,7 @@ int net_context_sendmsg(struct net_context *context,
 	k_mutex_lock(&context->lock, K_FOREVER);
 
 	ret = context_sendto(context, msghdr, 0, NULL, 0,
-			     cb, timeout, user_data, true);
+			     cb, timeout, user_data, true, flags);
 
 	k_mutex_unlock(&context->lock);
 
@@ -1885,7 +2036,7 @@ int net_context_sendto(struct net_context *context,
 	k_mutex_lock(&context->lock, K_FOREVER);
 
 	ret = context_sendto(context, buf, len, dst_addr, addrlen,
-			     cb, timeout, user_data, true);
+			     cb, timeout, user_data, true, 0);
 
 	k_mutex_unlock(&context->lock);
 
@@ -58,6 +58,24 @@ LOG_MODULE_REGISTER(net_core, CONFIG_NET_CORE_LOG_LEVEL);
 
 #include "net_stats.h"
 
+static inline enum net_verdict process_ip_data(struct net_pkt *pkt,
+					       bool is_loopback)
+{
+	/* IP version and header length. */
+	uint8_t vtc_vhl = NET_IPV6_HDR(pkt)->vtc & 0xf0;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && vtc_vhl == 0x60) {
+		return net_ipv6_input(pkt, is_loopback);
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) && vtc_vhl == 0x40) {
+		return net_ipv4_input(pkt);
+	}
+
+	NET_DBG("Unknown IP family packet (0x%x)", NET_IPV6_HDR(pkt)->vtc & 0xf0);
+	net_stats_update_ip_errors_protoerr(net_pkt_iface(pkt));
+	net_stats_update_ip_errors_vhlerr(net_pkt_iface(pkt));
+	return NET_DROP;
+}
+
 static inline enum net_verdict process_data(struct net_pkt *pkt,
 					    bool is_loopback)
 {
@@ -129,19 +147,11 @@ static inline enum net_verdict process_data(struct net_pkt *pkt,
 			return ret;
 		}
 
-		/* IP version and header length. */
-		uint8_t vtc_vhl = NET_IPV6_HDR(pkt)->vtc & 0xf0;
-
-		if (IS_ENABLED(CONFIG_NET_IPV6) && vtc_vhl == 0x60) {
-			return net_ipv6_input(pkt, is_loopback);
-		} else if (IS_ENABLED(CONFIG_NET_IPV4) && vtc_vhl == 0x40) {
-			return net_ipv4_input(pkt);
+		if (!is_loopback && net_gro_receive(pkt) == NET_OK) {
+			return NET_OK;
 		}
 
-		NET_DBG("Unknown IP family packet (0x%x)", NET_IPV6_HDR(pkt)->vtc & 0xf0);
-		net_stats_update_ip_errors_protoerr(net_pkt_iface(pkt));
-		net_stats_update_ip_errors_vhlerr(net_pkt_iface(pkt));
-		return NET_DROP;
+		return process_ip_data(pkt, is_loopback);
 	} else if (IS_ENABLED(CONFIG_NET_SOCKETS_CAN) && family == AF_CAN) {
 		return net_canbus_socket_input(pkt);
 	}
@@ -176,6 +186,28 @@ again:
 	}
 }
 
+#if defined(CONFIG_NET_GRO)
+void net_gro_deliver(struct net_pkt *pkt)
+{
+	switch (process_ip_data(pkt, false)) {
+	case NET_CONTINUE:
+		if (IS_ENABLED(CONFIG_NET_L2_VIRTUAL)) {
+			processing_data(pkt, false);
+			break;
+		}
+
+		__fallthrough;
+	case NET_DROP:
+		NET_DBG("Dropping pkt %p", pkt);
+		net_pkt_unref(pkt);
+		break;
+	default:
+		NET_DBG("Consumed pkt %p", pkt);
+		break;
+	}
+}
+#endif /* CONFIG_NET_GRO */
+
 /* Things to setup after we are able to RX and TX */
 static void net_post_init(void)
 {
@@ -343,6 +375,13 @@ int net_send_data(struct net_pkt *pkt)
 		return 0;
 	}
 
+#if defined(CONFIG_NET_GSO)
+	if (net_pkt_gso_size(pkt) > 0 &&
+	    net_if_need_tcp_segmentation(net_pkt_iface(pkt))) {
+		return net_gso_send(pkt);
+	}
+#endif
+
 	if (net_if_send_data(net_pkt_iface(pkt), pkt) == NET_DROP) {
 		return -EIO;
 	}
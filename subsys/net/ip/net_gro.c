@@ -0,0 +1,378 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Generic receive offload for TCP. While more packets are waiting in the
+ * RX queue, consecutive in-order TCP segments of the same connection are
+ * appended to the first one, so that the IP and TCP layers process, and
+ * acknowledge, them only once.
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_core, CONFIG_NET_CORE_LOG_LEVEL);
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+
+#include "net_private.h"
+
+#define TCP_FLAG_PSH BIT(3)
+#define TCP_FLAG_ACK BIT(4)
+
+/* Headers of a received TCP packet, all in its first buffer */
+struct gro_hdrs {
+	union {
+		struct net_ipv4_hdr *ipv4;
+		struct net_ipv6_hdr *ipv6;
+	};
+	struct net_tcp_hdr *tcp;
+	uint16_t hdr_len;
+	uint16_t data_len;
+};
+
+struct gro_flow {
+	/* Packet the following segments are appended to */
+	struct net_pkt *pkt;
+	struct gro_hdrs hdrs;
+	/* Total length of the coalesced packet */
+	uint32_t len;
+	/* Sequence number the next segment must start with */
+	uint32_t next_seq;
+	uint8_t segs;
+};
+
+static struct gro_flow flows[CONFIG_NET_GRO_FLOWS];
+static struct k_spinlock lock;
+
+static int gro_parse(struct net_pkt *pkt, struct gro_hdrs *hdrs)
+{
+	struct net_buf *buf = pkt->buffer;
+	size_t len = net_pkt_get_len(pkt);
+	uint8_t tcp_len;
+	size_t ip_len;
+
+	if (buf->len < sizeof(struct net_ipv4_hdr)) {
+		return -EINVAL;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET &&
+	    (buf->data[0] & 0xf0) == 0x40) {
+		hdrs->ipv4 = (struct net_ipv4_hdr *)buf->data;
+
+		/* No options, not a fragment */
+		if (hdrs->ipv4->vhl != 0x45 ||
+		    hdrs->ipv4->proto != IPPROTO_TCP ||
+		    (hdrs->ipv4->offset[0] & 0x3f) != 0U ||
+		    hdrs->ipv4->offset[1] != 0U) {
+			return -EINVAL;
+		}
+
+		ip_len = ntohs(hdrs->ipv4->len);
+		hdrs->hdr_len = sizeof(struct net_ipv4_hdr);
+
+		net_pkt_set_ipv4_opts_len(pkt, 0);
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   net_pkt_family(pkt) == AF_INET6 &&
+		   (buf->data[0] & 0xf0) == 0x60) {
+		if (buf->len < sizeof(struct net_ipv6_hdr)) {
+			return -EINVAL;
+		}
+
+		hdrs->ipv6 = (struct net_ipv6_hdr *)buf->data;
+
+		/* No extension headers */
+		if (hdrs->ipv6->nexthdr != IPPROTO_TCP) {
+			return -EINVAL;
+		}
+
+		ip_len = ntohs(hdrs->ipv6->len) + sizeof(struct net_ipv6_hdr);
+		hdrs->hdr_len = sizeof(struct net_ipv6_hdr);
+
+		net_pkt_set_ipv6_ext_len(pkt, 0);
+	} else {
+		return -EINVAL;
+	}
+
+	/* Link layer padding or truncated packets are left to the IP layer */
+	if (ip_len != len ||
+	    buf->len < hdrs->hdr_len + sizeof(struct net_tcp_hdr)) {
+		return -EINVAL;
+	}
+
+	net_pkt_set_ip_hdr_len(pkt, hdrs->hdr_len);
+
+	hdrs->tcp = (struct net_tcp_hdr *)(buf->data + hdrs->hdr_len);
+
+	tcp_len = (hdrs->tcp->offset >> 4) * 4U;
+	if (tcp_len < sizeof(struct net_tcp_hdr) ||
+	    buf->len < hdrs->hdr_len + tcp_len ||
+	    len < hdrs->hdr_len + tcp_len) {
+		return -EINVAL;
+	}
+
+	hdrs->hdr_len += tcp_len;
+	hdrs->data_len = len - hdrs->hdr_len;
+
+	return 0;
+}
+
+/* Only data segments with valid checksums are coalesced */
+static bool gro_is_candidate(struct net_pkt *pkt, struct gro_hdrs *hdrs)
+{
+	if ((hdrs->tcp->flags & ~TCP_FLAG_PSH) != TCP_FLAG_ACK ||
+	    hdrs->data_len == 0U) {
+		return false;
+	}
+
+	if (net_if_need_calc_rx_checksum(net_pkt_iface(pkt))) {
+#if defined(CONFIG_NET_IPV4)
+		if (net_pkt_family(pkt) == AF_INET &&
+		    net_calc_chksum_ipv4(pkt) != 0U) {
+			return false;
+		}
+#endif
+
+		if (IS_ENABLED(CONFIG_NET_TCP_CHECKSUM) &&
+		    !net_pkt_is_l4_chksum_ok(pkt) &&
+		    net_calc_chksum_tcp(pkt) != 0U) {
+			return false;
+		}
+	}
+
+	net_pkt_set_l4_chksum_ok(pkt, true);
+
+	return true;
+}
+
+/* Forwarded packets must be left as they are */
+static bool gro_is_local(struct net_pkt *pkt, struct gro_hdrs *hdrs)
+{
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		return net_ipv4_is_my_addr((struct in_addr *)hdrs->ipv4->dst);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && net_pkt_family(pkt) == AF_INET6) {
+		return net_ipv6_is_my_addr((struct in6_addr *)hdrs->ipv6->dst);
+	}
+
+	return false;
+}
+
+static bool gro_same_flow(struct gro_flow *flow, struct net_pkt *pkt,
+			  struct gro_hdrs *hdrs)
+{
+	if (net_pkt_iface(flow->pkt) != net_pkt_iface(pkt) ||
+	    net_pkt_family(flow->pkt) != net_pkt_family(pkt) ||
+	    flow->hdrs.tcp->src_port != hdrs->tcp->src_port ||
+	    flow->hdrs.tcp->dst_port != hdrs->tcp->dst_port) {
+		return false;
+	}
+
+	/* Source and destination addresses are next to each other */
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		return memcmp(flow->hdrs.ipv4->src, hdrs->ipv4->src,
+			      2 * NET_IPV4_ADDR_SIZE) == 0;
+	}
+
+	return memcmp(flow->hdrs.ipv6->src, hdrs->ipv6->src,
+		      2 * NET_IPV6_ADDR_SIZE) == 0;
+}
+
+static struct gro_flow *gro_find(struct net_pkt *pkt, struct gro_hdrs *hdrs)
+{
+	for (int i = 0; i < ARRAY_SIZE(flows); i++) {
+		if (flows[i].pkt != NULL && gro_same_flow(&flows[i], pkt, hdrs)) {
+			return &flows[i];
+		}
+	}
+
+	return NULL;
+}
+
+static bool gro_can_merge(struct gro_flow *flow, struct gro_hdrs *hdrs)
+{
+	struct gro_hdrs *held = &flow->hdrs;
+
+	if (flow->segs >= CONFIG_NET_GRO_MAX_SEGS ||
+	    flow->len + hdrs->data_len > UINT16_MAX ||
+	    sys_get_be32(hdrs->tcp->seq) != flow->next_seq ||
+	    memcmp(held->tcp->ack, hdrs->tcp->ack, sizeof(hdrs->tcp->ack)) ||
+	    held->tcp->offset != hdrs->tcp->offset) {
+		return false;
+	}
+
+	/* TCP options, timestamps included, must not change */
+	if (memcmp(held->tcp->optdata, hdrs->tcp->optdata,
+		   ((hdrs->tcp->offset >> 4) * 4U) -
+		   sizeof(struct net_tcp_hdr))) {
+		return false;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) &&
+	    net_pkt_family(flow->pkt) == AF_INET) {
+		return held->ipv4->tos == hdrs->ipv4->tos &&
+		       held->ipv4->ttl == hdrs->ipv4->ttl;
+	}
+
+	/* Traffic class and flow label */
+	return memcmp(held->ipv6, hdrs->ipv6, 4) == 0 &&
+	       held->ipv6->hop_limit == hdrs->ipv6->hop_limit;
+}
+
+static void gro_hold(struct gro_flow *flow, struct net_pkt *pkt,
+		     struct gro_hdrs *hdrs)
+{
+	flow->pkt = pkt;
+	flow->hdrs = *hdrs;
+	flow->len = hdrs->hdr_len + hdrs->data_len;
+	flow->next_seq = sys_get_be32(hdrs->tcp->seq) + hdrs->data_len;
+	flow->segs = 1U;
+}
+
+static void gro_merge(struct gro_flow *flow, struct net_pkt *pkt,
+		      struct gro_hdrs *hdrs)
+{
+	struct net_buf *buf = pkt->buffer;
+
+	/* Latest window and PSH flag */
+	memcpy(flow->hdrs.tcp->wnd, hdrs->tcp->wnd, sizeof(hdrs->tcp->wnd));
+	flow->hdrs.tcp->flags |= hdrs->tcp->flags;
+
+	flow->len += hdrs->data_len;
+	flow->next_seq += hdrs->data_len;
+	flow->segs++;
+
+	/* Only the payload is appended */
+	net_buf_pull(buf, hdrs->hdr_len);
+	if (buf->len == 0U) {
+		buf = net_buf_frag_del(NULL, buf);
+	}
+
+	pkt->buffer = NULL;
+	net_pkt_unref(pkt);
+
+	if (buf != NULL) {
+		net_pkt_append_buffer(flow->pkt, buf);
+	}
+}
+
+/* Remove the packet from the flow and fix up its IP header */
+static struct net_pkt *gro_take(struct gro_flow *flow)
+{
+	struct net_pkt *pkt = flow->pkt;
+
+	if (flow->segs > 1U) {
+#if defined(CONFIG_NET_IPV4)
+		if (net_pkt_family(pkt) == AF_INET) {
+			flow->hdrs.ipv4->len = htons(flow->len);
+			flow->hdrs.ipv4->chksum = 0U;
+			flow->hdrs.ipv4->chksum = net_calc_chksum_ipv4(pkt);
+		}
+#endif
+		if (net_pkt_family(pkt) == AF_INET6) {
+			flow->hdrs.ipv6->len =
+				htons(flow->len - sizeof(struct net_ipv6_hdr));
+		}
+	}
+
+	net_pkt_cursor_init(pkt);
+	flow->pkt = NULL;
+
+	return pkt;
+}
+
+enum net_verdict net_gro_receive(struct net_pkt *pkt)
+{
+	struct net_pkt *flush = NULL;
+	struct gro_flow *flow;
+	struct gro_hdrs hdrs;
+	k_spinlock_key_t key;
+	bool candidate;
+
+	if (!net_if_need_tcp_coalescing(net_pkt_iface(pkt)) ||
+	    gro_parse(pkt, &hdrs) < 0) {
+		return NET_CONTINUE;
+	}
+
+	candidate = gro_is_candidate(pkt, &hdrs);
+
+	key = k_spin_lock(&lock);
+
+	flow = gro_find(pkt, &hdrs);
+	if (flow != NULL) {
+		if (candidate && gro_can_merge(flow, &hdrs)) {
+			bool push = hdrs.tcp->flags & TCP_FLAG_PSH;
+
+			gro_merge(flow, pkt, &hdrs);
+
+			if (push || flow->segs >= CONFIG_NET_GRO_MAX_SEGS) {
+				flush = gro_take(flow);
+			}
+
+			k_spin_unlock(&lock, key);
+
+			if (flush != NULL) {
+				net_gro_deliver(flush);
+			}
+
+			return NET_OK;
+		}
+
+		/* Whatever is held must reach TCP before this packet */
+		flush = gro_take(flow);
+	}
+
+	k_spin_unlock(&lock, key);
+
+	if (flush != NULL) {
+		net_gro_deliver(flush);
+	}
+
+	/* Nothing to coalesce with a pushed segment */
+	if (!candidate || (hdrs.tcp->flags & TCP_FLAG_PSH) ||
+	    !gro_is_local(pkt, &hdrs)) {
+		return NET_CONTINUE;
+	}
+
+	key = k_spin_lock(&lock);
+
+	for (int i = 0; i < ARRAY_SIZE(flows); i++) {
+		if (flows[i].pkt == NULL) {
+			gro_hold(&flows[i], pkt, &hdrs);
+			k_spin_unlock(&lock, key);
+
+			return NET_OK;
+		}
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return NET_CONTINUE;
+}
+
+void net_gro_flush(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(flows); i++) {
+		struct net_pkt *pkt = NULL;
+		k_spinlock_key_t key;
+
+		key = k_spin_lock(&lock);
+
+		if (flows[i].pkt != NULL) {
+			pkt = gro_take(&flows[i]);
+		}
+
+		k_spin_unlock(&lock, key);
+
+		if (pkt != NULL) {
+			net_gro_deliver(pkt);
+		}
+	}
+}
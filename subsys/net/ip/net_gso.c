@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Generic segmentation offload for TCP. TCP may build packets carrying
+ * several segments worth of data, which are split into MSS sized packets
+ * only when they are about to be handed to a network interface that cannot
+ * do the segmentation itself.
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_core, CONFIG_NET_CORE_LOG_LEVEL);
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+
+#include "net_private.h"
+#include "ipv4.h"
+#include "ipv6.h"
+
+#define TCP_FLAG_FIN BIT(0)
+#define TCP_FLAG_PSH BIT(3)
+#define TCP_FLAG_CWR BIT(7)
+
+static int gso_fixup_tcp_hdr(struct net_pkt *seg, size_t offset, bool last)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+	struct net_tcp_hdr *tcp_hdr;
+
+	net_pkt_cursor_init(seg);
+	net_pkt_set_overwrite(seg, true);
+
+	if (net_pkt_skip(seg, net_pkt_ip_hdr_len(seg) +
+			 net_pkt_ip_opts_len(seg))) {
+		return -ENOBUFS;
+	}
+
+	tcp_hdr = (struct net_tcp_hdr *)net_pkt_get_data(seg, &tcp_access);
+	if (!tcp_hdr) {
+		return -ENOBUFS;
+	}
+
+	sys_put_be32(sys_get_be32(tcp_hdr->seq) + offset, tcp_hdr->seq);
+
+	if (!last) {
+		tcp_hdr->flags &= ~(TCP_FLAG_FIN | TCP_FLAG_PSH);
+	}
+
+	if (offset > 0) {
+		tcp_hdr->flags &= ~TCP_FLAG_CWR;
+	}
+
+	return net_pkt_set_data(seg, &tcp_access);
+}
+
+static int gso_finalize(struct net_pkt *seg)
+{
+	net_pkt_cursor_init(seg);
+
+#if defined(CONFIG_NET_IPV4)
+	if (net_pkt_family(seg) == AF_INET) {
+		/* The copied header checksum must not be summed in */
+		NET_IPV4_HDR(seg)->chksum = 0U;
+
+		return net_ipv4_finalize(seg, IPPROTO_TCP);
+	}
+#endif
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && net_pkt_family(seg) == AF_INET6) {
+		return net_ipv6_finalize(seg, IPPROTO_TCP);
+	}
+
+	return -EINVAL;
+}
+
+/* Build the segment carrying len bytes at offset of the packet payload */
+static struct net_pkt *gso_segment(struct net_pkt *pkt, size_t hdr_len,
+				   size_t offset, size_t len, bool last)
+{
+	struct net_pkt *seg;
+
+	/* Keeps all the metadata of the original packet */
+	seg = net_pkt_shallow_clone(pkt, K_NO_WAIT);
+	if (!seg) {
+		return NULL;
+	}
+
+	net_pkt_frag_unref(seg->buffer);
+	seg->buffer = NULL;
+	net_pkt_set_gso_size(seg, 0);
+
+	/* The copied headers include the IP and TCP options, so no
+	 * protocol header is estimated on top of them.
+	 */
+	if (net_pkt_alloc_buffer(seg, hdr_len + len, 0, K_NO_WAIT)) {
+		goto fail;
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (net_pkt_copy(seg, pkt, hdr_len) ||
+	    net_pkt_skip(pkt, offset) ||
+	    net_pkt_copy(seg, pkt, len)) {
+		goto fail;
+	}
+
+	if (gso_fixup_tcp_hdr(seg, offset, last) ||
+	    gso_finalize(seg)) {
+		goto fail;
+	}
+
+	return seg;
+
+fail:
+	net_pkt_unref(seg);
+
+	return NULL;
+}
+
+int net_gso_send(struct net_pkt *pkt)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+	size_t mss = net_pkt_gso_size(pkt);
+	struct net_tcp_hdr *tcp_hdr;
+	size_t hdr_len, data_len;
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	hdr_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt);
+
+	if (net_pkt_skip(pkt, hdr_len)) {
+		return -EINVAL;
+	}
+
+	tcp_hdr = (struct net_tcp_hdr *)net_pkt_get_data(pkt, &tcp_access);
+	if (!tcp_hdr) {
+		return -ENOBUFS;
+	}
+
+	hdr_len += (tcp_hdr->offset >> 4) * 4U;
+	data_len = net_pkt_get_len(pkt) - hdr_len;
+
+	for (size_t offset = 0; offset < data_len; offset += mss) {
+		size_t len = MIN(mss, data_len - offset);
+		struct net_pkt *seg;
+
+		seg = gso_segment(pkt, hdr_len, offset, len,
+				  offset + len == data_len);
+		if (!seg) {
+			NET_DBG("Cannot build segment at %zu of pkt %p",
+				offset, pkt);
+			return -ENOBUFS;
+		}
+
+		if (net_if_send_data(net_pkt_iface(seg), seg) == NET_DROP) {
+			net_pkt_unref(seg);
+			return -EIO;
+		}
+	}
+
+	net_pkt_unref(pkt);
+
+	return 0;
+}
@@ -3998,7 +3998,7 @@ void net_if_call_link_cb(struct net_if *iface, struct net_linkaddr *lladdr,
 	k_mutex_unlock(&lock);
 }
 
-static bool need_calc_checksum(struct net_if *iface, enum ethernet_hw_caps caps)
+static bool need_sw_offload(struct net_if *iface, enum ethernet_hw_caps caps)
 {
 #if defined(CONFIG_NET_L2_ETHERNET)
 	if (net_if_l2(iface) != &NET_L2_GET_NAME(ETHERNET)) {
@@ -4016,12 +4016,22 @@ static bool need_calc_checksum(struct net_if *iface, enum ethernet_hw_caps caps)
 
 bool net_if_need_calc_tx_checksum(struct net_if *iface)
 {
-	return need_calc_checksum(iface, ETHERNET_HW_TX_CHKSUM_OFFLOAD);
+	return need_sw_offload(iface, ETHERNET_HW_TX_CHKSUM_OFFLOAD);
 }
 
 bool net_if_need_calc_rx_checksum(struct net_if *iface)
 {
-	return need_calc_checksum(iface, ETHERNET_HW_RX_CHKSUM_OFFLOAD);
+	return need_sw_offload(iface, ETHERNET_HW_RX_CHKSUM_OFFLOAD);
+}
+
+bool net_if_need_tcp_segmentation(struct net_if *iface)
+{
+	return need_sw_offload(iface, ETHERNET_HW_TSO);
+}
+
+bool net_if_need_tcp_coalescing(struct net_if *iface)
+{
+	return need_sw_offload(iface, ETHERNET_HW_LRO);
 }
 
 int net_if_get_by_iface(struct net_if *iface)
@@ -4263,6 +4273,7 @@ int net_if_down(struct net_if *iface)
 
 done:
 	net_if_flag_clear(iface, NET_IF_UP);
+	net_pkt_cache_flush(iface);
 	net_mgmt_event_notify(NET_EVENT_IF_ADMIN_DOWN, iface);
 	update_operational_state(iface);
 
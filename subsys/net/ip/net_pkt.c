@@ -129,10 +129,14 @@ NET_BUF_POOL_FIXED_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT, CONFIG_NET_BUF_DATA_
 
 #else /* !CONFIG_NET_BUF_FIXED_DATA_SIZE */
 
-NET_BUF_POOL_VAR_DEFINE(rx_bufs, CONFIG_NET_BUF_RX_COUNT, CONFIG_NET_BUF_DATA_POOL_SIZE,
-			CONFIG_NET_PKT_BUF_USER_DATA_SIZE, NULL);
-NET_BUF_POOL_VAR_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT, CONFIG_NET_BUF_DATA_POOL_SIZE,
-			CONFIG_NET_PKT_BUF_USER_DATA_SIZE, NULL);
+NET_BUF_POOL_VAR_INLINE_DEFINE(rx_bufs, CONFIG_NET_BUF_RX_COUNT,
+			       CONFIG_NET_BUF_DATA_POOL_SIZE,
+			       CONFIG_NET_BUF_INLINE_DATA_SIZE,
+			       CONFIG_NET_PKT_BUF_USER_DATA_SIZE, NULL);
+NET_BUF_POOL_VAR_INLINE_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT,
+			       CONFIG_NET_BUF_DATA_POOL_SIZE,
+			       CONFIG_NET_BUF_INLINE_DATA_SIZE,
+			       CONFIG_NET_PKT_BUF_USER_DATA_SIZE, NULL);
 
 #endif /* CONFIG_NET_BUF_FIXED_DATA_SIZE */
 
@@ -952,16 +956,15 @@ static struct net_buf *pkt_alloc_buffer(struct net_buf_pool *pool,
 
 #endif /* CONFIG_NET_BUF_FIXED_DATA_SIZE */
 
-static size_t pkt_buffer_length(struct net_pkt *pkt,
+static size_t pkt_buffer_length(struct net_if *iface,
+				sa_family_t family,
 				size_t size,
-				enum net_ip_protocol proto,
 				size_t existing)
 {
-	sa_family_t family = net_pkt_family(pkt);
 	size_t max_len;
 
-	if (net_pkt_iface(pkt)) {
-		max_len = net_if_get_mtu(net_pkt_iface(pkt));
+	if (iface) {
+		max_len = net_if_get_mtu(iface);
 	} else {
 		max_len = 0;
 	}
@@ -985,8 +988,7 @@ static size_t pkt_buffer_length(struct net_pkt *pkt,
 		max_len = MAX(max_len, NET_IPV4_MTU);
 	} else { /* family == AF_UNSPEC */
 #if defined (CONFIG_NET_L2_ETHERNET)
-		if (net_if_l2(net_pkt_iface(pkt)) ==
-		    &NET_L2_GET_NAME(ETHERNET)) {
+		if (net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET)) {
 			max_len += NET_ETH_MAX_HDR_SIZE;
 		} else
 #endif /* CONFIG_NET_L2_ETHERNET */
@@ -1173,7 +1175,8 @@ int net_pkt_alloc_buffer(struct net_pkt *pkt,
 	}
 
 	/* Calculate the maximum that can be allocated depending on size */
-	alloc_len = pkt_buffer_length(pkt, size + hdr_len, proto, alloc_len);
+	alloc_len = pkt_buffer_length(net_pkt_iface(pkt), net_pkt_family(pkt),
+				      size + hdr_len, alloc_len);
 
 	NET_DBG("Data allocation maximum size %zu (requested %zu)",
 		alloc_len, size);
@@ -1397,6 +1400,208 @@ struct net_pkt *net_pkt_rx_alloc_on_iface(struct net_if *iface,
 #endif
 }
 
+#if defined(CONFIG_NET_PKT_CACHE)
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+/* Packets sitting in a cache are not accounted as allocations, they are
+ * accounted to the caller taking them out of the cache.
+ */
+static void pkt_cache_track(struct net_pkt *pkt, bool add,
+			    const char *caller, int line)
+{
+	struct net_buf *frag;
+
+	for (frag = pkt->frags; frag; frag = frag->frags) {
+		if (add) {
+#if CONFIG_NET_PKT_LOG_LEVEL >= LOG_LEVEL_DBG
+			net_pkt_alloc_add(frag, false, caller, line);
+#endif
+		} else {
+			net_pkt_alloc_del(frag, caller, line);
+		}
+	}
+
+	if (add) {
+		net_pkt_alloc_add(pkt, true, caller, line);
+	} else {
+		net_pkt_alloc_del(pkt, caller, line);
+	}
+}
+#endif /* NET_LOG_LEVEL >= LOG_LEVEL_DBG */
+
+static struct net_pkt *pkt_cache_take(struct net_pkt_cache *cache,
+				      enum net_pkt_cache_class class,
+				      size_t len)
+{
+	struct net_pkt *pkt = NULL;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&cache->lock);
+
+	if (cache->count[class] > 0 && cache->len[class] == len) {
+		pkt = cache->pkts[class][--cache->count[class]];
+	}
+
+	k_spin_unlock(&cache->lock, key);
+
+	return pkt;
+}
+
+/* Called when a class is found empty. The packets are allocated without
+ * waiting, so the refill stops early if the pools are running low.
+ */
+static void pkt_cache_refill(struct net_pkt_cache *cache,
+			     enum net_pkt_cache_class class,
+			     size_t len)
+{
+	struct net_pkt *fresh[CONFIG_NET_PKT_CACHE_REFILL];
+	struct net_pkt *stale[CONFIG_NET_PKT_CACHE_DEPTH];
+	int fresh_count, stale_count = 0;
+	k_spinlock_key_t key;
+
+	for (fresh_count = 0; fresh_count < CONFIG_NET_PKT_CACHE_REFILL;
+	     fresh_count++) {
+		struct net_pkt *pkt;
+		struct net_buf *buf;
+
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+		pkt = pkt_alloc(&tx_pkts, K_NO_WAIT, __func__, __LINE__);
+#else
+		pkt = pkt_alloc(&tx_pkts, K_NO_WAIT);
+#endif
+		if (!pkt) {
+			break;
+		}
+
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+		buf = pkt_alloc_buffer(&tx_bufs, len, K_NO_WAIT,
+				       __func__, __LINE__);
+#else
+		buf = pkt_alloc_buffer(&tx_bufs, len, K_NO_WAIT);
+#endif
+		if (!buf) {
+			net_pkt_unref(pkt);
+			break;
+		}
+
+		net_pkt_append_buffer(pkt, buf);
+
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+		pkt_cache_track(pkt, false, __func__, __LINE__);
+#endif
+
+		fresh[fresh_count] = pkt;
+	}
+
+	key = k_spin_lock(&cache->lock);
+
+	/* The interface MTU changed, the cached packets are of no use */
+	if (cache->len[class] != len) {
+		while (cache->count[class] > 0) {
+			stale[stale_count++] =
+				cache->pkts[class][--cache->count[class]];
+		}
+
+		cache->len[class] = len;
+	}
+
+	while (fresh_count > 0 &&
+	       cache->count[class] < CONFIG_NET_PKT_CACHE_DEPTH) {
+		cache->pkts[class][cache->count[class]++] = fresh[--fresh_count];
+	}
+
+	k_spin_unlock(&cache->lock, key);
+
+	/* Whatever did not fit because of a concurrent refill */
+	while (fresh_count > 0) {
+		net_pkt_unref(fresh[--fresh_count]);
+	}
+
+	while (stale_count > 0) {
+		net_pkt_unref(stale[--stale_count]);
+	}
+}
+
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+static struct net_pkt *pkt_cache_get(struct net_if *iface,
+				     size_t size,
+				     sa_family_t family,
+				     enum net_ip_protocol proto,
+				     const char *caller, int line)
+#else
+static struct net_pkt *pkt_cache_get(struct net_if *iface,
+				     size_t size,
+				     sa_family_t family,
+				     enum net_ip_protocol proto)
+#endif
+{
+	struct net_pkt_cache *cache = &iface->pkt_cache;
+	enum net_pkt_cache_class class;
+	struct net_pkt *pkt;
+	size_t len;
+
+	if (family != AF_INET && family != AF_INET6) {
+		return NULL;
+	}
+
+	/* Same length as net_pkt_alloc_buffer() would allocate */
+	len = pkt_buffer_length(iface, family,
+				size + pkt_estimate_headers_length(NULL, family,
+								   proto),
+				0);
+
+	if (len <= CONFIG_NET_PKT_CACHE_SMALL_SIZE) {
+		class = NET_PKT_CACHE_SMALL;
+		len = CONFIG_NET_PKT_CACHE_SMALL_SIZE;
+	} else if (len == net_if_get_mtu(iface)) {
+		class = NET_PKT_CACHE_MTU;
+	} else {
+		return NULL;
+	}
+
+	pkt = pkt_cache_take(cache, class, len);
+	if (!pkt) {
+		pkt_cache_refill(cache, class, len);
+
+		pkt = pkt_cache_take(cache, class, len);
+		if (!pkt) {
+			return NULL;
+		}
+	}
+
+	net_pkt_set_iface(pkt, iface);
+	net_pkt_set_family(pkt, family);
+
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS) ||
+	    IS_ENABLED(CONFIG_NET_PKT_TXTIME_STATS)) {
+		net_pkt_set_create_time(pkt, k_cycle_get_32());
+	}
+
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+	pkt_cache_track(pkt, true, caller, line);
+
+	NET_DBG("Cached pkt %p class %d len %zu (%s():%d)",
+		pkt, class, len, caller, line);
+#endif
+
+	return pkt;
+}
+
+void net_pkt_cache_flush(struct net_if *iface)
+{
+	struct net_pkt_cache *cache = &iface->pkt_cache;
+	int class;
+
+	for (class = 0; class < NET_PKT_CACHE_CLASSES; class++) {
+		struct net_pkt *pkt;
+
+		while ((pkt = pkt_cache_take(cache, class,
+					     cache->len[class])) != NULL) {
+			net_pkt_unref(pkt);
+		}
+	}
+}
+#endif /* CONFIG_NET_PKT_CACHE */
+
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 static struct net_pkt *
 pkt_alloc_with_buffer(struct k_mem_slab *slab,
@@ -1423,6 +1628,19 @@ pkt_alloc_with_buffer(struct k_mem_slab *slab,
 
 	NET_DBG("On iface %p size %zu", iface, size);
 
+#if defined(CONFIG_NET_PKT_CACHE)
+	if (slab == &tx_pkts && iface) {
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+		pkt = pkt_cache_get(iface, size, family, proto, caller, line);
+#else
+		pkt = pkt_cache_get(iface, size, family, proto);
+#endif
+		if (pkt) {
+			return pkt;
+		}
+	}
+#endif
+
 #if NET_LOG_LEVEL >= LOG_LEVEL_DBG
 	pkt = pkt_alloc_on_iface(slab, iface, timeout, caller, line);
 #else
@@ -1843,7 +2061,10 @@ static void clone_pkt_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt)
 
 	net_pkt_set_l2_bridged(clone_pkt, net_pkt_is_l2_bridged(pkt));
 	net_pkt_set_l2_processed(clone_pkt, net_pkt_is_l2_processed(pkt));
+	net_pkt_set_l4_chksum_ok(clone_pkt, net_pkt_is_l4_chksum_ok(pkt));
 	net_pkt_set_ll_proto_type(clone_pkt, net_pkt_ll_proto_type(pkt));
+	net_pkt_set_gso_size(clone_pkt, net_pkt_gso_size(pkt));
+	net_pkt_set_flow_hash(clone_pkt, net_pkt_flow_hash(pkt));
 
 	if (pkt->buffer && clone_pkt->buffer) {
 		memcpy(net_pkt_lladdr_src(clone_pkt), net_pkt_lladdr_src(pkt),
@@ -1970,6 +2191,66 @@ struct net_pkt *net_pkt_shallow_clone(struct net_pkt *pkt, k_timeout_t timeout)
 	return clone_pkt;
 }
 
+struct net_pkt *net_pkt_shared_clone(struct net_pkt *pkt, k_timeout_t timeout)
+{
+	uint64_t end = sys_clock_timeout_end_calc(timeout);
+	size_t cursor_offset = net_pkt_get_current_offset(pkt);
+	bool overwrite = net_pkt_is_being_overwritten(pkt);
+	struct net_pkt *clone_pkt;
+	struct net_buf *buf;
+
+#if NET_LOG_LEVEL >= LOG_LEVEL_DBG
+	clone_pkt = pkt_alloc(pkt->slab, timeout, __func__, __LINE__);
+#else
+	clone_pkt = pkt_alloc(pkt->slab, timeout);
+#endif
+	if (!clone_pkt) {
+		return NULL;
+	}
+
+	net_pkt_set_iface(clone_pkt, net_pkt_iface(pkt));
+
+	for (buf = pkt->buffer; buf; buf = buf->frags) {
+		struct net_buf *frag;
+
+		if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT) &&
+		    !K_TIMEOUT_EQ(timeout, K_FOREVER)) {
+			int64_t remaining = end - sys_clock_tick_get();
+
+			if (remaining <= 0) {
+				timeout = K_NO_WAIT;
+			} else {
+				timeout = Z_TIMEOUT_TICKS(remaining);
+			}
+		}
+
+		frag = net_buf_shared_clone(buf, timeout);
+		if (!frag) {
+			net_pkt_unref(clone_pkt);
+			return NULL;
+		}
+
+		net_pkt_append_buffer(clone_pkt, frag);
+	}
+
+	/* The data is already there, moving the cursor must not add any */
+	net_pkt_set_overwrite(clone_pkt, true);
+
+	clone_pkt_attributes(pkt, clone_pkt);
+
+	net_pkt_cursor_init(clone_pkt);
+
+	if (cursor_offset) {
+		net_pkt_skip(clone_pkt, cursor_offset);
+	}
+
+	net_pkt_set_overwrite(clone_pkt, overwrite);
+
+	NET_DBG("Shared cloned %p to %p", pkt, clone_pkt);
+
+	return clone_pkt;
+}
+
 size_t net_pkt_remaining_data(struct net_pkt *pkt)
 {
 	struct net_buf *buf;
@@ -68,6 +68,15 @@ static inline const char *net_context_state(struct net_context *context)
 }
 #endif
 
+#if defined(CONFIG_NET_PKT_CACHE)
+extern void net_pkt_cache_flush(struct net_if *iface);
+#else
+static inline void net_pkt_cache_flush(struct net_if *iface)
+{
+	ARG_UNUSED(iface);
+}
+#endif
+
 #if defined(CONFIG_NET_NATIVE)
 enum net_verdict net_ipv4_input(struct net_pkt *pkt);
 enum net_verdict net_ipv6_input(struct net_pkt *pkt, bool is_loopback);
@@ -143,6 +152,44 @@ int net_ipv6_send_fragmented_pkt(struct net_if *iface, struct net_pkt *pkt,
 				 uint16_t pkt_len);
 #endif
 
+#if defined(CONFIG_NET_GRO)
+/**
+ * @brief Try to coalesce a received TCP segment with the previous segments
+ * of the same connection.
+ *
+ * @param pkt Packet processed by the L2, starting with the IP header.
+ *
+ * @return NET_OK if the packet was consumed, NET_CONTINUE if it needs to be
+ * passed to the IP layer as usual.
+ */
+enum net_verdict net_gro_receive(struct net_pkt *pkt);
+
+/**
+ * @brief Pass all the coalesced packets to the IP layer.
+ */
+void net_gro_flush(void);
+
+/**
+ * @brief Pass a coalesced packet to the IP layer, implemented by net_core.
+ */
+void net_gro_deliver(struct net_pkt *pkt);
+#else
+#define net_gro_receive(pkt) NET_CONTINUE
+#define net_gro_flush()
+#endif /* CONFIG_NET_GRO */
+
+#if defined(CONFIG_NET_GSO)
+/**
+ * @brief Split a large outgoing TCP packet into net_pkt_gso_size() sized
+ * segments and send them.
+ *
+ * @param pkt Packet to split. It is consumed only if 0 is returned.
+ *
+ * @return 0 on success, <0 otherwise.
+ */
+int net_gso_send(struct net_pkt *pkt);
+#endif /* CONFIG_NET_GSO */
+
 extern const char *net_proto2str(int family, int proto);
 extern char *net_byte_to_hex(char *ptr, uint8_t byte, char base, bool pad);
 extern char *net_sprint_ll_addr_buf(const uint8_t *ll, uint8_t ll_len,
@@ -150,6 +197,62 @@ extern char *net_sprint_ll_addr_buf(const uint8_t *ll, uint8_t ll_len,
 extern uint16_t calc_chksum(uint16_t sum_in, const uint8_t *data, size_t len);
 extern uint16_t net_calc_chksum(struct net_pkt *pkt, uint8_t proto);
 
+/**
+ * @brief Update a checksum after a region it covers has been rewritten
+ *
+ * Incremental update as described in RFC 1624, so that header rewrites
+ * such as address or port translation do not need the whole packet to be
+ * summed again.
+ *
+ * @param chksum	Checksum field as found in the header (network order)
+ * @param old_data	Data before the rewrite
+ * @param new_data	Data after the rewrite
+ * @param len		Length of the rewritten region, must be even
+ *
+ * @return Updated checksum field value (network order)
+ */
+extern uint16_t net_chksum_update(uint16_t chksum, const uint8_t *old_data,
+				  const uint8_t *new_data, size_t len);
+
+/**
+ * @brief Update a checksum after a 16-bit field it covers has changed
+ *
+ * @param chksum	Checksum field as found in the header
+ * @param old_val	Previous field value, same byte order as @p chksum
+ * @param new_val	New field value, same byte order as @p chksum
+ *
+ * @return Updated checksum field value
+ */
+static inline uint16_t net_chksum_update16(uint16_t chksum, uint16_t old_val,
+					   uint16_t new_val)
+{
+	uint32_t sum;
+
+	/* HC' = ~(~HC + ~m + m'), RFC 1624 eqn. 3 */
+	sum = (uint16_t)~chksum + (uint16_t)~old_val + (uint32_t)new_val;
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return (uint16_t)~sum;
+}
+
+/**
+ * @brief Check if the L4 checksum of a received packet must be verified
+ *
+ * The checksum is not verified again if the network interface offloads
+ * RX checksum verification altogether, or if the driver or the stack has
+ * already verified it for this packet, see net_pkt_set_l4_chksum_ok().
+ *
+ * @param pkt Received network packet
+ *
+ * @return True if the checksum needs to be calculated, false otherwise.
+ */
+static inline bool net_pkt_need_rx_l4_chksum(struct net_pkt *pkt)
+{
+	return net_if_need_calc_rx_checksum(net_pkt_iface(pkt)) &&
+	       !net_pkt_is_l4_chksum_ok(pkt);
+}
+
 /**
  * @brief Deliver the incoming packet through the recv_cb of the net_context
  *        to the upper layers
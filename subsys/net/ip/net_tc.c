@@ -10,9 +10,11 @@ LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 #include <zephyr/kernel.h>
 #include <string.h>
 
+#include <zephyr/sys/byteorder.h>
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/net_pkt.h>
 #include <zephyr/net/net_stats.h>
+#include <zephyr/net/ethernet.h>
 
 #include "net_private.h"
 #include "net_stats.h"
@@ -21,23 +23,233 @@ LOG_MODULE_REGISTER(net_tc, CONFIG_NET_TC_LOG_LEVEL);
 /* Template for thread name. The "xx" is either "TX" denoting transmit thread,
  * or "RX" denoting receive thread. The "q[y]" denotes the traffic class queue
  * where y indicates the traffic class id. The value of y can be from 0 to 7.
+ * With flow steering, the ".z" denotes the queue within the traffic class.
  */
-#define MAX_NAME_LEN sizeof("xx_q[y]")
+#define MAX_NAME_LEN sizeof("xx_q[y.z]")
+
+#if defined(CONFIG_NET_TC_TX_FLOW_QUEUES)
+#define NET_TC_TX_FLOW_QUEUES CONFIG_NET_TC_TX_FLOW_QUEUES
+#else
+#define NET_TC_TX_FLOW_QUEUES 1
+#endif
+
+#if defined(CONFIG_NET_TC_RX_FLOW_QUEUES)
+#define NET_TC_RX_FLOW_QUEUES CONFIG_NET_TC_RX_FLOW_QUEUES
+#else
+#define NET_TC_RX_FLOW_QUEUES 1
+#endif
+
+#define NET_TC_TX_QUEUE_COUNT (NET_TC_TX_COUNT * NET_TC_TX_FLOW_QUEUES)
+#define NET_TC_RX_QUEUE_COUNT (NET_TC_RX_COUNT * NET_TC_RX_FLOW_QUEUES)
 
 /* Stacks for TX work queue */
-K_KERNEL_STACK_ARRAY_DEFINE(tx_stack, NET_TC_TX_COUNT,
+K_KERNEL_STACK_ARRAY_DEFINE(tx_stack, NET_TC_TX_QUEUE_COUNT,
 			    CONFIG_NET_TX_STACK_SIZE);
 
 /* Stacks for RX work queue */
-K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, NET_TC_RX_COUNT,
+K_KERNEL_STACK_ARRAY_DEFINE(rx_stack, NET_TC_RX_QUEUE_COUNT,
 			    CONFIG_NET_RX_STACK_SIZE);
 
+/* The queues of traffic class tc are found at index
+ * tc * NET_TC_xX_FLOW_QUEUES onwards.
+ */
 #if NET_TC_TX_COUNT > 0
-static struct net_traffic_class tx_classes[NET_TC_TX_COUNT];
+static struct net_traffic_class tx_classes[NET_TC_TX_QUEUE_COUNT];
 #endif
 
 #if NET_TC_RX_COUNT > 0
-static struct net_traffic_class rx_classes[NET_TC_RX_COUNT];
+static struct net_traffic_class rx_classes[NET_TC_RX_QUEUE_COUNT];
+#endif
+
+#if defined(CONFIG_NET_TC_FLOW_STEERING)
+/* The default Toeplitz key of the Microsoft RSS specification */
+static const uint8_t flow_hash_key[] = {
+	0x6d, 0x5a, 0x56, 0xda, 0x25, 0x5b, 0x0e, 0xc2,
+	0x41, 0x67, 0x25, 0x3d, 0x43, 0xa3, 0x8f, 0xb0,
+	0xd0, 0xca, 0x2b, 0xcb, 0xae, 0x7b, 0x30, 0xb4,
+	0x77, 0xcb, 0x2d, 0xa3, 0x80, 0x30, 0xf2, 0x0c,
+	0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa,
+};
+
+/* Source and destination addresses followed by source and destination
+ * ports.
+ */
+#define FLOW_HASH_INPUT_MAX (2 * NET_IPV6_ADDR_SIZE + 2 * sizeof(uint16_t))
+
+BUILD_ASSERT(sizeof(flow_hash_key) >= FLOW_HASH_INPUT_MAX + sizeof(uint32_t));
+
+static uint32_t toeplitz_hash(const uint8_t *input, size_t len)
+{
+	uint32_t key = sys_get_be32(flow_hash_key);
+	uint32_t hash = 0U;
+
+	for (size_t i = 0; i < len; i++) {
+		for (int bit = 7; bit >= 0; bit--) {
+			if (input[i] & BIT(bit)) {
+				hash ^= key;
+			}
+
+			key <<= 1;
+
+			if (flow_hash_key[i + sizeof(uint32_t)] & BIT(bit)) {
+				key |= 1U;
+			}
+		}
+	}
+
+	return hash;
+}
+
+/* Hash the addresses, and for TCP and UDP the ports, of the IP packet
+ * starting at offset. Returns 0 if the packet is not an IP packet.
+ */
+static uint32_t flow_hash_calc(struct net_pkt *pkt, size_t offset)
+{
+	bool overwrite = net_pkt_is_being_overwritten(pkt);
+	uint8_t input[FLOW_HASH_INPUT_MAX];
+	struct net_pkt_cursor backup;
+	union {
+		struct net_ipv4_hdr ipv4;
+		struct net_ipv6_hdr ipv6;
+	} hdr;
+	size_t len = 0;
+	uint8_t proto;
+	int ret;
+
+	net_pkt_cursor_backup(pkt, &backup);
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (net_pkt_skip(pkt, offset) ||
+	    net_pkt_read(pkt, &hdr.ipv4, sizeof(hdr.ipv4))) {
+		goto out;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && (hdr.ipv4.vhl & 0xf0) == 0x40) {
+		uint16_t frag = sys_get_be16(hdr.ipv4.offset);
+
+		memcpy(input, hdr.ipv4.src, NET_IPV4_ADDR_SIZE);
+		memcpy(input + NET_IPV4_ADDR_SIZE, hdr.ipv4.dst,
+		       NET_IPV4_ADDR_SIZE);
+		len = 2 * NET_IPV4_ADDR_SIZE;
+
+		/* Only the first fragment carries the ports, so all the
+		 * fragments are hashed by the addresses only.
+		 */
+		if (frag & (NET_IPV4_MORE_FRAG_MASK |
+			    NET_IPV4_FRAGH_OFFSET_MASK)) {
+			goto out;
+		}
+
+		proto = hdr.ipv4.proto;
+
+		if (net_pkt_skip(pkt, (hdr.ipv4.vhl & 0x0f) * 4U -
+				 sizeof(hdr.ipv4))) {
+			goto out;
+		}
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   (hdr.ipv6.vtc & 0xf0) == 0x60) {
+		if (net_pkt_read(pkt, (uint8_t *)&hdr.ipv6 + sizeof(hdr.ipv4),
+				 sizeof(hdr.ipv6) - sizeof(hdr.ipv4))) {
+			goto out;
+		}
+
+		memcpy(input, hdr.ipv6.src, NET_IPV6_ADDR_SIZE);
+		memcpy(input + NET_IPV6_ADDR_SIZE, hdr.ipv6.dst,
+		       NET_IPV6_ADDR_SIZE);
+		len = 2 * NET_IPV6_ADDR_SIZE;
+
+		/* Extension headers are not followed */
+		proto = hdr.ipv6.nexthdr;
+	} else {
+		goto out;
+	}
+
+	if (proto == IPPROTO_TCP || proto == IPPROTO_UDP) {
+		ret = net_pkt_read(pkt, input + len, 2 * sizeof(uint16_t));
+		if (ret == 0) {
+			len += 2 * sizeof(uint16_t);
+		}
+	}
+
+out:
+	net_pkt_cursor_restore(pkt, &backup);
+	net_pkt_set_overwrite(pkt, overwrite);
+
+	return len > 0 ? toeplitz_hash(input, len) : 0U;
+}
+
+static uint32_t rx_flow_hash(struct net_pkt *pkt)
+{
+	size_t offset = 0;
+
+#if defined(CONFIG_NET_L2_ETHERNET)
+	/* The link layer header is not parsed yet */
+	if (net_if_l2(net_pkt_iface(pkt)) == &NET_L2_GET_NAME(ETHERNET)) {
+		struct net_eth_hdr eth_hdr;
+		struct net_pkt_cursor backup;
+		uint16_t vlan_hdr[2];
+		uint16_t type;
+		int ret;
+
+		offset = sizeof(eth_hdr);
+
+		net_pkt_cursor_backup(pkt, &backup);
+		net_pkt_cursor_init(pkt);
+
+		ret = net_pkt_read(pkt, &eth_hdr, sizeof(eth_hdr));
+		type = ntohs(eth_hdr.type);
+
+		if (ret == 0 && type == NET_ETH_PTYPE_VLAN) {
+			ret = net_pkt_read(pkt, vlan_hdr, sizeof(vlan_hdr));
+			type = ntohs(vlan_hdr[1]);
+			offset += sizeof(vlan_hdr);
+		}
+
+		net_pkt_cursor_restore(pkt, &backup);
+
+		if (ret < 0 || (type != NET_ETH_PTYPE_IP &&
+				type != NET_ETH_PTYPE_IPV6)) {
+			return 0U;
+		}
+	}
+#endif
+
+	return flow_hash_calc(pkt, offset);
+}
+
+/* Select the queue of the traffic class by the flow of the packet */
+static size_t flow_queue(struct net_pkt *pkt, bool rx, size_t queues)
+{
+	uint32_t hash;
+
+	if (queues == 1) {
+		return 0;
+	}
+
+	hash = net_pkt_flow_hash(pkt);
+	if (hash == 0U) {
+		/* Outgoing packets start with the IP header */
+		hash = rx ? rx_flow_hash(pkt) : flow_hash_calc(pkt, 0);
+		net_pkt_set_flow_hash(pkt, hash);
+	}
+
+	return hash % queues;
+}
+#else
+#define flow_queue(pkt, rx, queues) 0
+#endif /* CONFIG_NET_TC_FLOW_STEERING */
+
+#if defined(CONFIG_NET_TC_FLOW_STEERING) && defined(CONFIG_SCHED_CPU_MASK)
+/* Spread the queues of each traffic class over the CPUs */
+static void flow_queue_cpu_pin(k_tid_t tid, int queue)
+{
+	if (k_thread_cpu_pin(tid, queue % (int)arch_num_cpus()) < 0) {
+		NET_DBG("Cannot pin thread %p", tid);
+	}
+}
+#else
+#define flow_queue_cpu_pin(tid, queue)
 #endif
 
 #if NET_TC_RX_COUNT > 0 || NET_TC_TX_COUNT > 0
@@ -50,9 +262,12 @@ static void submit_to_queue(struct k_fifo *queue, struct net_pkt *pkt)
 bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt)
 {
 #if NET_TC_TX_COUNT > 0
+	size_t queue = tc * NET_TC_TX_FLOW_QUEUES +
+		flow_queue(pkt, false, NET_TC_TX_FLOW_QUEUES);
+
 	net_pkt_set_tx_stats_tick(pkt, k_cycle_get_32());
 
-	submit_to_queue(&tx_classes[tc].fifo, pkt);
+	submit_to_queue(&tx_classes[queue].fifo, pkt);
 #else
 	ARG_UNUSED(tc);
 	ARG_UNUSED(pkt);
@@ -63,9 +278,12 @@ bool net_tc_submit_to_tx_queue(uint8_t tc, struct net_pkt *pkt)
 void net_tc_submit_to_rx_queue(uint8_t tc, struct net_pkt *pkt)
 {
 #if NET_TC_RX_COUNT > 0
+	size_t queue = tc * NET_TC_RX_FLOW_QUEUES +
+		flow_queue(pkt, true, NET_TC_RX_FLOW_QUEUES);
+
 	net_pkt_set_rx_stats_tick(pkt, k_cycle_get_32());
 
-	submit_to_queue(&rx_classes[tc].fifo, pkt);
+	submit_to_queue(&rx_classes[queue].fifo, pkt);
 #else
 	ARG_UNUSED(tc);
 	ARG_UNUSED(pkt);
@@ -248,6 +466,13 @@ static void tc_rx_handler(struct k_fifo *fifo)
 		}
 
 		net_process_rx_packet(pkt);
+
+		/* Coalesced TCP segments are held only while there are
+		 * more packets to process.
+		 */
+		if (IS_ENABLED(CONFIG_NET_GRO) && k_fifo_is_empty(fifo)) {
+			net_gro_flush();
+		}
 	}
 }
 #endif
@@ -285,12 +510,12 @@ void net_tc_tx_init(void)
 	net_if_foreach(net_tc_tx_stats_priority_setup, NULL);
 #endif
 
-	for (i = 0; i < NET_TC_TX_COUNT; i++) {
+	for (i = 0; i < NET_TC_TX_QUEUE_COUNT; i++) {
 		uint8_t thread_priority;
 		int priority;
 		k_tid_t tid;
 
-		thread_priority = tx_tc2thread(i);
+		thread_priority = tx_tc2thread(i / NET_TC_TX_FLOW_QUEUES);
 
 		priority = IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE) ?
 			K_PRIO_COOP(thread_priority) :
@@ -320,10 +545,19 @@ void net_tc_tx_init(void)
 		if (IS_ENABLED(CONFIG_THREAD_NAME)) {
 			char name[MAX_NAME_LEN];
 
-			snprintk(name, sizeof(name), "tx_q[%d]", i);
+			if (NET_TC_TX_FLOW_QUEUES > 1) {
+				snprintk(name, sizeof(name), "tx_q[%d.%d]",
+					 i / NET_TC_TX_FLOW_QUEUES,
+					 i % NET_TC_TX_FLOW_QUEUES);
+			} else {
+				snprintk(name, sizeof(name), "tx_q[%d]", i);
+			}
+
 			k_thread_name_set(tid, name);
 		}
 
+		flow_queue_cpu_pin(tid, i % NET_TC_TX_FLOW_QUEUES);
+
 		k_thread_start(tid);
 	}
 #endif
@@ -343,12 +577,12 @@ void net_tc_rx_init(void)
 	net_if_foreach(net_tc_rx_stats_priority_setup, NULL);
 #endif
 
-	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+	for (i = 0; i < NET_TC_RX_QUEUE_COUNT; i++) {
 		uint8_t thread_priority;
 		int priority;
 		k_tid_t tid;
 
-		thread_priority = rx_tc2thread(i);
+		thread_priority = rx_tc2thread(i / NET_TC_RX_FLOW_QUEUES);
 
 		priority = IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE) ?
 			K_PRIO_COOP(thread_priority) :
@@ -378,10 +612,19 @@ void net_tc_rx_init(void)
 		if (IS_ENABLED(CONFIG_THREAD_NAME)) {
 			char name[MAX_NAME_LEN];
 
-			snprintk(name, sizeof(name), "rx_q[%d]", i);
+			if (NET_TC_RX_FLOW_QUEUES > 1) {
+				snprintk(name, sizeof(name), "rx_q[%d.%d]",
+					 i / NET_TC_RX_FLOW_QUEUES,
+					 i % NET_TC_RX_FLOW_QUEUES);
+			} else {
+				snprintk(name, sizeof(name), "rx_q[%d]", i);
+			}
+
 			k_thread_name_set(tid, name);
 		}
 
+		flow_queue_cpu_pin(tid, i % NET_TC_RX_FLOW_QUEUES);
+
 		k_thread_start(tid);
 	}
 #endif
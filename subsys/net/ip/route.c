@@ -36,7 +36,34 @@ LOG_MODULE_REGISTER(net_route, CONFIG_NET_ROUTE_LOG_LEVEL);
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
  */
-static sys_slist_t routes;
+static sys_dlist_t routes = SYS_DLIST_STATIC_INIT(&routes);
+
+/* Node of the binary, path compressed, longest prefix match trie. Nodes
+ * without routes are only kept where two branches meet, so at most
+ * 2 * CONFIG_NET_MAX_ROUTES - 1 nodes are ever needed.
+ */
+struct route_lpm_node {
+	struct route_lpm_node *child[2];
+
+	/* Routes with exactly this prefix, on different interfaces */
+	sys_slist_t routes;
+
+	struct in6_addr prefix;
+	uint8_t len;
+};
+
+static struct route_lpm_node lpm_nodes[2 * CONFIG_NET_MAX_ROUTES];
+static struct route_lpm_node *lpm_free_nodes;
+static struct route_lpm_node *lpm_root;
+
+/* Last destination looked up on an interface */
+struct route_cache_entry {
+	struct net_if *iface;
+	struct net_route_entry *route;
+	struct in6_addr dst;
+};
+
+static struct route_cache_entry route_cache[CONFIG_NET_IF_MAX_IPV6_COUNT];
 
 /* Track currently active route lifetime timers */
 static sys_slist_t active_route_lifetime_timers;
@@ -272,41 +299,226 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_remove(&route->node);
+	sys_dlist_prepend(&routes, &route->node);
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+static inline void route_cache_clear(void)
 {
-	struct net_route_entry *route, *found = NULL;
-	uint8_t longest_match = 0U;
-	int i;
+	(void)memset(route_cache, 0, sizeof(route_cache));
+}
 
-	k_mutex_lock(&lock, K_FOREVER);
+static inline uint8_t lpm_bit(const struct in6_addr *addr, uint8_t pos)
+{
+	return (addr->s6_addr[pos / 8] >> (7 - (pos % 8))) & 1;
+}
 
-	for (i = 0; i < CONFIG_NET_MAX_ROUTES && longest_match < 128; i++) {
-		struct net_nbr *nbr = get_nbr(i);
+/* Number of leading bits, up to max_len, that are the same in a and b */
+static uint8_t lpm_common_len(const struct in6_addr *a,
+			      const struct in6_addr *b, uint8_t max_len)
+{
+	uint8_t len = 0U;
 
-		if (!nbr->ref) {
-			continue;
+	for (int i = 0; i < sizeof(a->s6_addr) && len < max_len; i++) {
+		uint8_t diff = a->s6_addr[i] ^ b->s6_addr[i];
+
+		if (diff != 0U) {
+			len += 8 - find_msb_set(diff);
+			break;
 		}
 
-		if (iface && nbr->iface != iface) {
-			continue;
+		len += 8;
+	}
+
+	return MIN(len, max_len);
+}
+
+static struct route_lpm_node *lpm_node_alloc(const struct in6_addr *addr,
+					     uint8_t len)
+{
+	struct route_lpm_node *node = lpm_free_nodes;
+
+	if (node == NULL) {
+		return NULL;
+	}
+
+	lpm_free_nodes = node->child[0];
+
+	(void)memset(node, 0, sizeof(*node));
+	node->len = len;
+
+	/* Only the prefix bits are kept */
+	for (int i = 0; i < sizeof(node->prefix.s6_addr) && len > 0; i++) {
+		if (len >= 8U) {
+			node->prefix.s6_addr[i] = addr->s6_addr[i];
+			len -= 8U;
+		} else {
+			node->prefix.s6_addr[i] = addr->s6_addr[i] &
+						  (uint8_t)(0xff << (8 - len));
+			len = 0U;
 		}
+	}
 
-		route = net_route_data(nbr);
+	return node;
+}
+
+static void lpm_node_free(struct route_lpm_node *node)
+{
+	node->child[0] = lpm_free_nodes;
+	lpm_free_nodes = node;
+}
+
+static int lpm_insert(struct net_route_entry *route)
+{
+	struct route_lpm_node **link = &lpm_root;
+	struct route_lpm_node *node, *new_node, *branch;
+	uint8_t len = route->prefix_len;
+	uint8_t common = 0U;
+
+	while ((node = *link) != NULL) {
+		common = lpm_common_len(&route->addr, &node->prefix,
+					MIN(len, node->len));
+		if (common < node->len) {
+			break;
+		}
 
-		if (route->prefix_len >= longest_match &&
-		    net_ipv6_is_prefix(dst->s6_addr,
-				       route->addr.s6_addr,
-				       route->prefix_len)) {
-			found = route;
-			longest_match = route->prefix_len;
+		if (len == node->len) {
+			sys_slist_prepend(&node->routes, &route->lpm_node);
+			return 0;
 		}
+
+		link = &node->child[lpm_bit(&route->addr, node->len)];
+	}
+
+	new_node = lpm_node_alloc(&route->addr, len);
+	if (new_node == NULL) {
+		return -ENOMEM;
+	}
+
+	sys_slist_prepend(&new_node->routes, &route->lpm_node);
+
+	if (node == NULL) {
+		*link = new_node;
+		return 0;
+	}
+
+	if (common == len) {
+		/* The new prefix covers the existing node */
+		new_node->child[lpm_bit(&node->prefix, len)] = node;
+		*link = new_node;
+		return 0;
+	}
+
+	/* The prefixes diverge, so they need a common parent */
+	branch = lpm_node_alloc(&route->addr, common);
+	if (branch == NULL) {
+		lpm_node_free(new_node);
+		return -ENOMEM;
 	}
 
+	branch->child[lpm_bit(&route->addr, common)] = new_node;
+	branch->child[lpm_bit(&node->prefix, common)] = node;
+	*link = branch;
+
+	return 0;
+}
+
+static inline struct route_lpm_node *lpm_only_child(struct route_lpm_node *node)
+{
+	return node->child[0] != NULL ? node->child[0] : node->child[1];
+}
+
+static void lpm_remove(struct net_route_entry *route)
+{
+	struct route_lpm_node **link = &lpm_root;
+	struct route_lpm_node **parent_link = NULL;
+	struct route_lpm_node *node, *parent;
+
+	while ((node = *link) != NULL && node->len < route->prefix_len) {
+		parent_link = link;
+		link = &node->child[lpm_bit(&route->addr, node->len)];
+	}
+
+	if (node == NULL || node->len != route->prefix_len ||
+	    !sys_slist_find_and_remove(&node->routes, &route->lpm_node)) {
+		return;
+	}
+
+	if (!sys_slist_is_empty(&node->routes) ||
+	    (node->child[0] != NULL && node->child[1] != NULL)) {
+		return;
+	}
+
+	*link = lpm_only_child(node);
+	lpm_node_free(node);
+
+	if (parent_link == NULL) {
+		return;
+	}
+
+	/* The parent may have been left without routes and one child */
+	parent = *parent_link;
+	if (sys_slist_is_empty(&parent->routes) &&
+	    (parent->child[0] == NULL || parent->child[1] == NULL)) {
+		*parent_link = lpm_only_child(parent);
+		lpm_node_free(parent);
+	}
+}
+
+static struct net_route_entry *lpm_lookup(struct net_if *iface,
+					  const struct in6_addr *dst)
+{
+	struct route_lpm_node *node = lpm_root;
+	struct net_route_entry *route, *found = NULL;
+
+	while (node != NULL &&
+	       net_ipv6_is_prefix(dst->s6_addr, node->prefix.s6_addr,
+				  node->len)) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&node->routes, route, lpm_node) {
+			if (iface == NULL || route->iface == iface) {
+				found = route;
+				break;
+			}
+		}
+
+		if (node->len == 128U) {
+			break;
+		}
+
+		node = node->child[lpm_bit(dst, node->len)];
+	}
+
+	return found;
+}
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct route_cache_entry *cache = NULL;
+	struct net_route_entry *found;
+	int idx;
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	idx = iface != NULL ? net_if_get_by_iface(iface) : -1;
+	if (idx > 0) {
+		cache = &route_cache[(idx - 1) % ARRAY_SIZE(route_cache)];
+
+		if (cache->route != NULL && cache->iface == iface &&
+		    net_ipv6_addr_cmp(&cache->dst, dst)) {
+			found = cache->route;
+			goto out;
+		}
+	}
+
+	found = lpm_lookup(iface, dst);
+	if (found && cache) {
+		cache->iface = iface;
+		cache->route = found;
+		net_ipaddr_copy(&cache->dst, dst);
+	}
+
+out:
 	if (found) {
 		net_route_info("Found", found, dst);
 
@@ -402,9 +614,9 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
-		sys_snode_t *last = sys_slist_peek_tail(&routes);
+		sys_dnode_t *last = sys_dlist_peek_tail(&routes);
 
-		sys_slist_find_and_remove(&routes, last);
+		sys_dlist_remove(last);
 
 		route = CONTAINER_OF(last,
 				     struct net_route_entry,
@@ -453,7 +665,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 
 	net_route_update_lifetime(route, lifetime);
 
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_prepend(&routes, &route->node);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -464,6 +676,15 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	sys_slist_init(&route->nexthop);
 	sys_slist_prepend(&route->nexthop, &nexthop_route->node);
 
+	if (lpm_insert(route) < 0) {
+		NET_ERR("No free route lookup node!");
+		net_route_del(route);
+		route = NULL;
+		goto exit;
+	}
+
+	route_cache_clear();
+
 	net_route_info("Added", route, addr);
 
 #if defined(CONFIG_NET_MGMT_EVENT_INFO)
@@ -595,7 +816,12 @@ int net_route_del(struct net_route_entry *route)
 		}
 	}
 
-	sys_slist_find_and_remove(&routes, &route->node);
+	if (sys_dnode_is_linked(&route->node)) {
+		sys_dlist_remove(&route->node);
+	}
+
+	lpm_remove(route);
+	route_cache_clear();
 
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
@@ -824,7 +1050,7 @@ int net_route_mcast_forward_packet(struct net_pkt *pkt,
 			continue;
 		}
 
-		pkt_cpy = net_pkt_shallow_clone(pkt, K_NO_WAIT);
+		pkt_cpy = net_pkt_shared_clone(pkt, K_NO_WAIT);
 
 		if (pkt_cpy == NULL) {
 			err--;
@@ -1101,4 +1327,8 @@ void net_route_init(void)
 		CONFIG_NET_MAX_NEXTHOPS, sizeof(net_route_nexthop_pool));
 
 	k_work_init_delayable(&route_lifetime_timer, route_lifetime_timeout);
+
+	for (int i = 0; i < ARRAY_SIZE(lpm_nodes); i++) {
+		lpm_node_free(&lpm_nodes[i]);
+	}
 }
@@ -14,6 +14,7 @@
 #define __ROUTE_H
 
 #include <zephyr/kernel.h>
+#include <zephyr/sys/dlist.h>
 #include <zephyr/sys/slist.h>
 
 #include <zephyr/net/net_ip.h>
@@ -47,7 +48,12 @@ struct net_route_entry {
 	 * we can remove it if we run out of available routes.
 	 * The oldest one is the last entry in the list.
 	 */
-	sys_snode_t node;
+	sys_dnode_t node;
+
+	/** Node in the list of routes having the same prefix in the
+	 * longest prefix match trie.
+	 */
+	sys_snode_t lpm_node;
 
 	/** List of neighbors that the routes go through. */
 	sys_slist_t nexthop;
@@ -12,6 +12,7 @@ LOG_MODULE_REGISTER(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
 #include <stdlib.h>
 #include <zephyr/kernel.h>
 #include <zephyr/random/rand32.h>
+#include <zephyr/sys/byteorder.h>
 
 #if defined(CONFIG_NET_TCP_ISN_RFC6528)
 #include <mbedtls/md5.h>
@@ -54,11 +55,25 @@ static int tcp_window =
 
 static sys_slist_t tcp_conns = SYS_SLIST_STATIC_INIT(&tcp_conns);
 
+/* Connections by addresses and ports, the seed makes the bucket of a
+ * connection unpredictable for the peers.
+ */
+static sys_slist_t tcp_conn_hash[CONFIG_NET_TCP_CONN_HASH_BUCKETS];
+static uint32_t tcp_conn_hash_seed;
+
 static K_MUTEX_DEFINE(tcp_lock);
 
 K_MEM_SLAB_DEFINE_STATIC(tcp_conns_slab, sizeof(struct tcp),
 				CONFIG_NET_MAX_CONTEXTS, 4);
 
+/* Out-of-order data ranges, only needed if receive queueing is enabled */
+#define TCP_OOO_RANGES (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT ?		\
+			(CONFIG_NET_MAX_CONTEXTS *			\
+			 CONFIG_NET_TCP_RECV_QUEUE_MAX_RANGES) : 1)
+
+K_MEM_SLAB_DEFINE_STATIC(tcp_ooo_slab, sizeof(struct tcp_ooo_range),
+			 TCP_OOO_RANGES, 4);
+
 static struct k_work_q tcp_work_q;
 static K_KERNEL_STACK_DEFINE(work_q_stack, CONFIG_NET_TCP_WORKQ_STACK_SIZE);
 
@@ -69,16 +84,6 @@ static void tcp_out(struct tcp *conn, uint8_t flags);
 int (*tcp_send_cb)(struct net_pkt *pkt) = NULL;
 size_t (*tcp_recv_cb)(struct tcp *conn, struct net_pkt *pkt) = NULL;
 
-static uint32_t tcp_get_seq(struct net_buf *buf)
-{
-	return *(uint32_t *)net_buf_user_data(buf);
-}
-
-static void tcp_set_seq(struct net_buf *buf, uint32_t seq)
-{
-	*(uint32_t *)net_buf_user_data(buf) = seq;
-}
-
 static int tcp_pkt_linearize(struct net_pkt *pkt, size_t pos, size_t len)
 {
 	struct net_buf *buf, *first = pkt->cursor.buf, *second = first->frags;
@@ -305,10 +310,8 @@ end:
 	  (IS_ENABLED(CONFIG_NET_L2_IEEE802154) &&			\
 	   net_pkt_lladdr_dst(pkt)->type == NET_LINK_IEEE802154)))
 
-static void tcp_send(struct net_pkt *pkt)
+static void tcp_send_pkt(struct net_pkt *pkt)
 {
-	NET_DBG("%s", tcp_th(pkt));
-
 	tcp_pkt_ref(pkt);
 
 	if (tcp_send_cb) {
@@ -359,6 +362,19 @@ out:
 	tcp_pkt_unref(pkt);
 }
 
+static void tcp_send(struct net_pkt *pkt)
+{
+	NET_DBG("%s", tcp_th(pkt));
+
+#if defined(CONFIG_NET_TEST_PROTOCOL)
+	if (tp_impair(pkt, tcp_send_pkt)) {
+		return;
+	}
+#endif
+
+	tcp_send_pkt(pkt);
+}
+
 static void tcp_derive_rto(struct tcp *conn)
 {
 #ifdef CONFIG_NET_TCP_RANDOMIZED_RTO
@@ -393,6 +409,181 @@ static void tcp_send_queue_flush(struct tcp *conn)
 	}
 }
 
+static bool tcp_ooo_lessthan(struct rbnode *a, struct rbnode *b)
+{
+	return net_tcp_seq_cmp(CONTAINER_OF(a, struct tcp_ooo_range, node)->seq,
+			       CONTAINER_OF(b, struct tcp_ooo_range, node)->seq) < 0;
+}
+
+/* Find the last range starting at or before seq, or with after set, the
+ * first range starting after seq.
+ */
+static struct tcp_ooo_range *tcp_ooo_find(struct tcp *conn, uint32_t seq,
+					  bool after)
+{
+	struct rbnode *node = conn->recv_queue.root;
+	struct tcp_ooo_range *found = NULL;
+
+	while (node) {
+		struct tcp_ooo_range *range =
+			CONTAINER_OF(node, struct tcp_ooo_range, node);
+		bool before = net_tcp_seq_cmp(range->seq, seq) <= 0;
+
+		if (before != after) {
+			found = range;
+		}
+
+		node = z_rb_child(node, before ? 1U : 0U);
+	}
+
+	return found;
+}
+
+static struct tcp_ooo_range *tcp_ooo_first(struct tcp *conn)
+{
+	struct rbnode *node = rb_get_min(&conn->recv_queue);
+
+	return node ? CONTAINER_OF(node, struct tcp_ooo_range, node) : NULL;
+}
+
+static struct tcp_ooo_range *tcp_ooo_range_alloc(struct tcp *conn)
+{
+	struct tcp_ooo_range *range;
+
+	if (conn->recv_queue_ranges >= CONFIG_NET_TCP_RECV_QUEUE_MAX_RANGES) {
+		return NULL;
+	}
+
+	if (k_mem_slab_alloc(&tcp_ooo_slab, (void **)&range, K_NO_WAIT)) {
+		return NULL;
+	}
+
+	memset(range, 0, sizeof(*range));
+	conn->recv_queue_ranges++;
+
+	return range;
+}
+
+/* The range must have been removed from the tree already */
+static void tcp_ooo_range_free(struct tcp *conn, struct tcp_ooo_range *range)
+{
+	if (range->buf) {
+		net_buf_unref(range->buf);
+	}
+
+	if (conn->recv_queue_last == range) {
+		conn->recv_queue_last = NULL;
+	}
+
+	conn->recv_queue_ranges--;
+
+	k_mem_slab_free(&tcp_ooo_slab, (void **)&range);
+}
+
+static void tcp_recv_queue_flush(struct tcp *conn)
+{
+	struct tcp_ooo_range *range;
+
+	while ((range = tcp_ooo_first(conn)) != NULL) {
+		rb_remove(&conn->recv_queue, &range->node);
+		tcp_ooo_range_free(conn, range);
+	}
+}
+
+static size_t tcp_conn_hash_idx(union tcp_endpoint *src,
+				union tcp_endpoint *dst)
+{
+	size_t len = tcp_endpoint_len(src->sa.sa_family);
+	uint32_t hash = tcp_conn_hash_seed;
+
+	/* FNV-1a over both endpoints */
+	for (size_t i = 0; i < len; i++) {
+		hash = (hash ^ ((uint8_t *)src)[i]) * 16777619U;
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		hash = (hash ^ ((uint8_t *)dst)[i]) * 16777619U;
+	}
+
+	return hash % ARRAY_SIZE(tcp_conn_hash);
+}
+
+/* Make the connection visible to tcp_conn_search(), its endpoints must be
+ * set already.
+ */
+static void tcp_conn_hash_add(struct tcp *conn)
+{
+	k_mutex_lock(&tcp_lock, K_FOREVER);
+
+	if (conn->hash_bucket) {
+		sys_slist_find_and_remove(conn->hash_bucket, &conn->hash_node);
+	}
+
+	conn->hash_bucket =
+		&tcp_conn_hash[tcp_conn_hash_idx(&conn->src, &conn->dst)];
+	sys_slist_prepend(conn->hash_bucket, &conn->hash_node);
+
+	k_mutex_unlock(&tcp_lock);
+}
+
+static void tcp_backlog_add(struct tcp *listener, struct tcp *conn)
+{
+	k_mutex_lock(&tcp_lock, K_FOREVER);
+
+	conn->listener = listener;
+	sys_slist_append(&listener->backlog, &conn->backlog_node);
+
+	k_mutex_unlock(&tcp_lock);
+}
+
+/* Count the connections of a listener that are in the handshake, and the
+ * ones waiting for the application to accept them. Connections accepted
+ * by the application leave the backlog here.
+ */
+static void tcp_backlog_count(struct tcp *listener, size_t *handshake,
+			      size_t *accept_queue)
+{
+	sys_snode_t *prev = NULL;
+	struct tcp *conn, *tmp;
+
+	*handshake = 0;
+	*accept_queue = 0;
+
+	k_mutex_lock(&tcp_lock, K_FOREVER);
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&listener->backlog, conn, tmp,
+					  backlog_node) {
+		if (conn->state == TCP_LISTEN ||
+		    conn->state == TCP_SYN_RECEIVED) {
+			(*handshake)++;
+		} else if (net_context_is_accepting(conn->context)) {
+			(*accept_queue)++;
+		} else {
+			sys_slist_remove(&listener->backlog, prev,
+					 &conn->backlog_node);
+			conn->listener = NULL;
+			continue;
+		}
+
+		prev = &conn->backlog_node;
+	}
+
+	k_mutex_unlock(&tcp_lock);
+}
+
+static bool tcp_backlog_full(struct tcp *listener)
+{
+	size_t handshake, accept_queue;
+
+	if (listener->backlog_max == 0) {
+		return false;
+	}
+
+	tcp_backlog_count(listener, &handshake, &accept_queue);
+
+	/* Like in Linux, one more connection than the backlog is allowed */
+	return handshake + accept_queue > listener->backlog_max;
+}
 
 static int tcp_conn_unref(struct tcp *conn)
 {
@@ -444,7 +635,8 @@ static int tcp_conn_unref(struct tcp *conn)
 	tcp_pkt_unref(conn->send_data);
 
 	if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT) {
-		tcp_pkt_unref(conn->queue_recv_data);
+		k_work_cancel_delayable(&conn->recv_queue_timer);
+		tcp_recv_queue_flush(conn);
 	}
 
 	(void)k_work_cancel_delayable(&conn->timewait_timer);
@@ -454,6 +646,23 @@ static int tcp_conn_unref(struct tcp *conn)
 
 	sys_slist_find_and_remove(&tcp_conns, &conn->next);
 
+	if (conn->hash_bucket) {
+		sys_slist_find_and_remove(conn->hash_bucket, &conn->hash_node);
+	}
+
+	if (conn->listener) {
+		sys_slist_find_and_remove(&conn->listener->backlog,
+					  &conn->backlog_node);
+	}
+
+	/* The connections still in the backlog outlive their listener */
+	while (!sys_slist_is_empty(&conn->backlog)) {
+		struct tcp *child = CONTAINER_OF(sys_slist_get(&conn->backlog),
+						 struct tcp, backlog_node);
+
+		child->listener = NULL;
+	}
+
 	memset(conn, 0, sizeof(*conn));
 
 	k_mem_slab_free(&tcp_conns_slab, (void **)&conn);
@@ -659,9 +868,6 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 
 	NET_DBG("len=%zd", len);
 
-	recv_options->mss_found = false;
-	recv_options->wnd_found = false;
-
 	for ( ; options && len >= 1; options += opt_len, len -= opt_len) {
 		opt = options[0];
 
@@ -706,9 +912,51 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 				goto end;
 			}
 
-			recv_options->window = opt;
+			recv_options->window = options[2];
 			recv_options->wnd_found = true;
+			NET_DBG("WS=%hu", recv_options->window);
+			break;
+		case NET_TCP_SACK_PERM_OPT:
+			if (opt_len != NET_TCP_SACK_PERM_SIZE) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->sack_perm_found = true;
+			break;
+		case NET_TCP_TIMESTAMP_OPT:
+			if (opt_len != NET_TCP_TIMESTAMP_SIZE) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->tsval =
+				ntohl(UNALIGNED_GET((uint32_t *)(options + 2)));
+			recv_options->tsecr =
+				ntohl(UNALIGNED_GET((uint32_t *)(options + 6)));
+			recv_options->ts_found = true;
+			break;
+#if defined(CONFIG_NET_TCP_SACK)
+		case NET_TCP_SACK_OPT:
+			if (opt_len < 2 + NET_TCP_SACK_BLOCK_SIZE ||
+			    (opt_len - 2) % NET_TCP_SACK_BLOCK_SIZE) {
+				result = false;
+				goto end;
+			}
+
+			for (int i = 2; i < opt_len &&
+			     recv_options->sack_count < NET_TCP_MAX_SACK_BLOCKS;
+			     i += NET_TCP_SACK_BLOCK_SIZE) {
+				struct tcp_sack_block *block =
+					&recv_options->sack[recv_options->sack_count++];
+
+				block->start = ntohl(UNALIGNED_GET(
+						(uint32_t *)(options + i)));
+				block->end = ntohl(UNALIGNED_GET(
+						(uint32_t *)(options + i + 4)));
+			}
 			break;
+#endif
 		default:
 			continue;
 		}
@@ -721,6 +969,65 @@ end:
 	return result;
 }
 
+/* Largest receive window that can be advertised on the connection */
+static uint32_t tcp_max_recv_win(struct tcp *conn)
+{
+	return (uint32_t)UINT16_MAX << conn->rcv_wscale;
+}
+
+/* Offer the options enabled in Kconfig in a SYN segment */
+static void tcp_syn_options_init(struct tcp *conn)
+{
+	conn->wscale_ok = IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE);
+	conn->ts_ok = IS_ENABLED(CONFIG_NET_TCP_TIMESTAMPS);
+	conn->sack_ok = IS_ENABLED(CONFIG_NET_TCP_SACK);
+}
+
+/* Keep the options offered in the SYN segments of both ends */
+static void tcp_syn_options_negotiate(struct tcp *conn)
+{
+	struct tcp_options *opts = &conn->recv_options;
+
+	conn->wscale_ok = conn->wscale_ok && opts->wnd_found;
+	conn->ts_ok = conn->ts_ok && opts->ts_found;
+	conn->sack_ok = conn->sack_ok && opts->sack_perm_found;
+
+	if (conn->wscale_ok) {
+		conn->snd_wscale = MIN(opts->window, NET_TCP_MAX_WINDOW_SCALE);
+	} else {
+		/* Windows larger than 64 KiB cannot be advertised */
+		conn->rcv_wscale = 0U;
+		conn->recv_win_max = MIN(conn->recv_win_max, UINT16_MAX);
+		conn->recv_win = MIN(conn->recv_win, UINT16_MAX);
+	}
+
+	if (conn->ts_ok) {
+		conn->ts_recent = opts->tsval;
+	}
+}
+
+/* Record the timestamp to echo, returns false if the segment is an old
+ * duplicate according to PAWS (RFC 7323).
+ */
+static bool tcp_timestamp_check(struct tcp *conn, struct tcphdr *th)
+{
+	struct tcp_options *opts = &conn->recv_options;
+
+	if (!conn->ts_ok || !opts->ts_found || conn->state == TCP_SYN_SENT) {
+		return true;
+	}
+
+	if ((int32_t)(opts->tsval - conn->ts_recent) < 0) {
+		return false;
+	}
+
+	if (net_tcp_seq_cmp(th_seq(th), conn->ack) <= 0) {
+		conn->ts_recent = opts->tsval;
+	}
+
+	return true;
+}
+
 static bool tcp_short_window(struct tcp *conn)
 {
 	int32_t threshold = MIN(conn_mss(conn), conn->recv_win_max / 2);
@@ -747,8 +1054,8 @@ static int tcp_update_recv_wnd(struct tcp *conn, int32_t delta)
 	bool short_win_before;
 	bool short_win_after;
 
-	new_win = conn->recv_win + delta;
-	if (new_win < 0 || new_win > UINT16_MAX) {
+	new_win = (int32_t)conn->recv_win + delta;
+	if (new_win < 0 || new_win > (int32_t)tcp_max_recv_win(conn)) {
 		return -EINVAL;
 	}
 
@@ -770,60 +1077,40 @@ static int tcp_update_recv_wnd(struct tcp *conn, int32_t delta)
 static size_t tcp_check_pending_data(struct tcp *conn, struct net_pkt *pkt,
 				     size_t len)
 {
+	uint32_t expected_seq = th_seq(th_get(pkt)) + len;
+	struct tcp_ooo_range *range;
 	size_t pending_len = 0;
 
-	if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT &&
-	    !net_pkt_is_empty(conn->queue_recv_data)) {
-		/* Some potentential cases:
-		 * Note: MI = MAX_INT
-		 * Packet | Queued| End off   | Gap size | Required handling
-		 * Seq|Len|Seq|Len|           |          |
-		 *  3 | 3 | 6 | 4 | 3+3-6=  0 | 6-3-3=0  | Append
-		 *  3 | 4 | 6 | 4 | 3+4-6 = 1 | 6-3-4=-1 | Append, pull from queue
-		 *  3 | 7 | 6 | 4 | 3+7-6 = 4 | 6-3-7=-4 | Drop queued data
-		 *  3 | 8 | 6 | 4 | 3+8-6 = 5 | 6-3-8=-5 | Drop queued data
-		 *  6 | 5 | 6 | 4 | 6+5-6 = 5 | 6-6-5=-5 | Drop queued data
-		 *  6 | 4 | 6 | 4 | 6+4-6 = 4 | 6-6-4=-4 | Drop queued data / packet
-		 * 10 | 2 | 6 | 4 | 10+2-6= 6 | 6-10-2=-6| Should not happen, dropping queue
-		 *  7 | 4 | 6 | 4 | 7+4-6 = 5 | 6-7-4=-5 | Should not happen, dropping queue
-		 * 11 | 2 | 6 | 4 | 11+2-6= 7 | 6-11-2=-7| Should not happen, dropping queue
-		 *  2 | 3 | 6 | 4 | 2+3-6= MI | 6-2-3=1  | Keep queued data
-		 */
-		struct tcphdr *th = th_get(pkt);
-		uint32_t expected_seq = th_seq(th) + len;
-		uint32_t pending_seq;
-		int32_t gap_size;
-		uint32_t end_offset;
-
-		pending_seq = tcp_get_seq(conn->queue_recv_data->buffer);
-		end_offset = expected_seq - pending_seq;
-		gap_size = (int32_t)(pending_seq - th_seq(th) - ((uint32_t)len));
-		pending_len = net_pkt_get_len(conn->queue_recv_data);
-		if (end_offset < pending_len) {
-			if (end_offset) {
-				net_pkt_remove_tail(pkt, end_offset);
-				pending_len -= end_offset;
-			}
+	if (!CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT) {
+		return 0;
+	}
+
+	/* Pull every range that the incoming data reaches. Data already
+	 * carried by the packet is dropped from the queued ranges.
+	 */
+	while ((range = tcp_ooo_first(conn)) != NULL &&
+	       net_tcp_seq_cmp(range->seq, expected_seq) <= 0) {
+		uint32_t overlap = expected_seq - range->seq;
+
+		rb_remove(&conn->recv_queue, &range->node);
 
-			NET_DBG("Found pending data seq %u len %zd",
-				expected_seq, pending_len);
+		if (overlap < range->len) {
+			NET_DBG("Found pending data seq %u len %u",
+				expected_seq, range->len - overlap);
 
 			net_buf_frag_add(pkt->buffer,
-					 conn->queue_recv_data->buffer);
-			conn->queue_recv_data->buffer = NULL;
+					 net_buf_skip(range->buf, overlap));
+			range->buf = NULL;
 
-			k_work_cancel_delayable(&conn->recv_queue_timer);
-		} else {
-			/* Check if the queued data is just a section of the incoming data */
-			if (gap_size <= 0) {
-				net_buf_unref(conn->queue_recv_data->buffer);
-				conn->queue_recv_data->buffer = NULL;
+			pending_len += range->len - overlap;
+			expected_seq += range->len - overlap;
+		}
 
-				k_work_cancel_delayable(&conn->recv_queue_timer);
-			}
+		tcp_ooo_range_free(conn, range);
+	}
 
-			pending_len = 0;
-		}
+	if (tcp_ooo_first(conn) == NULL) {
+		k_work_cancel_delayable(&conn->recv_queue_timer);
 	}
 
 	return pending_len;
@@ -880,8 +1167,18 @@ static int tcp_finalize_pkt(struct net_pkt *pkt)
 	return -EINVAL;
 }
 
+/* Window to advertise, the window in a SYN segment is never scaled */
+static uint16_t tcp_adv_win(struct tcp *conn, uint8_t flags)
+{
+	if (flags & SYN) {
+		return MIN(conn->recv_win, UINT16_MAX);
+	}
+
+	return MIN(conn->recv_win >> conn->rcv_wscale, UINT16_MAX);
+}
+
 static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
-			  uint32_t seq)
+			  uint32_t seq, size_t options_len)
 {
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
 	struct tcphdr *th;
@@ -895,14 +1192,10 @@ static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
 
 	UNALIGNED_PUT(conn->src.sin.sin_port, &th->th_sport);
 	UNALIGNED_PUT(conn->dst.sin.sin_port, &th->th_dport);
-	th->th_off = 5;
-
-	if (conn->send_options.mss_found) {
-		th->th_off++;
-	}
+	th->th_off = 5 + options_len / 4;
 
 	UNALIGNED_PUT(flags, &th->th_flags);
-	UNALIGNED_PUT(htons(conn->recv_win), &th->th_win);
+	UNALIGNED_PUT(htons(tcp_adv_win(conn, flags)), &th->th_win);
 	UNALIGNED_PUT(htonl(seq), &th->th_seq);
 
 	if (ACK & flags) {
@@ -960,23 +1253,93 @@ static int get_tcp_nodelay(struct tcp *conn, void *value, size_t *len)
 	return 0;
 }
 
-static int net_tcp_set_mss_opt(struct tcp *conn, struct net_pkt *pkt)
+/* Fill in the options of an outgoing segment, returns their length which
+ * is always a multiple of 4.
+ */
+static size_t tcp_options_build(struct tcp *conn, uint8_t flags, uint8_t *buf)
 {
-	NET_PKT_DATA_ACCESS_DEFINE(mss_opt_access, struct tcp_mss_option);
-	struct tcp_mss_option *mss;
-	uint32_t recv_mss;
+	size_t len = 0;
 
-	mss = net_pkt_get_data(pkt, &mss_opt_access);
-	if (!mss) {
-		return -ENOBUFS;
-	}
+	if (conn->send_options.mss_found) {
+		buf[len++] = NET_TCP_MSS_OPT;
+		buf[len++] = NET_TCP_MSS_SIZE;
+		sys_put_be16(net_tcp_get_supported_mss(conn), &buf[len]);
+		len += sizeof(uint16_t);
+	}
+
+	if ((flags & SYN) && conn->wscale_ok) {
+		buf[len++] = NET_TCP_NOP_OPT;
+		buf[len++] = NET_TCP_WINDOW_SCALE_OPT;
+		buf[len++] = NET_TCP_WINDOW_SCALE_SIZE;
+		buf[len++] = conn->rcv_wscale;
+	}
+
+	if ((flags & SYN) && conn->sack_ok) {
+		buf[len++] = NET_TCP_NOP_OPT;
+		buf[len++] = NET_TCP_NOP_OPT;
+		buf[len++] = NET_TCP_SACK_PERM_OPT;
+		buf[len++] = NET_TCP_SACK_PERM_SIZE;
+	}
+
+	if (conn->ts_ok) {
+		buf[len++] = NET_TCP_NOP_OPT;
+		buf[len++] = NET_TCP_NOP_OPT;
+		buf[len++] = NET_TCP_TIMESTAMP_OPT;
+		buf[len++] = NET_TCP_TIMESTAMP_SIZE;
+		sys_put_be32(k_uptime_get_32(), &buf[len]);
+		len += sizeof(uint32_t);
+		sys_put_be32(conn->ts_recent, &buf[len]);
+		len += sizeof(uint32_t);
+	}
+
+#if defined(CONFIG_NET_TCP_SACK)
+	/* Two NOPs, the kind and the length, then at least one block */
+	if (!(flags & SYN) && conn->sack_ok && tcp_ooo_first(conn) &&
+	    len + 4 + NET_TCP_SACK_BLOCK_SIZE <= NET_TCP_MAX_OPT_SIZE) {
+		struct tcp_ooo_range *first = conn->recv_queue_last;
+		struct tcp_ooo_range *range;
+		size_t blocks;
+		uint8_t *opt_len;
+
+		/* The range holding the latest segment goes first, RFC 2018
+		 * chapter 4, then the others in order as long as they fit.
+		 */
+		if (first == NULL) {
+			first = tcp_ooo_first(conn);
+		}
+
+		blocks = MIN(NET_TCP_MAX_SACK_BLOCKS,
+			     (NET_TCP_MAX_OPT_SIZE - len - 4) /
+			     NET_TCP_SACK_BLOCK_SIZE);
 
-	recv_mss = net_tcp_get_supported_mss(conn);
-	recv_mss |= (NET_TCP_MSS_OPT << 24) | (NET_TCP_MSS_SIZE << 16);
+		buf[len++] = NET_TCP_NOP_OPT;
+		buf[len++] = NET_TCP_NOP_OPT;
+		buf[len++] = NET_TCP_SACK_OPT;
+		opt_len = &buf[len++];
+		*opt_len = 2 + NET_TCP_SACK_BLOCK_SIZE;
 
-	UNALIGNED_PUT(htonl(recv_mss), (uint32_t *)mss);
+		sys_put_be32(first->seq, &buf[len]);
+		sys_put_be32(first->seq + first->len, &buf[len + 4]);
+		len += NET_TCP_SACK_BLOCK_SIZE;
 
-	return net_pkt_set_data(pkt, &mss_opt_access);
+		RB_FOR_EACH_CONTAINER(&conn->recv_queue, range, node) {
+			if (*opt_len == 2 + blocks * NET_TCP_SACK_BLOCK_SIZE) {
+				break;
+			}
+
+			if (range == first) {
+				continue;
+			}
+
+			sys_put_be32(range->seq, &buf[len]);
+			sys_put_be32(range->seq + range->len, &buf[len + 4]);
+			len += NET_TCP_SACK_BLOCK_SIZE;
+			*opt_len += NET_TCP_SACK_BLOCK_SIZE;
+		}
+	}
+#endif
+
+	return len;
 }
 
 static bool is_destination_local(struct net_pkt *pkt)
@@ -1005,21 +1368,24 @@ static bool is_destination_local(struct net_pkt *pkt)
 static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		       uint32_t seq)
 {
-	size_t alloc_len = sizeof(struct tcphdr);
+	uint8_t options[NET_TCP_MAX_OPT_SIZE];
+	size_t options_len = tcp_options_build(conn, flags, options);
 	struct net_pkt *pkt;
 	int ret = 0;
 
-	if (conn->send_options.mss_found) {
-		alloc_len += sizeof(uint32_t);
-	}
-
-	pkt = tcp_pkt_alloc(conn, alloc_len);
+	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr) + options_len);
 	if (!pkt) {
 		ret = -ENOBUFS;
 		goto out;
 	}
 
 	if (data) {
+		/* Large packets are split into segments before sending */
+		if (IS_ENABLED(CONFIG_NET_GSO) &&
+		    net_pkt_get_len(data) > conn_mss(conn)) {
+			net_pkt_set_gso_size(pkt, conn_mss(conn));
+		}
+
 		/* Append the data buffer to the pkt */
 		net_pkt_append_buffer(pkt, data->buffer);
 		data->buffer = NULL;
@@ -1031,14 +1397,14 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		goto out;
 	}
 
-	ret = tcp_header_add(conn, pkt, flags, seq);
+	ret = tcp_header_add(conn, pkt, flags, seq, options_len);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
 		goto out;
 	}
 
-	if (conn->send_options.mss_found) {
-		ret = net_tcp_set_mss_opt(conn, pkt);
+	if (options_len) {
+		ret = net_pkt_write(pkt, options, options_len);
 		if (ret < 0) {
 			tcp_pkt_unref(pkt);
 			goto out;
@@ -1120,8 +1486,19 @@ static bool tcp_window_full(struct tcp *conn)
 	return window_full;
 }
 
+/* Usable send window, the congestion window limits the peer's window */
+static uint32_t tcp_send_wnd(struct tcp *conn)
+{
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	return MIN(conn->send_win, conn->ca.cwnd);
+#else
+	return conn->send_win;
+#endif
+}
+
 static int tcp_unsent_len(struct tcp *conn)
 {
+	uint32_t send_wnd = tcp_send_wnd(conn);
 	int unsent_len;
 
 	if (conn->unacked_len > conn->send_data_total) {
@@ -1132,10 +1509,11 @@ static int tcp_unsent_len(struct tcp *conn)
 	}
 
 	unsent_len = conn->send_data_total - conn->unacked_len;
-	if (conn->unacked_len >= conn->send_win) {
+	if ((uint32_t)conn->unacked_len >= send_wnd) {
 		unsent_len = 0;
 	} else {
-		unsent_len = MIN(unsent_len, conn->send_win - conn->unacked_len);
+		unsent_len = MIN(unsent_len,
+				 (int)(send_wnd - conn->unacked_len));
 	}
  out:
 	NET_DBG("unsent_len=%d", unsent_len);
@@ -1143,40 +1521,28 @@ static int tcp_unsent_len(struct tcp *conn)
 	return unsent_len;
 }
 
-static int tcp_send_data(struct tcp *conn)
+/* Send len bytes of the send queue, starting offset bytes after conn->seq */
+static int tcp_send_segment(struct tcp *conn, int offset, int len)
 {
-	int ret = 0;
-	int len;
 	struct net_pkt *pkt;
+	int ret;
 
-	len = MIN3(conn->send_data_total - conn->unacked_len,
-		   conn->send_win - conn->unacked_len,
-		   conn_mss(conn));
-	if (len == 0) {
-		NET_DBG("conn: %p no data to send", conn);
-		ret = -ENODATA;
-		goto out;
-	}
-
-	pkt = tcp_pkt_alloc(conn, len);
+	pkt = tcp_data_pkt_alloc(len);
 	if (!pkt) {
 		NET_ERR("conn: %p packet allocation failed, len=%d", conn, len);
-		ret = -ENOBUFS;
-		goto out;
+		return -ENOBUFS;
 	}
 
-	ret = tcp_pkt_peek(pkt, conn->send_data, conn->unacked_len, len);
+	ret = tcp_pkt_peek(pkt, conn->send_data, offset, len);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
-		ret = -ENOBUFS;
-		goto out;
+		return -ENOBUFS;
 	}
 
-	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + conn->unacked_len);
+	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + offset);
 	if (ret == 0) {
-		conn->unacked_len += len;
-
-		if (conn->data_mode == TCP_DATA_MODE_RESEND) {
+		if (conn->data_mode == TCP_DATA_MODE_RESEND ||
+		    offset < conn->unacked_len) {
 			net_stats_update_tcp_resent(conn->iface, len);
 			net_stats_update_tcp_seg_rexmit(conn->iface);
 		} else {
@@ -1191,6 +1557,26 @@ static int tcp_send_data(struct tcp *conn)
 	 */
 	tcp_pkt_unref(pkt);
 
+	return ret;
+}
+
+static int tcp_send_data(struct tcp *conn)
+{
+	int ret = 0;
+	int len;
+
+	len = MIN(tcp_unsent_len(conn), conn_send_max(conn));
+	if (len <= 0) {
+		NET_DBG("conn: %p no data to send", conn);
+		ret = -ENODATA;
+		goto out;
+	}
+
+	ret = tcp_send_segment(conn, conn->unacked_len, len);
+	if (ret == 0) {
+		conn->unacked_len += len;
+	}
+
 	conn_send_data_dump(conn);
 
  out:
@@ -1222,28 +1608,266 @@ static int tcp_send_queued_data(struct tcp *conn)
 			}
 		}
 
-		ret = tcp_send_data(conn);
-		if (ret < 0) {
-			break;
-		}
-	}
+		ret = tcp_send_data(conn);
+		if (ret < 0) {
+			break;
+		}
+	}
+
+	if (conn->send_data_total) {
+		subscribe = true;
+	}
+
+	if (k_work_delayable_remaining_get(&conn->send_data_timer)) {
+		subscribe = false;
+	}
+
+	if (subscribe) {
+		conn->send_data_retries = 0;
+		k_work_reschedule_for_queue(&tcp_work_q, &conn->send_data_timer,
+					    K_MSEC(TCP_RTO_MS));
+	}
+ out:
+	return ret;
+}
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+/* Initial window, RFC 6928 */
+static void tcp_ca_init(struct tcp *conn)
+{
+	uint32_t mss = conn_mss(conn);
+
+	conn->ca.cwnd = MIN(10U * mss, MAX(2U * mss, 14600U));
+	conn->ca.ssthresh = UINT32_MAX;
+
+	tcp_cc.init(conn);
+}
+
+/* Grow the congestion window for newly acknowledged data */
+static void tcp_ca_ack(struct tcp *conn, uint32_t acked)
+{
+	if (conn->ca.cwnd < conn->ca.ssthresh) {
+		conn->ca.cwnd += MIN(acked, conn_mss(conn));
+	} else {
+		tcp_cc.cong_avoid(conn, acked);
+	}
+}
+
+static void tcp_ca_timeout(struct tcp *conn)
+{
+	/* Only the first timeout of a series lowers the threshold */
+	if (conn->data_mode == TCP_DATA_MODE_SEND) {
+		conn->ca.ssthresh = tcp_cc.ssthresh(conn);
+	}
+
+	conn->ca.cwnd = conn_mss(conn);
+}
+#else
+#define tcp_ca_init(_conn)
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
+
+#if defined(CONFIG_NET_TCP_SACK)
+static void tcp_sack_insert(struct tcp *conn, uint32_t start, uint32_t end)
+{
+	struct tcp_sack_block *sb = conn->sacked;
+	int i, j;
+
+	for (i = 0; i < conn->sacked_count; i++) {
+		if (net_tcp_seq_cmp(start, sb[i].start) < 0) {
+			break;
+		}
+	}
+
+	if (conn->sacked_count == ARRAY_SIZE(conn->sacked)) {
+		if (i == conn->sacked_count) {
+			return;
+		}
+
+		/* Forget the highest block, the holes below it come first */
+		conn->sacked_count--;
+	}
+
+	memmove(&sb[i + 1], &sb[i], (conn->sacked_count - i) * sizeof(*sb));
+	sb[i].start = start;
+	sb[i].end = end;
+	conn->sacked_count++;
+
+	/* Merge overlapping and adjacent blocks */
+	for (i = 0, j = 1; j < conn->sacked_count; j++) {
+		if (net_tcp_seq_cmp(sb[j].start, sb[i].end) <= 0) {
+			if (net_tcp_seq_cmp(sb[j].end, sb[i].end) > 0) {
+				sb[i].end = sb[j].end;
+			}
+		} else {
+			sb[++i] = sb[j];
+		}
+	}
+
+	conn->sacked_count = i + 1;
+}
+
+/* Update the scoreboard with the SACK blocks of an ACK, the blocks below
+ * the cumulative ACK are removed.
+ */
+static void tcp_sack_update(struct tcp *conn, uint32_t ack)
+{
+	struct tcp_options *opts = &conn->recv_options;
+	uint32_t snd_max = conn->seq + conn->unacked_len;
+	int i, j;
+
+	for (i = 0, j = 0; i < conn->sacked_count; i++) {
+		if (net_tcp_seq_cmp(conn->sacked[i].end, ack) <= 0) {
+			continue;
+		}
+
+		conn->sacked[j] = conn->sacked[i];
+
+		if (net_tcp_seq_cmp(conn->sacked[j].start, ack) < 0) {
+			conn->sacked[j].start = ack;
+		}
+
+		j++;
+	}
+
+	conn->sacked_count = j;
+
+	for (i = 0; i < opts->sack_count; i++) {
+		struct tcp_sack_block *block = &opts->sack[i];
+
+		/* Ignore D-SACK and bogus blocks */
+		if (net_tcp_seq_cmp(block->start, ack) <= 0 ||
+		    net_tcp_seq_cmp(block->end, block->start) <= 0 ||
+		    net_tcp_seq_cmp(block->end, snd_max) > 0) {
+			continue;
+		}
+
+		tcp_sack_insert(conn, block->start, block->end);
+	}
+}
+
+/* Retransmit one segment from the first hole below the highest SACKed
+ * sequence that has not been retransmitted yet. Returns the number of
+ * bytes sent.
+ */
+static int tcp_sack_retransmit(struct tcp *conn)
+{
+	uint32_t hole = conn->seq;
+	int len;
+
+	if (net_tcp_seq_cmp(conn->high_rxt, hole) > 0) {
+		hole = conn->high_rxt;
+	}
+
+	for (int i = 0; i < conn->sacked_count; i++) {
+		struct tcp_sack_block *sb = &conn->sacked[i];
+
+		if (net_tcp_seq_cmp(sb->end, hole) <= 0) {
+			continue;
+		}
+
+		if (net_tcp_seq_cmp(sb->start, hole) <= 0) {
+			hole = sb->end;
+			continue;
+		}
+
+		len = MIN(sb->start - hole, conn_mss(conn));
+
+		if (tcp_send_segment(conn, hole - conn->seq, len) < 0) {
+			return 0;
+		}
+
+		conn->high_rxt = hole + len;
+
+		return len;
+	}
+
+	return 0;
+}
+
+static void tcp_sack_clear(struct tcp *conn)
+{
+	conn->sacked_count = 0;
+	conn->high_rxt = conn->seq;
+}
+#endif /* CONFIG_NET_TCP_SACK */
+
+#if defined(CONFIG_NET_TCP_FAST_RETRANSMIT)
+/* Retransmit the first unacknowledged segment, or the next hole when the
+ * peer is doing SACK.
+ */
+static void tcp_retransmit_first(struct tcp *conn)
+{
+#if defined(CONFIG_NET_TCP_SACK)
+	if (conn->sack_ok && tcp_sack_retransmit(conn) > 0) {
+		return;
+	}
+#endif
+
+	(void)tcp_send_segment(conn, 0,
+			       MIN(conn->send_data_total, conn_mss(conn)));
+}
+
+/* Third duplicate ACK, enter fast recovery (RFC 6582) */
+static void tcp_fast_retransmit(struct tcp *conn)
+{
+	conn->in_recovery = true;
+	conn->recover = conn->seq + conn->unacked_len;
+
+#if defined(CONFIG_NET_TCP_SACK)
+	conn->high_rxt = conn->seq;
+#endif
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	conn->ca.ssthresh = tcp_cc.ssthresh(conn);
+	conn->ca.cwnd = conn->ca.ssthresh +
+		DUPLICATE_ACK_RETRANSMIT_TRHESHOLD * conn_mss(conn);
+#endif
+
+	tcp_retransmit_first(conn);
+}
 
-	if (conn->send_data_total) {
-		subscribe = true;
+/* Further duplicate ACK during fast recovery, a segment has left the
+ * network so another one can be sent.
+ */
+static void tcp_fast_recovery_dup_ack(struct tcp *conn)
+{
+#if defined(CONFIG_NET_TCP_SACK)
+	if (conn->sack_ok && tcp_sack_retransmit(conn) > 0) {
+		return;
 	}
+#endif
 
-	if (k_work_delayable_remaining_get(&conn->send_data_timer)) {
-		subscribe = false;
-	}
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	conn->ca.cwnd += conn_mss(conn);
+#endif
 
-	if (subscribe) {
-		conn->send_data_retries = 0;
-		k_work_reschedule_for_queue(&tcp_work_q, &conn->send_data_timer,
-					    K_MSEC(TCP_RTO_MS));
+	(void)tcp_send_queued_data(conn);
+}
+
+/* Cumulative ACK during fast recovery, stay in recovery and retransmit
+ * the next hole until everything sent before the loss is acknowledged.
+ */
+static void tcp_fast_recovery_ack(struct tcp *conn, uint32_t acked)
+{
+	if (net_tcp_seq_cmp(conn->seq, conn->recover) >= 0) {
+		conn->in_recovery = false;
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+		conn->ca.cwnd = conn->ca.ssthresh;
+#endif
+		return;
 	}
- out:
-	return ret;
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	/* Deflate the window by the amount of new data acknowledged */
+	conn->ca.cwnd -= MIN(conn->ca.cwnd, acked);
+	conn->ca.cwnd += conn_mss(conn);
+#else
+	ARG_UNUSED(acked);
+#endif
+
+	tcp_retransmit_first(conn);
 }
+#endif /* CONFIG_NET_TCP_FAST_RETRANSMIT */
 
 static void tcp_cleanup_recv_queue(struct k_work *work)
 {
@@ -1252,12 +1876,10 @@ static void tcp_cleanup_recv_queue(struct k_work *work)
 
 	k_mutex_lock(&conn->lock, K_FOREVER);
 
-	NET_DBG("Cleanup recv queue conn %p len %zd seq %u", conn,
-		net_pkt_get_len(conn->queue_recv_data),
-		tcp_get_seq(conn->queue_recv_data->buffer));
+	NET_DBG("Cleanup recv queue conn %p ranges %u", conn,
+		conn->recv_queue_ranges);
 
-	net_buf_unref(conn->queue_recv_data->buffer);
-	conn->queue_recv_data->buffer = NULL;
+	tcp_recv_queue_flush(conn);
 
 	k_mutex_unlock(&conn->lock);
 }
@@ -1280,6 +1902,17 @@ static void tcp_resend_data(struct k_work *work)
 		goto out;
 	}
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	tcp_ca_timeout(conn);
+#endif
+#if defined(CONFIG_NET_TCP_FAST_RETRANSMIT)
+	conn->in_recovery = false;
+#endif
+#if defined(CONFIG_NET_TCP_SACK)
+	/* The peer may discard data it has SACKed, RFC 2018 */
+	tcp_sack_clear(conn);
+#endif
+
 	conn->data_mode = TCP_DATA_MODE_RESEND;
 	conn->unacked_len = 0;
 
@@ -1431,14 +2064,7 @@ static struct tcp *tcp_conn_alloc(struct net_context *context)
 
 	memset(conn, 0, sizeof(*conn));
 
-	if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT) {
-		conn->queue_recv_data = tcp_rx_pkt_alloc(conn, 0);
-		if (conn->queue_recv_data == NULL) {
-			NET_ERR("Cannot allocate %s queue for conn %p", "recv",
-				conn);
-			goto fail;
-		}
-	}
+	conn->recv_queue.lessthan_fn = tcp_ooo_lessthan;
 
 	conn->send_data = tcp_pkt_alloc(conn, 0);
 	if (conn->send_data == NULL) {
@@ -1467,6 +2093,15 @@ static struct tcp *tcp_conn_alloc(struct net_context *context)
 		}
 	}
 
+	conn->recv_win_max = MIN(conn->recv_win_max, NET_TCP_MAX_WIN);
+
+	if (IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE)) {
+		while (conn->rcv_wscale < NET_TCP_MAX_WINDOW_SCALE &&
+		       (conn->recv_win_max >> conn->rcv_wscale) > UINT16_MAX) {
+			conn->rcv_wscale++;
+		}
+	}
+
 	conn->recv_win = conn->recv_win_max;
 
 	/* The ISN value will be set when we get the connection attempt or
@@ -1493,11 +2128,6 @@ out:
 	return conn;
 
 fail:
-	if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT && conn->queue_recv_data) {
-		tcp_pkt_unref(conn->queue_recv_data);
-		conn->queue_recv_data = NULL;
-	}
-
 	k_mem_slab_free(&tcp_conns_slab, (void **)&conn);
 	return NULL;
 }
@@ -1524,41 +2154,270 @@ out:
 	return ret;
 }
 
-static bool tcp_endpoint_cmp(union tcp_endpoint *ep, struct net_pkt *pkt,
-			     enum pkt_addr which)
+static struct tcp *tcp_conn_search(struct net_pkt *pkt)
 {
-	union tcp_endpoint ep_tmp;
+	union tcp_endpoint src, dst;
+	struct tcp *conn, *found = NULL;
+	size_t len;
 
-	if (tcp_endpoint_set(&ep_tmp, pkt, which) < 0) {
-		return false;
+	if (tcp_endpoint_set(&src, pkt, TCP_EP_DST) < 0 ||
+	    tcp_endpoint_set(&dst, pkt, TCP_EP_SRC) < 0) {
+		return NULL;
+	}
+
+	len = tcp_endpoint_len(src.sa.sa_family);
+
+	/* The bucket is modified by tcp_conn_hash_add() and on release */
+	k_mutex_lock(&tcp_lock, K_FOREVER);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(
+		&tcp_conn_hash[tcp_conn_hash_idx(&src, &dst)], conn, hash_node) {
+		if (!memcmp(&conn->src, &src, len) &&
+		    !memcmp(&conn->dst, &dst, len)) {
+			found = conn;
+			break;
+		}
+	}
+
+	k_mutex_unlock(&tcp_lock);
+
+	return found;
+}
+
+static struct tcp *tcp_conn_new(struct net_pkt *pkt);
+
+#if defined(CONFIG_NET_TCP_SYN_COOKIES)
+/* A SYN cookie is the ISN of our SYN-ACK, it holds a counter of 64 second
+ * periods, the index of the peer MSS and a hash of the connection.
+ */
+#define SYN_COOKIE_TIME_SHIFT 27
+#define SYN_COOKIE_MSS_SHIFT 25
+#define SYN_COOKIE_MSS_MASK BIT_MASK(2)
+#define SYN_COOKIE_HASH_MASK BIT_MASK(SYN_COOKIE_MSS_SHIFT)
+#define SYN_COOKIE_TIME_MASK BIT_MASK(32 - SYN_COOKIE_TIME_SHIFT)
+
+static const uint16_t syn_cookie_mss[] = { 536, 1220, 1440, 1460 };
+
+/* Secret of the cookie hash, set in net_tcp_init() */
+static uint8_t syn_cookie_key[16];
+
+static uint32_t syn_cookie_time(void)
+{
+	return (uint32_t)(k_uptime_get() >> 16);
+}
+
+static uint32_t syn_cookie_hash(struct net_pkt *pkt, uint32_t peer_isn,
+				uint32_t time)
+{
+	struct {
+		uint8_t key[sizeof(syn_cookie_key)];
+		union tcp_endpoint src;
+		union tcp_endpoint dst;
+		uint32_t peer_isn;
+		uint32_t time;
+	} buf;
+	uint8_t hash[16];
+
+	memset(&buf, 0, sizeof(buf));
+	memcpy(buf.key, syn_cookie_key, sizeof(buf.key));
+	(void)tcp_endpoint_set(&buf.src, pkt, TCP_EP_SRC);
+	(void)tcp_endpoint_set(&buf.dst, pkt, TCP_EP_DST);
+	buf.peer_isn = peer_isn;
+	buf.time = time;
+
+	mbedtls_md5((const unsigned char *)&buf, sizeof(buf), hash);
+
+	return UNALIGNED_GET((uint32_t *)&hash[0]);
+}
+
+static uint32_t syn_cookie_make(struct net_pkt *pkt, uint16_t mss)
+{
+	uint32_t time = syn_cookie_time();
+	uint32_t idx = ARRAY_SIZE(syn_cookie_mss) - 1;
+
+	while (idx > 0 && syn_cookie_mss[idx] > mss) {
+		idx--;
 	}
 
-	return !memcmp(ep, &ep_tmp, tcp_endpoint_len(ep->sa.sa_family));
+	return (time << SYN_COOKIE_TIME_SHIFT) |
+		(idx << SYN_COOKIE_MSS_SHIFT) |
+		(syn_cookie_hash(pkt, th_seq(th_get(pkt)), time) &
+		 SYN_COOKIE_HASH_MASK);
 }
 
-static bool tcp_conn_cmp(struct tcp *conn, struct net_pkt *pkt)
+/* Returns the peer MSS if the segment acks a valid cookie, 0 otherwise */
+static uint16_t syn_cookie_check(struct net_pkt *pkt)
 {
-	return tcp_endpoint_cmp(&conn->src, pkt, TCP_EP_DST) &&
-		tcp_endpoint_cmp(&conn->dst, pkt, TCP_EP_SRC);
+	struct tcphdr *th = th_get(pkt);
+	uint32_t cookie = th_ack(th) - 1U;
+	uint32_t time = syn_cookie_time();
+	uint32_t age;
+
+	/* Cookies are valid for up to two periods */
+	age = (time - (cookie >> SYN_COOKIE_TIME_SHIFT)) & SYN_COOKIE_TIME_MASK;
+	if (age > 1) {
+		return 0;
+	}
+
+	if ((syn_cookie_hash(pkt, th_seq(th) - 1U, time - age) ^ cookie) &
+	    SYN_COOKIE_HASH_MASK) {
+		return 0;
+	}
+
+	return syn_cookie_mss[(cookie >> SYN_COOKIE_MSS_SHIFT) &
+			      SYN_COOKIE_MSS_MASK];
 }
 
-static struct tcp *tcp_conn_search(struct net_pkt *pkt)
+/* Answer a SYN with a SYN-ACK carrying a cookie, without allocating a
+ * connection.
+ */
+static int tcp_syn_cookie_send(struct tcp *listener, struct net_pkt *syn)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
+	struct tcphdr *th = th_get(syn);
+	size_t options_len = (th_off(th) - 5) * 4;
+	struct tcp_options opts = { 0 };
+	union tcp_endpoint src, dst;
+	uint8_t options[NET_TCP_MSS_SIZE];
+	struct net_pkt *pkt;
+	struct tcphdr *out;
+	uint16_t mss;
+	int ret;
+
+	if (options_len && !tcp_options_check(&opts, syn, options_len)) {
+		return -EINVAL;
+	}
+
+	if (tcp_endpoint_set(&src, syn, TCP_EP_DST) < 0 ||
+	    tcp_endpoint_set(&dst, syn, TCP_EP_SRC) < 0) {
+		return -EINVAL;
+	}
+
+	mss = opts.mss_found ? opts.mss : NET_TCP_DEFAULT_MSS;
+
+	pkt = net_pkt_alloc_with_buffer(net_pkt_iface(syn),
+					sizeof(struct tcphdr) + sizeof(options),
+					net_pkt_family(syn), IPPROTO_TCP,
+					K_NO_WAIT);
+	if (!pkt) {
+		return -ENOBUFS;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
+		ret = net_context_create_ipv4_new(listener->context, pkt,
+						  &src.sin.sin_addr,
+						  &dst.sin.sin_addr);
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   net_pkt_family(pkt) == AF_INET6) {
+		ret = net_context_create_ipv6_new(listener->context, pkt,
+						  &src.sin6.sin6_addr,
+						  &dst.sin6.sin6_addr);
+	} else {
+		ret = -EINVAL;
+	}
+
+	if (ret < 0) {
+		goto fail;
+	}
+
+	out = (struct tcphdr *)net_pkt_get_data(pkt, &tcp_access);
+	if (!out) {
+		ret = -ENOBUFS;
+		goto fail;
+	}
+
+	memset(out, 0, sizeof(struct tcphdr));
+
+	UNALIGNED_PUT(src.sin.sin_port, &out->th_sport);
+	UNALIGNED_PUT(dst.sin.sin_port, &out->th_dport);
+	out->th_off = 5 + sizeof(options) / 4;
+	UNALIGNED_PUT(SYN | ACK, &out->th_flags);
+	UNALIGNED_PUT(htons(MIN(listener->recv_win, UINT16_MAX)),
+		      &out->th_win);
+	UNALIGNED_PUT(htonl(syn_cookie_make(syn, mss)), &out->th_seq);
+	UNALIGNED_PUT(htonl(th_seq(th) + 1U), &out->th_ack);
+
+	options[0] = NET_TCP_MSS_OPT;
+	options[1] = NET_TCP_MSS_SIZE;
+	sys_put_be16(net_tcp_get_supported_mss(listener), &options[2]);
+
+	if (net_pkt_set_data(pkt, &tcp_access) < 0 ||
+	    net_pkt_write(pkt, options, sizeof(options)) < 0) {
+		ret = -ENOBUFS;
+		goto fail;
+	}
+
+	ret = tcp_finalize_pkt(pkt);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	NET_DBG("SYN cookie sent for listener %p", listener);
+
+	tcp_send(pkt);
+
+	return 0;
+
+fail:
+	tcp_pkt_unref(pkt);
+
+	return ret;
+}
+
+/* Create the connection of a listener when the peer acks a cookie */
+static struct tcp *tcp_syn_cookie_conn_new(struct tcp *listener,
+					   struct net_pkt *pkt)
 {
-	bool found = false;
+	struct tcphdr *th = th_get(pkt);
+	size_t handshake, accept_queue;
 	struct tcp *conn;
-	struct tcp *tmp;
+	uint16_t mss;
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp_conns, conn, tmp, next) {
-		found = tcp_conn_cmp(conn, pkt);
-		if (found) {
-			break;
+	if (!listener ||
+	    net_context_get_state(listener->context) != NET_CONTEXT_LISTENING) {
+		return NULL;
+	}
+
+	mss = syn_cookie_check(pkt);
+	if (mss == 0) {
+		NET_DBG("Invalid SYN cookie");
+		return NULL;
+	}
+
+	/* Only the connections waiting to be accepted count, the ones in
+	 * the handshake are what made us send cookies.
+	 */
+	if (listener->backlog_max) {
+		tcp_backlog_count(listener, &handshake, &accept_queue);
+		if (accept_queue > listener->backlog_max) {
+			NET_DBG("Accept queue of conn %p is full", listener);
+			return NULL;
 		}
 	}
 
-	return found ? conn : NULL;
-}
+	conn = tcp_conn_new(pkt);
+	if (!conn) {
+		return NULL;
+	}
 
-static struct tcp *tcp_conn_new(struct net_pkt *pkt);
+	net_ipaddr_copy(&listener->context->remote, &conn->dst.sa);
+
+	conn->accepted_conn = listener;
+	tcp_backlog_add(listener, conn);
+
+	/* Pick up the handshake as if we had sent the SYN-ACK with the
+	 * options that fit in a cookie.
+	 */
+	conn->recv_options.mss = mss;
+	conn->recv_options.mss_found = true;
+	conn->seq = th_ack(th);
+	conn->ack = th_seq(th);
+	tcp_syn_options_negotiate(conn);
+	conn_state(conn, TCP_SYN_RECEIVED);
+
+	return conn;
+}
+#endif /* CONFIG_NET_TCP_SYN_COOKIES */
 
 static enum net_verdict tcp_recv(struct net_conn *net_conn,
 				 struct net_pkt *pkt,
@@ -1583,16 +2442,36 @@ static enum net_verdict tcp_recv(struct net_conn *net_conn,
 	if (th_flags(th) & SYN && !(th_flags(th) & ACK)) {
 		struct tcp *conn_old = ((struct net_context *)user_data)->tcp;
 
-		conn = tcp_conn_new(pkt);
+		if (tcp_backlog_full(conn_old)) {
+			NET_DBG("Backlog of conn %p is full", conn_old);
+		} else {
+			conn = tcp_conn_new(pkt);
+			if (!conn) {
+				NET_ERR("Cannot allocate a new TCP connection");
+			}
+		}
+
 		if (!conn) {
-			NET_ERR("Cannot allocate a new TCP connection");
+#if defined(CONFIG_NET_TCP_SYN_COOKIES)
+			if (tcp_syn_cookie_send(conn_old, pkt) == 0) {
+				net_pkt_unref(pkt);
+				verdict = NET_OK;
+			}
+#endif
 			goto in;
 		}
 
 		net_ipaddr_copy(&conn_old->context->remote, &conn->dst.sa);
 
 		conn->accepted_conn = conn_old;
+		tcp_backlog_add(conn_old, conn);
+	}
+#if defined(CONFIG_NET_TCP_SYN_COOKIES)
+	else if ((th_flags(th) & (SYN | ACK | RST)) == ACK) {
+		conn = tcp_syn_cookie_conn_new(
+			((struct net_context *)user_data)->tcp, pkt);
 	}
+#endif
  in:
 	if (conn) {
 		verdict = tcp_in(conn, pkt);
@@ -1792,6 +2671,8 @@ static struct tcp *tcp_conn_new(struct net_pkt *pkt)
 		conn = NULL;
 		goto err;
 	}
+
+	tcp_conn_hash_add(conn);
 err:
 	if (!conn) {
 		net_stats_update_tcp_seg_conndrop(net_pkt_iface(pkt));
@@ -1806,165 +2687,91 @@ static bool tcp_validate_seq(struct tcp *conn, struct tcphdr *hdr)
 		(net_tcp_seq_cmp(th_seq(hdr), conn->ack + conn->recv_win) < 0);
 }
 
-static bool check_seq_list(struct net_buf *buf)
-{
-	struct net_buf *last = NULL;
-	struct net_buf *tmp = buf;
-	uint32_t seq;
-	uint32_t next_seq = 0;
-	bool result = true;
-
-	while (tmp) {
-		seq = tcp_get_seq(tmp);
-
-		NET_DBG("buf %p seq %u len %d", tmp, seq, tmp->len);
-
-		if (last != NULL) {
-			if (next_seq != seq) {
-				result = false;
-			}
-		}
-
-		next_seq = seq + tmp->len;
-		last = tmp;
-		tmp = tmp->frags;
-	}
-	return result;
-}
-
 static void tcp_queue_recv_data(struct tcp *conn, struct net_pkt *pkt,
 				size_t len, uint32_t seq)
 {
-	uint32_t seq_start = seq;
-	bool inserted = false;
-	struct net_buf *tmp;
+	struct tcp_ooo_range *range, *next;
+	uint32_t end = seq + len;
 
 	NET_DBG("conn: %p len %zd seq %u ack %u", conn, len, seq, conn->ack);
 
-	tmp = pkt->buffer;
-
-	tcp_set_seq(tmp, seq);
-	seq += tmp->len;
-	tmp = tmp->frags;
-
-	while (tmp) {
-		tcp_set_seq(tmp, seq);
-		seq += tmp->len;
-		tmp = tmp->frags;
-	}
-
-	if (IS_ENABLED(CONFIG_NET_TCP_LOG_LEVEL_DBG)) {
-		NET_DBG("Queuing data: conn %p", conn);
+	/* Sequence numbers of the queue are compared with each other, so
+	 * only data that fits in the receive window is accepted.
+	 */
+	if (net_tcp_seq_cmp(seq, conn->ack + conn->recv_win) >= 0) {
+		NET_DBG("Data seq %u outside of window", seq);
+		return;
 	}
 
-	if (!net_pkt_is_empty(conn->queue_recv_data)) {
-		/* Place the data to correct place in the list. If the data
-		 * would not be sequential, then drop this packet.
-		 *
-		 * Only work with subtractions between sequence numbers in uint32_t format
-		 * to proper handle cases that are around the wrapping point.
-		 */
-
-		/* Some potentential cases:
-		 * Note: MI = MAX_INT
-		 * Packet | Queued| End off1  | Start off| End off2    | Required handling
-		 * Seq|Len|Seq|Len|           |          |             |
-		 *  3 | 3 | 6 | 4 | 3+3-6=  0 | NA       | NA          | Prepend
-		 *  3 | 4 | 6 | 4 | 3+4-6 = 1 | NA       | NA          | Prepend, pull from buffer
-		 *  3 | 7 | 6 | 4 | 3+7-6 = 4 | 6-3=3    | 6+4-3=7     | Drop queued data
-		 *  3 | 8 | 6 | 4 | 3+8-6 = 5 | 6-3=3    | 6+4-3=7     | Drop queued data
-		 *  6 | 5 | 6 | 4 | 6+5-6 = 5 | 6-6=0    | 6+4-6=4     | Drop queued data
-		 *  6 | 4 | 6 | 4 | 6+4-6 = 4 | 6-6=0    | 6+4-6=4     | Drop queued data / packet
-		 *  7 | 2 | 6 | 4 | 7+2-6 = 3 | 6-7=MI   | 6+4-7=3     | Drop packet
-		 * 10 | 2 | 6 | 4 | 10+2-6= 6 | 6-10=MI-3| 6+4-10=0    | Append
-		 *  7 | 4 | 6 | 4 | 7+4-6 = 5 | 6-7 =MI  | 6+4-7 =3    | Append, pull from packet
-		 * 11 | 2 | 6 | 4 | 11+2-6= 7 | 6-11=MI-6| 6+4-11=MI-1 | Drop incoming packet
-		 *  2 | 3 | 6 | 4 | 2+3-6= MI | 6-2=4    | 6+4-2=8     | Drop incoming packet
-		 */
+	/* Only work with subtractions between sequence numbers in uint32_t
+	 * format to proper handle cases that are around the wrapping point.
+	 */
+	range = tcp_ooo_find(conn, seq, false);
+	if (range && net_tcp_seq_cmp(range->seq + range->len, seq) >= 0) {
+		uint32_t range_end = range->seq + range->len;
 
-		uint32_t pending_seq;
-		uint32_t start_offset;
-		uint32_t end_offset;
-		size_t pending_len;
-
-		pending_seq = tcp_get_seq(conn->queue_recv_data->buffer);
-		end_offset = seq - pending_seq;
-		pending_len = net_pkt_get_len(conn->queue_recv_data);
-		if (end_offset < pending_len) {
-			if (end_offset < len) {
-				if (end_offset) {
-					net_pkt_remove_tail(pkt, end_offset);
-				}
+		if (net_tcp_seq_cmp(range_end, end) >= 0) {
+			NET_DBG("Data seq %u len %zd already queued", seq, len);
+			return;
+		}
 
-				/* Put new data before the pending data */
-				net_buf_frag_add(pkt->buffer,
-						 conn->queue_recv_data->buffer);
-				NET_DBG("Adding at before queue, end_offset %i, pending_len %zu",
-					end_offset, pending_len);
-				conn->queue_recv_data->buffer = pkt->buffer;
-				inserted = true;
-			}
-		} else {
-			struct net_buf *last;
+		/* Extend the preceding range with the data after its end */
+		if (range_end != seq) {
+			tcp_pkt_pull(pkt, range_end - seq);
+			seq = range_end;
+		}
+	} else {
+		range = tcp_ooo_range_alloc(conn);
+		if (range == NULL) {
+			NET_DBG("Cannot add new data to queue");
+			return;
+		}
 
-			last = net_buf_frag_last(conn->queue_recv_data->buffer);
-			pending_seq = tcp_get_seq(last);
+		range->seq = seq;
+		rb_insert(&conn->recv_queue, &range->node);
+	}
 
-			start_offset = pending_seq - seq_start;
-			/* Compute the offset w.r.t. the start point of the new packet */
-			end_offset = (pending_seq + last->len) - seq_start;
+	/* Drop the ranges covered by the new data and merge with the one
+	 * overlapping or following its end.
+	 */
+	while ((next = tcp_ooo_find(conn, seq, true)) != NULL &&
+	       net_tcp_seq_cmp(next->seq, end) <= 0) {
+		uint32_t next_end = next->seq + next->len;
 
-			/* Check if queue start with within the within the new packet */
-			if ((start_offset < len) && (end_offset <= len)) {
-				/* The queued data is irrelevant since the new packet overlaps the
-				 * new packet, take the new packet as contents
-				 */
-				net_buf_unref(conn->queue_recv_data->buffer);
-				conn->queue_recv_data->buffer = pkt->buffer;
-				inserted = true;
-			} else {
-				if (end_offset < len) {
-					if (end_offset) {
-						net_pkt_remove_tail(conn->queue_recv_data,
-								    end_offset);
-					}
+		rb_remove(&conn->recv_queue, &next->node);
 
-					/* Put new data after pending data */
-					NET_DBG("Adding at end of queue, start %i, end %i, len %zu",
-						start_offset, end_offset, len);
-					net_buf_frag_add(conn->queue_recv_data->buffer,
-							 pkt->buffer);
-					inserted = true;
-				}
+		if (net_tcp_seq_cmp(next_end, end) > 0) {
+			if (end != next->seq) {
+				net_pkt_remove_tail(pkt, end - next->seq);
 			}
-		}
 
-		if (inserted) {
-			NET_DBG("All pending data: conn %p", conn);
-			if (check_seq_list(conn->queue_recv_data->buffer) == false) {
-				NET_ERR("Incorrect order in out of order sequence for conn %p",
-					conn);
-				/* error in sequence list, drop it */
-				net_buf_unref(conn->queue_recv_data->buffer);
-				conn->queue_recv_data->buffer = NULL;
-			}
-		} else {
-			NET_DBG("Cannot add new data to queue");
+			net_buf_frag_add(pkt->buffer, next->buf);
+			next->buf = NULL;
+			end = next_end;
 		}
+
+		tcp_ooo_range_free(conn, next);
+	}
+
+	if (range->buf) {
+		net_buf_frag_add(range->buf, pkt->buffer);
 	} else {
-		net_pkt_append_buffer(conn->queue_recv_data, pkt->buffer);
-		inserted = true;
+		range->buf = pkt->buffer;
 	}
 
-	if (inserted) {
-		/* We need to keep the received data but free the pkt */
-		pkt->buffer = NULL;
+	range->len = end - range->seq;
+	conn->recv_queue_last = range;
 
-		if (!k_work_delayable_is_pending(&conn->recv_queue_timer)) {
-			k_work_reschedule_for_queue(
-				&tcp_work_q, &conn->recv_queue_timer,
-				K_MSEC(CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT));
-		}
+	NET_DBG("Queued range seq %u len %u, %u ranges", range->seq,
+		range->len, conn->recv_queue_ranges);
+
+	/* We need to keep the received data but free the pkt */
+	pkt->buffer = NULL;
+
+	if (!k_work_delayable_is_pending(&conn->recv_queue_timer)) {
+		k_work_reschedule_for_queue(
+			&tcp_work_q, &conn->recv_queue_timer,
+			K_MSEC(CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT));
 	}
 }
 
@@ -2073,6 +2880,12 @@ static enum net_verdict tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		goto next_state;
 	}
 
+	if (th) {
+		/* Timestamps and SACK blocks only describe this segment */
+		conn->recv_options.ts_found = false;
+		conn->recv_options.sack_count = 0;
+	}
+
 	if (tcp_options_len && !tcp_options_check(&conn->recv_options, pkt,
 						  tcp_options_len)) {
 		NET_DBG("DROP: Invalid TCP option list");
@@ -2082,6 +2895,14 @@ static enum net_verdict tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		goto next_state;
 	}
 
+	if (th && !tcp_timestamp_check(conn, th)) {
+		NET_DBG("DROP: Old timestamp");
+		net_stats_update_tcp_seg_drop(conn->iface);
+		tcp_out(conn, ACK);
+		k_mutex_unlock(&conn->lock);
+		return NET_DROP;
+	}
+
 	if (th && (conn->state != TCP_LISTEN) && (conn->state != TCP_SYN_SENT) &&
 	    tcp_validate_seq(conn, th) && FL(&fl, &, SYN)) {
 		/* According to RFC 793, ch 3.9 Event Processing, receiving SYN
@@ -2101,6 +2922,9 @@ static enum net_verdict tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		size_t max_win;
 
 		conn->send_win = ntohs(th_win(th));
+		if (!(th_flags(th) & SYN)) {
+			conn->send_win <<= conn->snd_wscale;
+		}
 
 #if defined(CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE)
 		if (CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE) {
@@ -2158,6 +2982,8 @@ next_state:
 			/* Make sure our MSS is also sent in the ACK */
 			conn->send_options.mss_found = true;
 			conn_ack(conn, th_seq(th) + 1); /* capture peer's isn */
+			tcp_syn_options_init(conn);
+			tcp_syn_options_negotiate(conn);
 			tcp_out(conn, SYN | ACK);
 			conn->send_options.mss_found = false;
 			conn_seq(conn, + 1);
@@ -2171,6 +2997,7 @@ next_state:
 			verdict = NET_OK;
 		} else {
 			conn->send_options.mss_found = true;
+			tcp_syn_options_init(conn);
 			tcp_out(conn, SYN);
 			conn->send_options.mss_found = false;
 			conn_seq(conn, + 1);
@@ -2182,12 +3009,18 @@ next_state:
 				th_seq(th) == conn->ack)) {
 			k_work_cancel_delayable(&conn->establish_timer);
 			tcp_send_timer_cancel(conn);
+			tcp_ca_init(conn);
 			next = TCP_ESTABLISHED;
 			tcp_conn_ref(conn);
 			net_context_set_state(conn->context,
 					      NET_CONTEXT_CONNECTED);
 
 			if (conn->accepted_conn) {
+				/* Waiting in the accept queue of the listener
+				 * until the application takes it.
+				 */
+				net_context_set_accepting(conn->context, true);
+
 				if (conn->accepted_conn->accept_cb) {
 					conn->accepted_conn->accept_cb(
 						conn->context,
@@ -2222,6 +3055,8 @@ next_state:
 		 */
 		if (FL(&fl, &, SYN | ACK, th && th_ack(th) == conn->seq)) {
 			tcp_send_timer_cancel(conn);
+			tcp_syn_options_negotiate(conn);
+			tcp_ca_init(conn);
 			conn_ack(conn, th_seq(th) + 1);
 			if (len) {
 				verdict = tcp_data_get(conn, pkt, &len);
@@ -2289,6 +3124,12 @@ next_state:
 		}
 
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+#if defined(CONFIG_NET_TCP_SACK)
+		if (th && conn->sack_ok) {
+			tcp_sack_update(conn, th_ack(th));
+		}
+#endif
+
 		if (th && (net_tcp_seq_cmp(th_ack(th), conn->seq) == 0)) {
 			/* Only if there is pending data, increment the duplicate ack count */
 			if (conn->send_data_total > 0) {
@@ -2308,14 +3149,10 @@ next_state:
 			if ((conn->data_mode == TCP_DATA_MODE_SEND) &&
 			    (conn->dup_ack_cnt == DUPLICATE_ACK_RETRANSMIT_TRHESHOLD)) {
 				/* Apply a fast retransmit */
-				int temp_unacked_len = conn->unacked_len;
-
-				conn->unacked_len = 0;
-
-				(void)tcp_send_data(conn);
-
-				/* Restore the current transmission */
-				conn->unacked_len = temp_unacked_len;
+				tcp_fast_retransmit(conn);
+			} else if (conn->in_recovery && len == 0 &&
+				   conn->send_data_total > 0) {
+				tcp_fast_recovery_dup_ack(conn);
 			}
 		}
 #endif
@@ -2357,6 +3194,17 @@ next_state:
 			conn_seq(conn, + len_acked);
 			net_stats_update_tcp_seg_recv(conn->iface);
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+			if (!conn->in_recovery) {
+				tcp_ca_ack(conn, len_acked);
+			}
+#endif
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+			if (conn->in_recovery) {
+				tcp_fast_recovery_ack(conn, len_acked);
+			}
+#endif
+
 			conn_send_data_dump(conn);
 
 			if (!k_work_delayable_remaining_get(
@@ -2623,8 +3471,14 @@ int net_tcp_put(struct net_context *context)
 	return 0;
 }
 
-int net_tcp_listen(struct net_context *context)
+int net_tcp_listen(struct net_context *context, int backlog)
 {
+	struct tcp *conn = context->tcp;
+
+	if (conn) {
+		conn->backlog_max = CLAMP(backlog, 0, UINT16_MAX);
+	}
+
 	/* when created, tcp connections are in state TCP_LISTEN */
 	net_context_set_state(context, NET_CONTEXT_LISTENING);
 
@@ -2891,6 +3745,8 @@ int net_tcp_connect(struct net_context *context,
 		goto out;
 	}
 
+	tcp_conn_hash_add(conn);
+
 	/* Input of a (nonexistent) packet with no flags set will cause
 	 * a TCP connection to be established
 	 */
@@ -3037,7 +3893,7 @@ struct net_tcp_hdr *net_tcp_input(struct net_pkt *pkt,
 	struct net_tcp_hdr *tcp_hdr;
 
 	if (IS_ENABLED(CONFIG_NET_TCP_CHECKSUM) &&
-	    net_if_need_calc_rx_checksum(net_pkt_iface(pkt)) &&
+	    net_pkt_need_rx_l4_chksum(pkt) &&
 	    net_calc_chksum_tcp(pkt) != 0U) {
 		NET_DBG("DROP: checksum mismatch");
 		goto drop;
@@ -3074,6 +3930,7 @@ static enum net_verdict tcp_input(struct net_conn *net_conn,
 			conn = context->tcp;
 			tcp_endpoint_set(&conn->dst, pkt, TCP_EP_SRC);
 			tcp_endpoint_set(&conn->src, pkt, TCP_EP_DST);
+			tcp_conn_hash_add(conn);
 			/* Make an extra reference, the sanity check suite
 			 * will delete the connection explicitly
 			 */
@@ -3196,6 +4053,7 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 				conn = context->tcp;
 				tcp_endpoint_set(&conn->dst, pkt, TCP_EP_SRC);
 				tcp_endpoint_set(&conn->src, pkt, TCP_EP_DST);
+				tcp_conn_hash_add(conn);
 				conn->iface = pkt->iface;
 				tcp_conn_ref(conn);
 			}
@@ -3260,6 +4118,8 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 		tp_new_find_and_apply(tp_new, "tcp_window", &tcp_window,
 					TP_INT);
 		tp_new_find_and_apply(tp_new, "tp_trace", &tp_trace, TP_BOOL);
+		tp_new_find_and_apply(tp_new, "tp_loss", &tp_loss, TP_INT);
+		tp_new_find_and_apply(tp_new, "tp_delay", &tp_delay, TP_INT);
 		break;
 	case TP_INTROSPECT_REQUEST:
 		json_len = sizeof(buf);
@@ -3447,6 +4307,12 @@ void net_tcp_init(void)
 #define THREAD_PRIORITY K_PRIO_PREEMPT(0)
 #endif
 
+	tcp_conn_hash_seed = sys_rand32_get();
+
+#if defined(CONFIG_NET_TCP_SYN_COOKIES)
+	sys_rand_get(syn_cookie_key, sizeof(syn_cookie_key));
+#endif
+
 	/* Use private workqueue in order not to block the system work queue.
 	 */
 	k_work_queue_start(&tcp_work_q, work_q_stack,
@@ -3470,4 +4336,8 @@ void net_tcp_init(void)
 
 	k_thread_name_set(&tcp_work_q.thread, "tcp_work");
 	NET_DBG("Workq started. Thread ID: %p", &tcp_work_q.thread);
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	NET_DBG("Congestion control: %s", tcp_cc.name);
+#endif
 }
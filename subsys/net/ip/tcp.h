@@ -56,10 +56,12 @@ int net_tcp_put(struct net_context *context);
  * @brief Listen for an incoming TCP connection
  *
  * @param context Network context
+ * @param backlog Max number of connections in the handshake or waiting to
+ *        be accepted, 0 for no limit
  *
  * @return 0 if successful, < 0 on error
  */
-int net_tcp_listen(struct net_context *context);
+int net_tcp_listen(struct net_context *context, int backlog);
 
 /**
  * @brief Register an accept callback
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* CUBIC congestion control (RFC 8312). After a loss the congestion
+ * window follows a cubic function of the time elapsed since the loss,
+ * which plateaus around the window where the loss happened and probes
+ * beyond it afterwards. The window never grows slower than the window
+ * NewReno would have (the Reno-friendly region).
+ *
+ * Windows are kept in bytes and times in milliseconds.
+ */
+
+#include <zephyr/kernel.h>
+
+#include "tcp_internal.h"
+
+/* C = 0.4 segments / s^3, beta = 0.7 */
+#define CUBIC_C_NUM      4
+#define CUBIC_C_DEN      10
+#define CUBIC_BETA_NUM   7
+#define CUBIC_BETA_DEN   10
+
+/* Reno-friendly additive increase, 3 * (1 - beta) / (1 + beta) */
+#define CUBIC_ALPHA_NUM  9
+#define CUBIC_ALPHA_DEN  17
+
+/* Beyond this the target is capped by the window limit anyway */
+#define CUBIC_MAX_DELTA_MS 100000
+
+struct cubic {
+	uint32_t w_max;       /* Window before the last reduction */
+	uint32_t k;           /* Time to reach w_max again */
+	uint32_t epoch_start; /* Start of the congestion avoidance epoch */
+	uint32_t origin;      /* Plateau of the cubic function */
+	uint32_t w_est;       /* Window NewReno would have */
+	uint32_t est_acked;   /* Bytes acked since w_est last grew */
+};
+
+BUILD_ASSERT(sizeof(struct cubic) <= sizeof(((struct tcp_ca *)0)->priv));
+
+static uint32_t cubic_root(uint64_t a)
+{
+	uint64_t y = 0U;
+
+	for (int s = 63; s >= 0; s -= 3) {
+		uint64_t b;
+
+		y <<= 1;
+		b = 3U * y * (y + 1U) + 1U;
+
+		if ((a >> s) >= b) {
+			a -= b << s;
+			y++;
+		}
+	}
+
+	return (uint32_t)y;
+}
+
+static void cubic_init(struct tcp *conn)
+{
+	struct cubic *ca = (struct cubic *)conn->ca.priv;
+
+	memset(ca, 0, sizeof(*ca));
+}
+
+static uint32_t cubic_ssthresh(struct tcp *conn)
+{
+	struct cubic *ca = (struct cubic *)conn->ca.priv;
+	uint32_t cwnd = conn->ca.cwnd;
+
+	ca->epoch_start = 0U;
+
+	/* Fast convergence, release bandwidth to new flows */
+	if (cwnd < ca->w_max) {
+		ca->w_max = (uint32_t)((uint64_t)cwnd *
+				       (CUBIC_BETA_DEN + CUBIC_BETA_NUM) /
+				       (2U * CUBIC_BETA_DEN));
+	} else {
+		ca->w_max = cwnd;
+	}
+
+	return MAX((uint32_t)((uint64_t)cwnd * CUBIC_BETA_NUM / CUBIC_BETA_DEN),
+		   2U * conn_mss(conn));
+}
+
+/* Window of the cubic function dt ms after the plateau */
+static uint32_t cubic_target(struct cubic *ca, uint32_t mss, int64_t dt)
+{
+	int64_t offs;
+
+	dt = CLAMP(dt, -CUBIC_MAX_DELTA_MS, CUBIC_MAX_DELTA_MS);
+
+	/* C * mss * (dt / 1000)^3, scaled in steps to stay in range */
+	offs = ((dt * dt * dt) / 10000) * CUBIC_C_NUM * mss;
+	offs /= 100000 * CUBIC_C_DEN;
+
+	if (offs < 0 && (uint32_t)-offs >= ca->origin) {
+		return 0U;
+	}
+
+	return (uint32_t)MIN((int64_t)ca->origin + offs, (int64_t)UINT32_MAX);
+}
+
+static void cubic_cong_avoid(struct tcp *conn, uint32_t acked)
+{
+	struct cubic *ca = (struct cubic *)conn->ca.priv;
+	uint32_t cwnd = conn->ca.cwnd;
+	uint32_t mss = conn_mss(conn);
+	uint32_t now = k_uptime_get_32();
+	uint32_t target;
+
+	if (ca->epoch_start == 0U) {
+		ca->epoch_start = now ? now : 1U;
+
+		if (cwnd < ca->w_max) {
+			ca->k = cubic_root((uint64_t)(ca->w_max - cwnd) *
+					   1000000000U * CUBIC_C_DEN /
+					   (CUBIC_C_NUM * mss));
+			ca->origin = ca->w_max;
+		} else {
+			ca->k = 0U;
+			ca->origin = cwnd;
+		}
+
+		ca->w_est = cwnd;
+		ca->est_acked = 0U;
+	}
+
+	target = cubic_target(ca, mss,
+			      (int64_t)(now - ca->epoch_start) - ca->k);
+
+	/* Reno-friendly region */
+	ca->est_acked += acked;
+	if ((uint64_t)ca->est_acked * CUBIC_ALPHA_NUM >=
+	    (uint64_t)cwnd * CUBIC_ALPHA_DEN) {
+		ca->est_acked = 0U;
+		ca->w_est += mss;
+	}
+
+	target = MAX(target, ca->w_est);
+
+	/* Do not grow more than 50% per round trip */
+	target = MIN(target, cwnd + cwnd / 2U);
+
+	if (target > cwnd) {
+		conn->ca.cwnd += MAX((uint32_t)((uint64_t)(target - cwnd) *
+						acked / cwnd), 1U);
+	}
+}
+
+const struct tcp_cc_ops tcp_cc = {
+	.name = "cubic",
+	.init = cubic_init,
+	.ssthresh = cubic_ssthresh,
+	.cong_avoid = cubic_cong_avoid,
+};
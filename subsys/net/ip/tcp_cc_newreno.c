@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* NewReno congestion control (RFC 5681, RFC 6582). In congestion
+ * avoidance the congestion window grows by one segment for each window
+ * worth of acknowledged data, and it is halved on loss.
+ */
+
+#include <zephyr/kernel.h>
+
+#include "tcp_internal.h"
+
+struct newreno {
+	uint32_t bytes_acked;
+};
+
+BUILD_ASSERT(sizeof(struct newreno) <= sizeof(((struct tcp_ca *)0)->priv));
+
+static void newreno_init(struct tcp *conn)
+{
+	struct newreno *ca = (struct newreno *)conn->ca.priv;
+
+	ca->bytes_acked = 0U;
+}
+
+static uint32_t newreno_ssthresh(struct tcp *conn)
+{
+	return MAX((uint32_t)conn->unacked_len / 2U, 2U * conn_mss(conn));
+}
+
+static void newreno_cong_avoid(struct tcp *conn, uint32_t acked)
+{
+	struct newreno *ca = (struct newreno *)conn->ca.priv;
+
+	ca->bytes_acked += acked;
+
+	if (ca->bytes_acked >= conn->ca.cwnd) {
+		ca->bytes_acked -= conn->ca.cwnd;
+		conn->ca.cwnd += conn_mss(conn);
+	}
+}
+
+const struct tcp_cc_ops tcp_cc = {
+	.name = "newreno",
+	.init = newreno_init,
+	.ssthresh = newreno_ssthresh,
+	.cong_avoid = newreno_cong_avoid,
+};
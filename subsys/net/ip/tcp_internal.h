@@ -153,16 +153,19 @@ static inline int net_tcp_connect(struct net_context *context,
  * @brief Set TCP socket into listening state
  *
  * @param context Network context
+ * @param backlog Max number of connections in the handshake or waiting to
+ *        be accepted, 0 for no limit
  *
  * @return 0 if successful, -EOPNOTSUPP if the context was not for TCP,
  *         -EPROTONOSUPPORT if TCP is not supported
  */
 #if defined(CONFIG_NET_NATIVE_TCP)
-int net_tcp_listen(struct net_context *context);
+int net_tcp_listen(struct net_context *context, int backlog);
 #else
-static inline int net_tcp_listen(struct net_context *context)
+static inline int net_tcp_listen(struct net_context *context, int backlog)
 {
 	ARG_UNUSED(context);
+	ARG_UNUSED(backlog);
 
 	return -EPROTONOSUPPORT;
 }
@@ -345,8 +348,6 @@ static inline int net_tcp_put(struct net_context *context)
 }
 #endif
 
-#define NET_TCP_MAX_OPT_SIZE  8
-
 #if defined(CONFIG_NET_NATIVE_TCP)
 void net_tcp_init(void);
 #else
@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <zephyr/sys/rb.h>
+
 #include "tp.h"
 
 #define is(_a, _b) (strcmp((_a), (_b)) == 0)
@@ -77,6 +79,22 @@
 	_pkt;								\
 })
 
+/* Data of a segment, appended to the packet holding the headers. It is
+ * not bound to the interface, as its length is not limited by the MTU when
+ * the packet is segmented later, see CONFIG_NET_GSO.
+ */
+#define tcp_data_pkt_alloc(_len)					\
+({									\
+	struct net_pkt *_pkt;						\
+									\
+	_pkt = net_pkt_alloc_with_buffer(NULL, (_len), AF_UNSPEC, 0,	\
+					 TCP_PKT_ALLOC_TIMEOUT);	\
+									\
+	tp_pkt_alloc(_pkt, tp_basename(__FILE__), __LINE__);		\
+									\
+	_pkt;								\
+})
+
 #define tcp_rx_pkt_alloc(_conn, _len)					\
 ({									\
 	struct net_pkt *_pkt;						\
@@ -117,6 +135,13 @@
 					    : NET_TCP_DEFAULT_MSS,	\
 	    net_tcp_get_supported_mss(_conn))
 
+/* Max amount of data sent in one packet, see CONFIG_NET_GSO */
+#if defined(CONFIG_NET_GSO)
+#define conn_send_max(_conn) (conn_mss(_conn) * CONFIG_NET_GSO_MAX_SEGS)
+#else
+#define conn_send_max(_conn) conn_mss(_conn)
+#endif
+
 #define conn_state(_conn, _s)						\
 ({									\
 	NET_DBG("%s->%s",						\
@@ -128,7 +153,7 @@
 #define conn_send_data_dump(_conn)                                             \
 	({                                                                     \
 		NET_DBG("conn: %p total=%zd, unacked_len=%d, "                 \
-			"send_win=%hu, mss=%hu",                               \
+			"send_win=%u, mss=%hu",                                \
 			(_conn), net_pkt_get_len((_conn)->send_data),          \
 			_conn->unacked_len, _conn->send_win,                   \
 			(uint16_t)conn_mss((_conn)));                          \
@@ -174,10 +199,6 @@ enum th_flags {
 	CWR = BIT(7),
 };
 
-struct tcp_mss_option {
-	uint32_t option;
-};
-
 enum tcp_state {
 	TCP_LISTEN = 1,
 	TCP_SYN_SENT,
@@ -208,25 +229,102 @@ union tcp_endpoint {
 #define NET_TCP_NOP_OPT          1
 #define NET_TCP_MSS_OPT          2
 #define NET_TCP_WINDOW_SCALE_OPT 3
+#define NET_TCP_SACK_PERM_OPT    4
+#define NET_TCP_SACK_OPT         5
+#define NET_TCP_TIMESTAMP_OPT    8
 
 /* TCP Option sizes */
 #define NET_TCP_END_SIZE          1
 #define NET_TCP_NOP_SIZE          1
 #define NET_TCP_MSS_SIZE          4
 #define NET_TCP_WINDOW_SCALE_SIZE 3
+#define NET_TCP_SACK_PERM_SIZE    2
+#define NET_TCP_SACK_BLOCK_SIZE   8
+#define NET_TCP_TIMESTAMP_SIZE    10
+
+#define NET_TCP_MAX_OPT_SIZE      40
+
+/* Largest shift count of the window scale option, RFC 7323 */
+#define NET_TCP_MAX_WINDOW_SCALE 14
+
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+#define NET_TCP_MAX_WIN ((uint32_t)UINT16_MAX << NET_TCP_MAX_WINDOW_SCALE)
+#else
+#define NET_TCP_MAX_WIN UINT16_MAX
+#endif
+
+/* Max number of SACK blocks in an option, and in the scoreboard */
+#define NET_TCP_MAX_SACK_BLOCKS 4
+
+struct tcp_sack_block {
+	uint32_t start;
+	uint32_t end;
+};
 
 struct tcp_options {
+	uint32_t tsval;
+	uint32_t tsecr;
+#if defined(CONFIG_NET_TCP_SACK)
+	struct tcp_sack_block sack[NET_TCP_MAX_SACK_BLOCKS];
+#endif
 	uint16_t mss;
 	uint16_t window;
+	uint8_t sack_count;
 	bool mss_found : 1;
 	bool wnd_found : 1;
+	bool sack_perm_found : 1;
+	bool ts_found : 1;
 };
 
+/* Range of out-of-order data in the receive queue. Adjacent and
+ * overlapping ranges are coalesced, so the ranges of a connection never
+ * touch each other.
+ */
+struct tcp_ooo_range {
+	struct rbnode node;
+	struct net_buf *buf;
+	uint32_t seq;
+	uint32_t len;
+};
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+struct tcp;
+
+/* Congestion control algorithm, selected with Kconfig */
+struct tcp_cc_ops {
+	const char *name;
+	/* Initialize the private state when the connection is established */
+	void (*init)(struct tcp *conn);
+	/* Return the slow start threshold to use after a loss */
+	uint32_t (*ssthresh)(struct tcp *conn);
+	/* Grow the congestion window in congestion avoidance */
+	void (*cong_avoid)(struct tcp *conn, uint32_t acked);
+};
+
+struct tcp_ca {
+	uint32_t cwnd;
+	uint32_t ssthresh;
+	/* Private state of the algorithm */
+	uint32_t priv[6];
+};
+
+extern const struct tcp_cc_ops tcp_cc;
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
+
 struct tcp { /* TCP connection */
 	sys_snode_t next;
+	sys_snode_t hash_node; /* Entry in the connection lookup table */
+	sys_slist_t *hash_bucket;
+	/* Connections of a listener in the handshake or waiting to be
+	 * accepted by the application.
+	 */
+	sys_slist_t backlog;
+	sys_snode_t backlog_node;
+	struct tcp *listener; /* Listener holding this conn in its backlog */
 	struct net_context *context;
 	struct net_pkt *send_data;
-	struct net_pkt *queue_recv_data;
+	struct rbtree recv_queue; /* Out-of-order data ranges, sorted by seq */
+	struct tcp_ooo_range *recv_queue_last; /* Most recently updated range */
 	struct net_if *iface;
 	void *recv_user_data;
 	sys_slist_t send_queue;
@@ -263,23 +361,44 @@ struct tcp { /* TCP connection */
 	atomic_t ref_count;
 	enum tcp_state state;
 	enum tcp_data_mode data_mode;
+#if defined(CONFIG_NET_TCP_SACK)
+	/* Blocks SACKed by the peer, sorted and not overlapping */
+	struct tcp_sack_block sacked[NET_TCP_MAX_SACK_BLOCKS];
+	uint32_t high_rxt; /* Highest sequence retransmitted in recovery */
+	uint8_t sacked_count;
+#endif
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	struct tcp_ca ca;
+#endif
 	uint32_t seq;
 	uint32_t ack;
-	uint16_t recv_win_max;
-	uint16_t recv_win;
-	uint16_t send_win;
+	uint32_t recv_win_max;
+	uint32_t recv_win;
+	uint32_t send_win;
+	uint32_t ts_recent; /* Timestamp to echo to the peer */
+#ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
+	uint32_t recover; /* Highest sequence sent when recovery started */
+#endif
 #ifdef CONFIG_NET_TCP_RANDOMIZED_RTO
 	uint16_t rto;
 #endif
+	uint16_t backlog_max;
 	uint8_t send_data_retries;
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
 	uint8_t dup_ack_cnt;
+	bool in_recovery : 1;
 #endif
 	uint8_t zwp_retries;
+	uint8_t recv_queue_ranges;
+	uint8_t snd_wscale : 4; /* Shift of the windows sent by the peer */
+	uint8_t rcv_wscale : 4; /* Shift of the windows sent by us */
 	bool in_retransmission : 1;
 	bool in_connect : 1;
 	bool in_close : 1;
 	bool tcp_nodelay : 1;
+	bool wscale_ok : 1;
+	bool ts_ok : 1;
+	bool sack_ok : 1;
 };
 
 #define _flags(_fl, _op, _mask, _cond)					\
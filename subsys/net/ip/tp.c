@@ -6,6 +6,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <zephyr/random/rand32.h>
 #include "tp.h"
 #include "tp_priv.h"
 #include "ipv4.h"
@@ -18,8 +19,16 @@ static sys_slist_t tp_pkts = SYS_SLIST_STATIC_INIT(&tp_pkts);
 static sys_slist_t tp_seq = SYS_SLIST_STATIC_INIT(&tp_seq);
 
 bool tp_trace;
+int tp_loss; /* Percentage of the TCP segments dropped */
+int tp_delay; /* Delay of the TCP segments, in ms */
 enum tp_type tp_state = TP_NONE;
 
+struct tp_delayed_pkt {
+	struct k_work_delayable work;
+	struct net_pkt *pkt;
+	void (*send)(struct net_pkt *pkt);
+};
+
 char *tp_basename(char *path)
 {
 	char *filename = strrchr(path, '/');
@@ -598,6 +607,51 @@ void tp_out(sa_family_t af, struct net_if *iface, const char *msg,
 	}
 }
 
+static void tp_delayed_send(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct tp_delayed_pkt *delayed =
+		CONTAINER_OF(dwork, struct tp_delayed_pkt, work);
+
+	delayed->send(delayed->pkt);
+
+	k_free(delayed);
+}
+
+/* Emulate a lossy, long delay link as set with tp_loss and tp_delay.
+ * Returns true if the packet was dropped or will be sent later with send.
+ */
+bool tp_impair(struct net_pkt *pkt, void (*send)(struct net_pkt *pkt))
+{
+	struct tp_delayed_pkt *delayed;
+
+	if (tp_loss > 0 && (int)(sys_rand32_get() % 100U) < tp_loss) {
+		if (tp_trace) {
+			tp_dbg("drop %p", pkt);
+		}
+
+		tp_pkt_unref(pkt, tp_basename(__FILE__), __LINE__);
+		return true;
+	}
+
+	if (tp_delay <= 0) {
+		return false;
+	}
+
+	delayed = k_malloc(sizeof(*delayed));
+	if (!delayed) {
+		return false;
+	}
+
+	delayed->pkt = pkt;
+	delayed->send = send;
+
+	k_work_init_delayable(&delayed->work, tp_delayed_send);
+	k_work_schedule(&delayed->work, K_MSEC(tp_delay));
+
+	return true;
+}
+
 bool tp_tap_input(struct net_pkt *pkt)
 {
 	bool tap = tp_state != TP_NONE;
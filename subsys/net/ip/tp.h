@@ -46,6 +46,8 @@ enum tp_type { /* Test protocol message type */
 };
 
 extern bool tp_trace;
+extern int tp_loss;
+extern int tp_delay;
 extern enum tp_type tp_state;
 
 struct tp_msg {
@@ -161,6 +163,7 @@ void tp_out(sa_family_t af, struct net_if *iface, const char *msg,
 	    const char *key, const char *value);
 
 bool tp_tap_input(struct net_pkt *pkt);
+bool tp_impair(struct net_pkt *pkt, void (*send)(struct net_pkt *pkt));
 
 #else /* else of IS_ENABLED(CONFIG_NET_TEST_PROTOCOL) */
 
@@ -22,32 +22,56 @@ LOG_MODULE_REGISTER(net_arp, CONFIG_NET_ARP_LOG_LEVEL);
 
 #define NET_BUF_TIMEOUT K_MSEC(100)
 #define ARP_REQUEST_TIMEOUT (2 * MSEC_PER_SEC)
+#define ARP_HASH_SIZE CONFIG_NET_ARP_TABLE_SIZE
 
 static bool arp_cache_initialized;
 static struct arp_entry arp_entries[CONFIG_NET_ARP_TABLE_SIZE];
 
 static sys_slist_t arp_free_entries;
 static sys_slist_t arp_pending_entries;
+static sys_slist_t arp_failed_entries;
 static sys_slist_t arp_table;
 
+/* Resolved entries, hashed by interface and address. Only modified with
+ * arp_mutex held, but walked without any lock on the TX path.
+ */
+static atomic_ptr_t arp_hash[ARP_HASH_SIZE];
+
 static struct k_work_delayable arp_request_timer;
 
 static struct k_mutex arp_mutex;
 
+#if CONFIG_NET_ARP_ENTRY_LIFETIME > 0
+#define ARP_WHEEL_SLOTS 8
+#define ARP_LIFETIME (CONFIG_NET_ARP_ENTRY_LIFETIME * MSEC_PER_SEC)
+#define ARP_WHEEL_TICK (ARP_LIFETIME / ARP_WHEEL_SLOTS)
+
+/* Resolved entries, in the slot of the tick during which they expire */
+static sys_dlist_t arp_wheel[ARP_WHEEL_SLOTS];
+static struct k_work_delayable arp_wheel_timer;
+static int64_t arp_wheel_tick;
+static int arp_wheel_count;
+#endif
+
+static void arp_entry_release_pending(struct arp_entry *entry)
+{
+	struct net_pkt *pkt;
+
+	while (!k_fifo_is_empty(&entry->pending_queue)) {
+		pkt = k_fifo_get(&entry->pending_queue, K_FOREVER);
+		NET_DBG("Releasing pending pkt %p (ref %ld)",
+			pkt,
+			atomic_get(&pkt->atomic_ref) - 1);
+		net_pkt_unref(pkt);
+	}
+}
+
 static void arp_entry_cleanup(struct arp_entry *entry, bool pending)
 {
 	NET_DBG("%p", entry);
 
 	if (pending) {
-		struct net_pkt *pkt;
-
-		while (!k_fifo_is_empty(&entry->pending_queue)) {
-			pkt = k_fifo_get(&entry->pending_queue, K_FOREVER);
-			NET_DBG("Releasing pending pkt %p (ref %ld)",
-				pkt,
-				atomic_get(&pkt->atomic_ref) - 1);
-			net_pkt_unref(pkt);
-		}
+		arp_entry_release_pending(entry);
 	}
 
 	entry->iface = NULL;
@@ -56,6 +80,141 @@ static void arp_entry_cleanup(struct arp_entry *entry, bool pending)
 	(void)memset(&entry->eth, 0, sizeof(struct net_eth_addr));
 }
 
+static inline int arp_hash_index(struct net_if *iface, struct in_addr *dst)
+{
+	/* The address might come unaligned from an IPv4 header */
+	uint32_t key = UNALIGNED_GET(&dst->s_addr) ^ POINTER_TO_UINT(iface);
+
+	return (key * 2654435761U) % ARP_HASH_SIZE;
+}
+
+static void arp_hash_add(struct arp_entry *entry)
+{
+	atomic_ptr_t *bucket = &arp_hash[arp_hash_index(entry->iface,
+							&entry->ip)];
+
+	atomic_ptr_set(&entry->hash_next, atomic_ptr_get(bucket));
+	atomic_ptr_set(bucket, entry);
+
+	/* The entry is complete, let lookups match it */
+	atomic_inc(&entry->seq);
+}
+
+static void arp_hash_remove(struct arp_entry *entry)
+{
+	atomic_ptr_t *prev = &arp_hash[arp_hash_index(entry->iface,
+						      &entry->ip)];
+	struct arp_entry *node;
+
+	/* Lookups still walking through the entry reach the rest of the
+	 * bucket, but do not match the entry itself anymore.
+	 */
+	atomic_inc(&entry->seq);
+
+	while ((node = atomic_ptr_get(prev)) != NULL) {
+		if (node == entry) {
+			atomic_ptr_set(prev, atomic_ptr_get(&entry->hash_next));
+			break;
+		}
+
+		prev = &node->hash_next;
+	}
+}
+
+/* Lock-free lookup of a resolved entry. A concurrent update can make it
+ * miss an entry, the caller then retries with arp_mutex held.
+ */
+static struct arp_entry *arp_hash_find(struct net_if *iface,
+				       struct in_addr *dst)
+{
+	struct arp_entry *entry;
+	int steps = CONFIG_NET_ARP_TABLE_SIZE;
+
+	entry = atomic_ptr_get(&arp_hash[arp_hash_index(iface, dst)]);
+
+	/* An entry moved to another bucket meanwhile may lead the walk
+	 * there, bound it by the number of entries.
+	 */
+	while (entry && steps--) {
+		atomic_val_t seq = atomic_get(&entry->seq);
+
+		if (!(seq & 1) && entry->iface == iface &&
+		    UNALIGNED_GET(&dst->s_addr) == entry->ip.s_addr &&
+		    atomic_get(&entry->seq) == seq) {
+			return entry;
+		}
+
+		entry = atomic_ptr_get(&entry->hash_next);
+	}
+
+	return NULL;
+}
+
+#if CONFIG_NET_ARP_ENTRY_LIFETIME > 0
+static void arp_wheel_add(struct arp_entry *entry)
+{
+	int64_t now = k_uptime_get();
+	int slot = ((now + ARP_LIFETIME) / ARP_WHEEL_TICK) % ARP_WHEEL_SLOTS;
+
+	if (sys_dnode_is_linked(&entry->wheel_node)) {
+		sys_dlist_remove(&entry->wheel_node);
+	} else if (arp_wheel_count++ == 0) {
+		/* Nothing to catch up with, start from the current tick */
+		arp_wheel_tick = now / ARP_WHEEL_TICK;
+	}
+
+	entry->req_start = (uint32_t)now;
+	sys_dlist_append(&arp_wheel[slot], &entry->wheel_node);
+
+	if (!k_work_delayable_is_pending(&arp_wheel_timer)) {
+		k_work_reschedule(&arp_wheel_timer,
+				  K_MSEC((now / ARP_WHEEL_TICK + 1) *
+					 ARP_WHEEL_TICK - now));
+	}
+}
+
+static void arp_wheel_remove(struct arp_entry *entry)
+{
+	if (sys_dnode_is_linked(&entry->wheel_node)) {
+		sys_dlist_remove(&entry->wheel_node);
+		arp_wheel_count--;
+	}
+}
+#else
+static inline void arp_wheel_add(struct arp_entry *entry)
+{
+	entry->req_start = k_uptime_get_32();
+}
+
+#define arp_wheel_remove(...)
+#endif /* CONFIG_NET_ARP_ENTRY_LIFETIME > 0 */
+
+static void arp_table_add(struct arp_entry *entry)
+{
+	entry->used = k_uptime_get_32();
+
+	sys_slist_prepend(&arp_table, &entry->node);
+	arp_hash_add(entry);
+	arp_wheel_add(entry);
+}
+
+static void arp_table_remove(struct arp_entry *entry)
+{
+	sys_slist_find_and_remove(&arp_table, &entry->node);
+	arp_hash_remove(entry);
+	arp_wheel_remove(entry);
+}
+
+static void arp_table_set_eth(struct arp_entry *entry,
+			      struct net_eth_addr *hwaddr)
+{
+	atomic_inc(&entry->seq);
+	memcpy(&entry->eth, hwaddr, sizeof(struct net_eth_addr));
+	atomic_inc(&entry->seq);
+
+	arp_wheel_add(entry);
+}
+
 static struct arp_entry *arp_entry_find(sys_slist_t *list,
 					struct net_if *iface,
 					struct in_addr *dst,
@@ -80,30 +239,6 @@ static struct arp_entry *arp_entry_find(sys_slist_t *list,
 	return NULL;
 }
 
-static inline struct arp_entry *arp_entry_find_move_first(struct net_if *iface,
-							  struct in_addr *dst)
-{
-	sys_snode_t *prev = NULL;
-	struct arp_entry *entry;
-
-	NET_DBG("dst %s", net_sprint_ipv4_addr(dst));
-
-	entry = arp_entry_find(&arp_table, iface, dst, &prev);
-	if (entry) {
-		/* Let's assume the target is going to be accessed
-		 * more than once here in a short time frame. So we
-		 * place the entry first in position into the table
-		 * in order to reduce subsequent find.
-		 */
-		if (&entry->node != sys_slist_peek_head(&arp_table)) {
-			sys_slist_remove(&arp_table, prev, &entry->node);
-			sys_slist_prepend(&arp_table, &entry->node);
-		}
-	}
-
-	return entry;
-}
-
 static inline
 struct arp_entry *arp_entry_find_pending(struct net_if *iface,
 					 struct in_addr *dst)
@@ -134,37 +269,91 @@ static struct arp_entry *arp_entry_get_pending(struct net_if *iface,
 	return entry;
 }
 
+static void arp_failed_expire(void)
+{
+	uint32_t current = k_uptime_get_32();
+	struct arp_entry *entry, *next;
+
+	/* Failed entries are appended in order, so stop at the first
+	 * one still valid.
+	 */
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&arp_failed_entries,
+					  entry, next, node) {
+		if ((int32_t)(entry->req_start +
+			      CONFIG_NET_ARP_NEGATIVE_TIMEOUT - current) > 0) {
+			break;
+		}
+
+		arp_entry_cleanup(entry, false);
+
+		sys_slist_remove(&arp_failed_entries, NULL, &entry->node);
+		sys_slist_prepend(&arp_free_entries, &entry->node);
+	}
+}
+
+static bool arp_entry_is_failed(struct net_if *iface, struct in_addr *dst)
+{
+	if (sys_slist_is_empty(&arp_failed_entries)) {
+		return false;
+	}
+
+	arp_failed_expire();
+
+	return arp_entry_find(&arp_failed_entries, iface, dst, NULL) != NULL;
+}
+
+static void arp_entry_forget_failed(struct net_if *iface, struct in_addr *dst)
+{
+	sys_snode_t *prev = NULL;
+	struct arp_entry *entry;
+
+	entry = arp_entry_find(&arp_failed_entries, iface, dst, &prev);
+	if (entry) {
+		arp_entry_cleanup(entry, false);
+
+		sys_slist_remove(&arp_failed_entries, prev, &entry->node);
+		sys_slist_prepend(&arp_free_entries, &entry->node);
+	}
+}
+
 static struct arp_entry *arp_entry_get_free(void)
 {
 	sys_snode_t *node;
 
-	node = sys_slist_peek_head(&arp_free_entries);
+	node = sys_slist_get(&arp_free_entries);
 	if (!node) {
-		return NULL;
-	}
+		/* Then forget the oldest unresolved destination */
+		node = sys_slist_get(&arp_failed_entries);
+		if (!node) {
+			return NULL;
+		}
 
-	/* We remove the node from the free list */
-	sys_slist_remove(&arp_free_entries, NULL, node);
+		arp_entry_cleanup(CONTAINER_OF(node, struct arp_entry, node),
+				  false);
+	}
 
 	return CONTAINER_OF(node, struct arp_entry, node);
 }
 
 static struct arp_entry *arp_entry_get_last_from_table(void)
 {
-	sys_snode_t *node;
+	uint32_t current = k_uptime_get_32();
+	struct arp_entry *entry, *oldest = NULL;
 
-	/* We assume last entry is the oldest one,
-	 * so is the preferred one to be taken out.
+	/* The least recently used entry is the preferred one to be taken
+	 * out. Lookups do not reorder the table, as they do not lock it.
 	 */
-
-	node = sys_slist_peek_tail(&arp_table);
-	if (!node) {
-		return NULL;
+	SYS_SLIST_FOR_EACH_CONTAINER(&arp_table, entry, node) {
+		if (!oldest || current - entry->used > current - oldest->used) {
+			oldest = entry;
+		}
 	}
 
-	sys_slist_find_and_remove(&arp_table, node);
+	if (oldest) {
+		arp_table_remove(oldest);
+	}
 
-	return CONTAINER_OF(node, struct arp_entry, node);
+	return oldest;
 }
 
 
@@ -199,10 +388,17 @@ static void arp_request_timeout(struct k_work *work)
 			break;
 		}
 
-		arp_entry_cleanup(entry, true);
-
 		sys_slist_remove(&arp_pending_entries, NULL, &entry->node);
-		sys_slist_append(&arp_free_entries, &entry->node);
+
+		if (CONFIG_NET_ARP_NEGATIVE_TIMEOUT > 0) {
+			/* Remember the destination as unreachable */
+			arp_entry_release_pending(entry);
+			entry->req_start = current;
+			sys_slist_append(&arp_failed_entries, &entry->node);
+		} else {
+			arp_entry_cleanup(entry, true);
+			sys_slist_append(&arp_free_entries, &entry->node);
+		}
 
 		entry = NULL;
 	}
@@ -216,6 +412,54 @@ static void arp_request_timeout(struct k_work *work)
 	k_mutex_unlock(&arp_mutex);
 }
 
+#if CONFIG_NET_ARP_ENTRY_LIFETIME > 0
+static void arp_wheel_timeout(struct k_work *work)
+{
+	int64_t now = k_uptime_get();
+	int64_t tick = now / ARP_WHEEL_TICK;
+	struct arp_entry *entry, *next;
+	int slots = 0;
+
+	ARG_UNUSED(work);
+
+	k_mutex_lock(&arp_mutex, K_FOREVER);
+
+	/* Expire in one batch the entries of every tick elapsed since the
+	 * last run, each slot being visited at most once.
+	 */
+	while (arp_wheel_tick < tick && slots++ < ARP_WHEEL_SLOTS) {
+		sys_dlist_t *slot = &arp_wheel[arp_wheel_tick % ARP_WHEEL_SLOTS];
+
+		SYS_DLIST_FOR_EACH_CONTAINER_SAFE(slot, entry, next,
+						  wheel_node) {
+			/* Expires during a later turn of the wheel */
+			if ((int32_t)(entry->req_start + ARP_LIFETIME -
+				      (uint32_t)now) > 0) {
+				continue;
+			}
+
+			NET_DBG("Expiring %s",
+				net_sprint_ipv4_addr(&entry->ip));
+
+			arp_table_remove(entry);
+			arp_entry_cleanup(entry, false);
+			sys_slist_prepend(&arp_free_entries, &entry->node);
+		}
+
+		arp_wheel_tick++;
+	}
+
+	arp_wheel_tick = tick;
+
+	if (arp_wheel_count > 0) {
+		k_work_reschedule(&arp_wheel_timer,
+				  K_MSEC((tick + 1) * ARP_WHEEL_TICK - now));
+	}
+
+	k_mutex_unlock(&arp_mutex);
+}
+#endif /* CONFIG_NET_ARP_ENTRY_LIFETIME > 0 */
+
 static inline struct in_addr *if_get_addr(struct net_if *iface,
 					  struct in_addr *addr)
 {
@@ -374,17 +618,30 @@ struct net_pkt *net_arp_prepare(struct net_pkt *pkt,
 		addr = request_ip;
 	}
 
-	k_mutex_lock(&arp_mutex, K_FOREVER);
-
 	/* If the destination address is already known, we do not need
 	 * to send any ARP packet.
 	 */
-	entry = arp_entry_find_move_first(net_pkt_iface(pkt), addr);
+	entry = arp_hash_find(net_pkt_iface(pkt), addr);
+	if (entry) {
+		goto found;
+	}
+
+	k_mutex_lock(&arp_mutex, K_FOREVER);
+
+	entry = arp_hash_find(net_pkt_iface(pkt), addr);
 	if (!entry) {
 		struct net_pkt *req;
 
 		entry = arp_entry_find_pending(net_pkt_iface(pkt), addr);
 		if (!entry) {
+			if (!net_pkt_ipv4_auto(pkt) &&
+			    arp_entry_is_failed(net_pkt_iface(pkt), addr)) {
+				NET_DBG("DROP: %s is unreachable",
+					net_sprint_ipv4_addr(addr));
+				k_mutex_unlock(&arp_mutex);
+				return NULL;
+			}
+
 			/* No pending, let's try to get a new entry */
 			entry = arp_entry_get_free();
 			if (!entry) {
@@ -423,8 +680,11 @@ struct net_pkt *net_arp_prepare(struct net_pkt *pkt,
 
 	k_mutex_unlock(&arp_mutex);
 
+found:
+	entry->used = k_uptime_get_32();
+
 	net_pkt_lladdr_src(pkt)->addr =
-		(uint8_t *)net_if_get_link_addr(entry->iface)->addr;
+		(uint8_t *)net_if_get_link_addr(net_pkt_iface(pkt))->addr;
 	net_pkt_lladdr_src(pkt)->len = sizeof(struct net_eth_addr);
 
 	net_pkt_lladdr_dst(pkt)->addr = (uint8_t *)&entry->eth;
@@ -442,10 +702,9 @@ static void arp_gratuitous(struct net_if *iface,
 			   struct in_addr *src,
 			   struct net_eth_addr *hwaddr)
 {
-	sys_snode_t *prev = NULL;
 	struct arp_entry *entry;
 
-	entry = arp_entry_find(&arp_table, iface, src, &prev);
+	entry = arp_hash_find(iface, src);
 	if (entry) {
 		NET_DBG("Gratuitous ARP hwaddr %s -> %s",
 			net_sprint_ll_addr((const uint8_t *)&entry->eth,
@@ -453,7 +712,7 @@ static void arp_gratuitous(struct net_if *iface,
 			net_sprint_ll_addr((const uint8_t *)hwaddr,
 					   sizeof(struct net_eth_addr)));
 
-		memcpy(&entry->eth, hwaddr, sizeof(struct net_eth_addr));
+		arp_table_set_eth(entry, hwaddr);
 	}
 }
 
@@ -470,6 +729,9 @@ static void arp_update(struct net_if *iface,
 
 	k_mutex_lock(&arp_mutex, K_FOREVER);
 
+	/* The peer answers, it is not unreachable anymore */
+	arp_entry_forget_failed(iface, src);
+
 	entry = arp_entry_get_pending(iface, src);
 	if (!entry) {
 		if (IS_ENABLED(CONFIG_NET_ARP_GRATUITOUS) && gratuitous) {
@@ -477,13 +739,11 @@ static void arp_update(struct net_if *iface,
 		}
 
 		if (force) {
-			sys_snode_t *prev = NULL;
 			struct arp_entry *entry;
 
-			entry = arp_entry_find(&arp_table, iface, src, &prev);
+			entry = arp_hash_find(iface, src);
 			if (entry) {
-				memcpy(&entry->eth, hwaddr,
-				       sizeof(struct net_eth_addr));
+				arp_table_set_eth(entry, hwaddr);
 			} else {
 				/* Add new entry as it was not found and force
 				 * was set.
@@ -495,11 +755,10 @@ static void arp_update(struct net_if *iface,
 				}
 
 				if (entry) {
-					entry->req_start = k_uptime_get_32();
 					entry->iface = iface;
 					net_ipaddr_copy(&entry->ip, src);
 					memcpy(&entry->eth, hwaddr, sizeof(entry->eth));
-					sys_slist_prepend(&arp_table, &entry->node);
+					arp_table_add(entry);
 				}
 			}
 		}
@@ -511,7 +770,7 @@ static void arp_update(struct net_if *iface,
 	memcpy(&entry->eth, hwaddr, sizeof(struct net_eth_addr));
 
 	/* Inserting entry into the table */
-	sys_slist_prepend(&arp_table, &entry->node);
+	arp_table_add(entry);
 
 	while (!k_fifo_is_empty(&entry->pending_queue)) {
 		pkt = k_fifo_get(&entry->pending_queue, K_FOREVER);
@@ -721,6 +980,18 @@ void net_arp_clear_cache(struct net_if *iface)
 	k_mutex_lock(&arp_mutex, K_FOREVER);
 
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&arp_table, entry, next, node) {
+		if (iface && iface != entry->iface) {
+			continue;
+		}
+
+		arp_table_remove(entry);
+		arp_entry_cleanup(entry, false);
+
+		sys_slist_prepend(&arp_free_entries, &entry->node);
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&arp_failed_entries,
+					  entry, next, node) {
 		if (iface && iface != entry->iface) {
 			prev = &entry->node;
 			continue;
@@ -728,7 +999,7 @@ void net_arp_clear_cache(struct net_if *iface)
 
 		arp_entry_cleanup(entry, false);
 
-		sys_slist_remove(&arp_table, prev, &entry->node);
+		sys_slist_remove(&arp_failed_entries, prev, &entry->node);
 		sys_slist_prepend(&arp_free_entries, &entry->node);
 	}
 
@@ -796,16 +1067,26 @@ void net_arp_init(void)
 
 	sys_slist_init(&arp_free_entries);
 	sys_slist_init(&arp_pending_entries);
+	sys_slist_init(&arp_failed_entries);
 	sys_slist_init(&arp_table);
 
 	for (i = 0; i < CONFIG_NET_ARP_TABLE_SIZE; i++) {
 		/* Inserting entry as free with initialised packet queue */
 		k_fifo_init(&arp_entries[i].pending_queue);
+		atomic_set(&arp_entries[i].seq, 1);
 		sys_slist_prepend(&arp_free_entries, &arp_entries[i].node);
 	}
 
 	k_work_init_delayable(&arp_request_timer, arp_request_timeout);
 
+#if CONFIG_NET_ARP_ENTRY_LIFETIME > 0
+	for (i = 0; i < ARP_WHEEL_SLOTS; i++) {
+		sys_dlist_init(&arp_wheel[i]);
+	}
+
+	k_work_init_delayable(&arp_wheel_timer, arp_wheel_timeout);
+#endif
+
 	k_mutex_init(&arp_mutex);
 
 	arp_cache_initialized = true;
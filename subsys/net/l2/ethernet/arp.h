@@ -10,6 +10,8 @@
 #if defined(CONFIG_NET_ARP) && defined(CONFIG_NET_NATIVE)
 
 #include <zephyr/sys/slist.h>
+#include <zephyr/sys/dlist.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/net/ethernet.h>
 
 #ifdef __cplusplus
@@ -59,6 +61,15 @@ struct arp_entry {
 	struct in_addr ip;
 	struct net_eth_addr eth;
 	struct k_fifo pending_queue;
+	/* Next resolved entry in the same hash bucket */
+	atomic_ptr_t hash_next;
+	/* Odd while the entry is not in the hash table or being modified */
+	atomic_t seq;
+	/* Last time a packet was sent using this entry */
+	uint32_t used;
+#if CONFIG_NET_ARP_ENTRY_LIFETIME > 0
+	sys_dnode_t wheel_node;
+#endif
 };
 
 typedef void (*net_arp_cb_t)(struct arp_entry *entry,
@@ -205,7 +205,7 @@ enum net_verdict net_eth_bridge_input(struct ethernet_context *ctx,
 			continue;
 		}
 
-		out_pkt = net_pkt_shallow_clone(pkt, K_NO_WAIT);
+		out_pkt = net_pkt_shared_clone(pkt, K_NO_WAIT);
 		if (out_pkt == NULL) {
 			continue;
 		}
@@ -228,7 +228,7 @@ enum net_verdict net_eth_bridge_input(struct ethernet_context *ctx,
 
 		l = CONTAINER_OF(node, struct eth_bridge_listener, node);
 
-		out_pkt = net_pkt_shallow_clone(pkt, K_NO_WAIT);
+		out_pkt = net_pkt_shared_clone(pkt, K_NO_WAIT);
 		if (out_pkt == NULL) {
 			continue;
 		}
@@ -512,6 +512,10 @@ void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt)
 		return;
 	}
 
+#if defined(CONFIG_NET_CAPTURE_PCAPNG)
+	net_capture_pcapng_pkt(iface, pkt);
+#endif
+
 	k_mutex_lock(&lock, K_FOREVER);
 
 	SYS_SLIST_FOR_EACH_NODE_SAFE(&net_capture_devlist, sn, sns) {
@@ -524,9 +528,16 @@ void net_capture_pkt(struct net_if *iface, struct net_pkt *pkt)
 			continue;
 		}
 
+		if (!net_pkt_filter_capture_ok(pkt)) {
+			goto out;
+		}
+
 		orig_slab = pkt->slab;
 		pkt->slab = get_net_pkt();
 
+		/* The copy waits in the tunnel queue while the stack keeps
+		 * modifying the original, so the data cannot be shared.
+		 */
 		captured = net_pkt_clone(pkt, K_NO_WAIT);
 
 		pkt->slab = orig_slab;
@@ -0,0 +1,467 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Local packet capture. Packets are written as pcap-ng blocks into a ring
+ * buffer, copied straight from their network buffers, and the application
+ * drains the ring. Blocks are written in host byte order, which pcap-ng
+ * readers detect from the section header.
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_pcapng, CONFIG_NET_CAPTURE_PCAPNG_LOG_LEVEL);
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/ring_buffer.h>
+#include <zephyr/net/net_core.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_l2.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/capture.h>
+
+#if defined(CONFIG_FILE_SYSTEM)
+#include <zephyr/fs/fs.h>
+#endif
+
+#define PCAPNG_SHB_TYPE 0x0A0D0D0A
+#define PCAPNG_IDB_TYPE 0x00000001
+#define PCAPNG_ISB_TYPE 0x00000005
+#define PCAPNG_EPB_TYPE 0x00000006
+
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D
+
+#define PCAPNG_OPT_ENDOFOPT 0
+#define PCAPNG_OPT_ISB_OSDROP 7
+#define PCAPNG_OPT_ISB_USRDELIV 8
+
+#define LINKTYPE_ETHERNET 1
+#define LINKTYPE_RAW 101
+#define LINKTYPE_IEEE802_15_4_NOFCS 230
+
+struct pcapng_shb {
+	uint32_t type;
+	uint32_t len;
+	uint32_t magic;
+	uint16_t major;
+	uint16_t minor;
+	int64_t section_len;
+	uint32_t len_trailer;
+} __packed;
+
+struct pcapng_idb {
+	uint32_t type;
+	uint32_t len;
+	uint16_t link_type;
+	uint16_t reserved;
+	uint32_t snaplen;
+	uint32_t len_trailer;
+} __packed;
+
+struct pcapng_opt_u64 {
+	uint16_t code;
+	uint16_t len;
+	uint64_t value;
+} __packed;
+
+struct pcapng_isb {
+	uint32_t type;
+	uint32_t len;
+	uint32_t if_id;
+	uint32_t ts_high;
+	uint32_t ts_low;
+	struct pcapng_opt_u64 osdrop;
+	struct pcapng_opt_u64 usrdeliv;
+	uint32_t endofopt;
+	uint32_t len_trailer;
+} __packed;
+
+/* Enhanced packet block, up to the packet data */
+struct pcapng_epb {
+	uint32_t type;
+	uint32_t len;
+	uint32_t if_id;
+	uint32_t ts_high;
+	uint32_t ts_low;
+	uint32_t cap_len;
+	uint32_t orig_len;
+} __packed;
+
+struct pcapng_iface {
+	struct net_if *iface;
+	uint32_t if_id;
+	uint32_t snaplen;
+	uint16_t link_type;
+	struct net_capture_pcapng_stats stats;
+};
+
+static struct pcapng_iface ifaces[CONFIG_NET_CAPTURE_PCAPNG_IFACE_COUNT];
+static uint32_t next_if_id;
+static uint32_t snaplen = CONFIG_NET_CAPTURE_PCAPNG_SNAPLEN;
+static bool section_started;
+
+RING_BUF_DECLARE(pcapng_ring, CONFIG_NET_CAPTURE_PCAPNG_RING_SIZE);
+
+/* Protects the state above. Packets are captured from any network thread,
+ * so writers hold it while a block is put in the ring. It is only held for
+ * the copy of at most one snaplen worth of data.
+ */
+static struct k_spinlock lock;
+
+static uint16_t link_type_get(struct net_if *iface)
+{
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET)) {
+		return LINKTYPE_ETHERNET;
+	}
+#endif
+#if defined(CONFIG_NET_L2_IEEE802154)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(IEEE802154)) {
+		return LINKTYPE_IEEE802_15_4_NOFCS;
+	}
+#endif
+
+	/* Other link layers hand IP packets to the capture */
+	return LINKTYPE_RAW;
+}
+
+static uint64_t timestamp_us(void)
+{
+	return k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+static bool ring_put(const void *data, uint32_t len)
+{
+	return ring_buf_put(&pcapng_ring, data, len) == len;
+}
+
+static bool write_shb(void)
+{
+	struct pcapng_shb shb = {
+		.type = PCAPNG_SHB_TYPE,
+		.len = sizeof(shb),
+		.magic = PCAPNG_BYTE_ORDER_MAGIC,
+		.major = 1,
+		.minor = 0,
+		.section_len = -1,
+		.len_trailer = sizeof(shb),
+	};
+
+	if (ring_buf_space_get(&pcapng_ring) < sizeof(shb)) {
+		return false;
+	}
+
+	section_started = ring_put(&shb, sizeof(shb));
+
+	return section_started;
+}
+
+static bool write_idb(struct pcapng_iface *cap)
+{
+	struct pcapng_idb idb = {
+		.type = PCAPNG_IDB_TYPE,
+		.len = sizeof(idb),
+		.link_type = cap->link_type,
+		.snaplen = cap->snaplen,
+		.len_trailer = sizeof(idb),
+	};
+
+	if (ring_buf_space_get(&pcapng_ring) < sizeof(idb)) {
+		return false;
+	}
+
+	cap->if_id = next_if_id++;
+
+	return ring_put(&idb, sizeof(idb));
+}
+
+static void write_isb(struct pcapng_iface *cap)
+{
+	uint64_t ts = timestamp_us();
+	struct pcapng_isb isb = {
+		.type = PCAPNG_ISB_TYPE,
+		.len = sizeof(isb),
+		.if_id = cap->if_id,
+		.ts_high = ts >> 32,
+		.ts_low = (uint32_t)ts,
+		.osdrop = {
+			.code = PCAPNG_OPT_ISB_OSDROP,
+			.len = sizeof(uint64_t),
+			.value = cap->stats.dropped,
+		},
+		.usrdeliv = {
+			.code = PCAPNG_OPT_ISB_USRDELIV,
+			.len = sizeof(uint64_t),
+			.value = cap->stats.captured,
+		},
+		.endofopt = PCAPNG_OPT_ENDOFOPT,
+		.len_trailer = sizeof(isb),
+	};
+
+	if (ring_buf_space_get(&pcapng_ring) < sizeof(isb)) {
+		NET_DBG("No room for statistics of iface %d",
+			net_if_get_by_iface(cap->iface));
+		return;
+	}
+
+	(void)ring_put(&isb, sizeof(isb));
+}
+
+static struct pcapng_iface *iface_find(struct net_if *iface)
+{
+	for (int i = 0; i < ARRAY_SIZE(ifaces); i++) {
+		if (ifaces[i].iface == iface) {
+			return &ifaces[i];
+		}
+	}
+
+	return NULL;
+}
+
+void net_capture_pcapng_pkt(struct net_if *iface, struct net_pkt *pkt)
+{
+	static const uint8_t padding[sizeof(uint32_t)];
+	struct pcapng_epb epb;
+	struct pcapng_iface *cap;
+	k_spinlock_key_t key;
+	struct net_buf *frag;
+	uint32_t pad_len;
+	uint32_t left;
+	uint64_t ts;
+
+	key = k_spin_lock(&lock);
+
+	cap = iface_find(iface);
+	if (cap == NULL) {
+		goto out;
+	}
+
+	ts = timestamp_us();
+
+	epb.type = PCAPNG_EPB_TYPE;
+	epb.if_id = cap->if_id;
+	epb.ts_high = ts >> 32;
+	epb.ts_low = (uint32_t)ts;
+	epb.orig_len = net_pkt_get_len(pkt);
+	epb.cap_len = MIN(epb.orig_len, cap->snaplen);
+
+	pad_len = ROUND_UP(epb.cap_len, sizeof(uint32_t)) - epb.cap_len;
+	epb.len = sizeof(epb) + epb.cap_len + pad_len + sizeof(uint32_t);
+
+	if (ring_buf_space_get(&pcapng_ring) < epb.len) {
+		cap->stats.dropped++;
+		goto out;
+	}
+
+	(void)ring_put(&epb, sizeof(epb));
+
+	/* Copy the packet straight from its fragments, without touching the
+	 * packet cursor.
+	 */
+	left = epb.cap_len;
+	for (frag = pkt->buffer; frag && left > 0; frag = frag->frags) {
+		uint32_t len = MIN(frag->len, left);
+
+		(void)ring_put(frag->data, len);
+		left -= len;
+	}
+
+	(void)ring_put(padding, pad_len);
+	(void)ring_put(&epb.len, sizeof(epb.len));
+
+	cap->stats.captured++;
+
+out:
+	k_spin_unlock(&lock, key);
+}
+
+int net_capture_pcapng_enable(struct net_if *iface)
+{
+	struct pcapng_iface *cap;
+	k_spinlock_key_t key;
+	int ret = 0;
+
+	key = k_spin_lock(&lock);
+
+	if (iface_find(iface) != NULL) {
+		ret = -EALREADY;
+		goto out;
+	}
+
+	cap = iface_find(NULL);
+	if (cap == NULL) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	cap->link_type = link_type_get(iface);
+	cap->snaplen = snaplen;
+	cap->stats.captured = 0U;
+	cap->stats.dropped = 0U;
+
+	if ((!section_started && !write_shb()) || !write_idb(cap)) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	cap->iface = iface;
+
+	NET_DBG("Capturing iface %d as pcap-ng interface %u",
+		net_if_get_by_iface(iface), cap->if_id);
+
+out:
+	k_spin_unlock(&lock, key);
+
+	return ret;
+}
+
+int net_capture_pcapng_disable(struct net_if *iface)
+{
+	struct pcapng_iface *cap;
+	k_spinlock_key_t key;
+	int ret = 0;
+
+	key = k_spin_lock(&lock);
+
+	cap = iface_find(iface);
+	if (cap == NULL) {
+		ret = -ENOENT;
+		goto out;
+	}
+
+	write_isb(cap);
+	cap->iface = NULL;
+
+out:
+	k_spin_unlock(&lock, key);
+
+	return ret;
+}
+
+void net_capture_pcapng_set_snaplen(uint32_t len)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	snaplen = len;
+
+	k_spin_unlock(&lock, key);
+}
+
+int net_capture_pcapng_get_stats(struct net_if *iface,
+				 struct net_capture_pcapng_stats *stats)
+{
+	struct pcapng_iface *cap;
+	k_spinlock_key_t key;
+	int ret = 0;
+
+	key = k_spin_lock(&lock);
+
+	cap = iface_find(iface);
+	if (cap == NULL) {
+		ret = -ENOENT;
+	} else {
+		*stats = cap->stats;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return ret;
+}
+
+uint32_t net_capture_pcapng_get_claim(uint8_t **data, uint32_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	uint32_t len = ring_buf_get_claim(&pcapng_ring, data, size);
+
+	k_spin_unlock(&lock, key);
+
+	return len;
+}
+
+int net_capture_pcapng_get_finish(uint32_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	int ret = ring_buf_get_finish(&pcapng_ring, size);
+
+	k_spin_unlock(&lock, key);
+
+	return ret;
+}
+
+size_t net_capture_pcapng_read(uint8_t *data, size_t len)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	uint32_t ret = ring_buf_get(&pcapng_ring, data, len);
+
+	k_spin_unlock(&lock, key);
+
+	return ret;
+}
+
+void net_capture_pcapng_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	ring_buf_reset(&pcapng_ring);
+	section_started = false;
+	next_if_id = 0U;
+
+	if (!write_shb()) {
+		goto out;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(ifaces); i++) {
+		if (ifaces[i].iface != NULL) {
+			(void)write_idb(&ifaces[i]);
+		}
+	}
+
+out:
+	k_spin_unlock(&lock, key);
+}
+
+#if defined(CONFIG_FILE_SYSTEM)
+int net_capture_pcapng_write_file(const char *path)
+{
+	struct fs_file_t file;
+	uint8_t *data;
+	uint32_t len;
+	int total = 0;
+	int ret;
+
+	fs_file_t_init(&file);
+
+	ret = fs_open(&file, path, FS_O_CREATE | FS_O_WRITE | FS_O_APPEND);
+	if (ret < 0) {
+		NET_DBG("Cannot open %s (%d)", path, ret);
+		return ret;
+	}
+
+	while ((len = net_capture_pcapng_get_claim(&data, UINT32_MAX)) > 0) {
+		ssize_t written = fs_write(&file, data, len);
+
+		if (written < 0) {
+			(void)net_capture_pcapng_get_finish(0);
+			ret = written;
+			goto out;
+		}
+
+		(void)net_capture_pcapng_get_finish(written);
+		total += written;
+
+		if (written < len) {
+			ret = -ENOSPC;
+			goto out;
+		}
+	}
+
+	ret = total;
+
+out:
+	(void)fs_close(&file);
+
+	return ret;
+}
+#endif /* CONFIG_FILE_SYSTEM */
@@ -0,0 +1,379 @@
+/** @file
+ * @brief HTTP server listeners and worker threads
+ */
+
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <errno.h>
+
+#ifdef CONFIG_ARCH_POSIX
+#include <fcntl.h>
+#else
+#include <zephyr/posix/fcntl.h>
+#endif
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/status.h>
+
+#include "http_server_internal.h"
+
+#define CLIENTS_PER_WORKER \
+	ceiling_fraction(CONFIG_HTTP_SERVER_MAX_CLIENTS, CONFIG_HTTP_SERVER_NUM_WORKERS)
+
+/* How often an idle worker checks for inactive clients and stop requests */
+#define WORKER_POLL_TIMEOUT_MS 100
+
+struct http_worker {
+	struct k_thread thread;
+	struct http_client_ctx clients[CLIENTS_PER_WORKER];
+	struct zsock_pollfd fds[CONFIG_HTTP_SERVER_MAX_SERVICES +
+				CLIENTS_PER_WORKER];
+	uint8_t tx_buf[CONFIG_HTTP_SERVER_TX_BUFFER_SIZE];
+};
+
+static K_THREAD_STACK_ARRAY_DEFINE(worker_stacks,
+				   CONFIG_HTTP_SERVER_NUM_WORKERS,
+				   CONFIG_HTTP_SERVER_STACK_SIZE);
+static struct http_worker workers[CONFIG_HTTP_SERVER_NUM_WORKERS];
+
+static const struct http_service_desc *services[CONFIG_HTTP_SERVER_MAX_SERVICES];
+static int listen_fds[CONFIG_HTTP_SERVER_MAX_SERVICES];
+static atomic_t service_clients[CONFIG_HTTP_SERVER_MAX_SERVICES];
+static int num_services;
+
+static K_MUTEX_DEFINE(server_lock);
+static bool running;
+static atomic_t stopping;
+
+static int set_nonblocking(int fd)
+{
+	int flags;
+
+	flags = zsock_fcntl(fd, F_GETFL, 0);
+	if (flags < 0) {
+		return -errno;
+	}
+
+	if (zsock_fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+		return -errno;
+	}
+
+	return 0;
+}
+
+static int setup_listener(const struct http_service_desc *service)
+{
+	struct sockaddr_storage addr_storage = { 0 };
+	struct sockaddr *addr = (struct sockaddr *)&addr_storage;
+	socklen_t addrlen;
+	int optval = 1;
+	int fd, ret;
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && service->host != NULL &&
+	    zsock_inet_pton(AF_INET, service->host,
+			    &net_sin(addr)->sin_addr) == 1) {
+		addr->sa_family = AF_INET;
+		net_sin(addr)->sin_port = htons(*service->port);
+		addrlen = sizeof(struct sockaddr_in);
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) && service->host != NULL &&
+		   zsock_inet_pton(AF_INET6, service->host,
+				   &net_sin6(addr)->sin6_addr) == 1) {
+		addr->sa_family = AF_INET6;
+		net_sin6(addr)->sin6_port = htons(*service->port);
+		addrlen = sizeof(struct sockaddr_in6);
+	} else if (IS_ENABLED(CONFIG_NET_IPV4)) {
+		/* A host name, or no host, is served on all addresses */
+		addr->sa_family = AF_INET;
+		net_sin(addr)->sin_port = htons(*service->port);
+		addrlen = sizeof(struct sockaddr_in);
+	} else {
+		addr->sa_family = AF_INET6;
+		net_sin6(addr)->sin6_port = htons(*service->port);
+		addrlen = sizeof(struct sockaddr_in6);
+	}
+
+	fd = zsock_socket(addr->sa_family, SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0) {
+		LOG_ERR("socket() failed (%d)", errno);
+		return -errno;
+	}
+
+	(void)zsock_setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &optval,
+			       sizeof(optval));
+
+	if (zsock_bind(fd, addr, addrlen) < 0) {
+		ret = -errno;
+		LOG_ERR("Cannot bind port %u (%d)", *service->port, ret);
+		goto error;
+	}
+
+	if (zsock_listen(fd, service->backlog) < 0) {
+		ret = -errno;
+		LOG_ERR("listen() failed (%d)", ret);
+		goto error;
+	}
+
+	/* The ephemeral port is only known once the socket listens */
+	if (*service->port == 0) {
+		addrlen = sizeof(addr_storage);
+
+		if (zsock_getsockname(fd, addr, &addrlen) < 0) {
+			ret = -errno;
+			goto error;
+		}
+
+		if (IS_ENABLED(CONFIG_NET_IPV6) && addr->sa_family == AF_INET6) {
+			*service->port = ntohs(net_sin6(addr)->sin6_port);
+		} else {
+			*service->port = ntohs(net_sin(addr)->sin_port);
+		}
+	}
+
+	/* Every worker with a free slot polls the listeners, the ones that
+	 * lose the race for a connection must not block in accept().
+	 */
+	ret = set_nonblocking(fd);
+	if (ret < 0) {
+		goto error;
+	}
+
+	LOG_DBG("Serving port %u", *service->port);
+
+	return fd;
+
+error:
+	zsock_close(fd);
+
+	return ret;
+}
+
+static void close_client(struct http_client_ctx *client)
+{
+	LOG_DBG("Closing client %d", client->fd);
+
+	zsock_close(client->fd);
+	client->fd = -1;
+
+	atomic_dec(&service_clients[client->service_idx]);
+}
+
+static void accept_client(struct http_worker *worker, int idx)
+{
+	struct http_client_ctx *client = NULL;
+	int fd;
+
+	fd = zsock_accept(listen_fds[idx], NULL, NULL);
+	if (fd < 0) {
+		/* Taken by another worker */
+		return;
+	}
+
+	if (atomic_inc(&service_clients[idx]) >=
+	    services[idx]->concurrent) {
+		atomic_dec(&service_clients[idx]);
+		http1_send_error(fd, HTTP_503_SERVICE_UNAVAILABLE);
+		zsock_close(fd);
+		return;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(worker->clients); i++) {
+		if (worker->clients[i].fd < 0) {
+			client = &worker->clients[i];
+			break;
+		}
+	}
+
+	/* The listeners are only polled when a slot is free */
+	__ASSERT_NO_MSG(client != NULL);
+
+	client->fd = fd;
+	client->service_idx = idx;
+	client->service = services[idx];
+	client->last_activity = k_uptime_get();
+
+	http1_client_init(client);
+
+	LOG_DBG("Client %d connected on port %u", fd, *services[idx]->port);
+}
+
+static void worker_thread(void *p1, void *p2, void *p3)
+{
+	struct http_worker *worker = p1;
+	struct http_client_ctx *polled[ARRAY_SIZE(worker->fds)];
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < ARRAY_SIZE(worker->clients); i++) {
+		worker->clients[i].fd = -1;
+	}
+
+	while (!atomic_get(&stopping)) {
+		int64_t now = k_uptime_get();
+		bool has_free_slot = false;
+		int nfds = 0;
+		int ret;
+
+		for (int i = 0; i < ARRAY_SIZE(worker->clients); i++) {
+			struct http_client_ctx *client = &worker->clients[i];
+
+			if (client->fd < 0) {
+				has_free_slot = true;
+				continue;
+			}
+
+			if (now - client->last_activity >
+			    CONFIG_HTTP_SERVER_CLIENT_INACTIVITY_TIMEOUT) {
+				close_client(client);
+				has_free_slot = true;
+				continue;
+			}
+
+			worker->fds[nfds].fd = client->fd;
+			worker->fds[nfds].events = ZSOCK_POLLIN;
+			polled[nfds] = client;
+			nfds++;
+		}
+
+		for (int i = 0; has_free_slot && i < num_services; i++) {
+			worker->fds[nfds].fd = listen_fds[i];
+			worker->fds[nfds].events = ZSOCK_POLLIN;
+			polled[nfds] = NULL;
+			nfds++;
+		}
+
+		ret = zsock_poll(worker->fds, nfds, WORKER_POLL_TIMEOUT_MS);
+		if (ret < 0) {
+			LOG_ERR("poll() failed (%d)", errno);
+			k_msleep(WORKER_POLL_TIMEOUT_MS);
+			continue;
+		}
+
+		for (int i = 0; ret > 0 && i < nfds; i++) {
+			struct http_client_ctx *client = polled[i];
+
+			if (worker->fds[i].revents == 0) {
+				continue;
+			}
+
+			if (client == NULL) {
+				accept_client(worker,
+					      i - (nfds - num_services));
+				/* One client per round, the slot may have
+				 * been the last one.
+				 */
+				break;
+			}
+
+			client->last_activity = k_uptime_get();
+
+			if (http1_client_process(client, worker->tx_buf,
+						 sizeof(worker->tx_buf)) < 0) {
+				close_client(client);
+			}
+		}
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(worker->clients); i++) {
+		if (worker->clients[i].fd >= 0) {
+			close_client(&worker->clients[i]);
+		}
+	}
+}
+
+static void close_listeners(void)
+{
+	for (int i = 0; i < num_services; i++) {
+		zsock_close(listen_fds[i]);
+	}
+
+	num_services = 0;
+}
+
+int http_server_start(void)
+{
+	int ret = 0;
+
+	k_mutex_lock(&server_lock, K_FOREVER);
+
+	if (running) {
+		ret = -EALREADY;
+		goto out;
+	}
+
+	HTTP_SERVICE_FOREACH(service) {
+		if (num_services == ARRAY_SIZE(listen_fds)) {
+			LOG_ERR("Too many services, increase %s",
+				"CONFIG_HTTP_SERVER_MAX_SERVICES");
+			ret = -ENOMEM;
+			break;
+		}
+
+		ret = setup_listener(service);
+		if (ret < 0) {
+			break;
+		}
+
+		services[num_services] = service;
+		listen_fds[num_services] = ret;
+		atomic_set(&service_clients[num_services], 0);
+		num_services++;
+		ret = 0;
+	}
+
+	if (ret < 0) {
+		close_listeners();
+		goto out;
+	}
+
+	atomic_set(&stopping, 0);
+
+	for (int i = 0; i < ARRAY_SIZE(workers); i++) {
+		k_thread_create(&workers[i].thread, worker_stacks[i],
+				K_THREAD_STACK_SIZEOF(worker_stacks[i]),
+				worker_thread, &workers[i], NULL, NULL,
+				K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+		k_thread_name_set(&workers[i].thread, "http_server");
+	}
+
+	running = true;
+
+out:
+	k_mutex_unlock(&server_lock);
+
+	return ret;
+}
+
+int http_server_stop(void)
+{
+	int ret = 0;
+
+	k_mutex_lock(&server_lock, K_FOREVER);
+
+	if (!running) {
+		ret = -EALREADY;
+		goto out;
+	}
+
+	atomic_set(&stopping, 1);
+
+	for (int i = 0; i < ARRAY_SIZE(workers); i++) {
+		k_thread_join(&workers[i].thread, K_FOREVER);
+	}
+
+	close_listeners();
+	running = false;
+
+out:
+	k_mutex_unlock(&server_lock);
+
+	return ret;
+}
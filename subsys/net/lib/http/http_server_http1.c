@@ -0,0 +1,580 @@
+/** @file
+ * @brief HTTP/1.1 request handling of the HTTP server
+ */
+
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/status.h>
+
+#if defined(CONFIG_FILE_SYSTEM)
+#include <zephyr/fs/fs.h>
+#endif
+
+#include "http_server_internal.h"
+
+/* "%x\r\n" of a chunk size */
+#define CHUNK_HEADER_LEN (sizeof(size_t) * 2 + 2)
+#define CRLF "\r\n"
+#define LAST_CHUNK "0\r\n\r\n"
+
+static const char *status_text(uint16_t status)
+{
+	switch (status) {
+	case HTTP_200_OK:
+		return "OK";
+	case HTTP_400_BAD_REQUEST:
+		return "Bad Request";
+	case HTTP_404_NOT_FOUND:
+		return "Not Found";
+	case HTTP_405_METHOD_NOT_ALLOWED:
+		return "Method Not Allowed";
+	case HTTP_413_PAYLOAD_TOO_LARGE:
+		return "Payload Too Large";
+	case HTTP_414_URI_TOO_LONG:
+		return "URI Too Long";
+	case HTTP_503_SERVICE_UNAVAILABLE:
+		return "Service Unavailable";
+	default:
+		return "Internal Server Error";
+	}
+}
+
+static int sendv_all(int fd, struct iovec *iov, size_t iovcnt, int flags)
+{
+	struct msghdr msg = {
+		.msg_iov = iov,
+		.msg_iovlen = iovcnt,
+	};
+
+	while (msg.msg_iovlen > 0) {
+		ssize_t sent;
+
+		if (msg.msg_iov->iov_len == 0) {
+			msg.msg_iov++;
+			msg.msg_iovlen--;
+			continue;
+		}
+
+		sent = zsock_sendmsg(fd, &msg, flags);
+		if (sent < 0) {
+			return -errno;
+		}
+
+		/* Skip what was sent, which may end in the middle of a
+		 * vector.
+		 */
+		while (sent > 0) {
+			if (sent < msg.msg_iov->iov_len) {
+				msg.msg_iov->iov_base =
+					(uint8_t *)msg.msg_iov->iov_base + sent;
+				msg.msg_iov->iov_len -= sent;
+				break;
+			}
+
+			sent -= msg.msg_iov->iov_len;
+			msg.msg_iov++;
+			msg.msg_iovlen--;
+		}
+	}
+
+	return 0;
+}
+
+static int send_all(int fd, const void *data, size_t len)
+{
+	struct iovec iov = {
+		.iov_base = (void *)data,
+		.iov_len = len,
+	};
+
+	return sendv_all(fd, &iov, 1, 0);
+}
+
+/* Formats the status line and headers to buf. A negative content_len
+ * announces a chunked body, unless the connection is closed after the
+ * response, in which case the end of the body is the end of the data.
+ */
+static int format_headers(uint8_t *buf, size_t len, uint16_t status,
+			  const struct http_resource_detail *detail,
+			  ssize_t content_len, bool keep_alive)
+{
+	int pos;
+
+	pos = snprintk(buf, len, "HTTP/1.1 %u %s" CRLF, status,
+		       status_text(status));
+
+	if (detail && detail->content_type && pos < len) {
+		pos += snprintk(buf + pos, len - pos, "Content-Type: %s" CRLF,
+				detail->content_type);
+	}
+
+	if (detail && detail->content_encoding && pos < len) {
+		pos += snprintk(buf + pos, len - pos,
+				"Content-Encoding: %s" CRLF,
+				detail->content_encoding);
+	}
+
+	if (content_len >= 0 && pos < len) {
+		pos += snprintk(buf + pos, len - pos,
+				"Content-Length: %zd" CRLF, content_len);
+	} else if (keep_alive && pos < len) {
+		pos += snprintk(buf + pos, len - pos,
+				"Transfer-Encoding: chunked" CRLF);
+	}
+
+	if (!keep_alive && pos < len) {
+		pos += snprintk(buf + pos, len - pos, "Connection: close" CRLF);
+	}
+
+	if (pos < len) {
+		pos += snprintk(buf + pos, len - pos, CRLF);
+	}
+
+	if (pos >= len) {
+		LOG_ERR("Headers do not fit in %zu bytes", len);
+		return -ENOBUFS;
+	}
+
+	return pos;
+}
+
+static int send_status(int fd, uint8_t *buf, size_t len, uint16_t status,
+		       bool keep_alive)
+{
+	int ret;
+
+	ret = format_headers(buf, len, status, NULL, 0, keep_alive);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return send_all(fd, buf, ret);
+}
+
+void http1_send_error(int fd, uint16_t status)
+{
+	uint8_t buf[80];
+
+	(void)send_status(fd, buf, sizeof(buf), status, false);
+}
+
+static int serve_static(struct http_client_ctx *client,
+			const struct http_resource_detail_static *detail,
+			uint8_t *tx_buf, size_t tx_len, bool keep_alive)
+{
+	struct iovec iov[2];
+	int ret;
+
+	ret = format_headers(tx_buf, tx_len, HTTP_200_OK, &detail->common,
+			     detail->static_data_len, keep_alive);
+	if (ret < 0) {
+		return ret;
+	}
+
+	iov[0].iov_base = tx_buf;
+	iov[0].iov_len = ret;
+	iov[1].iov_base = (void *)detail->static_data;
+	iov[1].iov_len = client->parser.method == HTTP_HEAD ?
+			 0 : detail->static_data_len;
+
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+	/* The data outlives any connection, so the stack references it
+	 * where it is stored, usually flash. Only the headers, formatted in
+	 * the reused transmit buffer, are copied.
+	 */
+	ret = sendv_all(client->fd, &iov[0], 1, 0);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return sendv_all(client->fd, &iov[1], 1, ZSOCK_MSG_ZEROCOPY);
+#else
+	/* Headers and data go to the stack in a single send, without an
+	 * intermediate copy of the data.
+	 */
+	return sendv_all(client->fd, iov, ARRAY_SIZE(iov), 0);
+#endif
+}
+
+static int serve_dynamic(struct http_client_ctx *client,
+			 const struct http_resource_detail_dynamic *detail,
+			 uint8_t *tx_buf, size_t tx_len, bool keep_alive)
+{
+	struct http_server_request req = {
+		.method = client->parser.method,
+		.url = client->url,
+		.body = client->body_len ? client->body : NULL,
+		.body_len = client->body_len,
+	};
+	/* Without keep-alive the body ends with the connection, and is not
+	 * chunked. This is the case of HTTP/1.0 clients.
+	 */
+	bool chunked = keep_alive;
+	char chunk_header[CHUNK_HEADER_LEN + 1];
+	uint8_t *data = tx_buf + tx_len / 2;
+	size_t data_len = tx_len - tx_len / 2 - (sizeof(CRLF) - 1);
+	struct iovec iov[4];
+	size_t offset = 0;
+	int hdr_len, ret;
+
+	/* The headers go to the first half of the buffer, so that they are
+	 * sent along with the first chunk.
+	 */
+	hdr_len = format_headers(tx_buf, tx_len / 2, HTTP_200_OK,
+				 &detail->common, -1, keep_alive);
+	if (hdr_len < 0) {
+		return hdr_len;
+	}
+
+	if (client->parser.method == HTTP_HEAD) {
+		return send_all(client->fd, tx_buf, hdr_len);
+	}
+
+	do {
+		ret = detail->cb(&req, offset, data, data_len,
+				 detail->user_data);
+		if (ret < 0) {
+			LOG_DBG("Resource %s failed (%d)", client->url, ret);
+
+			if (offset == 0) {
+				return send_status(client->fd, tx_buf, tx_len,
+						   HTTP_500_INTERNAL_SERVER_ERROR,
+						   keep_alive);
+			}
+
+			/* The response cannot be completed, tell the client
+			 * by closing the connection.
+			 */
+			return ret;
+		}
+
+		ret = MIN(ret, data_len);
+
+		iov[0].iov_base = tx_buf;
+		iov[0].iov_len = hdr_len;
+		iov[1].iov_base = chunk_header;
+		iov[1].iov_len = 0;
+		iov[2].iov_base = data;
+		iov[2].iov_len = ret;
+		iov[3].iov_base = CRLF;
+		iov[3].iov_len = 0;
+
+		if (chunked && ret > 0) {
+			iov[1].iov_len = snprintk(chunk_header,
+						  sizeof(chunk_header),
+						  "%x" CRLF, ret);
+			iov[3].iov_len = sizeof(CRLF) - 1;
+		} else if (chunked) {
+			iov[1].iov_base = LAST_CHUNK;
+			iov[1].iov_len = sizeof(LAST_CHUNK) - 1;
+		}
+
+		offset += ret;
+		hdr_len = 0;
+
+		ret = sendv_all(client->fd, iov, ARRAY_SIZE(iov), 0);
+		if (ret < 0) {
+			return ret;
+		}
+	} while (iov[2].iov_len > 0);
+
+	return 0;
+}
+
+static int serve_fs(struct http_client_ctx *client,
+		    const struct http_resource_detail_fs *detail,
+		    uint8_t *tx_buf, size_t tx_len, bool keep_alive)
+{
+#if defined(CONFIG_FILE_SYSTEM)
+	struct fs_dirent entry;
+	struct fs_file_t file;
+	ssize_t len;
+	int ret;
+
+	ret = fs_stat(detail->path, &entry);
+	if (ret < 0 || entry.type != FS_DIR_ENTRY_FILE) {
+		return send_status(client->fd, tx_buf, tx_len,
+				   HTTP_404_NOT_FOUND, keep_alive);
+	}
+
+	fs_file_t_init(&file);
+
+	ret = fs_open(&file, detail->path, FS_O_READ);
+	if (ret < 0) {
+		return send_status(client->fd, tx_buf, tx_len,
+				   HTTP_500_INTERNAL_SERVER_ERROR, keep_alive);
+	}
+
+	ret = format_headers(tx_buf, tx_len, HTTP_200_OK, &detail->common,
+			     entry.size, keep_alive);
+	if (ret < 0) {
+		goto out;
+	}
+
+	ret = send_all(client->fd, tx_buf, ret);
+	if (ret < 0 || client->parser.method == HTTP_HEAD) {
+		goto out;
+	}
+
+	/* The file is sent in blocks of the transmit buffer size, each read
+	 * block going to the stack in a single send.
+	 */
+	while ((len = fs_read(&file, tx_buf, tx_len)) > 0) {
+		ret = send_all(client->fd, tx_buf, len);
+		if (ret < 0) {
+			goto out;
+		}
+	}
+
+	/* The length was announced, a short file cannot be recovered from */
+	ret = len < 0 ? len : 0;
+
+out:
+	fs_close(&file);
+
+	return ret;
+#else
+	ARG_UNUSED(detail);
+
+	LOG_DBG("No file system support for %s", client->url);
+
+	return send_status(client->fd, tx_buf, tx_len,
+			   HTTP_500_INTERNAL_SERVER_ERROR, keep_alive);
+#endif /* CONFIG_FILE_SYSTEM */
+}
+
+static const struct http_resource_detail *
+find_resource(const struct http_service_desc *service, const char *url)
+{
+	/* The resource is the path, without the query or fragment */
+	size_t path_len = strcspn(url, "?#");
+
+	HTTP_SERVICE_FOREACH_RESOURCE(service, resource) {
+		if (strncmp(resource->resource, url, path_len) == 0 &&
+		    resource->resource[path_len] == '\0') {
+			return resource->detail;
+		}
+	}
+
+	return NULL;
+}
+
+static int serve_request(struct http_client_ctx *client, uint8_t *tx_buf,
+			 size_t tx_len, bool keep_alive)
+{
+	const struct http_resource_detail *detail;
+	uint32_t methods;
+
+	client->url[client->url_len] = '\0';
+
+	LOG_DBG("%s %s", http_method_str(client->parser.method), client->url);
+
+	if (client->error_status) {
+		return send_status(client->fd, tx_buf, tx_len,
+				   client->error_status, keep_alive);
+	}
+
+	detail = find_resource(client->service, client->url);
+	if (!detail) {
+		return send_status(client->fd, tx_buf, tx_len,
+				   HTTP_404_NOT_FOUND, keep_alive);
+	}
+
+	methods = detail->bitmask_of_supported_http_methods;
+	if (methods & HTTP_METHOD_BIT(HTTP_GET)) {
+		methods |= HTTP_METHOD_BIT(HTTP_HEAD);
+	}
+
+	if (client->parser.method >= 32 ||
+	    !(methods & HTTP_METHOD_BIT(client->parser.method))) {
+		return send_status(client->fd, tx_buf, tx_len,
+				   HTTP_405_METHOD_NOT_ALLOWED, keep_alive);
+	}
+
+	switch (detail->type) {
+	case HTTP_RESOURCE_TYPE_STATIC:
+		return serve_static(client, (const void *)detail, tx_buf,
+				    tx_len, keep_alive);
+	case HTTP_RESOURCE_TYPE_DYNAMIC:
+		return serve_dynamic(client, (const void *)detail, tx_buf,
+				     tx_len, keep_alive);
+	case HTTP_RESOURCE_TYPE_FS:
+		return serve_fs(client, (const void *)detail, tx_buf, tx_len,
+				keep_alive);
+	}
+
+	return send_status(client->fd, tx_buf, tx_len,
+			   HTTP_500_INTERNAL_SERVER_ERROR, keep_alive);
+}
+
+static int on_message_begin(struct http_parser *parser)
+{
+	struct http_client_ctx *client = parser->data;
+
+	client->url_len = 0;
+	client->body_len = 0;
+	client->error_status = 0;
+
+	return 0;
+}
+
+static int on_url(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_client_ctx *client = parser->data;
+
+	/* The target may come in several parts */
+	if (client->url_len + length > CONFIG_HTTP_SERVER_MAX_URL_LENGTH) {
+		client->error_status = HTTP_414_URI_TOO_LONG;
+		return 0;
+	}
+
+	memcpy(client->url + client->url_len, at, length);
+	client->url_len += length;
+
+	return 0;
+}
+
+static int on_body(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_client_ctx *client = parser->data;
+
+	if (client->body_len + length > CONFIG_HTTP_SERVER_MAX_BODY_SIZE) {
+		if (!client->error_status) {
+			client->error_status = HTTP_413_PAYLOAD_TOO_LARGE;
+		}
+
+		return 0;
+	}
+
+	memcpy(client->body + client->body_len, at, length);
+	client->body_len += length;
+
+	return 0;
+}
+
+static int on_message_complete(struct http_parser *parser)
+{
+	struct http_client_ctx *client = parser->data;
+
+	/* Stop here, so that pipelined requests are answered in order */
+	client->complete = true;
+	http_parser_pause(parser, 1);
+
+	return 0;
+}
+
+static const struct http_parser_settings parser_settings = {
+	.on_message_begin = on_message_begin,
+	.on_url = on_url,
+	.on_body = on_body,
+	.on_message_complete = on_message_complete,
+};
+
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+static void static_data_released(const void *data, size_t len,
+				 void *user_data)
+{
+	/* Static data is never freed */
+	ARG_UNUSED(data);
+	ARG_UNUSED(len);
+	ARG_UNUSED(user_data);
+}
+#endif
+
+void http1_client_init(struct http_client_ctx *client)
+{
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+	if (zsock_set_zerocopy_cb(client->fd, static_data_released,
+				  NULL) < 0) {
+		LOG_DBG("No zero-copy on client %d (%d)", client->fd, errno);
+	}
+#endif
+
+
+	http_parser_init(&client->parser, HTTP_REQUEST);
+	client->parser.data = client;
+
+	client->data_len = 0;
+	client->offset = 0;
+	client->complete = false;
+}
+
+int http1_client_process(struct http_client_ctx *client, uint8_t *tx_buf,
+			 size_t tx_len)
+{
+	ssize_t received;
+	size_t parsed;
+	int ret;
+
+	if (client->offset == client->data_len) {
+		received = zsock_recv(client->fd, client->buffer,
+				      sizeof(client->buffer),
+				      ZSOCK_MSG_DONTWAIT);
+		if (received == 0) {
+			return -ENOTCONN;
+		}
+
+		if (received < 0) {
+			return errno == EAGAIN ? 0 : -errno;
+		}
+
+		client->data_len = received;
+		client->offset = 0;
+	}
+
+	while (client->offset < client->data_len) {
+		parsed = http_parser_execute(&client->parser, &parser_settings,
+					     client->buffer + client->offset,
+					     client->data_len - client->offset);
+		client->offset += parsed;
+
+		if (client->complete) {
+			bool keep_alive = http_should_keep_alive(&client->parser);
+
+			client->complete = false;
+			http_parser_pause(&client->parser, 0);
+
+			/* A request too large to be read is not completely
+			 * consumed, so the connection cannot be reused.
+			 */
+			if (client->error_status) {
+				keep_alive = false;
+			}
+
+			ret = serve_request(client, tx_buf, tx_len, keep_alive);
+			if (ret < 0) {
+				return ret;
+			}
+
+			if (!keep_alive) {
+				return -ECONNRESET;
+			}
+
+			continue;
+		}
+
+		if (HTTP_PARSER_ERRNO(&client->parser) != HPE_OK) {
+			LOG_DBG("Parse error: %s", http_errno_description(
+					HTTP_PARSER_ERRNO(&client->parser)));
+
+			(void)send_status(client->fd, tx_buf, tx_len,
+					  HTTP_400_BAD_REQUEST, false);
+
+			return -EBADMSG;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __HTTP_SERVER_INTERNAL_H
+#define __HTTP_SERVER_INTERNAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <zephyr/net/http/parser.h>
+#include <zephyr/net/http/server.h>
+
+struct http_client_ctx {
+	/** Socket, -1 if the slot is free */
+	int fd;
+
+	/** Index of the service in the listener table */
+	int service_idx;
+
+	/** Service the client connected to */
+	const struct http_service_desc *service;
+
+	/** Incremental request parser */
+	struct http_parser parser;
+
+	/** Last time data was received, in ms */
+	int64_t last_activity;
+
+	/** Received bytes in buffer, and how many of them were parsed */
+	size_t data_len;
+	size_t offset;
+
+	/** Error status to answer the current request with, or 0 */
+	uint16_t error_status;
+
+	/** A complete request is parsed, and waits for its response */
+	bool complete;
+
+	size_t url_len;
+	char url[CONFIG_HTTP_SERVER_MAX_URL_LENGTH + 1];
+
+	size_t body_len;
+	uint8_t body[CONFIG_HTTP_SERVER_MAX_BODY_SIZE];
+
+	uint8_t buffer[CONFIG_HTTP_SERVER_CLIENT_BUFFER_SIZE];
+};
+
+void http1_client_init(struct http_client_ctx *client);
+
+/* Reads and serves the requests available on the client socket. Returns 0
+ * to keep the connection open, or a negative error code to close it.
+ */
+int http1_client_process(struct http_client_ctx *client, uint8_t *tx_buf,
+			 size_t tx_len);
+
+/* Sends an error response to a client that is not served */
+void http1_send_error(int fd, uint16_t status);
+
+#endif /* __HTTP_SERVER_INTERNAL_H */
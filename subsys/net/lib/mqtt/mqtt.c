@@ -287,6 +287,117 @@ error:
 	return err_code;
 }
 
+#if defined(CONFIG_MQTT_PUBLISH_BATCH)
+static int publish_batch_write(struct mqtt_client *client,
+			       struct iovec *io_vector, size_t iovcnt)
+{
+	struct msghdr msg;
+
+	memset(&msg, 0, sizeof(msg));
+
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = iovcnt;
+
+	return client_write_msg(client, &msg);
+}
+
+/** @brief Space taken in the TX buffer by encoding a PUBLISH header. */
+static ptrdiff_t publish_header_space(const struct mqtt_publish_param *param)
+{
+	ptrdiff_t space = MQTT_FIXED_HEADER_MAX_SIZE +
+			  GET_UT8STR_BUFFER_SIZE(&param->message.topic.topic);
+
+	if (param->message.topic.qos) {
+		space += sizeof(uint16_t);
+	}
+
+	return space;
+}
+
+int mqtt_publish_batch(struct mqtt_client *client,
+		       const struct mqtt_publish_param *params, size_t count)
+{
+	int err_code;
+	struct buf_ctx packet;
+	struct iovec io_vector[2 * CONFIG_MQTT_PUBLISH_BATCH_SIZE];
+	uint8_t *free_start;
+	size_t batched = 0;
+	size_t i = 0;
+
+	NULL_PARAM_CHECK(client);
+	NULL_PARAM_CHECK(params);
+
+	NET_DBG("[CID %p]:[State 0x%02x]: >> Message count %zu",
+		 client, client->internal.state, count);
+
+	mqtt_mutex_lock(client);
+
+	err_code = verify_tx_state(client);
+	if (err_code < 0) {
+		goto error;
+	}
+
+	free_start = client->tx_buf;
+
+	while (i < count) {
+		/* Encode the next header right after the previous one. */
+		packet.cur = free_start;
+		packet.end = client->tx_buf + client->tx_buf_size;
+
+		if ((batched > 0) &&
+		    ((packet.end - packet.cur) <
+		     publish_header_space(&params[i]))) {
+			/* TX buffer full, write the batch and retry. */
+			err_code = publish_batch_write(client, io_vector,
+						       2 * batched);
+			if (err_code < 0) {
+				goto error;
+			}
+
+			free_start = client->tx_buf;
+			batched = 0;
+			continue;
+		}
+
+		err_code = publish_encode(&params[i], &packet);
+		if (err_code < 0) {
+			goto error;
+		}
+
+		io_vector[2 * batched].iov_base = packet.cur;
+		io_vector[2 * batched].iov_len = packet.end - packet.cur;
+		io_vector[2 * batched + 1].iov_base =
+					params[i].message.payload.data;
+		io_vector[2 * batched + 1].iov_len =
+					params[i].message.payload.len;
+
+		free_start = packet.end;
+		batched++;
+		i++;
+
+		if ((batched == CONFIG_MQTT_PUBLISH_BATCH_SIZE) ||
+		    (i == count)) {
+			err_code = publish_batch_write(client, io_vector,
+						       2 * batched);
+			if (err_code < 0) {
+				goto error;
+			}
+
+			free_start = client->tx_buf;
+			batched = 0;
+		}
+	}
+
+error:
+	NET_DBG("[CID %p]:[State 0x%02x]: << result 0x%08x",
+		 client, client->internal.state, err_code);
+
+	mqtt_mutex_unlock(client);
+
+	return err_code;
+}
+#endif /* CONFIG_MQTT_PUBLISH_BATCH */
+
 int mqtt_publish_qos1_ack(struct mqtt_client *client,
 			  const struct mqtt_puback_param *param)
 {
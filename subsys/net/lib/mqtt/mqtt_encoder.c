@@ -33,6 +33,20 @@ static const uint8_t disc_packet[MQTT_FIXED_HEADER_MIN_SIZE] = {
 	0x00
 };
 
+/**
+ * @brief Returns the space left in the buffer.
+ *
+ * @param[in] buf A pointer to the buf_ctx structure containing current
+ *                buffer position.
+ *
+ * @return Number of bytes between the current position and the end of the
+ *         buffer, 0 if the current position is past the end.
+ */
+static size_t buf_space(const struct buf_ctx *buf)
+{
+	return (buf->cur < buf->end) ? (size_t)(buf->end - buf->cur) : 0U;
+}
+
 /**
  * @brief Packs unsigned 8 bit value to the buffer at the offset requested.
  *
@@ -45,7 +59,7 @@ static const uint8_t disc_packet[MQTT_FIXED_HEADER_MIN_SIZE] = {
  */
 static int pack_uint8(uint8_t val, struct buf_ctx *buf)
 {
-	if ((buf->end - buf->cur) < sizeof(uint8_t)) {
+	if (buf_space(buf) < sizeof(uint8_t)) {
 		return -ENOMEM;
 	}
 
@@ -69,7 +83,7 @@ static int pack_uint8(uint8_t val, struct buf_ctx *buf)
  */
 static int pack_uint16(uint16_t val, struct buf_ctx *buf)
 {
-	if ((buf->end - buf->cur) < sizeof(uint16_t)) {
+	if (buf_space(buf) < sizeof(uint16_t)) {
 		return -ENOMEM;
 	}
 
@@ -94,7 +108,7 @@ static int pack_uint16(uint16_t val, struct buf_ctx *buf)
  */
 static int pack_utf8_str(const struct mqtt_utf8 *str, struct buf_ctx *buf)
 {
-	if ((buf->end - buf->cur) < GET_UT8STR_BUFFER_SIZE(str)) {
+	if (buf_space(buf) < GET_UT8STR_BUFFER_SIZE(str)) {
 		return -ENOMEM;
 	}
 
@@ -401,6 +415,11 @@ int publish_encode(const struct mqtt_publish_param *param, struct buf_ctx *buf)
 		return -EINVAL;
 	}
 
+	/* The buffer may be partly used by previous messages of a batch. */
+	if (buf_space(buf) < MQTT_FIXED_HEADER_MAX_SIZE) {
+		return -ENOMEM;
+	}
+
 	/* Reserve space for fixed header. */
 	buf->cur += MQTT_FIXED_HEADER_MAX_SIZE;
 	start = buf->cur;
@@ -470,7 +489,7 @@ int publish_complete_encode(const struct mqtt_pubcomp_param *param,
 
 int disconnect_encode(struct buf_ctx *buf)
 {
-	if (buf->end - buf->cur < sizeof(disc_packet)) {
+	if (buf_space(buf) < sizeof(disc_packet)) {
 		return -ENOMEM;
 	}
 
@@ -546,7 +565,7 @@ int unsubscribe_encode(const struct mqtt_subscription_list *param,
 
 int ping_request_encode(struct buf_ctx *buf)
 {
-	if (buf->end - buf->cur < sizeof(ping_packet)) {
+	if (buf_space(buf) < sizeof(ping_packet)) {
 		return -ENOMEM;
 	}
 
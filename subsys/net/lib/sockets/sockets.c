@@ -735,6 +735,9 @@ out:
 	return -1;
 }
 
+ssize_t zsock_sendmsg_ctx(struct net_context *ctx, const struct msghdr *msg,
+			  int flags);
+
 ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
 			 int flags,
 			 const struct sockaddr *dest_addr, socklen_t addrlen)
@@ -761,6 +764,23 @@ ssize_t zsock_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
 		return -1;
 	}
 
+	if (IS_ENABLED(CONFIG_NET_SOCKETS_ZEROCOPY) &&
+	    (flags & ZSOCK_MSG_ZEROCOPY)) {
+		struct iovec iov = {
+			.iov_base = (void *)buf,
+			.iov_len = len,
+		};
+		struct msghdr msg = {
+			.msg_name = (void *)dest_addr,
+			.msg_namelen = addrlen,
+			.msg_iov = &iov,
+			.msg_iovlen = 1,
+		};
+
+		/* Only the msghdr based send can reference the data */
+		return zsock_sendmsg_ctx(ctx, &msg, flags);
+	}
+
 	while (1) {
 		if (dest_addr) {
 			status = net_context_sendto(ctx, buf, len, dest_addr,
@@ -806,6 +826,9 @@ ssize_t z_vrfy_zsock_sendto(int sock, const void *buf, size_t len, int flags,
 					addrlen));
 	}
 
+	/* Zero-copy release callbacks cannot be delivered to user mode */
+	flags &= ~ZSOCK_MSG_ZEROCOPY;
+
 	return z_impl_zsock_sendto(sock, (const void *)buf, len, flags,
 			dest_addr ? (struct sockaddr *)&dest_addr_copy : NULL,
 			addrlen);
@@ -918,8 +941,9 @@ static inline ssize_t z_vrfy_zsock_sendmsg(int sock,
 		}
 	}
 
+	/* The data is copied to kernel memory that is freed on return */
 	ret = z_impl_zsock_sendmsg(sock, (const struct msghdr *)&msg_copy,
-				   flags);
+				   flags & ~ZSOCK_MSG_ZEROCOPY);
 
 	k_free(msg_copy.msg_name);
 	k_free(msg_copy.msg_control);
@@ -956,6 +980,79 @@ fail:
 #include <syscalls/zsock_sendmsg_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+static int zsock_sendmmsg_ctx(struct net_context *ctx, struct mmsghdr *msgvec,
+			      unsigned int vlen, int flags)
+{
+	unsigned int i;
+	int status;
+
+	/* As in sendto(), register the callback before sending in order to
+	 * receive the response from the peer. This also binds the socket to
+	 * a local address and port if it is not bound yet.
+	 */
+	status = net_context_recv(ctx, zsock_received_cb,
+				  K_NO_WAIT, ctx->user_data);
+	if (status < 0) {
+		errno = -status;
+		return -1;
+	}
+
+	for (i = 0; i < vlen; i++) {
+		ssize_t ret;
+
+		ret = zsock_sendmsg_ctx(ctx, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			/* errno is already set */
+			if (i == 0) {
+				return -1;
+			}
+
+			break;
+		}
+
+		msgvec[i].msg_len = ret;
+	}
+
+	return i;
+}
+
+int z_impl_zsock_sendmmsg(int sock, struct mmsghdr *msgvec, unsigned int vlen,
+			  int flags)
+{
+	VTABLE_CALL(sendmmsg, sock, msgvec, vlen, flags);
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	unsigned int i;
+
+	/* Every message needs its own copy to kernel memory, so just go
+	 * through the sendmsg() verification one message at a time.
+	 */
+	for (i = 0; i < vlen; i++) {
+		unsigned int len;
+		ssize_t ret;
+
+		ret = z_vrfy_zsock_sendmsg(sock, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			if (i == 0) {
+				return -1;
+			}
+
+			break;
+		}
+
+		len = ret;
+		Z_OOPS(z_user_to_copy(&msgvec[i].msg_len, &len, sizeof(len)));
+	}
+
+	return i;
+}
+#include <syscalls/zsock_sendmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
 static int sock_get_pkt_src_addr(struct net_pkt *pkt,
 				 enum net_ip_protocol proto,
 				 struct sockaddr *addr,
@@ -1110,6 +1207,50 @@ int zsock_wait_data(struct net_context *ctx, k_timeout_t *timeout)
 	return 0;
 }
 
+static int sock_get_dgram_src_addr(struct net_context *ctx,
+				   struct net_pkt *pkt,
+				   struct sockaddr *src_addr,
+				   socklen_t *addrlen)
+{
+	if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+	    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
+		/*
+		 * Packets from offloaded IP stack do not have IP
+		 * headers, so src address cannot be figured out at this
+		 * point. The best we can do is returning remote address
+		 * if that was set using connect() call.
+		 */
+		if (ctx->flags & NET_CONTEXT_REMOTE_ADDR_SET) {
+			memcpy(src_addr, &ctx->remote,
+			       MIN(*addrlen, sizeof(ctx->remote)));
+		} else {
+			return -ENOTSUP;
+		}
+	} else {
+		int rv;
+
+		rv = sock_get_pkt_src_addr(pkt, net_context_get_proto(ctx),
+					   src_addr, *addrlen);
+		if (rv < 0) {
+			LOG_ERR("sock_get_pkt_src_addr %d", rv);
+			return rv;
+		}
+	}
+
+	/* addrlen is a value-result argument, set to actual
+	 * size of source address
+	 */
+	if (src_addr->sa_family == AF_INET) {
+		*addrlen = sizeof(struct sockaddr_in);
+	} else if (src_addr->sa_family == AF_INET6) {
+		*addrlen = sizeof(struct sockaddr_in6);
+	} else {
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
 static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 				       void *buf,
 				       size_t max_len,
@@ -1160,42 +1301,11 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 	net_pkt_cursor_backup(pkt, &backup);
 
 	if (src_addr && addrlen) {
-		if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
-		    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
-			/*
-			 * Packets from offloaded IP stack do not have IP
-			 * headers, so src address cannot be figured out at this
-			 * point. The best we can do is returning remote address
-			 * if that was set using connect() call.
-			 */
-			if (ctx->flags & NET_CONTEXT_REMOTE_ADDR_SET) {
-				memcpy(src_addr, &ctx->remote,
-				       MIN(*addrlen, sizeof(ctx->remote)));
-			} else {
-				errno = ENOTSUP;
-				goto fail;
-			}
-		} else {
-			int rv;
-
-			rv = sock_get_pkt_src_addr(pkt, net_context_get_proto(ctx),
-						   src_addr, *addrlen);
-			if (rv < 0) {
-				errno = -rv;
-				LOG_ERR("sock_get_pkt_src_addr %d", rv);
-				goto fail;
-			}
-		}
+		int rv;
 
-		/* addrlen is a value-result argument, set to actual
-		 * size of source address
-		 */
-		if (src_addr->sa_family == AF_INET) {
-			*addrlen = sizeof(struct sockaddr_in);
-		} else if (src_addr->sa_family == AF_INET6) {
-			*addrlen = sizeof(struct sockaddr_in6);
-		} else {
-			errno = ENOTSUP;
+		rv = sock_get_dgram_src_addr(ctx, pkt, src_addr, addrlen);
+		if (rv < 0) {
+			errno = -rv;
 			goto fail;
 		}
 	}
@@ -1418,6 +1528,434 @@ ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 #include <syscalls/zsock_recvfrom_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+/* Scatter the datagram at the cursor of pkt into the iovecs of msg */
+static ssize_t zsock_recv_dgram_msg(struct net_context *ctx,
+				    struct net_pkt *pkt,
+				    struct msghdr *msg)
+{
+	size_t recv_len = net_pkt_remaining_data(pkt);
+	size_t read_len = 0;
+
+	msg->msg_flags = 0;
+	msg->msg_controllen = 0;
+
+	if (msg->msg_name && msg->msg_namelen > 0) {
+		int rv;
+
+		rv = sock_get_dgram_src_addr(ctx, pkt, msg->msg_name,
+					     &msg->msg_namelen);
+		if (rv < 0) {
+			return rv;
+		}
+	}
+
+	for (size_t i = 0; i < msg->msg_iovlen && read_len < recv_len; i++) {
+		size_t len = MIN(msg->msg_iov[i].iov_len, recv_len - read_len);
+
+		if (net_pkt_read(pkt, msg->msg_iov[i].iov_base, len)) {
+			return -ENOBUFS;
+		}
+
+		read_len += len;
+	}
+
+	if (read_len < recv_len) {
+		msg->msg_flags |= ZSOCK_MSG_TRUNC;
+	}
+
+	return read_len;
+}
+
+static int zsock_recvmmsg_ctx(struct net_context *ctx, struct mmsghdr *msgvec,
+			      unsigned int vlen, int flags)
+{
+	k_timeout_t timeout = K_FOREVER;
+	unsigned int i;
+
+	if (net_context_get_type(ctx) != SOCK_DGRAM) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	if (flags & ZSOCK_MSG_PEEK) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else {
+		int ret;
+
+		net_context_get_option(ctx, NET_OPT_RCVTIMEO, &timeout, NULL);
+
+		ret = zsock_wait_data(ctx, &timeout);
+		if (ret < 0) {
+			errno = -ret;
+			return -1;
+		}
+	}
+
+	for (i = 0; i < vlen; i++) {
+		struct net_pkt *pkt;
+		ssize_t ret;
+
+		/* Only wait for the first datagram, then take what is queued */
+		pkt = k_fifo_get(&ctx->recv_q, i == 0 ? timeout : K_NO_WAIT);
+		if (!pkt) {
+			break;
+		}
+
+		ret = zsock_recv_dgram_msg(ctx, pkt, &msgvec[i].msg_hdr);
+
+		if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+			net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+		}
+
+		net_pkt_unref(pkt);
+
+		if (ret < 0) {
+			if (i == 0) {
+				errno = -ret;
+				return -1;
+			}
+
+			break;
+		}
+
+		msgvec[i].msg_len = ret;
+	}
+
+	if (i == 0 && vlen > 0) {
+		errno = EAGAIN;
+		return -1;
+	}
+
+	return i;
+}
+
+int z_impl_zsock_recvmmsg(int sock, struct mmsghdr *msgvec, unsigned int vlen,
+			  int flags)
+{
+	VTABLE_CALL(recvmmsg, sock, msgvec, vlen, flags);
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	struct mmsghdr *vec_copy;
+	unsigned int n_iov = 0;
+	size_t size;
+	int ret = -1;
+
+	if (vlen == 0) {
+		return 0;
+	}
+
+	if (size_mul_overflow(vlen, sizeof(*msgvec), &size)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	vec_copy = z_user_alloc_from_copy(msgvec, size);
+	if (!vec_copy) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	/* The datagrams are read straight into the (verified) user buffers,
+	 * only the headers and scatter arrays are copied.
+	 */
+	for (n_iov = 0; n_iov < vlen; n_iov++) {
+		struct msghdr *msg = &vec_copy[n_iov].msg_hdr;
+		const struct iovec *iov = msg->msg_iov;
+
+		msg->msg_control = NULL;
+		msg->msg_iov = NULL;
+
+		if (msg->msg_name &&
+		    Z_SYSCALL_MEMORY_WRITE(msg->msg_name, msg->msg_namelen)) {
+			errno = EFAULT;
+			goto out;
+		}
+
+		if (msg->msg_iovlen == 0) {
+			continue;
+		}
+
+		if (size_mul_overflow(msg->msg_iovlen, sizeof(*iov), &size)) {
+			errno = EINVAL;
+			goto out;
+		}
+
+		msg->msg_iov = z_user_alloc_from_copy(iov, size);
+		if (!msg->msg_iov) {
+			errno = ENOMEM;
+			goto out;
+		}
+
+		for (size_t i = 0; i < msg->msg_iovlen; i++) {
+			if (Z_SYSCALL_MEMORY_WRITE(msg->msg_iov[i].iov_base,
+						   msg->msg_iov[i].iov_len)) {
+				/* Freed below with the others */
+				n_iov++;
+				errno = EFAULT;
+				goto out;
+			}
+		}
+	}
+
+	ret = z_impl_zsock_recvmmsg(sock, vec_copy, vlen, flags);
+
+	for (int i = 0; i < ret; i++) {
+		Z_OOPS(z_user_to_copy(&msgvec[i].msg_len, &vec_copy[i].msg_len,
+				      sizeof(msgvec[i].msg_len)));
+		Z_OOPS(z_user_to_copy(&msgvec[i].msg_hdr.msg_namelen,
+				      &vec_copy[i].msg_hdr.msg_namelen,
+				      sizeof(socklen_t)));
+		Z_OOPS(z_user_to_copy(&msgvec[i].msg_hdr.msg_controllen,
+				      &vec_copy[i].msg_hdr.msg_controllen,
+				      sizeof(size_t)));
+		Z_OOPS(z_user_to_copy(&msgvec[i].msg_hdr.msg_flags,
+				      &vec_copy[i].msg_hdr.msg_flags,
+				      sizeof(int)));
+	}
+
+out:
+	for (unsigned int i = 0; i < n_iov; i++) {
+		k_free(vec_copy[i].msg_hdr.msg_iov);
+	}
+
+	k_free(vec_copy);
+
+	return ret;
+}
+#include <syscalls/zsock_recvmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+/* Zero-copy calls exchange kernel buffers and are therefore only offered
+ * for native sockets, and not as system calls.
+ */
+static struct net_context *zerocopy_get_ctx(int sock, struct k_mutex **lock)
+{
+	const struct socket_op_vtable *vtable;
+	struct net_context *ctx;
+
+	ctx = get_sock_vtable(sock, &vtable, lock);
+	if (ctx == NULL) {
+		errno = EBADF;
+		return NULL;
+	}
+
+	if (vtable != &sock_fd_op_vtable) {
+		errno = EOPNOTSUPP;
+		return NULL;
+	}
+
+	return ctx;
+}
+
+/* Take the payload, from the cursor on, out of the packet */
+static struct net_buf *sock_detach_payload(struct net_pkt *pkt)
+{
+	struct net_buf *data = pkt->cursor.buf;
+	struct net_buf *frag = pkt->buffer;
+
+	/* Fragments before the cursor only hold headers */
+	while (frag != data) {
+		struct net_buf *next = frag->frags;
+
+		frag->frags = NULL;
+		net_buf_unref(frag);
+		frag = next;
+	}
+
+	if (data) {
+		net_buf_pull(data, pkt->cursor.pos - data->data);
+	}
+
+	pkt->buffer = NULL;
+	net_pkt_cursor_init(pkt);
+
+	return data;
+}
+
+static struct net_pkt *zsock_recv_buf_stream(struct net_context *ctx,
+					     k_timeout_t timeout,
+					     ssize_t *status)
+{
+	struct net_pkt *pkt;
+	int res;
+
+	if (net_context_get_state(ctx) != NET_CONTEXT_CONNECTED) {
+		*status = -ENOTCONN;
+		return NULL;
+	}
+
+	if (!sock_is_eof(ctx) && !sock_is_error(ctx) &&
+	    !K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		res = zsock_wait_data(ctx, &timeout);
+		if (res < 0) {
+			*status = res;
+			return NULL;
+		}
+	}
+
+	pkt = k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+	if (!pkt) {
+		if (sock_is_error(ctx)) {
+			*status = -POINTER_TO_INT(ctx->user_data);
+		} else if (sock_is_eof(ctx)) {
+			*status = 0;
+		} else {
+			*status = -EAGAIN;
+		}
+
+		return NULL;
+	}
+
+	if (net_pkt_eof(pkt)) {
+		sock_set_eof(ctx);
+	}
+
+	return pkt;
+}
+
+static ssize_t zsock_recv_buf_ctx(struct net_context *ctx,
+				  struct net_buf **buf, int flags,
+				  struct sockaddr *src_addr,
+				  socklen_t *addrlen)
+{
+	enum net_sock_type sock_type = net_context_get_type(ctx);
+	k_timeout_t timeout = K_FOREVER;
+	struct net_pkt *pkt;
+	ssize_t len;
+	int res;
+
+	if (flags & ~ZSOCK_MSG_DONTWAIT) {
+		return -EINVAL;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	} else {
+		net_context_get_option(ctx, NET_OPT_RCVTIMEO, &timeout, NULL);
+	}
+
+	if (sock_type == SOCK_STREAM) {
+		pkt = zsock_recv_buf_stream(ctx, timeout, &len);
+		if (!pkt) {
+			return len;
+		}
+	} else if (sock_type == SOCK_DGRAM) {
+		if (!K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			res = zsock_wait_data(ctx, &timeout);
+			if (res < 0) {
+				return res;
+			}
+		}
+
+		pkt = k_fifo_get(&ctx->recv_q, timeout);
+		if (!pkt) {
+			return -EAGAIN;
+		}
+
+		if (src_addr && addrlen) {
+			res = sock_get_dgram_src_addr(ctx, pkt, src_addr,
+						      addrlen);
+			if (res < 0) {
+				net_pkt_unref(pkt);
+				return res;
+			}
+		}
+	} else {
+		return -EOPNOTSUPP;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS)) {
+		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
+	}
+
+	len = net_pkt_remaining_data(pkt);
+	*buf = sock_detach_payload(pkt);
+	net_pkt_unref(pkt);
+
+	return len;
+}
+
+ssize_t zsock_recv_buf(int sock, struct net_buf **buf, int flags,
+		       struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	ssize_t ret;
+
+	*buf = NULL;
+
+	ctx = zerocopy_get_ctx(sock, &lock);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+	ret = zsock_recv_buf_ctx(ctx, buf, flags, src_addr, addrlen);
+	k_mutex_unlock(lock);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return ret;
+}
+
+void zsock_release_buf(int sock, struct net_buf *buf)
+{
+	struct net_context *ctx;
+	struct k_mutex *lock;
+	size_t len;
+
+	if (buf == NULL) {
+		return;
+	}
+
+	len = net_buf_frags_len(buf);
+	net_buf_unref(buf);
+
+	ctx = zerocopy_get_ctx(sock, &lock);
+	if (ctx == NULL) {
+		return;
+	}
+
+	/* The peer may send more once the application let go of the data */
+	if (net_context_get_type(ctx) == SOCK_STREAM) {
+		(void)k_mutex_lock(lock, K_FOREVER);
+		net_context_update_recv_wnd(ctx, len);
+		k_mutex_unlock(lock);
+	}
+}
+
+int zsock_set_zerocopy_cb(int sock, zsock_zerocopy_cb_t cb, void *user_data)
+{
+	struct net_context *ctx;
+	struct k_mutex *lock;
+
+	ctx = zerocopy_get_ctx(sock, &lock);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+	ctx->zerocopy_cb = cb;
+	ctx->zerocopy_user_data = user_data;
+	k_mutex_unlock(lock);
+
+	return 0;
+}
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY */
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
@@ -2544,6 +3082,18 @@ static ssize_t sock_sendmsg_vmeth(void *obj, const struct msghdr *msg,
 	return zsock_sendmsg_ctx(obj, msg, flags);
 }
 
+static int sock_sendmmsg_vmeth(void *obj, struct mmsghdr *msgvec,
+			       unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg_ctx(obj, msgvec, vlen, flags);
+}
+
+static int sock_recvmmsg_vmeth(void *obj, struct mmsghdr *msgvec,
+			       unsigned int vlen, int flags)
+{
+	return zsock_recvmmsg_ctx(obj, msgvec, vlen, flags);
+}
+
 static ssize_t sock_recvfrom_vmeth(void *obj, void *buf, size_t max_len,
 				   int flags, struct sockaddr *src_addr,
 				   socklen_t *addrlen)
@@ -2594,7 +3144,9 @@ const struct socket_op_vtable sock_fd_op_vtable = {
 	.accept = sock_accept_vmeth,
 	.sendto = sock_sendto_vmeth,
 	.sendmsg = sock_sendmsg_vmeth,
+	.sendmmsg = sock_sendmmsg_vmeth,
 	.recvfrom = sock_recvfrom_vmeth,
+	.recvmmsg = sock_recvmmsg_vmeth,
 	.getsockopt = sock_getsockopt_vmeth,
 	.setsockopt = sock_setsockopt_vmeth,
 	.getpeername = sock_getpeername_vmeth,
@@ -10,6 +10,7 @@ LOG_MODULE_REGISTER(npf_base, CONFIG_NET_PKT_FILTER_LOG_LEVEL);
 #include <zephyr/net/net_core.h>
 #include <zephyr/net/net_pkt_filter.h>
 #include <zephyr/spinlock.h>
+#include <zephyr/sys/byteorder.h>
 
 /*
  * Our actual rule lists for supported test points
@@ -18,13 +19,320 @@ LOG_MODULE_REGISTER(npf_base, CONFIG_NET_PKT_FILTER_LOG_LEVEL);
 struct npf_rule_list npf_send_rules = {
 	.rule_head = SYS_SLIST_STATIC_INIT(&send_rules.rule_head),
 	.lock = { },
+	.prog_lock = Z_MUTEX_INITIALIZER(npf_send_rules.prog_lock),
 };
 
 struct npf_rule_list npf_recv_rules = {
 	.rule_head = SYS_SLIST_STATIC_INIT(&recv_rules.rule_head),
 	.lock = { },
+	.prog_lock = Z_MUTEX_INITIALIZER(npf_recv_rules.prog_lock),
 };
 
+#if defined(CONFIG_NET_CAPTURE)
+struct npf_rule_list npf_capture_rules = {
+	.rule_head = SYS_SLIST_STATIC_INIT(&capture_rules.rule_head),
+	.lock = { },
+	.prog_lock = Z_MUTEX_INITIALIZER(npf_capture_rules.prog_lock),
+};
+#endif
+
+/*
+ * Compiled rule lists
+ *
+ * A rule list is compiled into a program of the instructions below,
+ * working on a single register A. Each instruction has a true and a false
+ * outcome, and execution continues at the next instruction plus the jt or
+ * jf offset accordingly. Jumps only go forward and every program ends
+ * with NPF_RET, so evaluation always terminates.
+ */
+
+enum {
+	NPF_RET,		/* return verdict k */
+	NPF_JA,			/* always true */
+	NPF_LD_H,		/* A = 16-bit word at offset k, false if beyond */
+	NPF_LD_LEN,		/* A = packet length */
+	NPF_LD_IFACE,		/* A = interface index */
+	NPF_LD_ORIG_IFACE,	/* A = original interface index */
+	NPF_JEQ,		/* A == k */
+	NPF_JGE,		/* A >= k */
+	NPF_JGT,		/* A > k */
+	NPF_ETH_ADDR,		/* address at offset k is in the test set */
+	NPF_CALL,		/* result of the test function */
+};
+
+/* Jump target placeholder for "this rule does not match" */
+#define NPF_JFAIL UINT16_MAX
+
+#if defined(CONFIG_NET_L2_ETHERNET)
+static bool eth_addr_match(struct npf_test *test, const uint8_t *pkt_addr)
+{
+	struct npf_test_eth_addr *test_eth_addr =
+			CONTAINER_OF(test, struct npf_test_eth_addr, test);
+	const uint8_t *mask = test_eth_addr->mask.addr;
+
+	for (unsigned int i = 0; i < test_eth_addr->nb_addresses; i++) {
+		const uint8_t *addr = test_eth_addr->addresses[i].addr;
+		int j;
+
+		for (j = 0; j < sizeof(struct net_eth_addr); j++) {
+			if ((addr[j] & mask[j]) != (pkt_addr[j] & mask[j])) {
+				break;
+			}
+		}
+
+		if (j == sizeof(struct net_eth_addr)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif
+
+static enum net_verdict run_prog(const struct npf_prog *prog,
+				 struct net_pkt *pkt)
+{
+	const struct npf_insn *insn = prog->insns;
+	const struct net_buf *buf = pkt->buffer;
+	uint32_t a = 0U;
+	bool res;
+
+	while (true) {
+		res = true;
+
+		switch (insn->op) {
+		case NPF_RET:
+			return (enum net_verdict)insn->k;
+		case NPF_JA:
+			break;
+		case NPF_LD_H:
+			if (buf == NULL || insn->k + sizeof(uint16_t) > buf->len) {
+				res = false;
+				break;
+			}
+
+			a = sys_get_be16(buf->data + insn->k);
+			break;
+		case NPF_LD_LEN:
+			a = net_pkt_get_len(pkt);
+			break;
+		case NPF_LD_IFACE:
+			a = net_if_get_by_iface(net_pkt_iface(pkt));
+			break;
+		case NPF_LD_ORIG_IFACE:
+			a = net_if_get_by_iface(net_pkt_orig_iface(pkt));
+			break;
+		case NPF_JEQ:
+			res = a == insn->k;
+			break;
+		case NPF_JGE:
+			res = a >= insn->k;
+			break;
+		case NPF_JGT:
+			res = a > insn->k;
+			break;
+#if defined(CONFIG_NET_L2_ETHERNET)
+		case NPF_ETH_ADDR:
+			res = buf != NULL &&
+			      insn->k + sizeof(struct net_eth_addr) <= buf->len &&
+			      eth_addr_match(insn->test, buf->data + insn->k);
+			break;
+#endif
+		case NPF_CALL:
+			res = insn->test->fn(insn->test, pkt);
+			break;
+		default:
+			__ASSERT(false, "invalid filter op %u", insn->op);
+			return NET_DROP;
+		}
+
+		insn += 1 + (res ? insn->jt : insn->jf);
+	}
+}
+
+static bool emit(struct npf_prog *prog, struct npf_insn insn)
+{
+	if (prog->len >= ARRAY_SIZE(prog->insns)) {
+		return false;
+	}
+
+	prog->insns[prog->len++] = insn;
+
+	return true;
+}
+
+/* Emit a test whose success falls through to the next instruction */
+static bool compile_test(struct npf_prog *prog, struct npf_test *test)
+{
+	npf_test_fn_t *fn = test->fn;
+	bool match;
+
+	if (fn == npf_iface_match || fn == npf_iface_unmatch ||
+	    fn == npf_orig_iface_match || fn == npf_orig_iface_unmatch) {
+		struct npf_test_iface *test_iface =
+				CONTAINER_OF(test, struct npf_test_iface, test);
+		bool orig = fn == npf_orig_iface_match ||
+			    fn == npf_orig_iface_unmatch;
+
+		match = fn == npf_iface_match || fn == npf_orig_iface_match;
+
+		return emit(prog, (struct npf_insn){
+				.op = orig ? NPF_LD_ORIG_IFACE : NPF_LD_IFACE }) &&
+		       emit(prog, (struct npf_insn){
+				.op = NPF_JEQ,
+				.jt = match ? 0 : NPF_JFAIL,
+				.jf = match ? NPF_JFAIL : 0,
+				.k = net_if_get_by_iface(test_iface->iface) });
+	}
+
+	if (fn == npf_size_inbounds) {
+		struct npf_test_size_bounds *bounds =
+				CONTAINER_OF(test, struct npf_test_size_bounds, test);
+
+		if (!emit(prog, (struct npf_insn){ .op = NPF_LD_LEN })) {
+			return false;
+		}
+
+		if (bounds->min > 0 &&
+		    !emit(prog, (struct npf_insn){
+				.op = NPF_JGE,
+				.jf = NPF_JFAIL,
+				.k = MIN(bounds->min, UINT32_MAX) })) {
+			return false;
+		}
+
+		if (bounds->max >= UINT32_MAX) {
+			return true;
+		}
+
+		return emit(prog, (struct npf_insn){
+				.op = NPF_JGT,
+				.jt = NPF_JFAIL,
+				.k = bounds->max });
+	}
+
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (fn == npf_eth_type_match || fn == npf_eth_type_unmatch) {
+		struct npf_test_eth_type *test_eth_type =
+				CONTAINER_OF(test, struct npf_test_eth_type, test);
+
+		match = fn == npf_eth_type_match;
+
+		return emit(prog, (struct npf_insn){
+				.op = NPF_LD_H,
+				.jf = NPF_JFAIL,
+				.k = offsetof(struct net_eth_hdr, type) }) &&
+		       emit(prog, (struct npf_insn){
+				.op = NPF_JEQ,
+				.jt = match ? 0 : NPF_JFAIL,
+				.jf = match ? NPF_JFAIL : 0,
+				.k = ntohs(test_eth_type->type) });
+	}
+
+	if (fn == npf_eth_src_addr_match || fn == npf_eth_src_addr_unmatch ||
+	    fn == npf_eth_dst_addr_match || fn == npf_eth_dst_addr_unmatch) {
+		bool src = fn == npf_eth_src_addr_match ||
+			   fn == npf_eth_src_addr_unmatch;
+
+		match = fn == npf_eth_src_addr_match ||
+			fn == npf_eth_dst_addr_match;
+
+		return emit(prog, (struct npf_insn){
+				.op = NPF_ETH_ADDR,
+				.jt = match ? 0 : NPF_JFAIL,
+				.jf = match ? NPF_JFAIL : 0,
+				.k = src ? offsetof(struct net_eth_hdr, src) :
+					   offsetof(struct net_eth_hdr, dst),
+				.test = test });
+	}
+#endif
+
+	return emit(prog, (struct npf_insn){
+			.op = NPF_CALL,
+			.jf = NPF_JFAIL,
+			.test = test });
+}
+
+static bool compile(sys_slist_t *rule_head, struct npf_prog *prog)
+{
+	struct npf_rule *rule;
+
+	prog->len = 0U;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(rule_head, rule, node) {
+		uint16_t start = prog->len;
+
+		for (unsigned int i = 0; i < rule->nb_tests; i++) {
+			if (!compile_test(prog, rule->tests[i])) {
+				return false;
+			}
+		}
+
+		if (!emit(prog, (struct npf_insn){
+				.op = NPF_RET,
+				.k = rule->result })) {
+			return false;
+		}
+
+		/* Rules without tests always match, nothing after is reached */
+		if (rule->nb_tests == 0U) {
+			return true;
+		}
+
+		/* A failed test continues with the next rule */
+		for (uint16_t i = start; i < prog->len; i++) {
+			uint16_t next = prog->len - i - 1;
+
+			if (prog->insns[i].jt == NPF_JFAIL) {
+				prog->insns[i].jt = next;
+			}
+
+			if (prog->insns[i].jf == NPF_JFAIL) {
+				prog->insns[i].jf = next;
+			}
+		}
+	}
+
+	return emit(prog, (struct npf_insn){
+			.op = NPF_RET,
+			.k = sys_slist_is_empty(rule_head) ? NET_OK : NET_DROP });
+}
+
+/*
+ * Recompile the rule list after a change, into the program slot not in
+ * use, and make it the active one.
+ */
+static void update_prog(struct npf_rule_list *rules)
+{
+	struct npf_prog *prog;
+	k_spinlock_key_t key;
+	bool ok;
+
+	k_mutex_lock(&rules->prog_lock, K_FOREVER);
+
+	prog = atomic_ptr_get(&rules->prog) == &rules->progs[0] ?
+		&rules->progs[1] : &rules->progs[0];
+
+	/* Let evaluations still running the previous program in this slot
+	 * finish.
+	 */
+	while (atomic_get(&prog->users) != 0) {
+		k_msleep(1);
+	}
+
+	key = k_spin_lock(&rules->lock);
+	ok = compile(&rules->rule_head, prog);
+	k_spin_unlock(&rules->lock, key);
+
+	if (!ok) {
+		NET_DBG("rule list %p too long to compile", rules);
+	}
+
+	atomic_ptr_set(&rules->prog, ok ? prog : NULL);
+
+	k_mutex_unlock(&rules->prog_lock);
+}
+
 /*
  * Rule application
  */
@@ -84,20 +392,62 @@ static enum net_verdict lock_evaluate(struct npf_rule_list *rules, struct net_pk
 	return result;
 }
 
+static enum net_verdict prog_evaluate(struct npf_rule_list *rules, struct net_pkt *pkt)
+{
+	struct npf_prog *prog;
+	enum net_verdict result;
+
+	while (true) {
+		prog = atomic_ptr_get(&rules->prog);
+		if (prog == NULL) {
+			break;
+		}
+
+		/* The program is only ours if it is still the active one
+		 * once we are accounted as its user.
+		 */
+		atomic_inc(&prog->users);
+
+		if (atomic_ptr_get(&rules->prog) == prog) {
+			result = run_prog(prog, pkt);
+			atomic_dec(&prog->users);
+
+			return result;
+		}
+
+		atomic_dec(&prog->users);
+	}
+
+	if (sys_slist_is_empty(&rules->rule_head)) {
+		return NET_OK;
+	}
+
+	return lock_evaluate(rules, pkt);
+}
+
 bool net_pkt_filter_send_ok(struct net_pkt *pkt)
 {
-	enum net_verdict result = lock_evaluate(&npf_send_rules, pkt);
+	enum net_verdict result = prog_evaluate(&npf_send_rules, pkt);
 
 	return result == NET_OK;
 }
 
 bool net_pkt_filter_recv_ok(struct net_pkt *pkt)
 {
-	enum net_verdict result = lock_evaluate(&npf_recv_rules, pkt);
+	enum net_verdict result = prog_evaluate(&npf_recv_rules, pkt);
 
 	return result == NET_OK;
 }
 
+#if defined(CONFIG_NET_CAPTURE)
+bool net_pkt_filter_capture_ok(struct net_pkt *pkt)
+{
+	enum net_verdict result = prog_evaluate(&npf_capture_rules, pkt);
+
+	return result == NET_OK;
+}
+#endif
+
 /*
  * Rule management
  */
@@ -110,6 +460,8 @@ void npf_insert_rule(struct npf_rule_list *rules, struct npf_rule *rule)
 	sys_slist_prepend(&rules->rule_head, &rule->node);
 
 	k_spin_unlock(&rules->lock, key);
+
+	update_prog(rules);
 }
 
 void npf_append_rule(struct npf_rule_list *rules, struct npf_rule *rule)
@@ -123,6 +475,8 @@ void npf_append_rule(struct npf_rule_list *rules, struct npf_rule *rule)
 	sys_slist_append(&rules->rule_head, &rule->node);
 
 	k_spin_unlock(&rules->lock, key);
+
+	update_prog(rules);
 }
 
 bool npf_remove_rule(struct npf_rule_list *rules, struct npf_rule *rule)
@@ -132,6 +486,11 @@ bool npf_remove_rule(struct npf_rule_list *rules, struct npf_rule *rule)
 
 	k_spin_unlock(&rules->lock, key);
 	NET_DBG("removing rule %p from %p: %d", rule, rules, result);
+
+	if (result) {
+		update_prog(rules);
+	}
+
 	return result;
 }
 
@@ -146,6 +505,11 @@ bool npf_remove_all_rules(struct npf_rule_list *rules)
 	}
 
 	k_spin_unlock(&rules->lock, key);
+
+	if (result) {
+		update_prog(rules);
+	}
+
 	return result;
 }
 
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief Cache-aware B+tree versus red/black tree benchmark
+ *
+ * Both trees hold the same set of 64-bit keys inserted in random
+ * order. Each operation is timed over the whole set and reported as
+ * average cycles per operation.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/sys/btree.h>
+#include <zephyr/sys/rb.h>
+
+#define MAX_ELEMENTS CONFIG_BTREE_PERF_MAX_ELEMENTS
+
+struct container_node {
+	struct rbnode node;
+	sys_btree_key_t key;
+};
+
+static struct container_node rb_nodes[MAX_ELEMENTS];
+static uint32_t order[MAX_ELEMENTS];
+static struct rbtree rb_tree;
+
+SYS_BTREE_DEFINE(btree, SYS_BTREE_POOL_SIZE(MAX_ELEMENTS));
+
+static bool node_lessthan(struct rbnode *a, struct rbnode *b)
+{
+	return CONTAINER_OF(a, struct container_node, node)->key <
+	       CONTAINER_OF(b, struct container_node, node)->key;
+}
+
+/* Deterministic shuffle, so that runs are comparable */
+static void shuffle(uint32_t count)
+{
+	uint32_t state = 2463534242U;
+
+	for (uint32_t i = 0; i < count; i++) {
+		order[i] = i;
+	}
+
+	for (uint32_t i = count - 1; i > 0; i--) {
+		uint32_t j, tmp;
+
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+
+		j = state % (i + 1);
+		tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+}
+
+static void report(const char *op, uint32_t count, uint32_t rb_cycles,
+		   uint32_t btree_cycles)
+{
+	TC_PRINT("%6u elements %-8s rbtree: %6u btree: %6u cycles/op\n",
+		 count, op, rb_cycles / count, btree_cycles / count);
+}
+
+static void run_benchmark(uint32_t count)
+{
+	struct sys_btree_iter iter;
+	struct rbnode *rb_node;
+	uint32_t rb_cycles, bt_cycles, start;
+	uint64_t rb_sum = 0, bt_sum = 0;
+	sys_btree_key_t key;
+	int ret;
+
+	shuffle(count);
+
+	(void)memset(&rb_tree, 0, sizeof(rb_tree));
+	rb_tree.lessthan_fn = node_lessthan;
+	sys_btree_init(&btree, btree.pool, btree.pool_size);
+
+	for (uint32_t i = 0; i < count; i++) {
+		rb_nodes[i].key = (sys_btree_key_t)i * 7;
+	}
+
+	/* Insert */
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < count; i++) {
+		rb_insert(&rb_tree, &rb_nodes[order[i]].node);
+	}
+	rb_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < count; i++) {
+		ret = sys_btree_insert(&btree, rb_nodes[order[i]].key,
+				       &rb_nodes[order[i]]);
+		zassert_equal(ret, 0, "insert failed: %d", ret);
+	}
+	bt_cycles = k_cycle_get_32() - start;
+	report("insert", count, rb_cycles, bt_cycles);
+
+	/* Lookup */
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < count; i++) {
+		zassert_true(rb_contains(&rb_tree, &rb_nodes[order[i]].node));
+	}
+	rb_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < count; i++) {
+		zassert_true(sys_btree_contains(&btree, rb_nodes[order[i]].key));
+	}
+	bt_cycles = k_cycle_get_32() - start;
+	report("lookup", count, rb_cycles, bt_cycles);
+
+	/* Minimum */
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < count; i++) {
+		zassert_equal(rb_get_min(&rb_tree), &rb_nodes[0].node);
+	}
+	rb_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < count; i++) {
+		zassert_equal(sys_btree_get_min(&btree, &key, NULL), 0);
+		zassert_equal(key, 0);
+	}
+	bt_cycles = k_cycle_get_32() - start;
+	report("min", count, rb_cycles, bt_cycles);
+
+	/* In-order iteration */
+	start = k_cycle_get_32();
+	RB_FOR_EACH(&rb_tree, rb_node) {
+		rb_sum += CONTAINER_OF(rb_node, struct container_node, node)->key;
+	}
+	rb_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	SYS_BTREE_FOR_EACH(&btree, iter) {
+		bt_sum += sys_btree_iter_key(&iter);
+	}
+	bt_cycles = k_cycle_get_32() - start;
+	zassert_equal(rb_sum, bt_sum);
+	report("foreach", count, rb_cycles, bt_cycles);
+
+	/* Remove */
+	shuffle(count);
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < count; i++) {
+		rb_remove(&rb_tree, &rb_nodes[order[i]].node);
+	}
+	rb_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < count; i++) {
+		ret = sys_btree_remove(&btree, rb_nodes[order[i]].key, NULL);
+		zassert_equal(ret, 0, "remove failed: %d", ret);
+	}
+	bt_cycles = k_cycle_get_32() - start;
+	report("remove", count, rb_cycles, bt_cycles);
+
+	zassert_is_null(rb_tree.root);
+	zassert_true(sys_btree_is_empty(&btree));
+}
+
+ZTEST(btree_perf, test_btree_vs_rbtree)
+{
+	for (uint32_t count = 1000; count <= MAX_ELEMENTS; count *= 10) {
+		run_benchmark(count);
+	}
+}
+
+ZTEST_SUITE(btree_perf, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @brief Hashmap load factor versus lookup latency benchmark
+ *
+ * Every enabled Hashmap implementation is filled up to a range of load
+ * factors over the same number of buckets, after which successful and
+ * unsuccessful lookups are timed and reported as average cycles per
+ * lookup.
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/sys/hash_map.h>
+
+#define N_BUCKETS CONFIG_HASH_MAP_PERF_N_BUCKETS
+
+BUILD_ASSERT(IS_POWER_OF_TWO(N_BUCKETS), "N_BUCKETS must be a power of two");
+
+static const uint8_t load_factors[] = {25, 50, 75, 90};
+
+#define DEFINE_MAPS(_type)                                                                         \
+	SYS_HASHMAP_##_type##_DEFINE_STATIC_ADVANCED(_type##_25, sys_hash32,                       \
+						     SYS_HASHMAP_DEFAULT_ALLOCATOR,                \
+						     SYS_HASHMAP_CONFIG(SIZE_MAX, 25));            \
+	SYS_HASHMAP_##_type##_DEFINE_STATIC_ADVANCED(_type##_50, sys_hash32,                       \
+						     SYS_HASHMAP_DEFAULT_ALLOCATOR,                \
+						     SYS_HASHMAP_CONFIG(SIZE_MAX, 50));            \
+	SYS_HASHMAP_##_type##_DEFINE_STATIC_ADVANCED(_type##_75, sys_hash32,                       \
+						     SYS_HASHMAP_DEFAULT_ALLOCATOR,                \
+						     SYS_HASHMAP_CONFIG(SIZE_MAX, 75));            \
+	SYS_HASHMAP_##_type##_DEFINE_STATIC_ADVANCED(_type##_90, sys_hash32,                       \
+						     SYS_HASHMAP_DEFAULT_ALLOCATOR,                \
+						     SYS_HASHMAP_CONFIG(SIZE_MAX, 90));            \
+	static struct sys_hashmap *const _type##_maps[] = {&_type##_25, &_type##_50, &_type##_75,  \
+							   &_type##_90}
+
+DEFINE_MAPS(SC);
+DEFINE_MAPS(OA_LP);
+DEFINE_MAPS(SWISS);
+#ifdef CONFIG_SYS_HASH_MAP_CXX
+DEFINE_MAPS(CXX);
+#endif
+
+struct backend {
+	const char *name;
+	struct sys_hashmap *const *maps;
+};
+
+static const struct backend backends[] = {
+	{"sc", SC_maps},
+	{"oa_lp", OA_LP_maps},
+	{"swiss", SWISS_maps},
+#ifdef CONFIG_SYS_HASH_MAP_CXX
+	{"cxx", CXX_maps},
+#endif
+};
+
+/* Spread keys over the whole 64-bit space, distinct for distinct i */
+static inline uint64_t key_of(uint32_t i)
+{
+	return (uint64_t)i * 0x9e3779b97f4a7c15ULL;
+}
+
+static void run_benchmark(const struct backend *backend, size_t lf_idx)
+{
+	uint32_t start, hit_cycles, miss_cycles;
+	struct sys_hashmap *map = backend->maps[lf_idx];
+	const uint32_t count = load_factors[lf_idx] * N_BUCKETS / 100;
+	uint64_t value;
+	int ret;
+
+	for (uint32_t i = 0; i < count; i++) {
+		ret = sys_hashmap_insert(map, key_of(i), i, NULL);
+		zassert_equal(ret, 1, "%s: insert failed: %d", backend->name, ret);
+	}
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < count; i++) {
+		zassert_true(sys_hashmap_get(map, key_of(i), &value));
+	}
+	hit_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (uint32_t i = count; i < 2 * count; i++) {
+		zassert_false(sys_hashmap_get(map, key_of(i), &value));
+	}
+	miss_cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("load factor %3u%% %-6s hit: %6u miss: %6u cycles/lookup\n",
+		 sys_hashmap_load_factor(map), backend->name, hit_cycles / count,
+		 miss_cycles / count);
+
+	sys_hashmap_clear(map, NULL, NULL);
+}
+
+ZTEST(hash_map_perf, test_load_factor_vs_lookup)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(load_factors); i++) {
+		for (size_t j = 0; j < ARRAY_SIZE(backends); j++) {
+			run_benchmark(&backends[j], i);
+		}
+	}
+}
+
+ZTEST_SUITE(hash_map_perf, NULL, NULL, NULL, NULL, NULL);
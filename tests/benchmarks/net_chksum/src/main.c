@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/ztest.h>
+
+#include "net_private.h"
+
+/* Internet checksum microbenchmark, sums buffers of the sizes typically
+ * seen on the wire, from a bare TCP ACK to a full Ethernet frame, and
+ * reports the average cost per call and per byte.
+ */
+
+#define N_RUNS 1000
+
+static const size_t chksum_lens[] = { 40, 64, 128, 256, 512, 576, 1024,
+				      1280, 1460, 1500 };
+
+static uint8_t buf[1500 + 1] __aligned(sizeof(uint64_t));
+
+static void bench_chksum(const uint8_t *data, size_t len, bool aligned)
+{
+	volatile uint16_t sum = 0U;
+	uint32_t start, cycles;
+	uint64_t ns;
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < N_RUNS; i++) {
+		sum = calc_chksum(sum, data, len);
+	}
+
+	cycles = k_cycle_get_32() - start;
+	ns = k_cyc_to_ns_floor64(cycles);
+
+	TC_PRINT("%s len %4zu: %6llu ns/call %4llu ps/byte\n",
+		 aligned ? "  aligned" : "unaligned", len,
+		 (unsigned long long)(ns / N_RUNS),
+		 (unsigned long long)((ns * 1000U) / ((uint64_t)N_RUNS * len)));
+}
+
+ZTEST(net_chksum_perf, test_chksum_perf)
+{
+	for (int i = 0; i < sizeof(buf); i++) {
+		buf[i] = (uint8_t)(i * 31 + 7);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(chksum_lens); i++) {
+		bench_chksum(buf, chksum_lens[i], true);
+	}
+
+	/* Packet payloads rarely start at an aligned address */
+	for (int i = 0; i < ARRAY_SIZE(chksum_lens); i++) {
+		bench_chksum(buf + 1, chksum_lens[i], false);
+	}
+}
+
+ZTEST_SUITE(net_chksum_perf, NULL, NULL, NULL, NULL, NULL);
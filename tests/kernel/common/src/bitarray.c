@@ -502,6 +502,176 @@ ZTEST(bitarray, test_bitarray_alloc_free)
 	alloc_and_free_interval();
 }
 
+/**
+ * @brief Test bitarrays scatter allocation
+ *
+ * @see sys_bitarray_alloc_scatter()
+ */
+ZTEST(bitarray, test_bitarray_alloc_scatter)
+{
+	int ret;
+	struct sys_bitarray_region regions[4];
+	uint32_t ba_expected[4];
+
+	/* Bitarrays have embedded spinlocks and can't on the stack. */
+	if (IS_ENABLED(CONFIG_KERNEL_COHERENCE)) {
+		ztest_test_skip();
+	}
+
+	SYS_BITARRAY_DEFINE(ba, 128);
+
+	printk("Testing bit array scatter alloc\n");
+
+	/* Leave bits 0-7, 40-47 and 120-127 free */
+	zassert_equal(sys_bitarray_set_region(&ba, 32, 8), 0, NULL);
+	zassert_equal(sys_bitarray_set_region(&ba, 72, 48), 0, NULL);
+
+	ba_expected[0] = 0xFFFFFF00;
+	ba_expected[1] = 0xFFFF00FF;
+	ba_expected[2] = 0xFFFFFFFF;
+	ba_expected[3] = 0x00FFFFFF;
+
+	zassert_true(cmp_u32_arrays(ba.bundles, ba_expected, ba.num_bundles),
+		     "sys_bitarray_set_region() failed bits comparison");
+
+	ret = sys_bitarray_alloc_scatter(&ba, 0, ARRAY_SIZE(regions), regions);
+	zassert_equal(ret, -EINVAL, "sys_bitarray_alloc_scatter() should fail but not");
+
+	ret = sys_bitarray_alloc_scatter(&ba, 8, 0, regions);
+	zassert_equal(ret, -EINVAL, "sys_bitarray_alloc_scatter() should fail but not");
+
+	/* A single region is used whenever one is large enough */
+	ret = sys_bitarray_alloc_scatter(&ba, 8, ARRAY_SIZE(regions), regions);
+	zassert_equal(ret, 1, "sys_bitarray_alloc_scatter() returned %d", ret);
+	zassert_equal(regions[0].offset, 0, "offset expected 0, got %u",
+		      regions[0].offset);
+	zassert_equal(regions[0].num_bits, 8, "num_bits expected 8, got %u",
+		      regions[0].num_bits);
+
+	ret = sys_bitarray_free(&ba, 8, 0);
+	zassert_equal(ret, 0, "sys_bitarray_free() failed: %d", ret);
+
+	/* Not enough regions allowed, nothing must be allocated */
+	ret = sys_bitarray_alloc_scatter(&ba, 20, 2, regions);
+	zassert_equal(ret, -ENOSPC, "sys_bitarray_alloc_scatter() should fail but not");
+	zassert_true(cmp_u32_arrays(ba.bundles, ba_expected, ba.num_bundles),
+		     "sys_bitarray_alloc_scatter() failed bits comparison");
+
+	/* Not enough free bits, nothing must be allocated */
+	ret = sys_bitarray_alloc_scatter(&ba, 25, ARRAY_SIZE(regions), regions);
+	zassert_equal(ret, -ENOSPC, "sys_bitarray_alloc_scatter() should fail but not");
+	zassert_true(cmp_u32_arrays(ba.bundles, ba_expected, ba.num_bundles),
+		     "sys_bitarray_alloc_scatter() failed bits comparison");
+
+	/* Free regions are collected from the start */
+	ret = sys_bitarray_alloc_scatter(&ba, 20, ARRAY_SIZE(regions), regions);
+	zassert_equal(ret, 3, "sys_bitarray_alloc_scatter() returned %d", ret);
+	zassert_equal(regions[0].offset, 0, NULL);
+	zassert_equal(regions[0].num_bits, 8, NULL);
+	zassert_equal(regions[1].offset, 40, NULL);
+	zassert_equal(regions[1].num_bits, 8, NULL);
+	zassert_equal(regions[2].offset, 120, NULL);
+	zassert_equal(regions[2].num_bits, 4, NULL);
+
+	ba_expected[0] = 0xFFFFFFFF;
+	ba_expected[1] = 0xFFFFFFFF;
+	ba_expected[3] = 0x0FFFFFFF;
+	zassert_true(cmp_u32_arrays(ba.bundles, ba_expected, ba.num_bundles),
+		     "sys_bitarray_alloc_scatter() failed bits comparison");
+
+	for (ret = 0; ret < 3; ret++) {
+		zassert_equal(sys_bitarray_free(&ba, regions[ret].num_bits,
+						regions[ret].offset), 0,
+			      "sys_bitarray_free() failed");
+	}
+
+	ba_expected[0] = 0xFFFFFF00;
+	ba_expected[1] = 0xFFFF00FF;
+	ba_expected[3] = 0x00FFFFFF;
+	zassert_true(cmp_u32_arrays(ba.bundles, ba_expected, ba.num_bundles),
+		     "sys_bitarray_free() failed bits comparison");
+}
+
+/**
+ * @brief Test bitarrays with more than one summary word
+ *
+ * With more than 32 bundles the summary of full and used bundles spans
+ * several words, so searches have to cross from one summary word to the
+ * next one.
+ *
+ * @see sys_bitarray_alloc(), sys_bitarray_is_region_cleared()
+ */
+ZTEST(bitarray, test_bitarray_summary_words)
+{
+	int ret;
+	int val;
+	size_t offset;
+
+	SYS_BITARRAY_DEFINE_STATIC(ba, 64 * 32);
+
+	printk("Testing bit array with more than one summary word\n");
+
+	zassert_equal(ba.num_bundles, 64, NULL);
+
+	/* First summary word and one more bundle are full */
+	ret = sys_bitarray_set_region(&ba, 33 * 32, 0);
+	zassert_equal(ret, 0, "sys_bitarray_set_region() failed: %d", ret);
+
+	ret = sys_bitarray_alloc(&ba, 16, &offset);
+	zassert_equal(ret, 0, "sys_bitarray_alloc() failed: %d", ret);
+	zassert_equal(offset, 33 * 32, "offset expected %d, got %zu",
+		      33 * 32, offset);
+
+	ret = sys_bitarray_free(&ba, 16, offset);
+	zassert_equal(ret, 0, "sys_bitarray_free() failed: %d", ret);
+
+	/* Free region straddling the first and the second summary word */
+	ret = sys_bitarray_free(&ba, 3 * 32 - 16, 30 * 32 + 16);
+	zassert_equal(ret, 0, "sys_bitarray_free() failed: %d", ret);
+
+	ret = sys_bitarray_alloc(&ba, 128, &offset);
+	zassert_equal(ret, 0, "sys_bitarray_alloc() failed: %d", ret);
+	zassert_equal(offset, 30 * 32 + 16, "offset expected %d, got %zu",
+		      30 * 32 + 16, offset);
+	zassert_true(sys_bitarray_is_region_set(&ba, 30 * 32 + 16 + 128, 0),
+		     "sys_bitarray_is_region_set() failed");
+
+	/* A set bit in the second summary word splits the free space */
+	ret = sys_bitarray_set_bit(&ba, 40 * 32 + 5);
+	zassert_equal(ret, 0, "sys_bitarray_set_bit() failed: %d", ret);
+
+	ret = sys_bitarray_alloc(&ba, 512, &offset);
+	zassert_equal(ret, 0, "sys_bitarray_alloc() failed: %d", ret);
+	zassert_equal(offset, 40 * 32 + 6, "offset expected %d, got %zu",
+		      40 * 32 + 6, offset);
+
+	ret = sys_bitarray_test_bit(&ba, 40 * 32 + 4, &val);
+	zassert_equal(ret, 0, "sys_bitarray_test_bit() failed: %d", ret);
+	zassert_equal(val, 0, "bit %d should be cleared", 40 * 32 + 4);
+
+	ret = sys_bitarray_alloc(&ba, 512, &offset);
+	zassert_equal(ret, -ENOSPC, "sys_bitarray_alloc() should fail but not");
+
+	ret = sys_bitarray_free(&ba, 512, 40 * 32 + 6);
+	zassert_equal(ret, 0, "sys_bitarray_free() failed: %d", ret);
+	ret = sys_bitarray_clear_bit(&ba, 40 * 32 + 5);
+	zassert_equal(ret, 0, "sys_bitarray_clear_bit() failed: %d", ret);
+	ret = sys_bitarray_free(&ba, 30 * 32 + 16 + 128, 0);
+	zassert_equal(ret, 0, "sys_bitarray_free() failed: %d", ret);
+
+	zassert_true(sys_bitarray_is_region_cleared(&ba, 64 * 32, 0),
+		     "sys_bitarray_is_region_cleared() failed");
+
+	/* A used bundle in the second summary word is seen from the first */
+	ret = sys_bitarray_set_bit(&ba, 50 * 32 + 7);
+	zassert_equal(ret, 0, "sys_bitarray_set_bit() failed: %d", ret);
+
+	zassert_false(sys_bitarray_is_region_cleared(&ba, 64 * 32, 0),
+		      "sys_bitarray_is_region_cleared() should fail but not");
+	zassert_true(sys_bitarray_is_region_cleared(&ba, 50 * 32 + 7, 0),
+		     "sys_bitarray_is_region_cleared() failed");
+}
+
 ZTEST(bitarray, test_bitarray_region_set_clear)
 {
 	int ret;
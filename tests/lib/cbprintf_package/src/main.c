@@ -893,6 +893,74 @@ ZTEST(cbprintf_package, test_cbprintf_package_convert)
 
 }
 
+#ifdef CONFIG_CBPRINTF_PACKAGE_FMT_DESC
+ZTEST(cbprintf_package, test_cbprintf_fmt_desc_package)
+{
+	int len, rt_len, clen;
+	int i = 100;
+	long long lli = 0x1122334455667788;
+	char str[] = "rw str";
+	static const char test_str[] = "test %d %llx %s %c";
+	struct test_cbprintf_covert_ctx ctx;
+	struct cbprintf_package_hdr_ext *hdr;
+	uint32_t flags = CBPRINTF_PACKAGE_ADD_RW_STR_POS;
+
+#define TEST_FMT test_str, i, lli, str, 'c'
+	char exp_str[128];
+
+	snprintfcb(exp_str, sizeof(exp_str), TEST_FMT);
+
+	CBPRINTF_FMT_DESC_PACKAGE(NULL, 0, len, flags, TEST_FMT);
+	zassert_true(len > 0);
+
+	/* Types are not stored in the package, thus it has the same size as
+	 * the one created by parsing the format string.
+	 */
+	rt_len = cbprintf_package(NULL, 0, flags, TEST_FMT);
+	zassert_equal(len, rt_len);
+
+	uint8_t __aligned(CBPRINTF_PACKAGE_ALIGNMENT) package[len];
+
+	CBPRINTF_FMT_DESC_PACKAGE(package, sizeof(package) - 1, rt_len, flags, TEST_FMT);
+	zassert_equal(rt_len, -ENOSPC);
+
+	CBPRINTF_FMT_DESC_PACKAGE(package, sizeof(package), rt_len, flags, TEST_FMT);
+	zassert_equal(len, rt_len);
+
+	hdr = (struct cbprintf_package_hdr_ext *)package;
+	zassert_true(hdr->hdr.desc.pkg_flags & CBPRINTF_PACKAGE_FMT_DESC);
+	zassert_equal(((const struct cbprintf_fmt_desc *)hdr->fmt)->fmt, test_str);
+	zassert_equal(hdr->hdr.desc.rw_str_cnt, 1);
+
+	check_package(package, len, exp_str);
+
+	/* Convert to self-contained package and expand the descriptor. */
+	memset(&ctx, 0, sizeof(ctx));
+	flags = CBPRINTF_PACKAGE_CONVERT_RW_STR | CBPRINTF_PACKAGE_CONVERT_EXPAND_FMT_DESC;
+	clen = cbprintf_package_convert(package, len, NULL, NULL, flags, NULL, 0);
+	zassert_true(clen > 0);
+
+	clen = cbprintf_package_convert(package, len, convert_cb, &ctx, flags, NULL, 0);
+	zassert_equal((int)ctx.offset, clen);
+
+	/* Input package is not modified. */
+	zassert_true(hdr->hdr.desc.pkg_flags & CBPRINTF_PACKAGE_FMT_DESC);
+
+	hdr = (struct cbprintf_package_hdr_ext *)ctx.buf;
+	zassert_false(hdr->hdr.desc.pkg_flags & CBPRINTF_PACKAGE_FMT_DESC);
+	zassert_equal(hdr->fmt, test_str);
+	zassert_equal(hdr->hdr.desc.str_cnt, 1);
+
+	check_package(ctx.buf, ctx.offset, exp_str);
+#undef TEST_FMT
+
+	/* Format string without arguments. */
+	CBPRINTF_FMT_DESC_PACKAGE(package, sizeof(package), len, 0, "no arguments");
+	zassert_true(len > 0);
+	check_package(package, len, "no arguments");
+}
+#endif /* CONFIG_CBPRINTF_PACKAGE_FMT_DESC */
+
 /**
  * @brief Log information about variable sizes and alignment.
  *
@@ -14,6 +14,9 @@
 SYS_HASHMAP_DEFINE(map);
 SYS_HASHMAP_DEFAULT_DEFINE_ADVANCED(custom_load_factor_map, sys_hash32, realloc,
 				    SYS_HASHMAP_CONFIG(SIZE_MAX, CUSTOM_LOAD_FACTOR));
+SYS_HASHMAP_DEFAULT_DEFINE_ADVANCED(incremental_map, sys_hash32, SYS_HASHMAP_DEFAULT_ALLOCATOR,
+				    SYS_HASHMAP_CONFIG(SIZE_MAX, SYS_HASHMAP_DEFAULT_LOAD_FACTOR,
+						       INCREMENTAL_REHASH_STEP));
 
 static void *setup(void)
 {
@@ -28,6 +31,7 @@ static void after(void *arg)
 
 	(void)sys_hashmap_clear(&map, NULL, NULL);
 	(void)sys_hashmap_clear(&custom_load_factor_map, NULL, NULL);
+	(void)sys_hashmap_clear(&incremental_map, NULL, NULL);
 }
 
 ZTEST_SUITE(hash_map, NULL, setup, NULL, after, NULL);
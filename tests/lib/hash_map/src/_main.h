@@ -9,10 +9,12 @@
 
 #include <zephyr/sys/hash_map.h>
 
-#define MANY		   CONFIG_TEST_LIB_HASH_MAP_MAX_ENTRIES
-#define CUSTOM_LOAD_FACTOR 42
+#define MANY			CONFIG_TEST_LIB_HASH_MAP_MAX_ENTRIES
+#define CUSTOM_LOAD_FACTOR	42
+#define INCREMENTAL_REHASH_STEP 1
 
 extern struct sys_hashmap map;
 extern struct sys_hashmap custom_load_factor_map;
+extern struct sys_hashmap incremental_map;
 
 #endif
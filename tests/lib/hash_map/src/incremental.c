@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/sys/hash_map.h>
+
+#include "_main.h"
+
+static void count_callback(uint64_t key, uint64_t value, void *cookie)
+{
+	size_t *count = (size_t *)cookie;
+
+	zassert_equal(key, value);
+	++*count;
+}
+
+/* Every entry must remain reachable while entries move between tables */
+static void check_entries(struct sys_hashmap *map, size_t n)
+{
+	size_t count = 0;
+	uint64_t value;
+
+	zassert_equal(n, sys_hashmap_size(map));
+
+	for (size_t i = 0; i < n; ++i) {
+		zassert_true(sys_hashmap_get(map, i, &value), "key %zu not found", i);
+		zassert_equal(i, value);
+	}
+
+	zassert_false(sys_hashmap_contains_key(map, n));
+
+	sys_hashmap_foreach(map, count_callback, &count);
+	zassert_equal(n, count);
+}
+
+ZTEST(hash_map, test_incremental_rehash)
+{
+	int ret;
+	uint64_t old_value;
+	struct sys_hashmap *const map = &incremental_map;
+
+	zassert_equal(map->config->rehash_step, INCREMENTAL_REHASH_STEP);
+	zassert_true(sys_hashmap_is_empty(map));
+
+	for (size_t i = 0; i < MANY; ++i) {
+		ret = sys_hashmap_insert(map, i, i, NULL);
+		zassert_equal(1, ret, "failed to insert (%zu, %zu): %d", i, i, ret);
+		check_entries(map, i + 1);
+		zassert_true(sys_hashmap_load_factor(map) <= SYS_HASHMAP_DEFAULT_LOAD_FACTOR);
+	}
+
+	for (size_t i = 0; i < MANY; ++i) {
+		zassert_equal(0, sys_hashmap_insert(map, i, i, &old_value));
+		zassert_equal(i, old_value);
+	}
+
+	check_entries(map, MANY);
+
+	for (size_t i = MANY; i > 0; --i) {
+		zassert_true(sys_hashmap_remove(map, i - 1, NULL));
+		check_entries(map, i - 1);
+	}
+
+	/* after removing the last node, all tables should be freed */
+	zassert_equal(map->data->buckets, NULL);
+	zassert_equal(map->data->n_buckets, 0);
+}
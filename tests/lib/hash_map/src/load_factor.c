@@ -55,3 +55,42 @@ ZTEST(hash_map, test_load_factor_custom)
 		zassert_true(load_factor <= CUSTOM_LOAD_FACTOR);
 	}
 }
+
+#ifdef CONFIG_SYS_HASH_MAP_SWISS
+#define HIGH_LOAD_FACTOR 250
+
+SYS_HASHMAP_SWISS_DEFINE_STATIC_ADVANCED(high_load_factor_map, sys_hash32,
+					 SYS_HASHMAP_DEFAULT_ALLOCATOR,
+					 SYS_HASHMAP_CONFIG(SIZE_MAX, HIGH_LOAD_FACTOR));
+
+ZTEST(hash_map, test_load_factor_high_swiss)
+{
+	int ret;
+	size_t n_buckets;
+	struct sys_hashmap *const map = &high_load_factor_map;
+
+	for (size_t i = 0; i < MANY; ++i) {
+		ret = sys_hashmap_insert(map, i, i, NULL);
+		zassert_equal(1, ret, "failed to insert (%zu, %zu): %d", i, i, ret);
+	}
+
+	for (size_t i = 0; i < MANY / 2; ++i) {
+		zassert_equal(true, sys_hashmap_remove(map, i, NULL));
+	}
+
+	/* alternating insert / remove must neither grow nor shrink the table */
+	n_buckets = map->data->n_buckets;
+	for (size_t i = 0; i < MANY; ++i) {
+		ret = sys_hashmap_insert(map, MANY, MANY, NULL);
+		zassert_equal(1, ret, "failed to insert (%d, %d): %d", MANY, MANY, ret);
+		zassert_equal(true, sys_hashmap_remove(map, MANY, NULL));
+		zassert_equal(n_buckets, map->data->n_buckets);
+	}
+
+	for (size_t i = MANY / 2; i < MANY; ++i) {
+		zassert_equal(true, sys_hashmap_remove(map, i, NULL));
+	}
+
+	zassert_true(sys_hashmap_is_empty(map));
+}
+#endif
@@ -588,6 +588,117 @@ ZTEST(lib_mem_block, test_mem_block_alloc_free_contiguous)
 #endif
 }
 
+ZTEST(lib_mem_block, test_mem_block_alloc_free_scatter)
+{
+	int i, ret, val;
+	void *block;
+	struct sys_mem_blocks_region regions[4];
+
+	ret = sys_mem_blocks_alloc_contiguous(&mem_block_01, NUM_BLOCKS, &block);
+	zassert_equal(ret, 0,
+		      "sys_mem_blocks_alloc_contiguous failed (%d)", ret);
+
+	/* leave only blocks 1, 4 and 5 free */
+	ret = sys_mem_blocks_free_contiguous(&mem_block_01, mem_block_01.buffer+BLK_SZ*1, 1);
+	zassert_equal(ret, 0,
+		      "sys_mem_blocks_free_contiguous failed (%d)", ret);
+	ret = sys_mem_blocks_free_contiguous(&mem_block_01, mem_block_01.buffer+BLK_SZ*4, 2);
+	zassert_equal(ret, 0,
+		      "sys_mem_blocks_free_contiguous failed (%d)", ret);
+
+	ret = sys_mem_blocks_alloc_scatter(&mem_block_01, 0, ARRAY_SIZE(regions), regions);
+	zassert_equal(ret, 0,
+		      "sys_mem_blocks_alloc_scatter should allocate nothing (%d)", ret);
+
+	/* a single region is used if possible */
+	ret = sys_mem_blocks_alloc_scatter(&mem_block_01, 2, ARRAY_SIZE(regions), regions);
+	zassert_equal(ret, 1,
+		      "sys_mem_blocks_alloc_scatter failed (%d)", ret);
+	zassert_equal(regions[0].block, mem_block_01.buffer+BLK_SZ*4,
+		      "sys_mem_blocks_alloc_scatter failed, %p != %p",
+		      regions[0].block, mem_block_01.buffer+BLK_SZ*4);
+	zassert_equal(regions[0].count, 2,
+		      "sys_mem_blocks_alloc_scatter failed, %u != 2", regions[0].count);
+
+	ret = sys_mem_blocks_free_scatter(&mem_block_01, 1, regions);
+	zassert_equal(ret, 0,
+		      "sys_mem_blocks_free_scatter failed (%d)", ret);
+
+	/* not enough blocks in a single region */
+	ret = sys_mem_blocks_alloc_scatter(&mem_block_01, 3, 1, regions);
+	zassert_equal(ret, -ENOMEM,
+		      "sys_mem_blocks_alloc_scatter should fail (%d)", ret);
+
+	/* not enough blocks at all */
+	ret = sys_mem_blocks_alloc_scatter(&mem_block_01, 4, ARRAY_SIZE(regions), regions);
+	zassert_equal(ret, -ENOMEM,
+		      "sys_mem_blocks_alloc_scatter should fail (%d)", ret);
+
+	ret = sys_mem_blocks_alloc_scatter(&mem_block_01, 3, ARRAY_SIZE(regions), regions);
+	zassert_equal(ret, 2,
+		      "sys_mem_blocks_alloc_scatter failed (%d)", ret);
+	zassert_equal(regions[0].block, mem_block_01.buffer+BLK_SZ*1,
+		      "sys_mem_blocks_alloc_scatter failed, %p != %p",
+		      regions[0].block, mem_block_01.buffer+BLK_SZ*1);
+	zassert_equal(regions[0].count, 1,
+		      "sys_mem_blocks_alloc_scatter failed, %u != 1", regions[0].count);
+	zassert_equal(regions[1].block, mem_block_01.buffer+BLK_SZ*4,
+		      "sys_mem_blocks_alloc_scatter failed, %p != %p",
+		      regions[1].block, mem_block_01.buffer+BLK_SZ*4);
+	zassert_equal(regions[1].count, 2,
+		      "sys_mem_blocks_alloc_scatter failed, %u != 2", regions[1].count);
+
+	/* all blocks should be taken */
+	for (i = 0; i < NUM_BLOCKS; i++) {
+		ret = sys_bitarray_test_bit(mem_block_01.bitmap, i, &val);
+		zassert_equal(val, 1,
+		     "sys_mem_blocks_alloc_scatter failed, bit %i should be set", i);
+	}
+
+	ret = sys_mem_blocks_free_scatter(&mem_block_01, 2, regions);
+	zassert_equal(ret, 0,
+		      "sys_mem_blocks_free_scatter failed (%d)", ret);
+
+	for (i = 0; i < NUM_BLOCKS; i++) {
+		ret = sys_bitarray_test_bit(mem_block_01.bitmap, i, &val);
+		switch (i) {
+		case 1:
+		case 4:
+		case 5:
+			zassert_equal(val, 0,
+			     "sys_mem_blocks_free_scatter failed, bit %i should be cleared", i);
+			break;
+		default:
+			zassert_equal(val, 1,
+			     "sys_mem_blocks_free_scatter failed, bit %i should be set", i);
+			break;
+		}
+	}
+
+	/* out of bounds region, nothing must be freed */
+	regions[0].block = mem_block_01.buffer;
+	regions[0].count = 1;
+	regions[1].block = mem_block_01.buffer+BLK_SZ*(NUM_BLOCKS-1);
+	regions[1].count = 2;
+	ret = sys_mem_blocks_free_scatter(&mem_block_01, 2, regions);
+	zassert_equal(ret, -EFAULT,
+		      "sys_mem_blocks_free_scatter should fail (%d)", ret);
+
+	ret = sys_bitarray_test_bit(mem_block_01.bitmap, 0, &val);
+	zassert_equal(val, 1,
+		      "sys_mem_blocks_free_scatter failed, bit 0 should be set");
+
+	regions[0].block = mem_block_01.buffer;
+	regions[0].count = 1;
+	regions[1].block = mem_block_01.buffer+BLK_SZ*2;
+	regions[1].count = 2;
+	regions[2].block = mem_block_01.buffer+BLK_SZ*6;
+	regions[2].count = 2;
+	ret = sys_mem_blocks_free_scatter(&mem_block_01, 3, regions);
+	zassert_equal(ret, 0,
+		      "sys_mem_blocks_free_scatter failed (%d)", ret);
+}
+
 ZTEST(lib_mem_block, test_multi_mem_block_alloc_free)
 {
 	int ret;
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <zephyr/ztest.h>
+#include <zephyr/ztress.h>
+#include <zephyr/sys/ring_buffer.h>
+#include <zephyr/sys/mpmc_ring_buffer.h>
+#include <zephyr/spinlock.h>
+
+#define SLOT_SIZE	16
+#define SLOT_COUNT	8
+#define CONTEXTS	4
+
+MPMC_RING_BUF_DECLARE(mpmc_ringbuf, SLOT_SIZE, SLOT_COUNT);
+
+struct record {
+	uint32_t producer;
+	uint32_t seq;
+};
+
+static uint32_t produced[CONTEXTS];
+static atomic_t consumed[CONTEXTS];
+static int64_t last_seen[CONTEXTS][CONTEXTS];
+
+ZTEST(mpmc_ringbuffer_api, test_mpmc_ringbuffer_put_get)
+{
+	uint8_t indata[SLOT_SIZE + 4];
+	uint8_t outdata[SLOT_SIZE];
+	uint32_t len;
+
+	for (int i = 0; i < sizeof(indata); i++) {
+		indata[i] = i;
+	}
+
+	zassert_true(mpmc_ring_buf_is_empty(&mpmc_ringbuf));
+	zassert_equal(mpmc_ring_buf_capacity_get(&mpmc_ringbuf), SLOT_COUNT);
+	zassert_equal(mpmc_ring_buf_slot_size_get(&mpmc_ringbuf), SLOT_SIZE);
+
+	/* Records are truncated to the slot size. */
+	len = mpmc_ring_buf_put(&mpmc_ringbuf, indata, sizeof(indata));
+	zassert_equal(len, SLOT_SIZE);
+
+	for (int i = 1; i < SLOT_COUNT; i++) {
+		len = mpmc_ring_buf_put(&mpmc_ringbuf, indata, i);
+		zassert_equal(len, i);
+	}
+
+	zassert_equal(mpmc_ring_buf_size_get(&mpmc_ringbuf), SLOT_COUNT);
+	zassert_equal(mpmc_ring_buf_put(&mpmc_ringbuf, indata, 1), 0,
+		      "Expected full ring buffer");
+
+	len = mpmc_ring_buf_get(&mpmc_ringbuf, outdata, sizeof(outdata));
+	zassert_equal(len, SLOT_SIZE);
+	zassert_mem_equal(outdata, indata, len);
+
+	for (int i = 1; i < SLOT_COUNT; i++) {
+		len = mpmc_ring_buf_get(&mpmc_ringbuf, outdata, sizeof(outdata));
+		zassert_equal(len, i);
+		zassert_mem_equal(outdata, indata, len);
+	}
+
+	zassert_true(mpmc_ring_buf_is_empty(&mpmc_ringbuf));
+	zassert_equal(mpmc_ring_buf_get(&mpmc_ringbuf, outdata, 1), 0);
+}
+
+ZTEST(mpmc_ringbuffer_api, test_mpmc_ringbuffer_claim_finish)
+{
+	uint8_t *data[2];
+	uint8_t *rd;
+	uint32_t len;
+	int err;
+
+	/* Claims are committed out of order. */
+	len = mpmc_ring_buf_put_claim(&mpmc_ringbuf, &data[0], 4);
+	zassert_equal(len, 4);
+	len = mpmc_ring_buf_put_claim(&mpmc_ringbuf, &data[1], 4);
+	zassert_equal(len, 4);
+	zassert_not_equal(data[0], data[1]);
+
+	memset(data[1], 0xbb, 4);
+	err = mpmc_ring_buf_put_finish(&mpmc_ringbuf, data[1], 4);
+	zassert_equal(err, 0);
+
+	/* First claim is not finished yet so nothing is available. */
+	zassert_equal(mpmc_ring_buf_get_claim(&mpmc_ringbuf, &rd, 4), 0);
+
+	err = mpmc_ring_buf_put_finish(&mpmc_ringbuf, data[0], 5);
+	zassert_equal(err, -EINVAL);
+
+	/* Abandon the first claim, consumer skips it. */
+	err = mpmc_ring_buf_put_finish(&mpmc_ringbuf, data[0], 0);
+	zassert_equal(err, 0);
+
+	len = mpmc_ring_buf_get_claim(&mpmc_ringbuf, &rd, 16);
+	zassert_equal(len, 4);
+	zassert_equal(rd, data[1]);
+	zassert_equal(rd[0], 0xbb);
+
+	err = mpmc_ring_buf_get_finish(&mpmc_ringbuf, rd, 5);
+	zassert_equal(err, -EINVAL);
+	err = mpmc_ring_buf_get_finish(&mpmc_ringbuf, rd, len);
+	zassert_equal(err, 0);
+
+	zassert_true(mpmc_ring_buf_is_empty(&mpmc_ringbuf));
+}
+
+ZTEST(mpmc_ringbuffer_api, test_mpmc_ringbuffer_item)
+{
+	uint32_t indata[SLOT_SIZE / 4 + 1] = { 1, 2, 3, 4, 5 };
+	uint32_t outdata[SLOT_SIZE / 4];
+	uint16_t type;
+	uint8_t value;
+	uint8_t size32;
+	int err;
+
+	err = mpmc_ring_buf_item_put(&mpmc_ringbuf, 1, 2, indata,
+				     ARRAY_SIZE(indata));
+	zassert_equal(err, -EMSGSIZE);
+
+	err = mpmc_ring_buf_item_put(&mpmc_ringbuf, 1, 2, indata, 3);
+	zassert_equal(err, 0);
+	err = mpmc_ring_buf_item_put(&mpmc_ringbuf, 3, 4, NULL, 0);
+	zassert_equal(err, 0);
+
+	size32 = 1;
+	err = mpmc_ring_buf_item_get(&mpmc_ringbuf, &type, &value, outdata, &size32);
+	zassert_equal(err, -EMSGSIZE);
+	zassert_equal(size32, 3);
+
+	size32 = ARRAY_SIZE(outdata);
+	err = mpmc_ring_buf_item_get(&mpmc_ringbuf, &type, &value, outdata, &size32);
+	zassert_equal(err, 0);
+	zassert_equal(type, 1);
+	zassert_equal(value, 2);
+	zassert_equal(size32, 3);
+	zassert_mem_equal(outdata, indata, 3 * sizeof(uint32_t));
+
+	size32 = ARRAY_SIZE(outdata);
+	err = mpmc_ring_buf_item_get(&mpmc_ringbuf, &type, &value, outdata, &size32);
+	zassert_equal(err, 0);
+	zassert_equal(type, 3);
+	zassert_equal(value, 4);
+	zassert_equal(size32, 0);
+
+	err = mpmc_ring_buf_item_get(&mpmc_ringbuf, &type, &value, outdata, &size32);
+	zassert_equal(err, -EAGAIN);
+}
+
+static void consume_record(int consumer, struct record *rec)
+{
+	zassert_true(rec->producer < CONTEXTS);
+
+	/* Each consumer observes records of a given producer in order. */
+	zassert_true((int64_t)rec->seq > last_seen[consumer][rec->producer],
+		     "producer %d: got %u after %lld", rec->producer, rec->seq,
+		     last_seen[consumer][rec->producer]);
+
+	last_seen[consumer][rec->producer] = rec->seq;
+	atomic_inc(&consumed[rec->producer]);
+}
+
+static bool mpmc_handler(void *user_data, uint32_t iter_cnt, bool last, int prio)
+{
+	uint32_t id = (uint32_t)(uintptr_t)user_data;
+	struct record rec = {
+		.producer = id,
+		.seq = produced[id]
+	};
+	uint8_t *data;
+	uint32_t len;
+
+	/* Alternate between zero copy and copy API. */
+	if (iter_cnt & 1) {
+		len = mpmc_ring_buf_put_claim(&mpmc_ringbuf, &data, sizeof(rec));
+		if (len) {
+			zassert_equal(len, sizeof(rec));
+			memcpy(data, &rec, sizeof(rec));
+			zassert_equal(mpmc_ring_buf_put_finish(&mpmc_ringbuf,
+							       data, len), 0);
+			produced[id]++;
+		}
+	} else if (mpmc_ring_buf_put(&mpmc_ringbuf, (uint8_t *)&rec,
+				     sizeof(rec)) == sizeof(rec)) {
+		produced[id]++;
+	}
+
+	if (iter_cnt & 2) {
+		len = mpmc_ring_buf_get_claim(&mpmc_ringbuf, &data, sizeof(rec));
+		if (len) {
+			zassert_equal(len, sizeof(rec));
+			memcpy(&rec, data, sizeof(rec));
+			zassert_equal(mpmc_ring_buf_get_finish(&mpmc_ringbuf,
+							       data, len), 0);
+			consume_record(id, &rec);
+		}
+	} else if (mpmc_ring_buf_get(&mpmc_ringbuf, (uint8_t *)&rec,
+				     sizeof(rec)) == sizeof(rec)) {
+		consume_record(id, &rec);
+	}
+
+	return true;
+}
+
+/* Every context (one of them is an interrupt) is a producer and a consumer
+ * at the same time. No locking is used.
+ */
+ZTEST(mpmc_ringbuffer_api, test_mpmc_ringbuffer_stress)
+{
+	struct record rec;
+	k_timeout_t timeout;
+
+	/* force internal position roll-over */
+	mpmc_ring_buf_internal_reset(&mpmc_ringbuf, -(SLOT_COUNT / 2));
+
+	for (int i = 0; i < CONTEXTS; i++) {
+		produced[i] = 0;
+		atomic_set(&consumed[i], 0);
+		for (int j = 0; j < CONTEXTS; j++) {
+			last_seen[i][j] = -1;
+		}
+	}
+
+	timeout = (CONFIG_SYS_CLOCK_TICKS_PER_SEC < 10000) ? K_MSEC(1000) : K_MSEC(10000);
+
+	ztress_set_timeout(timeout);
+	ZTRESS_EXECUTE(ZTRESS_TIMER(mpmc_handler, (void *)0, 0, Z_TIMEOUT_TICKS(20)),
+		       ZTRESS_THREAD(mpmc_handler, (void *)1, 0, 0, Z_TIMEOUT_TICKS(20)),
+		       ZTRESS_THREAD(mpmc_handler, (void *)2, 0, 1000, Z_TIMEOUT_TICKS(20)),
+		       ZTRESS_THREAD(mpmc_handler, (void *)3, 0, 1000, Z_TIMEOUT_TICKS(20)));
+
+	while (mpmc_ring_buf_get(&mpmc_ringbuf, (uint8_t *)&rec, sizeof(rec))) {
+		consume_record(0, &rec);
+	}
+
+	for (int i = 0; i < CONTEXTS; i++) {
+		zassert_equal(produced[i], atomic_get(&consumed[i]),
+			      "producer %d: produced %u consumed %ld", i,
+			      produced[i], atomic_get(&consumed[i]));
+	}
+}
+
+/* Compare lock-free multi-producer ring buffer with the usual approach of
+ * protecting single-producer ring buffer with a spinlock.
+ */
+ZTEST(mpmc_ringbuffer_api, test_mpmc_ringbuffer_performance)
+{
+	static struct k_spinlock lock;
+	static uint8_t buf[SLOT_SIZE * SLOT_COUNT];
+	static struct ring_buf rbuf;
+	uint8_t indata[SLOT_SIZE];
+	uint8_t outdata[SLOT_SIZE];
+	k_spinlock_key_t key;
+	uint32_t timestamp;
+	int loop = 1000;
+
+	ring_buf_init(&rbuf, sizeof(buf), buf);
+
+	for (uint32_t len = 1; len <= SLOT_SIZE; len *= 4) {
+		timestamp = k_cycle_get_32();
+		for (int i = 0; i < loop; i++) {
+			key = k_spin_lock(&lock);
+			ring_buf_put(&rbuf, indata, len);
+			k_spin_unlock(&lock, key);
+
+			key = k_spin_lock(&lock);
+			ring_buf_get(&rbuf, outdata, len);
+			k_spin_unlock(&lock, key);
+		}
+		timestamp = k_cycle_get_32() - timestamp;
+		PRINT("%u byte locked spsc put-get, avg cycles: %d\n",
+		      len, timestamp / loop);
+
+		timestamp = k_cycle_get_32();
+		for (int i = 0; i < loop; i++) {
+			mpmc_ring_buf_put(&mpmc_ringbuf, indata, len);
+			mpmc_ring_buf_get(&mpmc_ringbuf, outdata, len);
+		}
+		timestamp = k_cycle_get_32() - timestamp;
+		PRINT("%u byte mpmc put-get, avg cycles: %d\n",
+		      len, timestamp / loop);
+	}
+}
+
+static void mpmc_ringbuffer_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	mpmc_ring_buf_internal_reset(&mpmc_ringbuf, 0);
+}
+
+ZTEST_SUITE(mpmc_ringbuffer_api, NULL, NULL, mpmc_ringbuffer_before, NULL, NULL);
@@ -647,4 +647,149 @@ ZTEST(arp_fn_tests, test_arp)
 	}
 }
 
+static struct net_pkt *prepare_ipv4_pkt(struct net_if *iface,
+					struct in_addr *src,
+					struct in_addr *dst)
+{
+	struct net_ipv4_hdr *ipv4;
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(iface, sizeof(struct net_ipv4_hdr),
+					AF_INET, 0, K_SECONDS(1));
+	zassert_not_null(pkt, "out of mem");
+
+	ipv4 = (struct net_ipv4_hdr *)net_buf_add(pkt->buffer,
+						  sizeof(struct net_ipv4_hdr));
+	net_ipv4_addr_copy_raw(ipv4->src, (uint8_t *)src);
+	net_ipv4_addr_copy_raw(ipv4->dst, (uint8_t *)dst);
+
+	return pkt;
+}
+
+static void feed_arp_request(struct net_if *iface, struct in_addr *src,
+			     struct net_eth_addr *src_hwaddr,
+			     struct in_addr *dst)
+{
+	struct net_eth_hdr *eth_hdr;
+	struct net_arp_hdr *arp_hdr;
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(iface, sizeof(struct net_eth_hdr) +
+					sizeof(struct net_arp_hdr),
+					AF_UNSPEC, 0, K_SECONDS(1));
+	zassert_not_null(pkt, "out of mem request");
+
+	setup_eth_header(iface, pkt, net_eth_broadcast_addr(),
+			 NET_ETH_PTYPE_ARP);
+
+	eth_hdr = (struct net_eth_hdr *)net_pkt_data(pkt);
+	net_buf_add(pkt->buffer, sizeof(struct net_eth_hdr));
+	net_buf_pull(pkt->buffer, sizeof(struct net_eth_hdr));
+	arp_hdr = NET_ARP_HDR(pkt);
+
+	arp_hdr->hwtype = htons(NET_ARP_HTYPE_ETH);
+	arp_hdr->protocol = htons(NET_ETH_PTYPE_IP);
+	arp_hdr->hwlen = sizeof(struct net_eth_addr);
+	arp_hdr->protolen = sizeof(struct in_addr);
+	arp_hdr->opcode = htons(NET_ARP_REQUEST);
+	memcpy(&arp_hdr->src_hwaddr, src_hwaddr, sizeof(struct net_eth_addr));
+	(void)memset(&arp_hdr->dst_hwaddr, 0, sizeof(struct net_eth_addr));
+	net_ipv4_addr_copy_raw(arp_hdr->src_ipaddr, (uint8_t *)src);
+	net_ipv4_addr_copy_raw(arp_hdr->dst_ipaddr, (uint8_t *)dst);
+
+	net_buf_add(pkt->buffer, sizeof(struct net_arp_hdr));
+
+	/* The sender is added to the cache, as the target is our address */
+	zassert_equal(net_arp_input(pkt, eth_hdr), NET_OK,
+		      "ARP request dropped");
+}
+
+ZTEST(arp_fn_tests, test_arp_negative_cache_and_aging)
+{
+	struct net_eth_addr peer_hwaddr = {
+		{ 0x02, 0x00, 0x5e, 0x10, 0x20, 0x30 }
+	};
+	struct in_addr unreachable = { { { 192, 168, 0, 77 } } };
+	struct in_addr peer = { { { 192, 168, 0, 78 } } };
+	struct in_addr src = { { { 192, 168, 0, 1 } } };
+	struct in_addr netmask = { { { 255, 255, 255, 0 } } };
+	struct net_if_addr *ifaddr;
+	struct net_pkt *pkt, *req;
+	struct net_if *iface;
+
+	if (CONFIG_NET_ARP_NEGATIVE_TIMEOUT == 0 ||
+	    CONFIG_NET_ARP_ENTRY_LIFETIME == 0) {
+		ztest_test_skip();
+	}
+
+	net_arp_init();
+
+	iface = net_if_lookup_by_dev(DEVICE_GET(net_arp_test));
+
+	net_if_ipv4_set_netmask(iface, &netmask);
+	ifaddr = net_if_ipv4_addr_add(iface, &src, NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "Cannot add address");
+	ifaddr->addr_state = NET_ADDR_PREFERRED;
+
+	net_arp_clear_cache(iface);
+
+	/* Nobody answers the first request */
+	pkt = prepare_ipv4_pkt(iface, &src, &unreachable);
+
+	req = net_arp_prepare(pkt, &unreachable, NULL);
+	zassert_not_null(req, "No ARP request");
+	zassert_not_equal(req, pkt, "Destination should be unknown");
+	net_pkt_unref(req);
+
+	k_sleep(K_MSEC(2 * MSEC_PER_SEC + 100));
+
+	zassert_equal(atomic_get(&pkt->atomic_ref), 1,
+		      "Pending packet not released");
+
+	/* The destination is now known to be unreachable */
+	req = net_arp_prepare(pkt, &unreachable, NULL);
+	zassert_is_null(req, "Packet to unreachable destination not dropped");
+	zassert_equal(atomic_get(&pkt->atomic_ref), 1, "Packet was queued");
+
+	k_sleep(K_MSEC(CONFIG_NET_ARP_NEGATIVE_TIMEOUT));
+
+	req = net_arp_prepare(pkt, &unreachable, NULL);
+	zassert_not_null(req, "No ARP request after negative timeout");
+	net_pkt_unref(req);
+
+	net_arp_clear_cache(iface);
+	net_pkt_unref(pkt);
+
+	/* A resolved entry is used directly, until it expires */
+	req_test = true;
+	feed_arp_request(iface, &peer, &peer_hwaddr, &src);
+
+	entry_found = false;
+	expected_hwaddr = &peer_hwaddr;
+	net_arp_foreach(arp_cb, &peer);
+	zassert_true(entry_found, "Entry not found");
+
+	pkt = prepare_ipv4_pkt(iface, &src, &peer);
+
+	zassert_equal_ptr(net_arp_prepare(pkt, &peer, NULL), pkt,
+			  "Resolved entry not used");
+	zassert_mem_equal(net_pkt_lladdr_dst(pkt)->addr, &peer_hwaddr,
+			  sizeof(struct net_eth_addr), "Wrong destination");
+
+	k_sleep(K_MSEC(CONFIG_NET_ARP_ENTRY_LIFETIME * MSEC_PER_SEC * 9 / 8 +
+		       100));
+
+	entry_found = false;
+	net_arp_foreach(arp_cb, &peer);
+	zassert_false(entry_found, "Entry did not expire");
+
+	req = net_arp_prepare(pkt, &peer, NULL);
+	zassert_not_null(req, "No ARP request");
+	zassert_not_equal(req, pkt, "Expired entry used");
+	net_pkt_unref(req);
+
+	net_arp_clear_cache(iface);
+	net_pkt_unref(pkt);
+}
+
 ZTEST_SUITE(arp_fn_tests, NULL, NULL, NULL, NULL, NULL);
@@ -20,6 +20,8 @@
 #define USER_DATA_HEAP	4
 #define USER_DATA_FIXED	0
 #define USER_DATA_VAR	63
+#define USER_DATA_INLINE 5
+#define INLINE_SIZE	32
 
 struct bt_data {
 	void *hci_sync;
@@ -70,6 +72,8 @@ static void var_destroy(struct net_buf *buf);
 NET_BUF_POOL_HEAP_DEFINE(bufs_pool, 10, USER_DATA_HEAP, buf_destroy);
 NET_BUF_POOL_FIXED_DEFINE(fixed_pool, 10, 128, USER_DATA_FIXED, fixed_destroy);
 NET_BUF_POOL_VAR_DEFINE(var_pool, 10, 1024, USER_DATA_VAR, var_destroy);
+NET_BUF_POOL_VAR_INLINE_DEFINE(inline_pool, 4, 256, INLINE_SIZE,
+			       USER_DATA_INLINE, NULL);
 
 static void buf_destroy(struct net_buf *buf)
 {
@@ -424,6 +428,52 @@ ZTEST(net_buf_tests, test_net_buf_clone)
 	zassert_equal(destroy_called, 2, "Incorrect destroy callback count");
 }
 
+ZTEST(net_buf_tests, test_net_buf_shared_clone)
+{
+	struct net_buf *buf, *clone, *other;
+
+	destroy_called = 0;
+
+	buf = net_buf_alloc(&fixed_pool, K_NO_WAIT);
+	zassert_not_null(buf, "Failed to get buffer");
+
+	net_buf_reserve(buf, 8);
+	net_buf_add_mem(buf, example_data, sizeof(example_data));
+
+	/* net_buf_clone() still copies fixed pool data */
+	clone = net_buf_clone(buf, K_NO_WAIT);
+	zassert_not_null(clone, "Failed to clone buffer");
+	zassert_not_equal(clone->__buf, buf->__buf, "Data not copied");
+	net_buf_unref(clone);
+
+	clone = net_buf_shared_clone(buf, K_NO_WAIT);
+	zassert_not_null(clone, "Failed to clone buffer");
+	zassert_equal_ptr(clone->__buf, buf->__buf, "Data not shared");
+	zassert_equal_ptr(clone->data, buf->data, "Bad data pointer");
+	zassert_equal(clone->len, buf->len, "Bad length");
+	zassert_equal(net_buf_headroom(clone), 8, "Bad headroom");
+
+	/* Headers are independent */
+	net_buf_pull(clone, 10);
+	zassert_equal(buf->len, sizeof(example_data), "Original modified");
+
+	net_buf_unref(buf);
+
+	/* The data outlives the original, and is not given to new buffers */
+	other = net_buf_alloc(&fixed_pool, K_NO_WAIT);
+	zassert_not_null(other, "Failed to get buffer");
+	zassert_not_equal(other->__buf, clone->__buf, "Shared data reused");
+	memset(other->__buf, 0, other->size);
+
+	zassert_mem_equal(clone->data, example_data + 10,
+			  sizeof(example_data) - 10, "Shared data corrupted");
+
+	net_buf_unref(clone);
+	net_buf_unref(other);
+
+	zassert_equal(destroy_called, 4, "Incorrect destroy callback count");
+}
+
 ZTEST(net_buf_tests, test_net_buf_fixed_pool)
 {
 	struct net_buf *buf;
@@ -461,6 +511,63 @@ ZTEST(net_buf_tests, test_net_buf_var_pool)
 	zassert_equal(destroy_called, 3, "Incorrect destroy callback count");
 }
 
+static bool buf_data_is_inline(struct net_buf *buf)
+{
+	return buf->__buf == buf->user_data + buf->user_data_size;
+}
+
+ZTEST(net_buf_tests, test_net_buf_inline_pool)
+{
+	struct net_buf *buf, *clone, *big;
+	int i;
+
+	buf = net_buf_alloc_len(&inline_pool, INLINE_SIZE, K_NO_WAIT);
+	zassert_not_null(buf, "Failed to get buffer");
+	zassert_true(buf_data_is_inline(buf), "Data not stored inline");
+	zassert_equal(net_buf_tailroom(buf), INLINE_SIZE, "Bad tailroom");
+
+	memset(net_buf_user_data(buf), 0xaa, USER_DATA_INLINE);
+
+	net_buf_reserve(buf, 4);
+	net_buf_add_mem(buf, example_data, INLINE_SIZE - 4);
+	net_buf_push_be16(buf, 0x1234);
+	zassert_equal(net_buf_pull_be16(buf), 0x1234, "Bad pulled value");
+	zassert_mem_equal(buf->data, example_data, INLINE_SIZE - 4,
+			  "Bad inline data");
+
+	for (i = 0; i < USER_DATA_INLINE; i++) {
+		zassert_equal(buf->user_data[i], 0xaa, "User data overwritten");
+	}
+
+	/* Inline data cannot be shared, so the clone gets its own copy */
+	clone = net_buf_clone(buf, K_NO_WAIT);
+	zassert_not_null(clone, "Failed to clone buffer");
+	zassert_true(buf_data_is_inline(clone), "Clone data not inline");
+	zassert_mem_equal(clone->data, buf->data, buf->len,
+			  "Cloned data doesn't match");
+
+	net_buf_unref(buf);
+	net_buf_unref(clone);
+
+	/* Larger payloads come from the memory pool, which would run out
+	 * within a few iterations if they did not go back to it.
+	 */
+	for (i = 0; i < 10; i++) {
+		big = net_buf_alloc_len(&inline_pool, 100, K_NO_WAIT);
+		zassert_not_null(big, "Failed to get buffer");
+		zassert_false(buf_data_is_inline(big), "Data stored inline");
+		zassert_equal(net_buf_tailroom(big), 100, "Bad tailroom");
+
+		clone = net_buf_clone(big, K_NO_WAIT);
+		zassert_not_null(clone, "Failed to clone buffer");
+		zassert_equal_ptr(clone->__buf, big->__buf,
+				  "Pool data not shared");
+
+		net_buf_unref(big);
+		net_buf_unref(clone);
+	}
+}
+
 ZTEST(net_buf_tests, test_net_buf_byte_order)
 {
 	struct net_buf *buf;
@@ -0,0 +1,398 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_gso_gro_test, CONFIG_NET_CORE_LOG_LEVEL);
+
+#include <string.h>
+#include <errno.h>
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/net/dummy.h>
+#include <zephyr/net/net_ip.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+
+#include "net_private.h"
+#include "ipv4.h"
+#include "connection.h"
+#include "tcp_private.h"
+
+#define WAIT_TIME K_SECONDS(1)
+#define ALLOC_TIMEOUT K_MSEC(100)
+
+#define MY_PORT 4242
+#define PEER_PORT 4243
+#define SEQ 1000
+#define MSS 100
+
+/* TCP header with two NOPs and a timestamp option */
+#define TCP_HDR_LEN 32
+#define HDR_LEN (NET_IPV4H_LEN + TCP_HDR_LEN)
+
+#define MAX_PKTS 4
+#define MAX_PKT_LEN (HDR_LEN + 400)
+
+static const uint8_t tcp_opts[] = {
+	0x01, 0x01, 0x08, 0x0a,
+	0x00, 0x00, 0x12, 0x34,
+	0x00, 0x00, 0x56, 0x78,
+};
+
+/* 192.0.2.1 and 192.0.2.2 */
+static struct in_addr my_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+
+static struct net_if *iface;
+static uint8_t payload[400];
+
+/* Packets seen by the driver (GSO) or by the upper layer (GRO) */
+struct captured_pkt {
+	uint8_t data[MAX_PKT_LEN];
+	size_t len;
+	bool ip_chksum_ok;
+	bool tcp_chksum_ok;
+};
+
+static struct captured_pkt captured[MAX_PKTS];
+static atomic_t captured_count;
+static int captured_seen;
+static K_SEM_DEFINE(captured_sem, 0, MAX_PKTS);
+
+static void capture(struct net_pkt *pkt)
+{
+	int idx = atomic_inc(&captured_count);
+	struct captured_pkt *cap;
+
+	if (idx >= MAX_PKTS) {
+		return;
+	}
+
+	cap = &captured[idx];
+	cap->len = net_pkt_get_len(pkt);
+	cap->ip_chksum_ok = net_calc_chksum_ipv4(pkt) == 0U;
+	cap->tcp_chksum_ok = net_calc_chksum_tcp(pkt) == 0U;
+
+	net_pkt_cursor_init(pkt);
+	if (cap->len > sizeof(cap->data) ||
+	    net_pkt_read(pkt, cap->data, cap->len)) {
+		cap->len = 0;
+	}
+
+	k_sem_give(&captured_sem);
+}
+
+static int dummy_send(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+
+	capture(pkt);
+
+	return 0;
+}
+
+static void dummy_iface_init(struct net_if *iface)
+{
+	static uint8_t mac[6] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_DUMMY);
+}
+
+static struct dummy_api dummy_api = {
+	.iface_api.init = dummy_iface_init,
+	.send = dummy_send,
+};
+
+static int dummy_dev_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+NET_DEVICE_INIT(gso_gro_test, "gso_gro_test", dummy_dev_init, NULL, NULL,
+		NULL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &dummy_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), NET_IPV4_MTU);
+
+static enum net_verdict tcp_received(struct net_conn *conn,
+				     struct net_pkt *pkt,
+				     union net_ip_header *ip_hdr,
+				     union net_proto_header *proto_hdr,
+				     void *user_data)
+{
+	ARG_UNUSED(conn);
+	ARG_UNUSED(ip_hdr);
+	ARG_UNUSED(proto_hdr);
+	ARG_UNUSED(user_data);
+
+	capture(pkt);
+	net_pkt_unref(pkt);
+
+	return NET_OK;
+}
+
+/* IPv4 TCP packet carrying len bytes of the payload at offset, with valid
+ * checksums.
+ */
+static struct net_pkt *tcp_pkt(bool rx, const struct in_addr *src,
+			       const struct in_addr *dst, uint16_t src_port,
+			       uint16_t dst_port, uint32_t seq, uint8_t flags,
+			       size_t offset, size_t len)
+{
+	uint8_t hdr[TCP_HDR_LEN] = { 0 };
+	struct net_tcp_hdr *tcp_hdr = (struct net_tcp_hdr *)hdr;
+	struct net_pkt *pkt;
+
+	if (rx) {
+		pkt = net_pkt_rx_alloc_with_buffer(iface, TCP_HDR_LEN + len,
+						   AF_INET, IPPROTO_TCP,
+						   ALLOC_TIMEOUT);
+	} else {
+		pkt = net_pkt_alloc_with_buffer(iface, TCP_HDR_LEN + len,
+						AF_INET, IPPROTO_TCP,
+						ALLOC_TIMEOUT);
+	}
+
+	zassert_not_null(pkt, "Cannot allocate packet");
+
+	tcp_hdr->src_port = htons(src_port);
+	tcp_hdr->dst_port = htons(dst_port);
+	sys_put_be32(seq, tcp_hdr->seq);
+	sys_put_be32(1, tcp_hdr->ack);
+	tcp_hdr->offset = (TCP_HDR_LEN / 4) << 4;
+	tcp_hdr->flags = flags;
+	sys_put_be16(8192, tcp_hdr->wnd);
+	memcpy(tcp_hdr->optdata, tcp_opts, sizeof(tcp_opts));
+
+	zassert_ok(net_ipv4_create(pkt, src, dst));
+	zassert_ok(net_pkt_write(pkt, hdr, sizeof(hdr)));
+	zassert_ok(net_pkt_write(pkt, payload + offset, len));
+
+	net_pkt_cursor_init(pkt);
+	zassert_ok(net_ipv4_finalize(pkt, IPPROTO_TCP));
+	net_pkt_cursor_init(pkt);
+
+	return pkt;
+}
+
+static struct net_pkt *rx_segment(uint32_t offset, size_t len, uint8_t flags)
+{
+	return tcp_pkt(true, &peer_addr, &my_addr, PEER_PORT, MY_PORT,
+		       SEQ + offset, flags, offset, len);
+}
+
+static void check_captured(int idx, uint32_t offset, size_t len, uint8_t flags)
+{
+	struct captured_pkt *cap = &captured[idx];
+	struct net_ipv4_hdr *ipv4_hdr = (struct net_ipv4_hdr *)cap->data;
+	struct net_tcp_hdr *tcp_hdr =
+		(struct net_tcp_hdr *)(cap->data + NET_IPV4H_LEN);
+
+	zassert_equal(cap->len, HDR_LEN + len, "Packet %d length %zu", idx,
+		      cap->len);
+	zassert_equal(ntohs(ipv4_hdr->len), cap->len, "Packet %d IP length",
+		      idx);
+	zassert_true(cap->ip_chksum_ok, "Packet %d IP checksum", idx);
+
+	zassert_equal(sys_get_be32(tcp_hdr->seq), SEQ + offset,
+		      "Packet %d sequence number", idx);
+	zassert_equal(tcp_hdr->flags, flags, "Packet %d flags 0x%02x", idx,
+		      tcp_hdr->flags);
+	zassert_equal(tcp_hdr->offset, (TCP_HDR_LEN / 4) << 4,
+		      "Packet %d data offset", idx);
+	zassert_mem_equal(tcp_hdr->optdata, tcp_opts, sizeof(tcp_opts),
+			  "Packet %d options", idx);
+	zassert_mem_equal(cap->data + HDR_LEN, payload + offset, len,
+			  "Packet %d payload", idx);
+}
+
+/* Wait until count packets in total have been captured in the test */
+static void wait_captured(int count)
+{
+	for (; captured_seen < count; captured_seen++) {
+		zassert_ok(k_sem_take(&captured_sem, WAIT_TIME),
+			   "Got %d packets out of %d",
+			   (int)atomic_get(&captured_count), count);
+	}
+
+	/* Nothing more */
+	zassert_equal(k_sem_take(&captured_sem, K_MSEC(50)), -EAGAIN);
+	zassert_equal(atomic_get(&captured_count), count);
+}
+
+ZTEST(net_gso_gro, test_gso_segments)
+{
+	size_t data_len = 2 * MSS + MSS / 2;
+	struct net_pkt *pkt;
+
+	pkt = tcp_pkt(false, &my_addr, &peer_addr, MY_PORT, PEER_PORT, SEQ,
+		      ACK | PSH | FIN, 0, data_len);
+	net_pkt_set_gso_size(pkt, MSS);
+
+	zassert_ok(net_gso_send(pkt));
+
+	wait_captured(3);
+
+	/* FIN and PSH only on the last segment */
+	check_captured(0, 0, MSS, ACK);
+	check_captured(1, MSS, MSS, ACK);
+	check_captured(2, 2 * MSS, MSS / 2, ACK | PSH | FIN);
+
+	for (int i = 0; i < 3; i++) {
+		zassert_true(captured[i].tcp_chksum_ok,
+			     "Segment %d TCP checksum", i);
+	}
+}
+
+ZTEST(net_gso_gro, test_gso_exact_mss)
+{
+	struct net_pkt *pkt;
+
+	pkt = tcp_pkt(false, &my_addr, &peer_addr, MY_PORT, PEER_PORT, SEQ,
+		      ACK | PSH, 0, 2 * MSS);
+	net_pkt_set_gso_size(pkt, MSS);
+
+	zassert_ok(net_gso_send(pkt));
+
+	wait_captured(2);
+
+	check_captured(0, 0, MSS, ACK);
+	check_captured(1, MSS, MSS, ACK | PSH);
+}
+
+ZTEST(net_gso_gro, test_gro_merge_flush)
+{
+	for (int i = 0; i < 3; i++) {
+		zassert_equal(net_gro_receive(rx_segment(i * MSS, MSS, ACK)),
+			      NET_OK, "Segment %d not held", i);
+	}
+
+	zassert_equal(atomic_get(&captured_count), 0, "Delivered before flush");
+
+	net_gro_flush();
+
+	wait_captured(1);
+	check_captured(0, 0, 3 * MSS, ACK);
+}
+
+ZTEST(net_gso_gro, test_gro_push)
+{
+	zassert_equal(net_gro_receive(rx_segment(0, MSS, ACK)), NET_OK);
+	zassert_equal(net_gro_receive(rx_segment(MSS, MSS, ACK | PSH)), NET_OK);
+
+	/* A pushed segment is delivered at once, with the held ones */
+	wait_captured(1);
+	check_captured(0, 0, 2 * MSS, ACK | PSH);
+
+	net_gro_flush();
+	zassert_equal(atomic_get(&captured_count), 1);
+}
+
+ZTEST(net_gso_gro, test_gro_max_segs)
+{
+	for (int i = 0; i < CONFIG_NET_GRO_MAX_SEGS + 1; i++) {
+		zassert_equal(net_gro_receive(rx_segment(i * MSS / 4, MSS / 4,
+							 ACK)),
+			      NET_OK, "Segment %d not held", i);
+	}
+
+	/* A full packet is delivered, the next segment starts a new one */
+	wait_captured(1);
+	check_captured(0, 0, CONFIG_NET_GRO_MAX_SEGS * MSS / 4, ACK);
+
+	net_gro_flush();
+
+	wait_captured(2);
+	check_captured(1, CONFIG_NET_GRO_MAX_SEGS * MSS / 4, MSS / 4, ACK);
+}
+
+ZTEST(net_gso_gro, test_gro_out_of_order)
+{
+	zassert_equal(net_gro_receive(rx_segment(0, MSS, ACK)), NET_OK);
+
+	/* The held segment is delivered before the one that cannot be
+	 * appended to it.
+	 */
+	zassert_equal(net_gro_receive(rx_segment(2 * MSS, MSS, ACK)), NET_OK);
+	wait_captured(1);
+	check_captured(0, 0, MSS, ACK);
+
+	net_gro_flush();
+
+	wait_captured(2);
+	check_captured(1, 2 * MSS, MSS, ACK);
+}
+
+ZTEST(net_gso_gro, test_gro_not_candidate)
+{
+	struct net_pkt *pkt;
+
+	/* No data */
+	pkt = rx_segment(0, 0, ACK);
+	zassert_equal(net_gro_receive(pkt), NET_CONTINUE);
+	net_pkt_unref(pkt);
+
+	/* Not for this host */
+	pkt = tcp_pkt(true, &peer_addr, &peer_addr, PEER_PORT, MY_PORT, SEQ,
+		      ACK, 0, MSS);
+	zassert_equal(net_gro_receive(pkt), NET_CONTINUE);
+	net_pkt_unref(pkt);
+
+	net_gro_flush();
+	zassert_equal(atomic_get(&captured_count), 0);
+}
+
+static void *net_gso_gro_setup(void)
+{
+	struct sockaddr_in local = {
+		.sin_family = AF_INET,
+		.sin_addr = my_addr,
+	};
+	struct sockaddr_in remote = {
+		.sin_family = AF_INET,
+		.sin_addr = peer_addr,
+	};
+	static struct net_conn_handle *handle;
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(iface, "No dummy interface");
+
+	zassert_not_null(net_if_ipv4_addr_add(iface, &my_addr, NET_ADDR_MANUAL,
+					      0), "Cannot add IPv4 address");
+
+	zassert_ok(net_conn_register(IPPROTO_TCP, AF_INET,
+				     (struct sockaddr *)&remote,
+				     (struct sockaddr *)&local, PEER_PORT,
+				     MY_PORT, NULL, tcp_received, NULL,
+				     &handle), "Cannot register TCP handler");
+
+	for (int i = 0; i < sizeof(payload); i++) {
+		payload[i] = i;
+	}
+
+	return NULL;
+}
+
+static void net_gso_gro_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	atomic_set(&captured_count, 0);
+	captured_seen = 0;
+	k_sem_reset(&captured_sem);
+	memset(captured, 0, sizeof(captured));
+}
+
+static void net_gso_gro_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	/* Nothing held over to the next test */
+	net_gro_flush();
+}
+
+ZTEST_SUITE(net_gso_gro, NULL, net_gso_gro_setup, net_gso_gro_before,
+	    net_gso_gro_after, NULL);
@@ -0,0 +1,378 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/ztest.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http/server.h>
+
+#define RECV_TIMEOUT_MS 2000
+#define LOAD_CLIENTS 2
+#define LOAD_REQUESTS 50
+
+static const char index_html[] = "<html><body>Hello</body></html>";
+
+static uint16_t test_port;
+HTTP_SERVICE_DEFINE(test_service, "127.0.0.1", &test_port, 4, 4, NULL);
+
+static struct http_resource_detail_static index_detail = {
+	.common = {
+		.bitmask_of_supported_http_methods = HTTP_METHOD_BIT(HTTP_GET),
+		.type = HTTP_RESOURCE_TYPE_STATIC,
+		.content_type = "text/html",
+	},
+	.static_data = index_html,
+	.static_data_len = sizeof(index_html) - 1,
+};
+HTTP_RESOURCE_DEFINE(index_resource, test_service, "/", &index_detail);
+
+/* Produces three chunks, or echoes the body of a POST */
+static int dynamic_cb(const struct http_server_request *req, size_t offset,
+		      uint8_t *buf, size_t len, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (req->method == HTTP_POST) {
+		if (offset >= req->body_len) {
+			return 0;
+		}
+
+		len = MIN(len, req->body_len - offset);
+		memcpy(buf, req->body + offset, len);
+
+		return len;
+	}
+
+	if (offset >= 3 * 5) {
+		return 0;
+	}
+
+	return snprintk(buf, len, "part%zu", offset / 5);
+}
+
+static struct http_resource_detail_dynamic dynamic_detail = {
+	.common = {
+		.bitmask_of_supported_http_methods =
+			HTTP_METHOD_BIT(HTTP_GET) | HTTP_METHOD_BIT(HTTP_POST),
+		.type = HTTP_RESOURCE_TYPE_DYNAMIC,
+		.content_type = "text/plain",
+	},
+	.cb = dynamic_cb,
+};
+HTTP_RESOURCE_DEFINE(dynamic_resource, test_service, "/dynamic",
+		     &dynamic_detail);
+
+static char response[1024];
+
+static int connect_server(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(test_port),
+	};
+	int fd;
+
+	zassert_equal(zsock_inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr), 1);
+
+	fd = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(fd >= 0, "socket() failed (%d)", errno);
+
+	zassert_ok(zsock_connect(fd, (struct sockaddr *)&addr, sizeof(addr)),
+		   "connect() failed (%d)", errno);
+
+	return fd;
+}
+
+static void send_str(int fd, const char *str)
+{
+	zassert_equal(zsock_send(fd, str, strlen(str), 0), strlen(str));
+}
+
+/* Receives until @p count occurrences of @p end are in the response, or
+ * until the server closes the connection if @p end is NULL.
+ */
+static size_t recv_response(int fd, const char *end, int count)
+{
+	struct zsock_pollfd pfd = { .fd = fd, .events = ZSOCK_POLLIN };
+	size_t len = 0;
+
+	while (len < sizeof(response) - 1) {
+		const char *p = response;
+		int found = 0;
+		ssize_t ret;
+
+		response[len] = '\0';
+
+		while (end && (p = strstr(p, end)) != NULL) {
+			p += strlen(end);
+			found++;
+		}
+
+		if (end && found >= count) {
+			break;
+		}
+
+		zassert_equal(zsock_poll(&pfd, 1, RECV_TIMEOUT_MS), 1,
+			      "Timeout, received \"%s\"", response);
+
+		ret = zsock_recv(fd, response + len, sizeof(response) - 1 - len,
+				 0);
+		zassert_true(ret >= 0, "recv() failed (%d)", errno);
+
+		if (ret == 0) {
+			zassert_is_null(end, "Connection closed");
+			break;
+		}
+
+		len += ret;
+	}
+
+	response[len] = '\0';
+
+	return len;
+}
+
+static void request(const char *req, const char *status)
+{
+	int fd = connect_server();
+
+	send_str(fd, req);
+	recv_response(fd, NULL, 0);
+
+	zassert_equal(strncmp(response, status, strlen(status)), 0,
+		      "Unexpected response \"%s\"", response);
+
+	zsock_close(fd);
+}
+
+ZTEST(http_server, test_static)
+{
+	request("GET / HTTP/1.1\r\nConnection: close\r\n\r\n",
+		"HTTP/1.1 200 OK\r\n");
+
+	zassert_not_null(strstr(response, "Content-Type: text/html\r\n"));
+	zassert_not_null(strstr(response, "Content-Length: 31\r\n"));
+	zassert_not_null(strstr(response, "\r\n\r\n" "<html><body>Hello"));
+}
+
+ZTEST(http_server, test_head)
+{
+	request("HEAD / HTTP/1.1\r\nConnection: close\r\n\r\n",
+		"HTTP/1.1 200 OK\r\n");
+
+	zassert_not_null(strstr(response, "Content-Length: 31\r\n"));
+	zassert_is_null(strstr(response, "<html>"));
+}
+
+ZTEST(http_server, test_not_found)
+{
+	request("GET /missing HTTP/1.1\r\nConnection: close\r\n\r\n",
+		"HTTP/1.1 404 Not Found\r\n");
+}
+
+ZTEST(http_server, test_method_not_allowed)
+{
+	request("POST / HTTP/1.1\r\nContent-Length: 1\r\n"
+		"Connection: close\r\n\r\nx",
+		"HTTP/1.1 405 Method Not Allowed\r\n");
+}
+
+ZTEST(http_server, test_payload_too_large)
+{
+	request("POST /dynamic HTTP/1.1\r\nContent-Length: 100\r\n\r\n"
+		"0123456789012345678901234567890123456789"
+		"0123456789012345678901234567890123456789"
+		"01234567890123456789",
+		"HTTP/1.1 413 Payload Too Large\r\n");
+}
+
+ZTEST(http_server, test_bad_request)
+{
+	request("GARBAGE\r\n\r\n", "HTTP/1.1 400 Bad Request\r\n");
+}
+
+ZTEST(http_server, test_query_string)
+{
+	request("GET /?foo=bar HTTP/1.1\r\nConnection: close\r\n\r\n",
+		"HTTP/1.1 200 OK\r\n");
+}
+
+ZTEST(http_server, test_pipelined)
+{
+	int fd = connect_server();
+
+	/* All requests in one segment, answered in order on one connection */
+	send_str(fd, "GET / HTTP/1.1\r\n\r\n"
+		     "GET /missing HTTP/1.1\r\n\r\n"
+		     "GET / HTTP/1.1\r\n\r\n");
+	recv_response(fd, "</html>", 2);
+
+	zassert_equal(strncmp(response, "HTTP/1.1 200 OK\r\n", 17), 0);
+	zassert_not_null(strstr(response, "HTTP/1.1 404 Not Found\r\n"));
+	zassert_true(strstr(response, "HTTP/1.1 404") <
+		     strrchr(response, '<'), "Responses out of order");
+
+	/* The connection is still usable */
+	send_str(fd, "GET / HTTP/1.1\r\nConnection: close\r\n\r\n");
+	recv_response(fd, NULL, 0);
+	zassert_equal(strncmp(response, "HTTP/1.1 200 OK\r\n", 17), 0);
+
+	zsock_close(fd);
+}
+
+ZTEST(http_server, test_dynamic_chunked)
+{
+	int fd = connect_server();
+
+	send_str(fd, "GET /dynamic HTTP/1.1\r\n\r\n");
+	recv_response(fd, "0\r\n\r\n", 1);
+
+	zassert_not_null(strstr(response, "Transfer-Encoding: chunked\r\n"));
+	zassert_not_null(strstr(response, "\r\n\r\n"
+					  "5\r\npart0\r\n"
+					  "5\r\npart1\r\n"
+					  "5\r\npart2\r\n"
+					  "0\r\n\r\n"));
+
+	zsock_close(fd);
+}
+
+ZTEST(http_server, test_dynamic_post)
+{
+	int fd = connect_server();
+
+	send_str(fd, "POST /dynamic HTTP/1.1\r\nContent-Length: 4\r\n\r\nping");
+	recv_response(fd, "0\r\n\r\n", 1);
+
+	zassert_not_null(strstr(response, "\r\n\r\n4\r\nping\r\n0\r\n\r\n"));
+
+	zsock_close(fd);
+}
+
+ZTEST(http_server, test_dynamic_http10)
+{
+	/* Without keep-alive the body is not chunked, and ends with the
+	 * connection.
+	 */
+	request("GET /dynamic HTTP/1.0\r\n\r\n", "HTTP/1.1 200 OK\r\n");
+
+	zassert_is_null(strstr(response, "Transfer-Encoding"));
+	zassert_not_null(strstr(response, "Connection: close\r\n"));
+	zassert_not_null(strstr(response, "\r\n\r\npart0part1part2"));
+}
+
+ZTEST(http_server, test_start_twice)
+{
+	zassert_equal(http_server_start(), -EALREADY);
+}
+
+static K_THREAD_STACK_ARRAY_DEFINE(load_stacks, LOAD_CLIENTS, 2048);
+static struct k_thread load_threads[LOAD_CLIENTS];
+static atomic_t load_failures;
+
+static void load_client(void *p1, void *p2, void *p3)
+{
+	static const char req[] = "GET / HTTP/1.1\r\n\r\n";
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(test_port),
+	};
+	char buf[128];
+	int fd;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	zsock_inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+	fd = zsock_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0 ||
+	    zsock_connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		atomic_inc(&load_failures);
+		goto out;
+	}
+
+	for (int i = 0; i < LOAD_REQUESTS; i++) {
+		size_t len = 0;
+
+		if (zsock_send(fd, req, sizeof(req) - 1, 0) != sizeof(req) - 1) {
+			atomic_inc(&load_failures);
+			break;
+		}
+
+		/* Every response ends with the closing tag of the page */
+		while (len < sizeof(buf) - 1) {
+			ssize_t ret = zsock_recv(fd, buf + len,
+						 sizeof(buf) - 1 - len, 0);
+
+			if (ret <= 0) {
+				atomic_inc(&load_failures);
+				goto out;
+			}
+
+			len += ret;
+			buf[len] = '\0';
+
+			if (strstr(buf, "</html>")) {
+				break;
+			}
+		}
+	}
+
+out:
+	if (fd >= 0) {
+		zsock_close(fd);
+	}
+}
+
+ZTEST(http_server, test_load)
+{
+	int64_t start = k_uptime_get();
+	int64_t elapsed;
+
+	atomic_set(&load_failures, 0);
+
+	for (int i = 0; i < LOAD_CLIENTS; i++) {
+		k_thread_create(&load_threads[i], load_stacks[i],
+				K_THREAD_STACK_SIZEOF(load_stacks[i]),
+				load_client, NULL, NULL, NULL,
+				K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < LOAD_CLIENTS; i++) {
+		zassert_ok(k_thread_join(&load_threads[i], K_SECONDS(30)));
+	}
+
+	elapsed = MAX(k_uptime_get() - start, 1);
+
+	zassert_equal(atomic_get(&load_failures), 0);
+
+	TC_PRINT("%d requests on %d connections in %lld ms (%lld req/s)\n",
+		 LOAD_CLIENTS * LOAD_REQUESTS, LOAD_CLIENTS, elapsed,
+		 LOAD_CLIENTS * LOAD_REQUESTS * 1000LL / elapsed);
+}
+
+static void *http_server_setup(void)
+{
+	zassert_ok(http_server_start());
+	zassert_not_equal(test_port, 0, "No ephemeral port assigned");
+
+	return NULL;
+}
+
+static void http_server_teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_ok(http_server_stop());
+	zassert_equal(http_server_stop(), -EALREADY);
+}
+
+ZTEST_SUITE(http_server, NULL, http_server_setup, NULL, NULL,
+	    http_server_teardown);
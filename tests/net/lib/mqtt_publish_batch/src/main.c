@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include <zephyr/ztest.h>
+#include <zephyr/net/mqtt.h>
+
+#include "mqtt_internal.h"
+#include "mqtt_transport.h"
+
+#define BUFFER_SIZE 128
+#define CAPTURE_SIZE 1024
+#define MSG_COUNT 10
+
+static uint8_t rx_buffer[BUFFER_SIZE];
+static uint8_t tx_buffer[BUFFER_SIZE];
+static struct mqtt_client client;
+
+/* Everything written by the client, and the number of writes */
+static uint8_t capture[CAPTURE_SIZE];
+static size_t capture_len;
+static int writes;
+
+/* Connection accepted */
+static const uint8_t connack[] = { 0x20, 0x02, 0x00, 0x00 };
+static size_t connack_offset;
+
+static struct mqtt_publish_param params[MSG_COUNT];
+static char payloads[MSG_COUNT][8];
+
+static void capture_data(const void *data, size_t len)
+{
+	zassert_true(capture_len + len <= sizeof(capture), "Capture overflow");
+
+	memcpy(capture + capture_len, data, len);
+	capture_len += len;
+}
+
+int mqtt_client_custom_transport_connect(struct mqtt_client *client)
+{
+	connack_offset = 0;
+
+	return 0;
+}
+
+int mqtt_client_custom_transport_write(struct mqtt_client *client,
+				       const uint8_t *data, uint32_t datalen)
+{
+	capture_data(data, datalen);
+	writes++;
+
+	return 0;
+}
+
+int mqtt_client_custom_transport_write_msg(struct mqtt_client *client,
+					   const struct msghdr *message)
+{
+	for (size_t i = 0; i < message->msg_iovlen; i++) {
+		capture_data(message->msg_iov[i].iov_base,
+			     message->msg_iov[i].iov_len);
+	}
+
+	writes++;
+
+	return 0;
+}
+
+int mqtt_client_custom_transport_read(struct mqtt_client *client,
+				      uint8_t *data, uint32_t buflen,
+				      bool shall_block)
+{
+	size_t len = MIN(buflen, sizeof(connack) - connack_offset);
+
+	if (len == 0) {
+		return -EAGAIN;
+	}
+
+	memcpy(data, connack + connack_offset, len);
+	connack_offset += len;
+
+	return len;
+}
+
+int mqtt_client_custom_transport_disconnect(struct mqtt_client *client)
+{
+	return 0;
+}
+
+static void reset_capture(void)
+{
+	capture_len = 0;
+	writes = 0;
+}
+
+static void client_connect(void)
+{
+	mqtt_client_init(&client);
+
+	client.client_id = MQTT_UTF8_LITERAL("zephyr");
+	client.transport.type = MQTT_TRANSPORT_CUSTOM;
+	client.rx_buf = rx_buffer;
+	client.rx_buf_size = sizeof(rx_buffer);
+	client.tx_buf = tx_buffer;
+	client.tx_buf_size = sizeof(tx_buffer);
+
+	zassert_ok(mqtt_connect(&client));
+	zassert_ok(mqtt_input(&client));
+	zassert_true(MQTT_HAS_STATE(&client, MQTT_STATE_CONNECTED),
+		     "Not connected");
+
+	reset_capture();
+}
+
+/* Publishes the messages one by one, to get the expected stream */
+static size_t publish_one_by_one(uint8_t *expected, size_t count)
+{
+	size_t len;
+
+	reset_capture();
+
+	for (size_t i = 0; i < count; i++) {
+		zassert_ok(mqtt_publish(&client, &params[i]));
+	}
+
+	zassert_equal(writes, count);
+
+	len = capture_len;
+	memcpy(expected, capture, len);
+
+	reset_capture();
+
+	return len;
+}
+
+static void check_batch(size_t count, int expected_writes)
+{
+	static uint8_t expected[CAPTURE_SIZE];
+	size_t expected_len;
+
+	expected_len = publish_one_by_one(expected, count);
+
+	zassert_ok(mqtt_publish_batch(&client, params, count));
+
+	zassert_equal(writes, expected_writes, "%d writes", writes);
+	zassert_equal(capture_len, expected_len);
+	zassert_mem_equal(capture, expected, expected_len);
+}
+
+ZTEST(mqtt_publish_batch, test_single_write)
+{
+	check_batch(3, 1);
+}
+
+ZTEST(mqtt_publish_batch, test_batch_size_limit)
+{
+	/* Batches of CONFIG_MQTT_PUBLISH_BATCH_SIZE messages */
+	check_batch(MSG_COUNT, 3);
+}
+
+ZTEST(mqtt_publish_batch, test_tx_buffer_full)
+{
+	/* Encoding takes 19 bytes of the TX buffer for a QoS 0 header and
+	 * 21 bytes for a QoS 1 one, so the third header does not fit.
+	 */
+	client.tx_buf_size = 19 + 21 + 19 - 1;
+
+	check_batch(4, 2);
+}
+
+ZTEST(mqtt_publish_batch, test_tx_buffer_almost_full)
+{
+	/* The first two headers end at byte 40, leaving less room than the
+	 * fixed header reservation. Nothing may be written past the end of
+	 * the TX buffer.
+	 */
+	client.tx_buf_size = 19 + 21 + 3;
+	memset(tx_buffer + client.tx_buf_size, 0xAA,
+	       sizeof(tx_buffer) - client.tx_buf_size);
+
+	check_batch(4, 2);
+
+	for (size_t i = client.tx_buf_size; i < sizeof(tx_buffer); i++) {
+		zassert_equal(tx_buffer[i], 0xAA, "TX buffer overflow at %zu",
+			      i);
+	}
+}
+
+ZTEST(mqtt_publish_batch, test_invalid_message)
+{
+	params[1].message_id = 0;
+
+	/* Nothing is written before the whole batch is encoded */
+	zassert_equal(mqtt_publish_batch(&client, params, 3), -EINVAL);
+	zassert_equal(writes, 0);
+}
+
+ZTEST(mqtt_publish_batch, test_not_connected)
+{
+	zassert_ok(mqtt_abort(&client));
+	reset_capture();
+
+	zassert_equal(mqtt_publish_batch(&client, params, 1), -ENOTCONN);
+	zassert_equal(writes, 0);
+}
+
+static void mqtt_publish_batch_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	client_connect();
+
+	for (size_t i = 0; i < MSG_COUNT; i++) {
+		snprintk(payloads[i], sizeof(payloads[i]), "value%zu", i);
+
+		memset(&params[i], 0, sizeof(params[i]));
+		params[i].message.topic.topic = MQTT_UTF8_LITERAL("sensors/temp");
+		params[i].message.topic.qos = i % 2;
+		params[i].message.payload.data = (uint8_t *)payloads[i];
+		params[i].message.payload.len = strlen(payloads[i]);
+		params[i].message_id = i + 1;
+	}
+}
+
+ZTEST_SUITE(mqtt_publish_batch, NULL, NULL, mqtt_publish_batch_before,
+	    NULL, NULL);
@@ -1239,4 +1239,68 @@ ZTEST(net_pkt_test_suite, test_net_pkt_shallow_clone_append_buf_2)
 	test_net_pkt_shallow_clone_append_buf(2);
 }
 
+ZTEST(net_pkt_test_suite, test_net_pkt_shared_clone)
+{
+	const int bufs_to_allocate = 3;
+	const size_t pkt_size = CONFIG_NET_BUF_DATA_SIZE * bufs_to_allocate;
+	struct net_pkt *pkt, *clone_pkt, *other;
+	struct net_buf_pool *tx_data;
+	struct net_buf *buf, *clone_buf;
+	uint8_t byte;
+	int i;
+
+	pkt = net_pkt_alloc_with_buffer(NULL, pkt_size, AF_UNSPEC, 0, K_NO_WAIT);
+	zassert_true(pkt != NULL, "Pkt not allocated");
+
+	for (i = 0; i < pkt_size; i++) {
+		zassert_ok(net_pkt_write_u8(pkt, (uint8_t)i), "Write failed");
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_skip(pkt, 5);
+
+	clone_pkt = net_pkt_shared_clone(pkt, K_NO_WAIT);
+	zassert_true(clone_pkt != NULL, "Pkt not allocated");
+	zassert_equal(net_pkt_get_len(clone_pkt), pkt_size, "Bad length");
+	zassert_equal(net_pkt_get_current_offset(clone_pkt), 5, "Bad cursor");
+
+	/* Each fragment has its own header, but the data is shared */
+	for (buf = pkt->buffer, clone_buf = clone_pkt->buffer; buf;
+	     buf = buf->frags, clone_buf = clone_buf->frags) {
+		zassert_not_null(clone_buf, "Missing fragment");
+		zassert_not_equal(clone_buf, buf, "Fragment not cloned");
+		zassert_equal_ptr(clone_buf->__buf, buf->__buf, "Data not shared");
+	}
+
+	net_pkt_get_info(NULL, NULL, NULL, &tx_data);
+	zassert_equal(atomic_get(&tx_data->avail_count),
+		      tx_data->buf_count - 2 * bufs_to_allocate,
+		      "Incorrect net buf allocation");
+
+	/* Moving the data start of the clone does not affect the original */
+	net_buf_pull(clone_pkt->buffer, 10);
+	zassert_equal(net_pkt_get_len(pkt), pkt_size, "Original modified");
+
+	net_pkt_unref(pkt);
+
+	/* The shared data is not handed out again while in use */
+	other = net_pkt_alloc_with_buffer(NULL, pkt_size, AF_UNSPEC, 0,
+					  K_NO_WAIT);
+	zassert_true(other != NULL, "Pkt not allocated");
+	zassert_ok(net_pkt_memset(other, 0xff, pkt_size), "Memset failed");
+
+	net_pkt_cursor_init(clone_pkt);
+	for (i = 10; i < pkt_size; i++) {
+		zassert_ok(net_pkt_read_u8(clone_pkt, &byte), "Read failed");
+		zassert_equal(byte, (uint8_t)i, "Shared data corrupted");
+	}
+
+	net_pkt_unref(other);
+	net_pkt_unref(clone_pkt);
+
+	zassert_equal(atomic_get(&tx_data->avail_count), tx_data->buf_count,
+		      "Leak detected");
+}
+
 ZTEST_SUITE(net_pkt_test_suite, NULL, NULL, NULL, NULL, NULL);
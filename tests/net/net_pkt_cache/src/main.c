@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_PKT_LOG_LEVEL);
+
+#include <zephyr/ztest.h>
+#include <zephyr/net/ethernet.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+
+#include "net_private.h"
+
+#define SMALL_LEN CONFIG_NET_PKT_CACHE_SMALL_SIZE
+#define REFILL CONFIG_NET_PKT_CACHE_REFILL
+
+static struct k_mem_slab *tx_slab;
+static struct net_buf_pool *tx_pool;
+
+static int eth_fake_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+ETH_NET_DEVICE_INIT(eth_fake, "eth_fake", eth_fake_init, NULL,
+		    NULL, NULL, CONFIG_ETH_INIT_PRIORITY,
+		    NULL, NET_ETH_MTU);
+
+#define fake_iface NET_IF_GET_NAME(eth_fake, 0)[0]
+
+static struct net_pkt *alloc_udp(size_t len)
+{
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(&fake_iface, len, AF_INET,
+					IPPROTO_UDP, K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt of %zu bytes", len);
+
+	return pkt;
+}
+
+static void *cache_setup(void)
+{
+	net_pkt_get_info(NULL, &tx_slab, NULL, &tx_pool);
+
+	return NULL;
+}
+
+static void cache_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	net_pkt_cache_flush(&fake_iface);
+	net_if_set_mtu(&fake_iface, NET_ETH_MTU);
+
+	zassert_equal(k_mem_slab_num_used_get(tx_slab), 0, "Packet leak");
+	zassert_equal(atomic_get(&tx_pool->avail_count), tx_pool->buf_count,
+		      "Buffer leak");
+}
+
+ZTEST(net_pkt_cache, test_small_class)
+{
+	struct net_pkt *pkt1, *pkt2;
+
+	pkt1 = alloc_udp(8);
+	zassert_equal(net_pkt_available_buffer(pkt1), SMALL_LEN, "");
+	zassert_equal(net_pkt_family(pkt1), AF_INET, "");
+	zassert_equal_ptr(net_pkt_iface(pkt1), &fake_iface, "");
+	zassert_equal(atomic_get(&pkt1->atomic_ref), 1, "");
+
+	/* The first allocation refilled the cache */
+	zassert_equal(k_mem_slab_num_used_get(tx_slab), REFILL, "");
+
+	pkt2 = alloc_udp(0);
+	zassert_equal(net_pkt_available_buffer(pkt2), SMALL_LEN, "");
+	zassert_equal(k_mem_slab_num_used_get(tx_slab), REFILL,
+		      "Not served from the cache");
+
+	zassert_ok(net_pkt_write_be32(pkt2, 0x01020304), "");
+	zassert_equal(net_pkt_get_len(pkt2), sizeof(uint32_t), "");
+
+	net_pkt_unref(pkt1);
+	net_pkt_unref(pkt2);
+
+	zassert_equal(k_mem_slab_num_used_get(tx_slab), REFILL - 2, "");
+}
+
+ZTEST(net_pkt_cache, test_mtu_class)
+{
+	struct net_pkt *pkt;
+
+	/* Capped to the MTU, so served from the MTU sized class */
+	pkt = alloc_udp(1600);
+	zassert_equal(net_pkt_available_buffer(pkt), NET_ETH_MTU, "");
+	zassert_equal(k_mem_slab_num_used_get(tx_slab), REFILL, "");
+
+	net_pkt_unref(pkt);
+
+	pkt = alloc_udp(NET_ETH_MTU - NET_IPV4UDPH_LEN);
+	zassert_equal(net_pkt_available_buffer(pkt), NET_ETH_MTU, "");
+	zassert_equal(k_mem_slab_num_used_get(tx_slab), REFILL - 1,
+		      "Not served from the cache");
+
+	net_pkt_unref(pkt);
+}
+
+ZTEST(net_pkt_cache, test_other_sizes)
+{
+	struct net_pkt *pkt;
+
+	pkt = alloc_udp(512);
+	zassert_equal(net_pkt_available_buffer(pkt), 512 + NET_IPV4UDPH_LEN,
+		      "");
+	zassert_equal(k_mem_slab_num_used_get(tx_slab), 1, "Cache was used");
+	net_pkt_unref(pkt);
+
+	pkt = net_pkt_alloc_with_buffer(&fake_iface, 8, AF_UNSPEC, 0,
+					K_NO_WAIT);
+	zassert_not_null(pkt, "");
+	zassert_equal(net_pkt_available_buffer(pkt), 8, "");
+	zassert_equal(k_mem_slab_num_used_get(tx_slab), 1, "Cache was used");
+	net_pkt_unref(pkt);
+
+	pkt = net_pkt_rx_alloc_with_buffer(&fake_iface, 8, AF_INET,
+					   IPPROTO_UDP, K_NO_WAIT);
+	zassert_not_null(pkt, "");
+	zassert_equal(k_mem_slab_num_used_get(tx_slab), 0, "Cache was used");
+	net_pkt_unref(pkt);
+}
+
+ZTEST(net_pkt_cache, test_mtu_change)
+{
+	struct net_pkt *pkt;
+
+	net_pkt_unref(alloc_udp(1600));
+	zassert_equal(k_mem_slab_num_used_get(tx_slab), REFILL - 1, "");
+
+	net_if_set_mtu(&fake_iface, 1280);
+
+	/* The packets cached for the old MTU are replaced */
+	pkt = alloc_udp(1600);
+	zassert_equal(net_pkt_available_buffer(pkt), 1280, "");
+	zassert_equal(k_mem_slab_num_used_get(tx_slab), REFILL, "");
+
+	net_pkt_unref(pkt);
+}
+
+#if defined(CONFIG_NET_DEBUG_NET_PKT_ALLOC)
+static void count_pkts(struct net_pkt *pkt, struct net_buf *buf,
+		       const char *func_alloc, int line_alloc,
+		       const char *func_free, int line_free,
+		       bool in_use, void *user_data)
+{
+	int *count = user_data;
+
+	if (pkt && in_use && pkt->slab == tx_slab) {
+		(*count)++;
+	}
+}
+
+ZTEST(net_pkt_cache, test_leak_tracking)
+{
+	struct net_pkt *pkt;
+	int count = 0;
+
+	pkt = alloc_udp(8);
+
+	/* Only the packet handed out is accounted, not the cached ones */
+	net_pkt_allocs_foreach(count_pkts, &count);
+	zassert_equal(count, 1, "%d packets in use", count);
+
+	net_pkt_unref(pkt);
+
+	count = 0;
+	net_pkt_allocs_foreach(count_pkts, &count);
+	zassert_equal(count, 0, "%d packets in use", count);
+}
+#endif /* CONFIG_NET_DEBUG_NET_PKT_ALLOC */
+
+ZTEST_SUITE(net_pkt_cache, NULL, cache_setup, NULL, cache_after, NULL);
@@ -314,4 +314,55 @@ ZTEST(net_pkt_filter_test_suite, test_npf_address_mask)
 	test_npf_eth_mac_addr_mask();
 }
 
+/*
+ * Conditions without a compiled form are called from the filter program.
+ */
+
+struct npf_test_custom {
+	struct npf_test test;
+	size_t len;
+	int calls;
+};
+
+static bool custom_len_match(struct npf_test *test, struct net_pkt *pkt)
+{
+	struct npf_test_custom *custom =
+			CONTAINER_OF(test, struct npf_test_custom, test);
+
+	custom->calls++;
+
+	return net_pkt_get_len(pkt) == custom->len;
+}
+
+static struct npf_test_custom custom_len_100 = {
+	.test.fn = custom_len_match,
+	.len = 100,
+};
+
+static NPF_RULE(accept_ip_len_100, NET_OK, ip_packet, custom_len_100);
+
+ZTEST(net_pkt_filter_test_suite, test_npf_custom_condition)
+{
+	struct net_pkt *pkt_100 = build_test_pkt(NET_ETH_PTYPE_IP, 100, NULL);
+	struct net_pkt *pkt_101 = build_test_pkt(NET_ETH_PTYPE_IP, 101, NULL);
+	struct net_pkt *pkt_arp = build_test_pkt(NET_ETH_PTYPE_ARP, 100, NULL);
+
+	npf_append_recv_rule(&accept_ip_len_100);
+	npf_append_recv_rule(&npf_default_drop);
+
+	zassert_true(net_pkt_filter_recv_ok(pkt_100), "");
+	zassert_false(net_pkt_filter_recv_ok(pkt_101), "");
+	zassert_equal(custom_len_100.calls, 2, "");
+
+	/* not called once an earlier condition of the rule failed */
+	zassert_false(net_pkt_filter_recv_ok(pkt_arp), "");
+	zassert_equal(custom_len_100.calls, 2, "");
+
+	zassert_true(npf_remove_all_recv_rules(), "");
+
+	net_pkt_unref(pkt_100);
+	net_pkt_unref(pkt_101);
+	net_pkt_unref(pkt_arp);
+}
+
 ZTEST_SUITE(net_pkt_filter_test_suite, NULL, test_npf_iface, NULL, NULL, NULL);
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_CAPTURE_PCAPNG_LOG_LEVEL);
+
+#include <zephyr/ztest.h>
+#include <zephyr/net/ethernet.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/capture.h>
+
+#define SHB_LEN 28
+#define IDB_LEN 20
+#define ISB_LEN 52
+#define EPB_HDR_LEN 28
+
+static uint8_t stream[CONFIG_NET_CAPTURE_PCAPNG_RING_SIZE];
+
+static int eth_fake_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+ETH_NET_DEVICE_INIT(eth_fake, "eth_fake", eth_fake_init, NULL,
+		    NULL, NULL, CONFIG_ETH_INIT_PRIORITY,
+		    NULL, NET_ETH_MTU);
+
+#define fake_iface NET_IF_GET_NAME(eth_fake, 0)[0]
+
+static struct net_pkt *build_pkt(size_t len)
+{
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_rx_alloc_with_buffer(&fake_iface, len, AF_UNSPEC, 0,
+					   K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	for (size_t i = 0; i < len; i++) {
+		zassert_ok(net_pkt_write_u8(pkt, (uint8_t)i), "");
+	}
+
+	return pkt;
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+	uint32_t val;
+
+	memcpy(&val, p, sizeof(val));
+
+	return val;
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+	uint16_t val;
+
+	memcpy(&val, p, sizeof(val));
+
+	return val;
+}
+
+static void pcapng_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	(void)net_capture_pcapng_disable(&fake_iface);
+	net_capture_pcapng_set_snaplen(CONFIG_NET_CAPTURE_PCAPNG_SNAPLEN);
+	net_capture_pcapng_reset();
+}
+
+ZTEST(net_pcapng, test_section_and_iface)
+{
+	size_t len;
+
+	zassert_ok(net_capture_pcapng_enable(&fake_iface), "");
+	zassert_equal(net_capture_pcapng_enable(&fake_iface), -EALREADY, "");
+
+	len = net_capture_pcapng_read(stream, sizeof(stream));
+	zassert_equal(len, SHB_LEN + IDB_LEN, "Unexpected length %zu", len);
+
+	zassert_equal(get_u32(&stream[0]), 0x0A0D0D0A, "Not a section header");
+	zassert_equal(get_u32(&stream[8]), 0x1A2B3C4D, "Bad byte order magic");
+
+	zassert_equal(get_u32(&stream[SHB_LEN]), 1, "Not an iface description");
+	zassert_equal(get_u16(&stream[SHB_LEN + 8]), 1, "Not Ethernet");
+	zassert_equal(get_u32(&stream[SHB_LEN + 12]),
+		      CONFIG_NET_CAPTURE_PCAPNG_SNAPLEN, "Bad snaplen");
+}
+
+ZTEST(net_pcapng, test_snaplen)
+{
+	struct net_pkt *pkt = build_pkt(100);
+	uint8_t *epb = &stream[SHB_LEN + IDB_LEN];
+	size_t len;
+
+	net_capture_pcapng_set_snaplen(30);
+	zassert_ok(net_capture_pcapng_enable(&fake_iface), "");
+
+	net_capture_pkt(&fake_iface, pkt);
+	net_pkt_unref(pkt);
+
+	len = net_capture_pcapng_read(stream, sizeof(stream));
+	zassert_equal(len, SHB_LEN + IDB_LEN + EPB_HDR_LEN + 32 + 4,
+		      "Unexpected length %zu", len);
+
+	zassert_equal(get_u32(&epb[0]), 6, "Not an enhanced packet block");
+	zassert_equal(get_u32(&epb[4]), EPB_HDR_LEN + 32 + 4, "Bad block length");
+	zassert_equal(get_u32(&epb[20]), 30, "Bad captured length");
+	zassert_equal(get_u32(&epb[24]), 100, "Bad original length");
+
+	for (int i = 0; i < 30; i++) {
+		zassert_equal(epb[EPB_HDR_LEN + i], i, "Bad data at %d", i);
+	}
+
+	zassert_equal(get_u32(&epb[EPB_HDR_LEN + 32]), EPB_HDR_LEN + 32 + 4,
+		      "Bad trailing block length");
+}
+
+ZTEST(net_pcapng, test_drops)
+{
+	struct net_capture_pcapng_stats stats;
+	struct net_pkt *pkt = build_pkt(64);
+	int count = 0;
+
+	zassert_ok(net_capture_pcapng_enable(&fake_iface), "");
+
+	/* Nobody drains the ring, so it eventually fills up */
+	for (int i = 0; i < 16; i++) {
+		net_capture_pkt(&fake_iface, pkt);
+	}
+
+	net_pkt_unref(pkt);
+
+	zassert_ok(net_capture_pcapng_get_stats(&fake_iface, &stats), "");
+	zassert_true(stats.dropped > 0, "Nothing dropped");
+	zassert_equal(stats.captured + stats.dropped, 16, "Packets lost");
+
+	/* Draining makes room for the statistics record */
+	while (net_capture_pcapng_read(stream, sizeof(stream)) > 0) {
+		count++;
+	}
+
+	zassert_true(count > 0, "");
+	zassert_ok(net_capture_pcapng_disable(&fake_iface), "");
+	zassert_equal(net_capture_pcapng_get_stats(&fake_iface, &stats),
+		      -ENOENT, "");
+
+	zassert_equal(net_capture_pcapng_read(stream, sizeof(stream)), ISB_LEN,
+		      "No statistics record");
+	zassert_equal(get_u32(&stream[0]), 5, "Not an iface statistics block");
+}
+
+ZTEST_SUITE(net_pcapng, NULL, NULL, pcapng_before, NULL, NULL);
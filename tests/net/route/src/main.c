@@ -544,6 +544,42 @@ static void test_route_preference(void)
 	net_route_del(entry);
 }
 
+static void test_route_longest_prefix(void)
+{
+	struct net_route_entry *host_route, *prefix_route;
+
+	host_route = net_route_add(my_iface,
+				   &dest_addr, 128,
+				   &peer_addr,
+				   NET_IPV6_ND_INFINITE_LIFETIME,
+				   NET_ROUTE_PREFERENCE_LOW);
+	zassert_not_null(host_route, "Host route add failed");
+
+	prefix_route = net_route_add(my_iface,
+				     &generic_addr, 64,
+				     &peer_addr,
+				     NET_IPV6_ND_INFINITE_LIFETIME,
+				     NET_ROUTE_PREFERENCE_LOW);
+	zassert_not_null(prefix_route, "Prefix route add failed");
+	zassert_not_equal(prefix_route, host_route, "Prefix route not added");
+
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addr), host_route,
+			  "Longest prefix not selected");
+	zassert_equal_ptr(net_route_lookup(my_iface, &peer_addr_alt),
+			  prefix_route, "Prefix route not selected");
+	zassert_equal_ptr(net_route_lookup(NULL, &generic_addr),
+			  prefix_route, "Prefix route not found on any iface");
+
+	zassert_false(net_route_del(host_route), "Host route del failed");
+
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addr), prefix_route,
+			  "Deleted host route still selected");
+
+	zassert_false(net_route_del(prefix_route), "Prefix route del failed");
+
+	zassert_is_null(net_route_lookup(my_iface, &dest_addr),
+			"Deleted prefix route still selected");
+}
 
 /*test case main entry*/
 ZTEST(route_test_suite, test_route)
@@ -566,6 +602,7 @@ ZTEST(route_test_suite, test_route)
 	test_route_del_many();
 	test_route_lifetime();
 	test_route_preference();
+	test_route_longest_prefix();
 }
 
 ZTEST_SUITE(route_test_suite, NULL, NULL, NULL, NULL, NULL);
@@ -295,6 +295,62 @@ ZTEST(socket_packet, test_raw_packet_sockets)
 	close(sock4);
 }
 
+ZTEST(socket_packet, test_raw_packet_sockets_connected_udp)
+{
+	uint8_t data_to_send[] = { 20, 21, 22, 23, 24, 25, 26, 27, 28, 29 };
+	uint8_t data_to_receive[sizeof(data_to_send) + HDR_SIZE];
+	struct sockaddr_in src_addr, dst_addr;
+	int ret, sock1, sock2, sock3, sock4;
+	ssize_t sent = 0;
+
+	__test_packet_sockets(&sock1, &sock2);
+
+	/* Both UDP sockets are connected, so none of the UDP connections
+	 * is left that is not fully specified.
+	 */
+	sock3 = prepare_udp_socket(&dst_addr, DST_PORT);
+	sock4 = prepare_udp_socket(&src_addr, SRC_PORT);
+
+	ret = connect(sock3, (struct sockaddr *)&src_addr, sizeof(src_addr));
+	zassert_equal(ret, 0, "Cannot connect receiving socket (%d)", -errno);
+
+	ret = connect(sock4, (struct sockaddr *)&dst_addr, sizeof(dst_addr));
+	zassert_equal(ret, 0, "Cannot connect sending socket (%d)", -errno);
+
+	sent = send(sock4, data_to_send, sizeof(data_to_send), 0);
+	zassert_equal(sent, sizeof(data_to_send), "send failed");
+
+	k_msleep(10); /* Let the packet enter the system */
+
+	/* The packet socket sees the packet... */
+	setblocking(sock1, false);
+	memset(&data_to_receive, 0, sizeof(data_to_receive));
+	errno = 0;
+
+	ret = recv(sock1, data_to_receive, sizeof(data_to_receive), 0);
+	zassert_equal(ret, sizeof(data_to_send) + HDR_SIZE,
+		      "Cannot receive all data on packet socket (%d)", -errno);
+	zassert_mem_equal(&data_to_receive[HDR_SIZE], data_to_send,
+			  sizeof(data_to_send),
+			  "Sent and received buffers do not match");
+
+	/* ...and so does the connected UDP socket */
+	setblocking(sock3, false);
+	memset(&data_to_receive, 0, sizeof(data_to_receive));
+	errno = 0;
+
+	ret = recv(sock3, data_to_receive, sizeof(data_to_receive), 0);
+	zassert_equal(ret, sizeof(data_to_send), "Cannot receive all data (%d)",
+		      -errno);
+	zassert_mem_equal(data_to_receive, data_to_send, sizeof(data_to_send),
+			  "Sent and received buffers do not match");
+
+	close(sock1);
+	close(sock2);
+	close(sock3);
+	close(sock4);
+}
+
 ZTEST(socket_packet, test_packet_sockets)
 {
 	int sock1, sock2;
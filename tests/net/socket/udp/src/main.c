@@ -1294,4 +1294,187 @@ ZTEST(net_socket_udp, test_23_v6_dgram_overflow)
 			    BUF_AND_SIZE(test_str_all_tx_bufs));
 }
 
+ZTEST(net_socket_udp, test_25_v4_sendmmsg_recvmmsg)
+{
+	static const char *const tx_data[] = {
+		TEST_STR_SMALL, TEST_STR2, TEST_STR_SMALL,
+	};
+	static char rx_data[ARRAY_SIZE(tx_data)][sizeof(TEST_STR2)];
+	struct iovec tx_iov[ARRAY_SIZE(tx_data)];
+	struct iovec rx_iov[ARRAY_SIZE(tx_data)];
+	struct mmsghdr tx_msgs[ARRAY_SIZE(tx_data)];
+	struct mmsghdr rx_msgs[ARRAY_SIZE(tx_data) + 1];
+	struct sockaddr_in rx_addr[ARRAY_SIZE(tx_data)];
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	int rv;
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, ANY_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	memset(tx_msgs, 0, sizeof(tx_msgs));
+	memset(rx_msgs, 0, sizeof(rx_msgs));
+
+	for (int i = 0; i < ARRAY_SIZE(tx_data); i++) {
+		tx_iov[i].iov_base = (void *)tx_data[i];
+		tx_iov[i].iov_len = strlen(tx_data[i]);
+		tx_msgs[i].msg_hdr.msg_name = &server_addr;
+		tx_msgs[i].msg_hdr.msg_namelen = sizeof(server_addr);
+		tx_msgs[i].msg_hdr.msg_iov = &tx_iov[i];
+		tx_msgs[i].msg_hdr.msg_iovlen = 1;
+
+		rx_iov[i].iov_base = rx_data[i];
+		rx_iov[i].iov_len = sizeof(rx_data[i]);
+		rx_msgs[i].msg_hdr.msg_name = &rx_addr[i];
+		rx_msgs[i].msg_hdr.msg_namelen = sizeof(rx_addr[i]);
+		rx_msgs[i].msg_hdr.msg_iov = &rx_iov[i];
+		rx_msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	rv = sendmmsg(client_sock, tx_msgs, ARRAY_SIZE(tx_msgs), 0);
+	zassert_equal(rv, ARRAY_SIZE(tx_msgs), "sendmmsg failed (%d)", errno);
+
+	for (int i = 0; i < ARRAY_SIZE(tx_data); i++) {
+		zassert_equal(tx_msgs[i].msg_len, strlen(tx_data[i]),
+			      "wrong sent length");
+	}
+
+	/* Let the loopback deliver every datagram before reading them */
+	k_msleep(50);
+
+	/* Asking for more than is queued returns what is available */
+	rv = recvmmsg(server_sock, rx_msgs, ARRAY_SIZE(rx_msgs), 0);
+	zassert_equal(rv, ARRAY_SIZE(tx_data), "recvmmsg failed (%d)", errno);
+
+	for (int i = 0; i < ARRAY_SIZE(tx_data); i++) {
+		zassert_equal(rx_msgs[i].msg_len, strlen(tx_data[i]),
+			      "wrong received length");
+		zassert_mem_equal(rx_data[i], tx_data[i], rx_msgs[i].msg_len,
+				  "wrong data");
+		zassert_equal(rx_msgs[i].msg_hdr.msg_namelen,
+			      sizeof(struct sockaddr_in), "unexpected addrlen");
+		zassert_equal(rx_msgs[i].msg_hdr.msg_flags, 0,
+			      "unexpected flags");
+	}
+
+	rv = recvmmsg(server_sock, rx_msgs, ARRAY_SIZE(rx_msgs), MSG_DONTWAIT);
+	zassert_equal(rv, -1, "recvmmsg succeeded on empty queue");
+	zassert_equal(errno, EAGAIN, "unexpected errno");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+static K_SEM_DEFINE(zerocopy_released, 0, 1);
+static const void *zerocopy_data;
+static size_t zerocopy_len;
+
+static void zerocopy_cb(const void *data, size_t len, void *user_data)
+{
+	zerocopy_data = data;
+	zerocopy_len = len;
+	k_sem_give(&zerocopy_released);
+}
+
+ZTEST(net_socket_udp, test_26_v4_zerocopy)
+{
+	static const char tx_data[] = TEST_STR2;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	struct net_buf *buf;
+	ssize_t len;
+	int rv;
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, ANY_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	rv = zsock_set_zerocopy_cb(client_sock, zerocopy_cb, NULL);
+	zassert_equal(rv, 0, "cannot set zerocopy callback");
+
+	len = sendto(client_sock, BUF_AND_SIZE(tx_data), MSG_ZEROCOPY,
+		     (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(len, STRLEN(tx_data), "sendto failed");
+
+	/* The loopback driver clones the packet, so the data is released
+	 * as soon as it has been sent.
+	 */
+	zassert_equal(k_sem_take(&zerocopy_released, K_MSEC(100)), 0,
+		      "data not released");
+	zassert_equal_ptr(zerocopy_data, tx_data, "wrong data released");
+	zassert_equal(zerocopy_len, STRLEN(tx_data), "wrong length released");
+
+	len = zsock_recv_buf(server_sock, &buf, 0, &addr, &addrlen);
+	zassert_equal(len, STRLEN(tx_data), "zsock_recv_buf failed");
+	zassert_not_null(buf, "no buffer received");
+	zassert_equal(addrlen, sizeof(struct sockaddr_in), "unexpected addrlen");
+	zassert_equal(net_buf_frags_len(buf), len, "wrong buffer length");
+
+	clear_buf(rx_buf);
+	net_buf_linearize(rx_buf, sizeof(rx_buf), buf, 0, len);
+	zassert_mem_equal(rx_buf, BUF_AND_SIZE(tx_data), "wrong data");
+
+	zsock_release_buf(server_sock, buf);
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+ZTEST(net_socket_udp, test_27_v4_zerocopy_dgram_overflow)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	ssize_t len;
+	int rv;
+
+	prepare_sock_udp_v4(MY_IPV4_ADDR, ANY_PORT, &client_sock, &client_addr);
+	prepare_sock_udp_v4(MY_IPV4_ADDR, SERVER_PORT, &server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	rv = zsock_set_zerocopy_cb(client_sock, zerocopy_cb, NULL);
+	zassert_equal(rv, 0, "cannot set zerocopy callback");
+
+	/* The data is not copied into the packet, but the datagram must
+	 * still fit in the MTU.
+	 */
+	len = sendto(client_sock, test_str_all_tx_bufs, NET_ETH_MTU + 1,
+		     MSG_ZEROCOPY, (struct sockaddr *)&server_addr,
+		     sizeof(server_addr));
+	zassert_equal(len, -1, "sendto succeeded");
+	zassert_equal(errno, ENOMEM, "incorrect errno value");
+
+	/* A failed send keeps the data with the caller */
+	zassert_equal(k_sem_take(&zerocopy_released, K_MSEC(10)), -EAGAIN,
+		      "data released");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY */
+
 ZTEST_SUITE(net_socket_udp, NULL, NULL, NULL, NULL, NULL);
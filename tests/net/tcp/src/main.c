@@ -20,6 +20,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_TCP_LOG_LEVEL);
 #include <stddef.h>
 #include <string.h>
 #include <zephyr/sys/printk.h>
+#include <zephyr/sys/byteorder.h>
 #include <zephyr/linker/sections.h>
 #include <zephyr/tc_util.h>
 
@@ -30,7 +31,7 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_TCP_LOG_LEVEL);
 #include "ipv4.h"
 #include "ipv6.h"
 #include "tcp.h"
-#include "tcp_private.h"
+#include "tcp_internal.h"
 #include "net_stats.h"
 
 #include <zephyr/ztest.h>
@@ -125,6 +126,7 @@ static void handle_syn_resend(void);
 static void handle_client_fin_wait_2_test(sa_family_t af, struct tcphdr *th);
 static void handle_client_closing_test(sa_family_t af, struct tcphdr *th);
 static void handle_server_recv_out_of_order(struct net_pkt *pkt);
+static void handle_syn_cookie_test(struct tcphdr *th);
 
 static void verify_flags(struct tcphdr *th, uint8_t flags,
 			 const char *fun, int line)
@@ -388,6 +390,59 @@ fail:
 	return -EINVAL;
 }
 
+/* The SYN ACK must carry the options both the peer and we support */
+static void check_syn_ack_options(struct net_pkt *pkt, struct tcphdr *th)
+{
+	uint8_t opts[NET_TCP_MAX_OPT_SIZE];
+	size_t opts_len = (th->th_off - 5) * 4;
+	bool wscale = false, sack_perm = false, ts = false;
+	size_t i;
+
+	if (th->th_flags != (SYN | ACK)) {
+		return;
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+	net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) + net_pkt_ip_opts_len(pkt) +
+		     sizeof(struct tcphdr));
+	zassert_ok(net_pkt_read(pkt, opts, opts_len), "cannot read options");
+	net_pkt_cursor_init(pkt);
+
+	for (i = 0; i < opts_len && opts[i] != NET_TCP_END_OPT; ) {
+		if (opts[i] == NET_TCP_NOP_OPT) {
+			i++;
+			continue;
+		}
+
+		switch (opts[i]) {
+		case NET_TCP_WINDOW_SCALE_OPT:
+			wscale = true;
+			break;
+		case NET_TCP_SACK_PERM_OPT:
+			sack_perm = true;
+			break;
+		case NET_TCP_TIMESTAMP_OPT:
+			ts = true;
+			/* The peer's timestamp is echoed */
+			zassert_equal(sys_get_be32(&opts[i + 6]), 0xc27bef0f,
+				      "wrong timestamp echo");
+			break;
+		default:
+			break;
+		}
+
+		i += opts[i + 1];
+	}
+
+	zassert_equal(wscale, IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE),
+		      "window scale option mismatch");
+	zassert_equal(sack_perm, IS_ENABLED(CONFIG_NET_TCP_SACK),
+		      "SACK permitted option mismatch");
+	zassert_equal(ts, IS_ENABLED(CONFIG_NET_TCP_TIMESTAMPS),
+		      "timestamps option mismatch");
+}
+
 static int tester_send(const struct device *dev, struct net_pkt *pkt)
 {
 	struct tcphdr th;
@@ -406,6 +461,10 @@ static int tester_send(const struct device *dev, struct net_pkt *pkt)
 	case 3:
 	case 4:
 	case 5:
+		if (test_case_no == 4) {
+			check_syn_ack_options(pkt, &th);
+		}
+
 		handle_server_test(net_pkt_family(pkt), &th);
 		break;
 	case 6:
@@ -420,6 +479,9 @@ static int tester_send(const struct device *dev, struct net_pkt *pkt)
 	case 9:
 		handle_server_recv_out_of_order(pkt);
 		break;
+	case 10:
+		handle_syn_cookie_test(&th);
+		break;
 	default:
 		zassert_true(false, "Undefined test case");
 	}
@@ -1409,9 +1471,9 @@ struct out_of_order_check_struct {
 static struct out_of_order_check_struct out_of_order_check_list[] = {
 	{ 30, 10, 0, 0}, /* First packet will be out-of-order */
 	{ 20, 12, 0, 0},
-	{ 10,  9, 0, 0}, /* Section with a gap */
-	{ 0,  10, 10, 0},
-	{ 10, 10, 40, 0}, /* First sequence complete */
+	{ 10,  9, 0, 0}, /* Section with a gap, queued as its own range */
+	{ 0,  10, 19, 0},
+	{ 19,  1, 40, 0}, /* First sequence complete */
 	{ 50,  6, 40, 0},
 	{ 50,  3, 40, 0}, /* Discardable packet */
 	{ 55,  5, 40, 0},
@@ -1426,6 +1488,14 @@ static struct out_of_order_check_struct out_of_order_check_list[] = {
 	{ 78,  2, 75, 0},
 	{ 77,  3, 75, 0},
 	{ 75,  2, 80, 0}, /* Over lapped in out of order processing, at boundary */
+	{150, 10, 80, 0}, /* Several separate ranges */
+	{130, 10, 80, 0},
+	{110, 10, 80, 0},
+	{ 90, 10, 80, 0},
+	{120, 15, 80, 0}, /* Overlaps and joins two ranges */
+	{140, 10, 80, 0},
+	{100, 10, 80, 0},
+	{ 80, 10, 160, 0}, /* All ranges merged */
 };
 
 static void checklist_based_out_of_order_test(struct out_of_order_check_struct *check_list,
@@ -1492,9 +1562,9 @@ static void test_server_recv_out_of_order_data(void)
 
 struct out_of_order_check_struct reorder_timeout_list[] = {
 	/* Wait more then the receive queue timeout */
-	{ 90, 10, 80, CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT * 2},
+	{170, 10, 160, CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT * 2},
 	/* First message has been timeout, so only this is acknowledged */
-	{ 80, 10, 90, 0},
+	{160, 10, 170, 0},
 };
 
 
@@ -1539,4 +1609,160 @@ ZTEST(net_tcp, test_server_out_of_order_data)
 	test_server_timeout_out_of_order_data();
 }
 
+/* Port the SYN cookie test waits for a segment on, and that segment */
+static uint16_t syn_cookie_port;
+static struct tcphdr syn_cookie_th;
+
+static void handle_syn_cookie_test(struct tcphdr *th)
+{
+	/* Retransmissions of the SYN ACKs are not interesting */
+	if (syn_cookie_port == 0U || th->th_dport != syn_cookie_port) {
+		return;
+	}
+
+	syn_cookie_port = 0U;
+	syn_cookie_th = *th;
+
+	test_sem_give();
+}
+
+static void count_conn(struct tcp *conn, void *user_data)
+{
+	int *count = user_data;
+
+	ARG_UNUSED(conn);
+
+	(*count)++;
+}
+
+static int conn_count(void)
+{
+	int count = 0;
+
+	net_tcp_foreach(count_conn, &count);
+
+	return count;
+}
+
+static void syn_cookie_send(struct net_pkt *pkt, uint16_t port)
+{
+	int ret;
+
+	zassert_not_null(pkt, "Cannot create pkt");
+
+	syn_cookie_port = htons(port);
+
+	ret = net_recv_data(iface, pkt);
+	zassert_true(ret == 0, "recv data failed (%d)", ret);
+
+	test_sem_take(K_MSEC(100), __LINE__);
+}
+
+/* Test case scenario IPv4
+ *   fill the backlog of a listener with SYNs,
+ *   send SYN,
+ *   expect SYN ACK with a cookie, and no new connection,
+ *   send ACK of the cookie,
+ *   expect the connection to be accepted.
+ *   any failures cause test case to fail.
+ */
+ZTEST(net_tcp, test_server_syn_cookie)
+{
+	struct net_context *ctx;
+	uint32_t cookie;
+	int count;
+	int ret;
+	int i;
+
+	if (!IS_ENABLED(CONFIG_NET_TCP_SYN_COOKIES)) {
+		ztest_test_skip();
+	}
+
+	test_case_no = 10;
+	seq = 100U;
+	accepted_ctx = NULL;
+	k_sem_reset(&test_sem);
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	zassert_equal(ret, 0, "Failed to get net_context");
+
+	net_context_ref(ctx);
+
+	ret = net_context_bind(ctx, (struct sockaddr *)&my_addr_s,
+			       sizeof(struct sockaddr_in));
+	zassert_equal(ret, 0, "Failed to bind net_context");
+
+	ret = net_context_listen(ctx, 1);
+	zassert_equal(ret, 0, "Failed to listen on net_context");
+
+	ret = net_context_accept(ctx, test_tcp_accept_cb, K_FOREVER, NULL);
+	zassert_equal(ret, 0, "Failed to set accept on net_context");
+
+	/* One more connection than the backlog is allowed in the handshake */
+	for (i = 1; i <= 2; i++) {
+		syn_cookie_send(prepare_syn_packet(AF_INET,
+						   htons(PEER_PORT + i),
+						   htons(MY_PORT)),
+				PEER_PORT + i);
+		test_verify_flags(&syn_cookie_th, SYN | ACK);
+	}
+
+	count = conn_count();
+
+	syn_cookie_send(prepare_syn_packet(AF_INET, htons(PEER_PORT + 3),
+					   htons(MY_PORT)),
+			PEER_PORT + 3);
+	test_verify_flags(&syn_cookie_th, SYN | ACK);
+	zassert_equal(ntohl(syn_cookie_th.th_ack), seq + 1U,
+		      "SYN not acked");
+	zassert_equal(conn_count(), count,
+		      "Connection allocated for a full backlog");
+
+	cookie = ntohl(syn_cookie_th.th_seq);
+
+	/* A wrong cookie is dropped */
+	seq++;
+	ack = cookie + 2U;
+	ret = net_recv_data(iface, prepare_ack_packet(AF_INET,
+						      htons(PEER_PORT + 3),
+						      htons(MY_PORT)));
+	zassert_true(ret == 0, "recv data failed (%d)", ret);
+
+	k_msleep(50);
+
+	zassert_is_null(accepted_ctx, "Invalid cookie accepted");
+	zassert_equal(conn_count(), count, "Invalid cookie made a connection");
+
+	/* The ACK of the cookie completes the handshake */
+	ack = cookie + 1U;
+	ret = net_recv_data(iface, prepare_ack_packet(AF_INET,
+						      htons(PEER_PORT + 3),
+						      htons(MY_PORT)));
+	zassert_true(ret == 0, "recv data failed (%d)", ret);
+
+	/* test_tcp_accept_cb will release the semaphore */
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	zassert_not_null(accepted_ctx, "Connection not accepted");
+	zassert_equal(net_sin(&accepted_ctx->remote)->sin_port,
+		      htons(PEER_PORT + 3), "Wrong connection accepted");
+	zassert_equal(net_tcp_get_state(accepted_ctx->tcp), TCP_ESTABLISHED,
+		      "Connection not established");
+
+	/* Abort the connections, none of them sent data */
+	for (i = 1; i <= 3; i++) {
+		ret = net_recv_data(iface,
+				    prepare_rst_packet(AF_INET,
+						       htons(PEER_PORT + i),
+						       htons(MY_PORT)));
+		zassert_true(ret == 0, "recv data failed (%d)", ret);
+	}
+
+	/* Let the receiving thread run */
+	k_msleep(50);
+
+	net_context_put(ctx);
+	net_context_put(accepted_ctx);
+}
+
 ZTEST_SUITE(net_tcp, NULL, presetup, NULL, NULL, NULL);
@@ -30,6 +30,7 @@ LOG_MODULE_REGISTER(net_test, NET_LOG_LEVEL);
 #include <zephyr/net/udp.h>
 
 #include "ipv6.h"
+#include "udp_internal.h"
 
 #define NET_LOG_ENABLED 1
 #include "net_private.h"
@@ -99,6 +100,46 @@ static struct k_sem wait_data;
 
 #define WAIT_TIME K_SECONDS(1)
 
+#if defined(CONFIG_NET_TC_FLOW_STEERING)
+#define FLOW_COUNT 8
+#define FLOW_PKTS 4
+
+/* Packets sent while testing the flow steering, in sending order */
+static struct {
+	uint32_t hash;
+	k_tid_t thread;
+	uint8_t flow;
+	uint8_t seq;
+} flow_sent[FLOW_COUNT * FLOW_PKTS];
+
+static bool flow_test_started;
+static atomic_t flow_sent_count;
+static K_SEM_DEFINE(flow_sem, 0, UINT_MAX);
+
+static void flow_pkt_sent(struct net_pkt *pkt)
+{
+	int idx = atomic_inc(&flow_sent_count);
+	uint8_t data[2] = { 0 };
+
+	if (idx >= ARRAY_SIZE(flow_sent)) {
+		return;
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+	(void)net_pkt_skip(pkt, sizeof(struct net_ipv6_hdr) +
+			   sizeof(struct net_udp_hdr));
+	(void)net_pkt_read(pkt, data, sizeof(data));
+
+	flow_sent[idx].hash = net_pkt_flow_hash(pkt);
+	flow_sent[idx].thread = k_current_get();
+	flow_sent[idx].flow = data[0];
+	flow_sent[idx].seq = data[1];
+
+	k_sem_give(&flow_sem);
+}
+#endif /* CONFIG_NET_TC_FLOW_STEERING */
+
 struct eth_context {
 	struct net_if *iface;
 	uint8_t mac_addr[6];
@@ -166,6 +207,13 @@ static int eth_tx(const struct device *dev, struct net_pkt *pkt)
 		return -ENODATA;
 	}
 
+#if defined(CONFIG_NET_TC_FLOW_STEERING)
+	if (flow_test_started) {
+		flow_pkt_sent(pkt);
+		return 0;
+	}
+#endif
+
 	if (start_receiving) {
 		struct in6_addr addr;
 		struct net_udp_hdr hdr, *udp_hdr;
@@ -1053,6 +1101,174 @@ ZTEST(net_traffic_class, test_mix_all_2)
 	test_traffic_class_recv_data_mix_all_2();
 }
 
+#if defined(CONFIG_NET_TC_FLOW_STEERING)
+/* Verification vectors of the Microsoft RSS specification, IPv6 with
+ * ports.
+ */
+static const struct {
+	struct in6_addr src;
+	struct in6_addr dst;
+	uint16_t src_port;
+	uint16_t dst_port;
+	uint32_t hash;
+} flow_hash_vectors[] = {
+	{
+		/* 3ffe:2501:200:1fff::7 to 3ffe:2501:200:3::1 */
+		.src = { { { 0x3f, 0xfe, 0x25, 0x01, 0x02, 0x00, 0x1f, 0xff,
+			     0, 0, 0, 0, 0, 0, 0, 0x07 } } },
+		.dst = { { { 0x3f, 0xfe, 0x25, 0x01, 0x02, 0x00, 0x00, 0x03,
+			     0, 0, 0, 0, 0, 0, 0, 0x01 } } },
+		.src_port = 2794,
+		.dst_port = 1766,
+		.hash = 0x40207d3d,
+	},
+	{
+		/* 3ffe:501:8::260:97ff:fe40:efab to ff02::1 */
+		.src = { { { 0x3f, 0xfe, 0x05, 0x01, 0x00, 0x08, 0x00, 0x00,
+			     0x02, 0x60, 0x97, 0xff, 0xfe, 0x40, 0xef,
+			     0xab } } },
+		.dst = { { { 0xff, 0x02, 0, 0, 0, 0, 0, 0,
+			     0, 0, 0, 0, 0, 0, 0, 0x01 } } },
+		.src_port = 14230,
+		.dst_port = 4739,
+		.hash = 0xdde51bbf,
+	},
+	{
+		/* 3ffe:1900:4545:3:200:f8ff:fe21:67cf to
+		 * fe80::200:f8ff:fe21:67cf
+		 */
+		.src = { { { 0x3f, 0xfe, 0x19, 0x00, 0x45, 0x45, 0x00, 0x03,
+			     0x02, 0x00, 0xf8, 0xff, 0xfe, 0x21, 0x67,
+			     0xcf } } },
+		.dst = { { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+			     0x02, 0x00, 0xf8, 0xff, 0xfe, 0x21, 0x67,
+			     0xcf } } },
+		.src_port = 44251,
+		.dst_port = 38024,
+		.hash = 0x02d1feef,
+	},
+};
+
+/* Send a UDP packet carrying its flow and sequence numbers */
+static void flow_send(const struct in6_addr *src, const struct in6_addr *dst,
+		      uint16_t src_port, uint16_t dst_port,
+		      uint8_t flow, uint8_t seq)
+{
+	struct net_if *iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	uint8_t data[2] = { flow, seq };
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_alloc_with_buffer(iface, sizeof(data), AF_INET6,
+					IPPROTO_UDP, K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	zassert_ok(net_ipv6_create(pkt, src, dst));
+	zassert_ok(net_udp_create(pkt, htons(src_port), htons(dst_port)));
+	zassert_ok(net_pkt_write(pkt, data, sizeof(data)));
+
+	net_pkt_cursor_init(pkt);
+	zassert_ok(net_ipv6_finalize(pkt, IPPROTO_UDP));
+
+	zassert_equal(net_if_send_data(iface, pkt), NET_OK, "Send failed");
+}
+
+static void flow_wait(int count)
+{
+	for (int i = 0; i < count; i++) {
+		zassert_ok(k_sem_take(&flow_sem, WAIT_TIME),
+			   "Timeout, %d packets out of %d sent",
+			   (int)atomic_get(&flow_sent_count), count);
+	}
+
+	flow_test_started = false;
+}
+
+static void flow_test_start(void)
+{
+	atomic_set(&flow_sent_count, 0);
+	k_sem_reset(&flow_sem);
+	flow_test_started = true;
+}
+
+ZTEST(net_traffic_class, test_flow_hash)
+{
+	flow_test_start();
+
+	for (int i = 0; i < ARRAY_SIZE(flow_hash_vectors); i++) {
+		flow_send(&flow_hash_vectors[i].src, &flow_hash_vectors[i].dst,
+			  flow_hash_vectors[i].src_port,
+			  flow_hash_vectors[i].dst_port, i, 0);
+	}
+
+	flow_wait(ARRAY_SIZE(flow_hash_vectors));
+
+	for (int i = 0; i < ARRAY_SIZE(flow_hash_vectors); i++) {
+		uint8_t flow = flow_sent[i].flow;
+
+		zassert_true(flow < ARRAY_SIZE(flow_hash_vectors),
+			     "Unknown flow %u", flow);
+		zassert_equal(flow_sent[i].hash, flow_hash_vectors[flow].hash,
+			      "Flow %u hash 0x%08x, expecting 0x%08x", flow,
+			      flow_sent[i].hash, flow_hash_vectors[flow].hash);
+	}
+}
+
+ZTEST(net_traffic_class, test_flow_order)
+{
+	k_tid_t threads[FLOW_COUNT] = { 0 };
+	uint32_t hashes[FLOW_COUNT] = { 0 };
+	uint8_t next_seq[FLOW_COUNT] = { 0 };
+
+	flow_test_start();
+
+	/* Interleave the packets of the flows, which differ by source port */
+	for (int seq = 0; seq < FLOW_PKTS; seq++) {
+		for (int flow = 0; flow < FLOW_COUNT; flow++) {
+			flow_send(&my_addr1, &dst_addr, 5000 + flow, TEST_PORT,
+				  flow, seq);
+		}
+	}
+
+	flow_wait(FLOW_COUNT * FLOW_PKTS);
+
+	for (int i = 0; i < FLOW_COUNT * FLOW_PKTS; i++) {
+		uint8_t flow = flow_sent[i].flow;
+
+		zassert_true(flow < FLOW_COUNT, "Unknown flow %u", flow);
+		zassert_not_equal(flow_sent[i].hash, 0, "Flow %u not hashed",
+				  flow);
+
+		/* One thread per flow, in sending order */
+		zassert_equal(flow_sent[i].seq, next_seq[flow],
+			      "Flow %u packet %u out of order", flow,
+			      flow_sent[i].seq);
+		next_seq[flow]++;
+
+		if (threads[flow] == NULL) {
+			threads[flow] = flow_sent[i].thread;
+			hashes[flow] = flow_sent[i].hash;
+		}
+
+		zassert_equal_ptr(flow_sent[i].thread, threads[flow],
+				  "Flow %u moved to another thread", flow);
+		zassert_equal(flow_sent[i].hash, hashes[flow],
+			      "Flow %u hash changed", flow);
+	}
+
+	/* The hash selects the queue, and so the thread */
+	for (int i = 0; i < FLOW_COUNT; i++) {
+		for (int j = 0; j < FLOW_COUNT; j++) {
+			bool same_queue =
+				hashes[i] % CONFIG_NET_TC_TX_FLOW_QUEUES ==
+				hashes[j] % CONFIG_NET_TC_TX_FLOW_QUEUES;
+
+			zassert_equal(threads[i] == threads[j], same_queue,
+				      "Flows %d and %d in wrong queues", i, j);
+		}
+	}
+}
+#endif /* CONFIG_NET_TC_FLOW_STEERING */
+
 static void run_before(void *dummy)
 {
 	ARG_UNUSED(dummy);
@@ -433,7 +433,7 @@ ZTEST(udp_fn_tests, test_udp)
 	struct net_conn_handle *handlers[CONFIG_NET_MAX_CONN];
 	struct net_if *iface;
 	struct net_if_addr *ifaddr;
-	struct ud *ud;
+	struct ud *ud, *ud_listen;
 	int ret, i = 0;
 	bool st;
 
@@ -624,10 +624,21 @@ ZTEST(udp_fn_tests, test_udp)
 	TEST_IPV6_OK(ud, &in6addr_peer, &in6addr_my, 1234, 4242);
 	TEST_IPV6_FAIL(ud, &in6addr_peer, &in6addr_my, 1234, 4243);
 
+	/* Fully specified connection is preferred over a listening one */
+	ud_listen = REGISTER(AF_INET6, NULL, &any_addr6, 0, 4242);
+	TEST_IPV6_OK(ud, &in6addr_peer, &in6addr_my, 1234, 4242);
+	TEST_IPV6_OK(ud_listen, &in6addr_peer, &in6addr_my, 1235, 4242);
+	UNREGISTER(ud_listen);
+
 	ud = REGISTER(AF_INET, &peer_addr4, &my_addr4, 1234, 4242);
 	TEST_IPV4_OK(ud, &in4addr_peer, &in4addr_my, 1234, 4242);
 	TEST_IPV4_FAIL(ud, &in4addr_peer, &in4addr_my, 1234, 4243);
 
+	ud_listen = REGISTER(AF_INET, NULL, &any_addr4, 0, 4242);
+	TEST_IPV4_OK(ud, &in4addr_peer, &in4addr_my, 1234, 4242);
+	TEST_IPV4_OK(ud_listen, &in4addr_peer, &in4addr_my, 1235, 4242);
+	UNREGISTER(ud_listen);
+
 	ud = REGISTER(AF_UNSPEC, NULL, NULL, 1234, 42423);
 	TEST_IPV4_OK(ud, &in4addr_peer, &in4addr_my, 1234, 42423);
 	TEST_IPV6_OK(ud, &in6addr_peer, &in6addr_my, 1234, 42423);
@@ -923,4 +923,51 @@ ZTEST(test_utils_fn, test_ip_checksum)
 	}
 }
 
+/* A region with a valid checksum field sums up to 0xffff */
+static bool ip_checksum_is_valid(uint16_t chksum, const uint8_t *data, size_t len)
+{
+	return calc_chksum(ntohs(chksum), data, len) == 0xffff;
+}
+
+ZTEST(test_utils_fn, test_ip_checksum_update)
+{
+	const size_t len = 64;
+	uint8_t old_data[sizeof(struct in_addr)];
+	uint16_t chksum, old_val, new_val;
+	uint16_t sum;
+
+	for (int i = 0; i < len; i++) {
+		testdata[i] = (uint8_t)(i * 7 + 3);
+	}
+
+	sum = htons(calc_chksum(0, testdata, len));
+	chksum = ~sum;
+
+	for (int i = 0; i < 64; i++) {
+		uint8_t *addr = &testdata[(i * 6) % (len - sizeof(old_data))];
+
+		/* Rewrite an address, as NAT would */
+		memcpy(old_data, addr, sizeof(old_data));
+		for (int j = 0; j < sizeof(old_data); j++) {
+			addr[j] ^= (uint8_t)(i * 13 + j);
+		}
+
+		chksum = net_chksum_update(chksum, old_data, addr,
+					   sizeof(old_data));
+
+		zassert_true(ip_checksum_is_valid(chksum, testdata, len),
+			     "Address rewrite %d: checksum 0x%04x", i, chksum);
+
+		/* Rewrite a port */
+		memcpy(&old_val, &testdata[20], sizeof(old_val));
+		new_val = old_val ^ (uint16_t)(i * 0x0101 + 1);
+		memcpy(&testdata[20], &new_val, sizeof(new_val));
+
+		chksum = net_chksum_update16(chksum, old_val, new_val);
+
+		zassert_true(ip_checksum_is_valid(chksum, testdata, len),
+			     "Port rewrite %d: checksum 0x%04x", i, chksum);
+	}
+}
+
 ZTEST_SUITE(test_utils_fn, NULL, NULL, NULL, NULL, NULL);
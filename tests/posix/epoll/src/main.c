@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/ztest.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#define TESTVAL 10
+#define TESTDATA 0x1234
+
+static int epfd;
+static int efd;
+
+static void add_fd(uint32_t events)
+{
+	struct epoll_event ev = {
+		.events = events,
+		.data.u32 = TESTDATA,
+	};
+	int ret;
+
+	ret = epoll_ctl(epfd, EPOLL_CTL_ADD, efd, &ev);
+	zassert_equal(ret, 0, "epoll_ctl ret %d errno %d", ret, errno);
+}
+
+static void expect_events(int timeout, int expected)
+{
+	struct epoll_event ev;
+	int ret;
+
+	ret = epoll_wait(epfd, &ev, 1, timeout);
+	zassert_equal(ret, expected, "epoll_wait ret %d errno %d", ret, errno);
+
+	if (expected > 0) {
+		zassert_equal(ev.events, EPOLLIN, "events 0x%x", ev.events);
+		zassert_equal(ev.data.u32, TESTDATA, "data 0x%x", ev.data.u32);
+	}
+}
+
+static void drain_fd(void)
+{
+	eventfd_t val;
+
+	zassert_equal(eventfd_read(efd, &val), 0, "read failed");
+}
+
+static void write_fd(void)
+{
+	zassert_equal(eventfd_write(efd, TESTVAL), 0, "write failed");
+}
+
+static void epoll_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epfd == %d", epfd);
+
+	efd = eventfd(0, EFD_NONBLOCK);
+	zassert_true(efd >= 0, "efd == %d", efd);
+}
+
+static void epoll_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	close(epfd);
+	close(efd);
+}
+
+ZTEST_SUITE(test_epoll, NULL, NULL, epoll_before, epoll_after, NULL);
+
+ZTEST(test_epoll, test_epoll_ctl_errors)
+{
+	struct epoll_event ev = { .events = EPOLLIN };
+	int ret;
+
+	ret = epoll_ctl(epfd, EPOLL_CTL_DEL, efd, NULL);
+	zassert_true(ret == -1 && errno == ENOENT, "del ret %d errno %d", ret, errno);
+
+	ret = epoll_ctl(epfd, EPOLL_CTL_MOD, efd, &ev);
+	zassert_true(ret == -1 && errno == ENOENT, "mod ret %d errno %d", ret, errno);
+
+	ret = epoll_ctl(epfd, EPOLL_CTL_ADD, epfd, &ev);
+	zassert_true(ret == -1 && errno == EINVAL, "add self ret %d errno %d", ret, errno);
+
+	ret = epoll_ctl(efd, EPOLL_CTL_ADD, epfd, &ev);
+	zassert_true(ret == -1 && errno == EINVAL, "bad epfd ret %d errno %d", ret, errno);
+
+	add_fd(EPOLLIN);
+
+	ret = epoll_ctl(epfd, EPOLL_CTL_ADD, efd, &ev);
+	zassert_true(ret == -1 && errno == EEXIST, "add twice ret %d errno %d", ret, errno);
+
+	ret = epoll_ctl(epfd, EPOLL_CTL_DEL, efd, NULL);
+	zassert_equal(ret, 0, "del ret %d errno %d", ret, errno);
+}
+
+ZTEST(test_epoll, test_epoll_level_triggered)
+{
+	add_fd(EPOLLIN);
+
+	expect_events(0, 0);
+
+	write_fd();
+
+	expect_events(0, 1);
+	/* Still readable, so reported again */
+	expect_events(0, 1);
+
+	drain_fd();
+
+	expect_events(0, 0);
+}
+
+ZTEST(test_epoll, test_epoll_edge_triggered)
+{
+	add_fd(EPOLLIN | EPOLLET);
+
+	write_fd();
+
+	expect_events(0, 1);
+
+	drain_fd();
+
+	expect_events(0, 0);
+
+	write_fd();
+
+	expect_events(0, 1);
+}
+
+ZTEST(test_epoll, test_epoll_oneshot)
+{
+	struct epoll_event ev = {
+		.events = EPOLLIN | EPOLLONESHOT,
+		.data.u32 = TESTDATA,
+	};
+	int ret;
+
+	add_fd(ev.events);
+
+	write_fd();
+
+	expect_events(0, 1);
+	/* Disabled until modified, even though still readable */
+	expect_events(0, 0);
+
+	ret = epoll_ctl(epfd, EPOLL_CTL_MOD, efd, &ev);
+	zassert_equal(ret, 0, "mod ret %d errno %d", ret, errno);
+
+	expect_events(0, 1);
+}
+
+static void write_work_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	(void)eventfd_write(efd, TESTVAL);
+}
+
+static K_WORK_DELAYABLE_DEFINE(write_work, write_work_handler);
+
+ZTEST(test_epoll, test_epoll_wait_blocking)
+{
+	add_fd(EPOLLIN);
+
+	expect_events(10, 0);
+
+	k_work_schedule(&write_work, K_MSEC(10));
+
+	expect_events(1000, 1);
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2023 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Smallest fan-out, so that the tree gets deep and rebalancing paths
+ * are exercised often.
+ */
+#define CONFIG_SYS_BTREE_CACHE_LINE_SIZE 32
+
+#include <zephyr/ztest.h>
+#include <zephyr/sys/btree.h>
+
+#include "../../../lib/os/btree.c"
+
+#define MAX_KEYS 2048
+
+SYS_BTREE_DEFINE(tree, SYS_BTREE_POOL_SIZE(MAX_KEYS));
+
+/* Set if key is in the tree */
+static bool present[MAX_KEYS];
+static size_t present_count;
+
+static uint32_t rand_state = 123456789;
+
+static uint32_t next_rand(void)
+{
+	/* xorshift32 */
+	rand_state ^= rand_state << 13;
+	rand_state ^= rand_state >> 17;
+	rand_state ^= rand_state << 5;
+
+	return rand_state;
+}
+
+static void *key_value(sys_btree_key_t key)
+{
+	return (void *)(uintptr_t)(key * 3 + 1);
+}
+
+static size_t check_node(struct sys_btree_node *node, int depth,
+			 sys_btree_key_t lo, sys_btree_key_t hi, bool root,
+			 int *leaf_depth)
+{
+	size_t count = 0;
+
+	if (!root) {
+		zassert_true(node->count >= (node->leaf ? LEAF_MIN : INNER_MIN),
+			     "underfull node");
+	}
+	zassert_true(node->count <= ORDER, "overfull node");
+
+	for (int i = 0; i < node->count; i++) {
+		zassert_true(node->keys[i] >= lo && node->keys[i] < hi,
+			     "key out of separator bounds");
+		if (i > 0) {
+			zassert_true(node->keys[i - 1] < node->keys[i],
+				     "keys not sorted");
+		}
+	}
+
+	if (node->leaf) {
+		if (*leaf_depth < 0) {
+			*leaf_depth = depth;
+		}
+		zassert_equal(*leaf_depth, depth, "unbalanced tree");
+
+		for (int i = 0; i < node->count; i++) {
+			zassert_equal(node->values[i], key_value(node->keys[i]));
+		}
+
+		return node->count;
+	}
+
+	for (int i = 0; i <= node->count; i++) {
+		count += check_node(node->children[i], depth + 1,
+				    i > 0 ? node->keys[i - 1] : lo,
+				    i < node->count ? node->keys[i] : hi,
+				    false, leaf_depth);
+	}
+
+	return count;
+}
+
+static void check_tree(void)
+{
+	struct sys_btree_iter iter;
+	sys_btree_key_t prev = 0;
+	int leaf_depth = -1;
+	size_t count = 0;
+
+	zassert_equal(sys_btree_size(&tree), present_count);
+
+	if (tree.root == NULL) {
+		zassert_equal(present_count, 0);
+		zassert_equal(tree.height, 0);
+		return;
+	}
+
+	zassert_equal(check_node(tree.root, 1, 0, UINT64_MAX, true, &leaf_depth),
+		      present_count);
+	zassert_equal(leaf_depth, tree.height);
+
+	SYS_BTREE_FOR_EACH(&tree, iter) {
+		sys_btree_key_t key = sys_btree_iter_key(&iter);
+
+		zassert_true(present[key], "iterated over removed key");
+		zassert_true(count == 0 || key > prev, "iteration out of order");
+		zassert_equal(sys_btree_iter_value(&iter), key_value(key));
+		prev = key;
+		count++;
+	}
+
+	zassert_equal(count, present_count);
+}
+
+static void check_minmax(void)
+{
+	sys_btree_key_t min, max;
+	int lo = 0, hi = MAX_KEYS - 1;
+
+	if (present_count == 0) {
+		zassert_equal(sys_btree_get_min(&tree, &min, NULL), -ENOENT);
+		zassert_equal(sys_btree_get_max(&tree, &max, NULL), -ENOENT);
+		return;
+	}
+
+	while (!present[lo]) {
+		lo++;
+	}
+
+	while (!present[hi]) {
+		hi--;
+	}
+
+	zassert_equal(sys_btree_get_min(&tree, &min, NULL), 0);
+	zassert_equal(sys_btree_get_max(&tree, &max, NULL), 0);
+	zassert_equal(min, lo);
+	zassert_equal(max, hi);
+}
+
+static void insert_key(sys_btree_key_t key)
+{
+	int ret = sys_btree_insert(&tree, key, key_value(key));
+
+	if (present[key]) {
+		zassert_equal(ret, -EEXIST);
+	} else {
+		zassert_equal(ret, 0, "insert failed %d", ret);
+		present[key] = true;
+		present_count++;
+	}
+}
+
+static void remove_key(sys_btree_key_t key)
+{
+	void *value;
+	int ret = sys_btree_remove(&tree, key, &value);
+
+	if (present[key]) {
+		zassert_equal(ret, 0);
+		zassert_equal(value, key_value(key));
+		present[key] = false;
+		present_count--;
+	} else {
+		zassert_equal(ret, -ENOENT);
+	}
+}
+
+ZTEST(btree, test_sequential)
+{
+	for (int key = 0; key < MAX_KEYS; key++) {
+		insert_key(key);
+	}
+	check_tree();
+	check_minmax();
+
+	for (int key = 0; key < MAX_KEYS; key++) {
+		zassert_true(sys_btree_contains(&tree, key));
+	}
+
+	for (int key = MAX_KEYS - 1; key >= 0; key--) {
+		remove_key(key);
+		if ((key % 61) == 0) {
+			check_tree();
+		}
+	}
+	check_tree();
+	check_minmax();
+
+	for (int key = MAX_KEYS - 1; key >= 0; key--) {
+		insert_key(key);
+	}
+	check_tree();
+
+	for (int key = 0; key < MAX_KEYS; key += 2) {
+		remove_key(key);
+	}
+	check_tree();
+	check_minmax();
+}
+
+ZTEST(btree, test_random)
+{
+	for (int i = 0; i < 50 * MAX_KEYS; i++) {
+		sys_btree_key_t key = next_rand() % MAX_KEYS;
+		uint32_t op = next_rand() % 100;
+
+		if (op < 55) {
+			insert_key(key);
+		} else if (op < 95) {
+			remove_key(key);
+		} else {
+			void *value;
+			int ret = sys_btree_get(&tree, key, &value);
+
+			zassert_equal(ret, present[key] ? 0 : -ENOENT);
+			if (ret == 0) {
+				zassert_equal(value, key_value(key));
+			}
+		}
+
+		if ((i % 1000) == 0) {
+			check_tree();
+			check_minmax();
+		}
+	}
+
+	check_tree();
+}
+
+static void btree_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	for (int key = 0; key < MAX_KEYS; key++) {
+		if (present[key]) {
+			remove_key(key);
+		}
+	}
+
+	zassert_true(sys_btree_is_empty(&tree));
+	zassert_is_null(tree.root);
+}
+
+ZTEST_SUITE(btree, NULL, NULL, btree_before, NULL, NULL);